@@ -0,0 +1,75 @@
+################################################################################
+# 
+# MIT License
+# 
+# Copyright (c) 2017 - 2023 Advanced Micro Devices, Inc.
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+# 
+################################################################################
+find_path(WebP_INCLUDE_DIRS
+    NAMES webp/decode.h
+    HINTS
+    $ENV{WebP_DIR}/include
+    PATHS
+    ${WebP_DIR}/include
+    /usr/include
+    /usr/local/include
+)
+mark_as_advanced(WebP_INCLUDE_DIRS)
+
+find_library(WebP_LIBRARIES
+    NAMES webp
+    HINTS
+    $ENV{WebP_DIR}/lib
+    $ENV{WebP_DIR}/lib64
+    PATHS
+    ${WebP_DIR}/lib
+    ${WebP_DIR}/lib64
+    /usr/local/lib
+    /usr/local/lib64
+    /usr/lib
+    /usr/lib64
+)
+mark_as_advanced(WebP_LIBRARIES)
+
+if(WebP_LIBRARIES AND WebP_INCLUDE_DIRS)
+    set(WebP_FOUND TRUE)
+endif( )
+
+include( FindPackageHandleStandardArgs )
+find_package_handle_standard_args( WebP
+    FOUND_VAR  WebP_FOUND
+    REQUIRED_VARS
+        WebP_LIBRARIES
+        WebP_INCLUDE_DIRS
+)
+
+set(WebP_FOUND ${WebP_FOUND} CACHE INTERNAL "")
+set(WebP_LIBRARIES ${WebP_LIBRARIES} CACHE INTERNAL "")
+set(WebP_INCLUDE_DIRS ${WebP_INCLUDE_DIRS} CACHE INTERNAL "")
+
+if(WebP_FOUND)
+    message("-- ${White}Using WebP -- \n\tLibraries:${WebP_LIBRARIES} \n\tIncludes:${WebP_INCLUDE_DIRS}${ColourReset}")
+else()
+    if(WebP_FIND_REQUIRED)
+        message(FATAL_ERROR "{Red}FindWebP -- NOT FOUND${ColourReset}")
+    endif()
+    message( "-- ${Yellow}NOTE: FindWebP failed to find -- WebP${ColourReset}" )
+endif()
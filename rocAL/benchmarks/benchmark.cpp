@@ -0,0 +1,203 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include "benchmark.h"
+
+BenchmarkResult Benchmark::result() const
+{
+    BenchmarkResult result;
+    result.name = _name;
+    result.skipped = _skipped;
+    result.iterations = _samples.size();
+    if(_samples.empty())
+        return result;
+    std::vector<double> sorted(_samples);
+    std::sort(sorted.begin(), sorted.end());
+    double total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+    result.mean_ns = total / sorted.size();
+    result.min_ns = sorted.front();
+    result.max_ns = sorted.back();
+    size_t mid = sorted.size() / 2;
+    result.median_ns = (sorted.size() % 2) ? sorted[mid] : 0.5 * (sorted[mid - 1] + sorted[mid]);
+    double variance = 0;
+    for(auto sample : sorted)
+        variance += (sample - result.mean_ns) * (sample - result.mean_ns);
+    result.stddev_ns = std::sqrt(variance / sorted.size());
+    if(total > 0)
+    {
+        result.items_per_second = _items * 1e9 / total;
+        result.bytes_per_second = _bytes * 1e9 / total;
+    }
+    return result;
+}
+
+void BenchmarkSuite::list() const
+{
+    for(auto &benchmark : _benchmarks)
+        std::cout << benchmark.first << std::endl;
+}
+
+static std::string json_escape(const std::string &value)
+{
+    std::ostringstream out;
+    for(char c : value)
+    {
+        switch(c)
+        {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20)
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec;
+                else
+                    out << c;
+        }
+    }
+    return out.str();
+}
+
+static void write_json(const std::string &path, const BenchmarkOptions &options, const std::vector<BenchmarkResult> &results)
+{
+    std::ofstream out(path);
+    if(!out)
+    {
+        std::cerr << "Could not open " << path << " to write the results" << std::endl;
+        return;
+    }
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    out << std::setprecision(10);
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"iterations\": " << options.iterations << ",\n";
+    out << "    \"warmup\": " << options.warmup << ",\n";
+    out << "    \"batch_size\": " << options.batch_size << ",\n";
+    out << "    \"cpu_threads\": " << options.cpu_threads << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        auto &result = results[i];
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"name\": \"" << json_escape(result.name) << "\",\n";
+        if(!result.error.empty())
+            out << "      \"error\": \"" << json_escape(result.error) << "\",\n";
+        if(!result.skipped.empty())
+            out << "      \"skipped\": \"" << json_escape(result.skipped) << "\",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"mean_ns\": " << result.mean_ns << ",\n";
+        out << "      \"median_ns\": " << result.median_ns << ",\n";
+        out << "      \"min_ns\": " << result.min_ns << ",\n";
+        out << "      \"max_ns\": " << result.max_ns << ",\n";
+        out << "      \"stddev_ns\": " << result.stddev_ns << ",\n";
+        out << "      \"items_per_second\": " << result.items_per_second << ",\n";
+        out << "      \"bytes_per_second\": " << result.bytes_per_second << "\n";
+        out << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static std::string format_duration(double ns)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    if(ns >= 1e9)
+        out << ns / 1e9 << " s";
+    else if(ns >= 1e6)
+        out << ns / 1e6 << " ms";
+    else if(ns >= 1e3)
+        out << ns / 1e3 << " us";
+    else
+        out << ns << " ns";
+    return out.str();
+}
+
+static std::string format_rate(double rate, const char *unit)
+{
+    if(rate <= 0)
+        return "-";
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    if(rate >= 1e9)
+        out << rate / 1e9 << " G" << unit;
+    else if(rate >= 1e6)
+        out << rate / 1e6 << " M" << unit;
+    else if(rate >= 1e3)
+        out << rate / 1e3 << " K" << unit;
+    else
+        out << rate << " " << unit;
+    return out.str();
+}
+
+int BenchmarkSuite::run(const BenchmarkOptions &options) const
+{
+    std::vector<BenchmarkResult> results;
+    int failed = 0;
+    std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(12) << "Median" << std::setw(12) << "Mean"
+              << std::setw(12) << "Min" << std::setw(14) << "Items/s" << std::setw(14) << "Bytes/s" << std::endl;
+    std::cout << std::string(112, '-') << std::endl;
+    for(auto &entry : _benchmarks)
+    {
+        if(!options.filter.empty() && entry.first.find(options.filter) == std::string::npos)
+            continue;
+        Benchmark benchmark(entry.first, options);
+        BenchmarkResult result;
+        try
+        {
+            entry.second(benchmark);
+            result = benchmark.result();
+        }
+        catch(const std::exception &e)
+        {
+            result = benchmark.result();
+            result.error = e.what();
+            failed++;
+        }
+        std::cout << std::left << std::setw(48) << result.name << std::right;
+        if(!result.error.empty())
+            std::cout << "  failed: " << result.error << std::endl;
+        else if(!result.skipped.empty())
+            std::cout << "  skipped: " << result.skipped << std::endl;
+        else
+            std::cout << std::setw(12) << format_duration(result.median_ns) << std::setw(12) << format_duration(result.mean_ns)
+                      << std::setw(12) << format_duration(result.min_ns) << std::setw(14) << format_rate(result.items_per_second, "")
+                      << std::setw(14) << format_rate(result.bytes_per_second, "B") << std::endl;
+        results.push_back(result);
+    }
+    if(!options.json_path.empty())
+        write_json(options.json_path, options, results);
+    return failed;
+}
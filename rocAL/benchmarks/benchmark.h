@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+//! Options shared by all the benchmarks, set from the command line
+struct BenchmarkOptions
+{
+    size_t iterations = 50;//!< Timed calls per benchmark
+    size_t warmup = 5;//!< Untimed calls made before the timed ones
+    size_t batch_size = 8;
+    size_t cpu_threads = 1;
+    std::string filter;//!< Only the benchmarks with a name containing this string are run
+    std::string json_path;//!< Results are written to this file in JSON format if set
+    std::string file_root;//!< Folder of jpeg images for the file reader
+    std::string tfrecord_path;
+    std::string caffe_lmdb_path;
+    std::string caffe2_lmdb_path;
+    std::string recordio_path;
+    std::string cifar10_path;
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    size_t iterations = 0;
+    double mean_ns = 0, median_ns = 0, min_ns = 0, max_ns = 0, stddev_ns = 0;
+    double items_per_second = 0, bytes_per_second = 0;
+    std::string skipped;//!< Reason the benchmark did not run, empty if it ran
+    std::string error;//!< Exception thrown by the benchmark, empty if none
+};
+
+/*! \brief Times the calls made to a benchmark body
+ *
+ * run() calls the body options().warmup times untimed and then options().iterations times timed, each timed call is one sample.
+ * Items and bytes reported with add_items() / add_bytes() are only counted for the timed calls, throughput is their total over the total timed duration.
+ */
+class Benchmark
+{
+public:
+    Benchmark(std::string name, const BenchmarkOptions &options): _name(std::move(name)), _options(options) {}
+    const std::string &name() const { return _name; }
+    const BenchmarkOptions &options() const { return _options; }
+    template <typename Body>
+    void run(Body body) { run([]() {}, body); }
+    //! setup() is called before every call to body() and is not timed
+    template <typename Setup, typename Body>
+    void run(Setup setup, Body body)
+    {
+        for(size_t i = 0; i < _options.warmup; i++)
+        {
+            setup();
+            body();
+        }
+        _samples.reserve(_samples.size() + _options.iterations);
+        for(size_t i = 0; i < _options.iterations; i++)
+        {
+            setup();
+            _timing = true;
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            _timing = false;
+            _samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+    }
+    //! Adds a duration measured by the benchmark itself, for the parts of the pipeline timed internally by rocAL
+    void add_sample(double ns) { _samples.push_back(ns); }
+    void add_items(double items) { if(_timing) _items += items; }
+    void add_bytes(double bytes) { if(_timing) _bytes += bytes; }
+    //! Counters for the samples added with add_sample()
+    void add_sampled_items(double items) { _items += items; }
+    void add_sampled_bytes(double bytes) { _bytes += bytes; }
+    void skip(const std::string &reason) { _skipped = reason; }
+    bool skipped() const { return !_skipped.empty(); }
+    BenchmarkResult result() const;
+private:
+    std::string _name;
+    const BenchmarkOptions &_options;
+    std::vector<double> _samples;
+    double _items = 0, _bytes = 0;
+    bool _timing = false;
+    std::string _skipped;
+};
+
+using BenchmarkFunction = std::function<void(Benchmark &)>;
+
+class BenchmarkSuite
+{
+public:
+    void add(const std::string &name, BenchmarkFunction function) { _benchmarks.emplace_back(name, std::move(function)); }
+    void list() const;
+    //! Runs the benchmarks selected by options.filter, prints a table of the results and writes them to options.json_path
+    /// \return number of benchmarks that failed
+    int run(const BenchmarkOptions &options) const;
+private:
+    std::vector<std::pair<std::string, BenchmarkFunction>> _benchmarks;
+};
+
+//! Keeps the compiler from optimizing out the computation of the value pointed to
+inline void benchmark_do_not_optimize(const void *p)
+{
+    asm volatile("" : : "g"(p) : "memory");
+}
+
+void register_reader_benchmarks(BenchmarkSuite &suite);
+void register_decoder_benchmarks(BenchmarkSuite &suite);
+void register_meta_data_benchmarks(BenchmarkSuite &suite);
+void register_pipeline_benchmarks(BenchmarkSuite &suite);
@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "benchmark.h"
+#include "decoder_factory.h"
+#include "reader_factory.h"
+
+static const unsigned DECODE_SIZES[][2] = {{320, 240}, {640, 480}, {1920, 1080}};
+
+//! Encodes a few distinct synthetic images of the given size, the same JPEGs the synthetic reader hands to the decoders
+static std::vector<std::vector<unsigned char>> encode_images(unsigned width, unsigned height, unsigned count)
+{
+    SyntheticDataConfig synthetic_config;
+    synthetic_config.sample_count = count;
+    synthetic_config.distinct_images = count;
+    synthetic_config.min_width = synthetic_config.max_width = width;
+    synthetic_config.min_height = synthetic_config.max_height = height;
+    synthetic_config.jpeg_encoded = true;
+    ReaderConfig config(StorageType::SYNTHETIC);
+    config.set_synthetic_data_config(synthetic_config);
+    auto reader = create_reader(config);
+    std::vector<std::vector<unsigned char>> images;
+    while(reader->count_items() > 0 && images.size() < count)
+    {
+        std::vector<unsigned char> image(reader->open());
+        reader->read_data(image.data(), image.size());
+        reader->close();
+        images.push_back(std::move(image));
+    }
+    return images;
+}
+
+static void decode_benchmark(Benchmark &state, DecoderType type, unsigned width, unsigned height)
+{
+    auto images = encode_images(width, height, 8);
+    DecoderConfig config(type);
+    auto decoder = create_decoder(config);
+    decoder->initialize(0);
+    // The fused decoder only decodes the center crop covering half of each dimension
+    const bool crop = decoder->is_partial_decoder();
+    const size_t output_width = crop ? width / 2 : width, output_height = crop ? height / 2 : height;
+    std::vector<unsigned char> output(width * height * 3);
+    size_t index = 0;
+    state.run([&]()
+    {
+        auto &image = images[index++ % images.size()];
+        int original_width, original_height, color_comps;
+        if(decoder->decode_info(image.data(), image.size(), &original_width, &original_height, &color_comps) != Decoder::Status::OK)
+            throw std::runtime_error("Decoder failed to read the jpeg header");
+        if(crop)
+        {
+            CropWindow window(original_width / 4, original_height / 4, output_height, output_width);
+            decoder->set_crop_window(window);
+        }
+        size_t decoded_width, decoded_height;
+        if(decoder->decode(image.data(), image.size(), output.data(), output_width, output_height, original_width, original_height,
+                           decoded_width, decoded_height, Decoder::ColorFormat::RGB, config, false) != Decoder::Status::OK)
+            throw std::runtime_error("Decoder failed to decode the image");
+        benchmark_do_not_optimize(output.data());
+        state.add_items(1);
+        state.add_bytes(decoded_width * decoded_height * 3);
+    });
+}
+
+void register_decoder_benchmarks(BenchmarkSuite &suite)
+{
+    for(auto &size : DECODE_SIZES)
+    {
+        unsigned width = size[0], height = size[1];
+        std::string resolution = std::to_string(width) + "x" + std::to_string(height);
+        suite.add("decoder/turbo_jpeg/" + resolution, [width, height](Benchmark &state)
+        {
+            decode_benchmark(state, DecoderType::TURBO_JPEG, width, height);
+        });
+        suite.add("decoder/fused_turbo_jpeg/" + resolution, [width, height](Benchmark &state)
+        {
+            decode_benchmark(state, DecoderType::FUSED_TURBO_JPEG, width, height);
+        });
+    }
+}
@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "benchmark.h"
+#include "bounding_box_graph.h"
+#include "synthetic_data.h"
+
+//! Default boxes of SSD300 (8732 anchors) in normalized ltrb format, the anchors the box encoder is used with for COCO training
+static std::vector<float> ssd300_anchors()
+{
+    const int fig_size = 300;
+    const int feature_sizes[] = {38, 19, 10, 5, 3, 1};
+    const int steps[] = {8, 16, 32, 64, 100, 300};
+    const int scales[] = {21, 45, 99, 153, 207, 261, 315};
+    const std::vector<std::vector<float>> aspect_ratios = {{2}, {2, 3}, {2, 3}, {2, 3}, {2}, {2}};
+    std::vector<float> anchors;
+    for(size_t level = 0; level < 6; level++)
+    {
+        float sk1 = scales[level] / (float)fig_size, sk2 = scales[level + 1] / (float)fig_size;
+        float sk3 = std::sqrt(sk1 * sk2);
+        std::vector<std::pair<float, float>> sizes = {{sk1, sk1}, {sk3, sk3}};
+        for(auto alpha : aspect_ratios[level])
+        {
+            float w = sk1 * std::sqrt(alpha), h = sk1 / std::sqrt(alpha);
+            sizes.emplace_back(w, h);
+            sizes.emplace_back(h, w);
+        }
+        float fk = fig_size / (float)steps[level];
+        for(int i = 0; i < feature_sizes[level]; i++)
+            for(int j = 0; j < feature_sizes[level]; j++)
+                for(auto &size : sizes)
+                {
+                    float cx = (j + 0.5f) / fk, cy = (i + 0.5f) / fk;
+                    anchors.push_back(std::clamp(cx - 0.5f * size.first, 0.f, 1.f));
+                    anchors.push_back(std::clamp(cy - 0.5f * size.second, 0.f, 1.f));
+                    anchors.push_back(std::clamp(cx + 0.5f * size.first, 0.f, 1.f));
+                    anchors.push_back(std::clamp(cy + 0.5f * size.second, 0.f, 1.f));
+                }
+    }
+    return anchors;
+}
+
+//! A batch of the synthetic reader's boxes, 1 to max_boxes per image
+static std::shared_ptr<BoundingBoxBatch> synthetic_box_batch(size_t batch_size, unsigned max_boxes)
+{
+    SyntheticDataConfig config;
+    config.max_boxes = max_boxes;
+    config.num_classes = 80;
+    auto batch = std::make_shared<BoundingBoxBatch>();
+    batch->resize(batch_size);
+    for(size_t i = 0; i < batch_size; i++)
+    {
+        auto desc = synthetic_image_desc(config, i);
+        synthetic_boxes(desc, batch->get_bb_cords_batch()[i], batch->get_bb_labels_batch()[i]);
+        batch->get_img_sizes_batch()[i] = {(int)desc.width, (int)desc.height};
+    }
+    return batch;
+}
+
+static void box_encoder_benchmark(Benchmark &state, unsigned max_boxes)
+{
+    const size_t batch_size = state.options().batch_size;
+    BoundingBoxGraph graph;
+    auto anchors = ssd300_anchors();
+    std::vector<float> means = {0, 0, 0, 0}, stds = {0.1f, 0.1f, 0.2f, 0.2f};
+    auto source = synthetic_box_batch(batch_size, max_boxes);
+    pMetaDataBatch batch;
+    // The encoder replaces the boxes of the batch with the encoded ones, every call gets a fresh copy
+    state.run([&]() { batch = source->clone(); },
+              [&]()
+              {
+                  graph.update_box_encoder_meta_data(&anchors, batch, 0.5, true, 1.0, means, stds);
+                  benchmark_do_not_optimize(batch->get_bb_cords_batch()[0].data());
+                  state.add_items(batch_size);
+              });
+}
+
+void register_meta_data_benchmarks(BenchmarkSuite &suite)
+{
+    suite.add("meta_data/box_encoder/8_boxes", [](Benchmark &state) { box_encoder_benchmark(state, 8); });
+    suite.add("meta_data/box_encoder/32_boxes", [](Benchmark &state) { box_encoder_benchmark(state, 32); });
+}
@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "benchmark.h"
+#include "rocal_api.h"
+#include "context.h"
+
+/* The to_tensor variants and the meta nodes are measured through small CPU pipelines built on the synthetic source:
+ * the conversions read the ring buffer filled by the output routine, and every meta node takes its crop/resize/flip
+ * parameters from the augmentation node it is attached to, so neither can run outside of a MasterGraph. */
+class BenchmarkPipeline
+{
+public:
+    explicit BenchmarkPipeline(const BenchmarkOptions &options)
+    {
+        _handle = rocalCreate(options.batch_size, RocalProcessMode::ROCAL_PROCESS_CPU, 0, options.cpu_threads);
+        check("rocalCreate");
+    }
+    ~BenchmarkPipeline() { rocalRelease(_handle); }
+    RocalContext handle() { return _handle; }
+    RocalImage source(unsigned width, unsigned height, bool is_output, RocalSyntheticMetaData meta_data, unsigned max_boxes = 8)
+    {
+        auto image = rocalSyntheticSource(_handle, RocalImageColor::ROCAL_COLOR_RGB24, 1, is_output, 1024,
+                                          width, width, height, height, meta_data, 80, max_boxes, false, 0, false, true);
+        check("rocalSyntheticSource");
+        return image;
+    }
+    void build()
+    {
+        rocalVerify(_handle);
+        check("rocalVerify");
+    }
+    void run()
+    {
+        rocalRun(_handle);
+        check("rocalRun");
+    }
+    void check(const std::string &call)
+    {
+        if(!_handle || rocalGetStatus(_handle) != ROCAL_OK)
+            throw std::runtime_error(call + " failed: " + (_handle ? std::string(rocalGetErrorMessage(_handle)) : std::string("no context")));
+    }
+private:
+    RocalContext _handle = nullptr;
+};
+
+static const unsigned TENSOR_WIDTH = 224, TENSOR_HEIGHT = 224;
+
+//! Times one output conversion of a 224x224 RGB batch, the batch is loaded once and converted again on every call
+static void to_tensor_benchmark(Benchmark &state, size_t element_size, std::function<RocalStatus(RocalContext, void *)> convert)
+{
+    BenchmarkPipeline pipeline(state.options());
+    pipeline.source(TENSOR_WIDTH, TENSOR_HEIGHT, true, ROCAL_SYNTHETIC_NO_META_DATA);
+    pipeline.build();
+    pipeline.run();
+    const size_t elements = state.options().batch_size * TENSOR_WIDTH * TENSOR_HEIGHT * 3;
+    std::vector<unsigned char> output(elements * element_size);
+    state.run([&]()
+    {
+        if(convert(pipeline.handle(), output.data()) != ROCAL_OK)
+            pipeline.check("output conversion");
+        benchmark_do_not_optimize(output.data());
+        state.add_items(state.options().batch_size);
+        state.add_bytes(output.size());
+    });
+}
+
+/* Times the meta data graph of a pipeline made of the synthetic source with boxes and a single augmentation.
+ * The meta nodes run on the output thread, the samples are the MasterGraph's meta data processing time accumulated between two rocalRun() calls. */
+static void meta_node_benchmark(Benchmark &state, std::function<void(RocalContext, RocalImage)> augment)
+{
+    BenchmarkPipeline pipeline(state.options());
+    auto input = pipeline.source(640, 480, false, ROCAL_SYNTHETIC_BOXES, 16);
+    augment(pipeline.handle(), input);
+    pipeline.check("augmentation");
+    pipeline.build();
+    auto context = static_cast<Context *>(pipeline.handle());
+    for(size_t i = 0; i < state.options().warmup; i++)
+        pipeline.run();
+    context->timing();// Drops the time accumulated so far
+    for(size_t i = 0; i < state.options().iterations; i++)
+    {
+        pipeline.run();
+        state.add_sample(context->timing().meta_data_process_time * 1000.0);
+        state.add_sampled_items(state.options().batch_size);
+    }
+}
+
+void register_pipeline_benchmarks(BenchmarkSuite &suite)
+{
+    const float mean[] = {0.485f * 255, 0.456f * 255, 0.406f * 255}, std_dev[] = {0.229f * 255, 0.224f * 255, 0.225f * 255};
+    suite.add("to_tensor/fp32_nhwc", [=](Benchmark &state)
+    {
+        to_tensor_benchmark(state, sizeof(float), [&](RocalContext handle, void *out)
+        {
+            return rocalToTensor32(handle, (float *)out, ROCAL_NHWC, 1 / std_dev[0], 1 / std_dev[1], 1 / std_dev[2],
+                                   -mean[0] / std_dev[0], -mean[1] / std_dev[1], -mean[2] / std_dev[2], false, ROCAL_MEMCPY_HOST);
+        });
+    });
+    suite.add("to_tensor/fp32_nchw", [=](Benchmark &state)
+    {
+        to_tensor_benchmark(state, sizeof(float), [&](RocalContext handle, void *out)
+        {
+            return rocalToTensor32(handle, (float *)out, ROCAL_NCHW, 1 / std_dev[0], 1 / std_dev[1], 1 / std_dev[2],
+                                   -mean[0] / std_dev[0], -mean[1] / std_dev[1], -mean[2] / std_dev[2], false, ROCAL_MEMCPY_HOST);
+        });
+    });
+    suite.add("to_tensor/fp32_nchw_reverse_channels", [=](Benchmark &state)
+    {
+        to_tensor_benchmark(state, sizeof(float), [&](RocalContext handle, void *out)
+        {
+            return rocalToTensor32(handle, (float *)out, ROCAL_NCHW, 1 / std_dev[0], 1 / std_dev[1], 1 / std_dev[2],
+                                   -mean[0] / std_dev[0], -mean[1] / std_dev[1], -mean[2] / std_dev[2], true, ROCAL_MEMCPY_HOST);
+        });
+    });
+    suite.add("to_tensor/fp16_nhwc", [=](Benchmark &state)
+    {
+        to_tensor_benchmark(state, sizeof(half), [&](RocalContext handle, void *out)
+        {
+            return rocalToTensor16(handle, (half *)out, ROCAL_NHWC, 1 / std_dev[0], 1 / std_dev[1], 1 / std_dev[2],
+                                   -mean[0] / std_dev[0], -mean[1] / std_dev[1], -mean[2] / std_dev[2], false, ROCAL_MEMCPY_HOST);
+        });
+    });
+    suite.add("to_tensor/fp16_nchw", [=](Benchmark &state)
+    {
+        to_tensor_benchmark(state, sizeof(half), [&](RocalContext handle, void *out)
+        {
+            return rocalToTensor16(handle, (half *)out, ROCAL_NCHW, 1 / std_dev[0], 1 / std_dev[1], 1 / std_dev[2],
+                                   -mean[0] / std_dev[0], -mean[1] / std_dev[1], -mean[2] / std_dev[2], false, ROCAL_MEMCPY_HOST);
+        });
+    });
+    suite.add("to_tensor/u8_copy_to_output", [](Benchmark &state)
+    {
+        to_tensor_benchmark(state, 1, [&](RocalContext handle, void *out)
+        {
+            return rocalCopyToOutput(handle, (unsigned char *)out, state.options().batch_size * TENSOR_WIDTH * TENSOR_HEIGHT * 3);
+        });
+    });
+
+    suite.add("meta_node/flip", [](Benchmark &state)
+    {
+        meta_node_benchmark(state, [](RocalContext handle, RocalImage input) { rocalFlip(handle, input, true); });
+    });
+    suite.add("meta_node/resize", [](Benchmark &state)
+    {
+        meta_node_benchmark(state, [](RocalContext handle, RocalImage input) { rocalResize(handle, input, 300, 300, true); });
+    });
+    suite.add("meta_node/crop", [](Benchmark &state)
+    {
+        meta_node_benchmark(state, [](RocalContext handle, RocalImage input) { rocalCrop(handle, input, true); });
+    });
+    suite.add("meta_node/crop_resize", [](Benchmark &state)
+    {
+        meta_node_benchmark(state, [](RocalContext handle, RocalImage input) { rocalCropResize(handle, input, 300, 300, true); });
+    });
+    suite.add("meta_node/crop_mirror_normalize", [](Benchmark &state)
+    {
+        meta_node_benchmark(state, [](RocalContext handle, RocalImage input)
+        {
+            std::vector<float> mean = {0, 0, 0}, std_dev = {1, 1, 1};
+            rocalCropMirrorNormalize(handle, input, 1, 224, 224, 0, 0, 0, mean, std_dev, true);
+        });
+    });
+    suite.add("meta_node/resize_crop_mirror", [](Benchmark &state)
+    {
+        meta_node_benchmark(state, [](RocalContext handle, RocalImage input) { rocalResizeCropMirror(handle, input, 300, 300, true); });
+    });
+    suite.add("meta_node/rotate", [](Benchmark &state)
+    {
+        meta_node_benchmark(state, [](RocalContext handle, RocalImage input) { rocalRotate(handle, input, true); });
+    });
+    suite.add("meta_node/ssd_random_crop", [](Benchmark &state)
+    {
+        meta_node_benchmark(state, [](RocalContext handle, RocalImage input) { rocalSSDRandomCrop(handle, input, true); });
+    });
+}
@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <memory>
+#include <vector>
+#include "benchmark.h"
+#include "reader_factory.h"
+
+/* Every iteration reads a batch of items the way the ImageReadAndDecode does: open(), read_data() into a preallocated buffer, close().
+ * The reader is reset outside of the timed region when it runs out of items. */
+static void read_batch_benchmark(Benchmark &state, ReaderConfig config)
+{
+    const size_t batch_size = state.options().batch_size;
+    config.set_batch_count(batch_size);
+    config.set_cpu_num_threads(state.options().cpu_threads);
+    auto reader = create_reader(config);
+    if(reader->count_items() == 0)
+    {
+        state.skip("the reader found no items at " + config.path());
+        return;
+    }
+    std::vector<unsigned char> buffer(1 << 20);
+    state.run([&]()
+              {
+                  if(reader->count_items() < batch_size)
+                      reader->reset();
+              },
+              [&]()
+              {
+                  for(size_t i = 0; i < batch_size && reader->count_items() > 0; i++)
+                  {
+                      size_t size = reader->open();
+                      if(size == 0)
+                          continue;
+                      if(size > buffer.size())
+                          buffer.resize(size);
+                      size_t read = reader->read_data(buffer.data(), size);
+                      reader->close();
+                      benchmark_do_not_optimize(buffer.data());
+                      state.add_items(1);
+                      state.add_bytes(read);
+                  }
+              });
+}
+
+static void path_reader_benchmark(Benchmark &state, StorageType type, const std::string &path, const std::string &option_name)
+{
+    if(path.empty())
+    {
+        state.skip("no data set, set it with " + option_name);
+        return;
+    }
+    ReaderConfig config(type, path);
+    if(type == StorageType::TF_RECORD)
+        config = ReaderConfig(type, path, "", {{"image/encoded", "image/encoded"}, {"image/filename", "image/filename"}});
+    if(type == StorageType::UNCOMPRESSED_BINARY_DATA)
+        config.set_file_prefix("data_batch");
+    read_batch_benchmark(state, config);
+}
+
+static void synthetic_reader_benchmark(Benchmark &state, bool jpeg_encoded)
+{
+    SyntheticDataConfig synthetic_config;
+    synthetic_config.jpeg_encoded = jpeg_encoded;
+    ReaderConfig config(StorageType::SYNTHETIC);
+    config.set_synthetic_data_config(synthetic_config);
+    read_batch_benchmark(state, config);
+}
+
+void register_reader_benchmarks(BenchmarkSuite &suite)
+{
+    suite.add("reader/synthetic", [](Benchmark &state) { synthetic_reader_benchmark(state, false); });
+    suite.add("reader/synthetic_jpeg", [](Benchmark &state) { synthetic_reader_benchmark(state, true); });
+    suite.add("reader/file", [](Benchmark &state)
+    {
+        path_reader_benchmark(state, StorageType::FILE_SYSTEM, state.options().file_root, "--file-root");
+    });
+    suite.add("reader/tfrecord", [](Benchmark &state)
+    {
+        path_reader_benchmark(state, StorageType::TF_RECORD, state.options().tfrecord_path, "--tfrecord");
+    });
+    suite.add("reader/caffe_lmdb", [](Benchmark &state)
+    {
+        path_reader_benchmark(state, StorageType::CAFFE_LMDB_RECORD, state.options().caffe_lmdb_path, "--caffe-lmdb");
+    });
+    suite.add("reader/caffe2_lmdb", [](Benchmark &state)
+    {
+        path_reader_benchmark(state, StorageType::CAFFE2_LMDB_RECORD, state.options().caffe2_lmdb_path, "--caffe2-lmdb");
+    });
+    suite.add("reader/mxnet_recordio", [](Benchmark &state)
+    {
+        path_reader_benchmark(state, StorageType::MXNET_RECORDIO, state.options().recordio_path, "--recordio");
+    });
+    suite.add("reader/cifar10", [](Benchmark &state)
+    {
+        path_reader_benchmark(state, StorageType::UNCOMPRESSED_BINARY_DATA, state.options().cifar10_path, "--cifar10");
+    });
+}
@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include "benchmark.h"
+
+static void usage()
+{
+    std::cout << "Usage: rocAL_benchmarks [options]\n"
+              << "  --list                 lists the benchmarks and exits\n"
+              << "  --filter <string>      runs only the benchmarks with a name containing <string>\n"
+              << "  --json <file>          writes the results to <file> in JSON format\n"
+              << "  --iterations <n>       timed calls per benchmark (default 50)\n"
+              << "  --warmup <n>           untimed calls made before the timed ones (default 5)\n"
+              << "  --batch-size <n>       batch size of the readers, meta data and pipelines (default 8)\n"
+              << "  --cpu-threads <n>      threads used by the pipelines (default 1)\n"
+              << "  --file-root <dir>      jpeg folder for the file reader (default: the AMD-tinyDataSet)\n"
+              << "  --tfrecord <dir>       TFRecord folder for the tfrecord reader\n"
+              << "  --caffe-lmdb <dir>     Caffe LMDB folder for the caffe reader\n"
+              << "  --caffe2-lmdb <dir>    Caffe2 LMDB folder for the caffe2 reader\n"
+              << "  --recordio <dir>       MXNet RecordIO folder for the recordio reader\n"
+              << "  --cifar10 <dir>        CIFAR-10 binary folder for the cifar10 reader\n"
+              << "The readers without a data set are reported as skipped." << std::endl;
+}
+
+int main(int argc, const char **argv)
+{
+    BenchmarkOptions options;
+#ifdef ROCAL_BENCHMARK_DATA_DIR
+    struct stat info;
+    if(stat(ROCAL_BENCHMARK_DATA_DIR, &info) == 0 && S_ISDIR(info.st_mode))
+        options.file_root = ROCAL_BENCHMARK_DATA_DIR;
+#endif
+    bool list = false;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string
+        {
+            if(i + 1 >= argc)
+            {
+                std::cerr << arg << " needs a value" << std::endl;
+                exit(-1);
+            }
+            return argv[++i];
+        };
+        if(arg == "--list") list = true;
+        else if(arg == "--filter") options.filter = value();
+        else if(arg == "--json") options.json_path = value();
+        else if(arg == "--iterations") options.iterations = std::stoul(value());
+        else if(arg == "--warmup") options.warmup = std::stoul(value());
+        else if(arg == "--batch-size") options.batch_size = std::stoul(value());
+        else if(arg == "--cpu-threads") options.cpu_threads = std::stoul(value());
+        else if(arg == "--file-root") options.file_root = value();
+        else if(arg == "--tfrecord") options.tfrecord_path = value();
+        else if(arg == "--caffe-lmdb") options.caffe_lmdb_path = value();
+        else if(arg == "--caffe2-lmdb") options.caffe2_lmdb_path = value();
+        else if(arg == "--recordio") options.recordio_path = value();
+        else if(arg == "--cifar10") options.cifar10_path = value();
+        else
+        {
+            usage();
+            return (arg == "--help" || arg == "-h") ? 0 : -1;
+        }
+    }
+    if(options.iterations == 0 || options.batch_size == 0 || options.cpu_threads == 0)
+    {
+        std::cerr << "iterations, batch size and cpu threads need to be bigger than 0" << std::endl;
+        return -1;
+    }
+
+    BenchmarkSuite suite;
+    register_reader_benchmarks(suite);
+    register_decoder_benchmarks(suite);
+    register_meta_data_benchmarks(suite);
+    register_pipeline_benchmarks(suite);
+    if(list)
+    {
+        suite.list();
+        return 0;
+    }
+    return suite.run(options) ? 1 : 0;
+}
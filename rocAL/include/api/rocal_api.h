@@ -58,6 +58,63 @@ extern "C" RocalContext ROCAL_API_CALL rocalCreate(size_t batch_size,
                                                    size_t prefetch_queue_depth = 3,
                                                    RocalTensorOutputType output_tensor_data_type = RocalTensorOutputType::ROCAL_FP32);
 
+/*!
+ * \brief  rocalSetShardScheduling defines how the batches loaded by the internal shards of the image loaders are handed out. Should be called before the loader is created
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [in] scheduling RocalShardScheduling: round robin (default) or the next batch ready in any of the shards
+ * \param [in] share_decode_threads if true a shard can borrow the decode threads of the shards that are idle
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSetShardScheduling(RocalContext context, RocalShardScheduling scheduling, bool share_decode_threads = false);
+
+/*!
+ * \brief  rocalSetNumaPlacement pins the loader threads, their decode threads and buffers to NUMA nodes, and the output thread and the output buffers to the node of the training process. Should be called before the loader is created
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [in] enable if false the threads and buffers are placed by the OS (default)
+ * \param [in] output_numa_node the node of the output thread and buffers, -1 for the node of the calling thread
+ * \param [in] shard_numa_nodes the node of each internal loader shard (shard i uses shard_numa_nodes[i % shard_numa_node_count]), nullptr to spread the shards over all the nodes detected from sysfs
+ * \param [in] shard_numa_node_count
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSetNumaPlacement(RocalContext context, bool enable, int output_numa_node = -1, const int *shard_numa_nodes = nullptr, unsigned shard_numa_node_count = 0);
+
+/*!
+ * \brief  rocalSetAutotune has the pipeline tune its decode threads, graph CPU threads and prefetch depth while it runs its first batches, for the most batches per second. Should be called before the loader is created
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [in] enable if false the thread counts and prefetch depth given to rocalCreate are used as they are (default)
+ * \param [in] tuning_batch_count the number of batches the pipeline is tuned on, the best configuration measured is then kept
+ * \param [in] memory_budget bytes the prefetch buffers of the loader may take, shared by all its internal shards. They are allocated up front for the deepest prefetch that fits. 0 for up to 8 batches
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSetAutotune(RocalContext context, bool enable, unsigned tuning_batch_count = 200, size_t memory_budget = 0);
+
+/*!
+ * \brief  rocalGetAutotuneResult returns the configuration picked by the autotuner, the best one measured so far while it is still tuning
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [out] result
+ * \return A \ref RocalStatus - A status code indicating the success or failure, fails if autotuning is not enabled or the pipeline is not built yet
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetAutotuneResult(RocalContext context, RocalAutotuneResult *result);
+
+/*!
+ * \brief  rocalSetOutputSize changes the size of the output images without rebuilding the pipeline. Takes effect at rocalVerify when called before it, otherwise at the next rocalResetLoaders (epoch boundary)
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [in] width up to the width the output images were created with
+ * \param [in] height up to the height the output images were created with
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSetOutputSize(RocalContext context, unsigned width, unsigned height);
+
 /*!
  * \brief  rocalVerify function to verify the graph for all the inputs and outputs
  * \ingroup group_rocal
@@ -76,6 +133,70 @@ extern "C" RocalStatus ROCAL_API_CALL rocalVerify(RocalContext context);
  */
 extern "C" RocalStatus ROCAL_API_CALL rocalRun(RocalContext context);
 
+/*!
+ * \brief  rocalTryRun function behaves as rocalRun when the next output batch is ready, otherwise returns right away without blocking.
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [out] ran Set to true if the call ran like rocalRun, false if the next batch is not ready yet
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalTryRun(RocalContext context, bool *ran);
+
+/*!
+ * \brief  rocalServe runs the built and verified graph as a rocAL service: the output batches are published in shared memory, round robin to rank_count client pipelines of the node created with rocalServiceSource(). Returns once epoch_count epochs are served
+ * \ingroup group_rocal
+ *
+ * \param [in] context the pipeline of the service, with a single output
+ * \param [in] service_name name the clients attach with, unique on the node
+ * \param [in] rank_count the number of client pipelines, each gets the same number of batches per epoch (the last batches of an epoch that cannot be shared evenly are dropped)
+ * \param [in] epoch_count the number of epochs to serve, 0 to serve till the process is stopped
+ * \param [in] ring_depth the number of batches each client can have in flight
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalServe(RocalContext context, const char *service_name, unsigned rank_count, unsigned epoch_count = 0, unsigned ring_depth = 3);
+
+/*!
+ * \brief  rocalSetStateTracking has the pipeline keep its state after every batch, for rocalSaveState. Should be called before rocalVerify, rocalLoadState enables it too
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [in] enable if false (default) the state is not kept and rocalSaveState fails
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSetStateTracking(RocalContext context, bool enable);
+
+/*!
+ * \brief  rocalSaveState saves where the pipeline is in its data and random streams (epoch, samples handed out, random parameter streams, seed), after the last batch returned by rocalRun, to resume the run later with rocalLoadState
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [out] buffer receives the state, can be nullptr to only get its size
+ * \param [in,out] size the size of buffer, set to the size of the state
+ * \return A \ref RocalStatus - A status code indicating the success or failure, fails if the buffer is too small, state tracking is not enabled or the loader of the pipeline cannot be resumed
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSaveState(RocalContext context, void *buffer, size_t *size);
+
+/*!
+ * \brief  rocalLoadState resumes the pipeline from a state saved by rocalSaveState: the readers start right after the last sample handed out, without reading the samples before, and the random streams continue where they were. Should be called before the loader is created, the pipeline has to be created the same way as the one saved
+ * \ingroup group_rocal
+ *
+ * \param [in] context
+ * \param [in] buffer the state
+ * \param [in] size the size of the state
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalLoadState(RocalContext context, const void *buffer, size_t size);
+
+/*!
+ * \brief  rocalGetOutputReadyFd returns a file descriptor that polls readable when the next output batch may be ready, to wait on it from an event loop.
+ * \ingroup group_rocal
+ * The descriptor is owned by the context, it can wake up spuriously so rocalTryRun should be used after a wake up.
+ * \param [in] context
+ * \return The file descriptor, or -1 if not supported on this platform or on failure
+ */
+extern "C" int ROCAL_API_CALL rocalGetOutputReadyFd(RocalContext context);
+
 /*!
  * \brief  rocalRelease function to free all the resources allocated during the graph creation process.
  * \ingroup group_rocal
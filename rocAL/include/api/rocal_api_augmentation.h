@@ -36,6 +36,8 @@ THE SOFTWARE.
  * \brief Rearranges the order of the frames in the sequences with respect to new_order.
  * new_order can have values in the range [0, sequence_length).
  * Frames can be repeated or dropped in the new_order.
+ * When input comes straight from a video loader or sequence reader and nothing else reads it yet, the loader reads only the frames of new_order:
+ * input is then consumed and cannot be passed to another augmentation or set as an output afterwards.
  * \ingroup group_rocal_augmentations
  * \note: Accepts U8 and RGB24 input.
  * \param context context for the pipeline.
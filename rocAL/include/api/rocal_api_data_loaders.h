@@ -768,6 +768,23 @@ extern "C" RocalImage ROCAL_API_CALL rocalRawCIFAR10Source(RocalContext context,
                                                            unsigned out_width, unsigned out_height, const char *filename_prefix = "",
                                                            bool loop = false);
 
+/*!
+ * \brief Creates the loader of a client of a rocAL service. The batches come decoded and augmented from the service
+ * started with rocalServe() on the same node, this pipeline gets the batches the service publishes for the given rank.
+ * \ingroup group_rocal_data_loaders
+ * \param context Rocal context, its batch size has to match the one of the service and it has to run on the CPU
+ * \param service_name Name the service was started with
+ * \param rank The rank of this client, in [0, rank_count) of the service
+ * \param is_output Determines if the user wants the loaded images to be part of the output or not.
+ * \param timeout_ms How long to wait for the service to come up
+ * \return Reference to the output image, its size and color format are the ones of the output of the service
+ */
+extern "C" RocalImage ROCAL_API_CALL rocalServiceSource(RocalContext context,
+                                                        const char *service_name,
+                                                        unsigned rank,
+                                                        bool is_output,
+                                                        unsigned timeout_ms = 60000);
+
 /*!
  * \brief
  * \ingroup group_rocal_data_loaders
@@ -839,4 +856,104 @@ extern "C" RocalImage ROCAL_API_CALL rocalJpegCaffe2LMDBRecordSourcePartialSingl
                                                                                        RocalImageSizeEvaluationPolicy decode_size_policy = ROCAL_USE_MOST_FREQUENT_SIZE,
                                                                                        unsigned max_width = 0, unsigned max_height = 0);
 
+/*!
+ * \brief Creates a synthetic image source: deterministic images generated in memory instead of being read from the storage, to measure the cost of the rest of the pipeline and to run it where no dataset is available.
+ * The widths and heights of the images are uniformly distributed in the given ranges, images are either generated straight into the decoder's output or encoded as JPEGs once and decoded with TurboJpeg.
+ * The labels or boxes are available through the usual meta data calls, no meta data reader should be created for this source.
+ * \ingroup group_rocal_data_loaders
+ * \param context Rocal context
+ * \param rocal_color_format The color format the images will be decoded to.
+ * \param internal_shard_count Defines the parallelism level by internally sharding the samples and load/decode using multiple decoder/loader instances.
+ * \param is_output Determines if the user wants the loaded images to be part of the output or not.
+ * \param num_samples Number of samples of an epoch
+ * \param min_width Smallest width of the images
+ * \param max_width Largest width of the images, as well as the width of the output
+ * \param min_height Smallest height of the images
+ * \param max_height Largest height of the images, as well as the height of the output
+ * \param meta_data Meta data generated along with the images
+ * \param num_classes Number of classes of the labels
+ * \param max_boxes Maximum number of boxes per image, for ROCAL_SYNTHETIC_BOXES
+ * \param jpeg_encoded Determines if the images go through JPEG decoding or not
+ * \param seed Seed of everything generated, the same seed gives the same samples
+ * \param shuffle Determines if the user wants to shuffle the samples or not.
+ * \param loop Determines if the user wants to indefinitely loops through images or not.
+ * \return Reference to the output image
+ */
+extern "C" RocalImage ROCAL_API_CALL rocalSyntheticSource(RocalContext context,
+                                                          RocalImageColor rocal_color_format,
+                                                          unsigned internal_shard_count,
+                                                          bool is_output,
+                                                          unsigned num_samples,
+                                                          unsigned min_width, unsigned max_width,
+                                                          unsigned min_height, unsigned max_height,
+                                                          RocalSyntheticMetaData meta_data = ROCAL_SYNTHETIC_LABELS,
+                                                          unsigned num_classes = 1000,
+                                                          unsigned max_boxes = 8,
+                                                          bool jpeg_encoded = false,
+                                                          unsigned seed = 0,
+                                                          bool shuffle = false,
+                                                          bool loop = false);
+
+/*!
+ * \brief Creates a loader of pre-decoded uint8 samples stored as NumPy (.npy) arrays or headerless raw tensor files. The files are memory mapped and their headers parsed once,
+ * the samples are copied straight from the mapping into the output without going through a decoder.
+ * source_path is either a single file holding all the samples along its first axis ((N, H, W) or (N, H, W, C) arrays), or a folder of files holding a sample each ((H, W) or (H, W, C) arrays).
+ * The files without the .npy extension are raw tensor files holding consecutive raw_height x raw_width samples, with as many channels as the color format.
+ * Samples smaller than the output keep their own size as ROI.
+ * \ingroup group_rocal_data_loaders
+ * \param context Rocal context
+ * \param source_path A NULL terminated char string pointing to the .npy/raw file or the folder of files
+ * \param rocal_color_format The color format of the samples, RGB24/BGR24 for 3 channel and U8 for single channel samples
+ * \param internal_shard_count Defines the parallelism level by internally sharding the samples and load/decode using multiple decoder/loader instances.
+ * \param is_output Determines if the user wants the loaded images to be part of the output or not.
+ * \param max_width The width of the output, no sample can be wider
+ * \param max_height The height of the output, no sample can be higher
+ * \param shuffle Determines if the user wants to shuffle the samples or not.
+ * \param loop Determines if the user wants to indefinitely loops through images or not.
+ * \param raw_width Width of the samples of the raw tensor files, not needed for .npy files
+ * \param raw_height Height of the samples of the raw tensor files, not needed for .npy files
+ * \return Reference to the output image
+ */
+extern "C" RocalImage ROCAL_API_CALL rocalNumpyFileSource(RocalContext context,
+                                                          const char *source_path,
+                                                          RocalImageColor rocal_color_format,
+                                                          unsigned internal_shard_count,
+                                                          bool is_output,
+                                                          unsigned max_width, unsigned max_height,
+                                                          bool shuffle = false,
+                                                          bool loop = false,
+                                                          unsigned raw_width = 0, unsigned raw_height = 0);
+
+/*!
+ * \brief Creates a reader and decoder of images stored in WebDataset style tar shards. The tar files are read sequentially in large chunks instead of opening a file per image.
+ * The members of a tar file sharing the same key (path up to the first dot of the file name) form a sample, its .jpg/.jpeg/.png member is the image and its .cls or .json member
+ * holds the label or the boxes read with rocalCreateTarShardLabelReader() or rocalCreateTarShardReaderDetection(). The id of a sample is its key.
+ * The tar files are dealt to the internal shards, there need to be at least internal_shard_count of them.
+ * \ingroup group_rocal_data_loaders
+ * \param context Rocal context
+ * \param source_path A NULL terminated char string pointing to a folder of .tar files or to a single .tar file
+ * \param rocal_color_format The color format the images will be decoded to.
+ * \param internal_shard_count Defines the parallelism level by internally sharding the tar files and load/decode using multiple decoder/loader instances.
+ * \param is_output Determines if the user wants the loaded images to be part of the output or not.
+ * \param shuffle Determines if the user wants to shuffle the dataset or not. The order of the tar files is shuffled every epoch and the samples go through a shuffle buffer.
+ * \param loop Determines if the user wants to indefinitely loops through images or not.
+ * \param decode_size_policy
+ * \param max_width The maximum width of the decoded images, larger or smaller will be resized to closest
+ * \param max_height The maximum height of the decoded images, larger or smaller will be resized to closest
+ * \param rocal_decoder_type Determines the decoder_type, tjpeg or opencv
+ * \param shuffle_buffer_size Number of samples each internal shard keeps in memory to shuffle them, only used when shuffle is set
+ * \return Reference to the output image
+ */
+extern "C" RocalImage ROCAL_API_CALL rocalTarShardSource(RocalContext context,
+                                                         const char *source_path,
+                                                         RocalImageColor rocal_color_format,
+                                                         unsigned internal_shard_count,
+                                                         bool is_output,
+                                                         bool shuffle = false,
+                                                         bool loop = false,
+                                                         RocalImageSizeEvaluationPolicy decode_size_policy = ROCAL_USE_MOST_FREQUENT_SIZE,
+                                                         unsigned max_width = 0, unsigned max_height = 0,
+                                                         RocalDecoderType rocal_decoder_type = RocalDecoderType::ROCAL_DECODER_TJPEG,
+                                                         unsigned shuffle_buffer_size = 512);
+
 #endif // MIVISIONX_ROCAL_API_DATA_LOADERS_H
@@ -88,4 +88,98 @@ extern "C" RocalStatus ROCAL_API_CALL rocalToTensor(RocalContext rocal_context,
  */
 extern "C" void ROCAL_API_CALL rocalSetOutputs(RocalContext p_context, unsigned int num_of_outputs, std::vector<RocalImage> &output_images);
 
+/*!
+ * \brief  Keeps the output batch returned by the last rocalRun() call in the pipeline's output queue so that it can be used in place, without a copy
+ * \ingroup group_rocal_data_transfer
+ * The batch stays valid through the following rocalRun() calls till rocalReleaseOutputBatch() is called, the pipeline reuses its memory only after that.
+ * Every acquired batch takes one slot of the prefetch queue, rocalRun() fails if all of them are held. Leases stay valid across rocalResetLoaders(), the held batches are kept till released.
+ * \param [in] context Rocal context
+ * \param [out] lease Identifies the acquired batch in the other rocalGetOutputBatch* calls
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalAcquireOutputBatch(RocalContext context, unsigned long long *lease);
+
+/*!
+ * \brief  Hands an output batch acquired by rocalAcquireOutputBatch() back to the pipeline, the pointers obtained for it must not be used after this call
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context Rocal context
+ * A lease released already is ignored, the other rocalGetOutputBatch* calls fail with it even once its memory holds another batch.
+ * \param [in] lease The lease returned by rocalAcquireOutputBatch()
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalReleaseOutputBatch(RocalContext context, unsigned long long lease);
+
+/*!
+ * \brief  Gives the memory of the images of an acquired output batch, one buffer per output image set by rocalSetOutputs() or marked as output
+ * \ingroup group_rocal_data_transfer
+ * Each buffer holds the U8 NHWC batch of rocalGetOutputHeight() rows of rocalGetOutputWidth() pixels, on the device when the pipeline runs on the GPU.
+ * \param [in] context Rocal context
+ * \param [in] lease The lease returned by rocalAcquireOutputBatch()
+ * \param [out] image_buffers User's array of buffer_count pointers filled with the address of each output image
+ * \param [in] buffer_count Size of the image_buffers array
+ * \param [out] mem_type Set to ROCAL_MEMCPY_GPU if the buffers are device memory, ROCAL_MEMCPY_HOST otherwise
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetOutputBatchImages(RocalContext context, unsigned long long lease, void **image_buffers, unsigned buffer_count, RocalOutputMemType *mem_type);
+
+/*!
+ * \brief  Gives the host memory of the labels of an acquired output batch, one int per image of the batch
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context Rocal context
+ * \param [in] lease The lease returned by rocalAcquireOutputBatch()
+ * \param [out] labels Set to the address of the labels, or nullptr if the pipeline does not output labels
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetOutputBatchLabels(RocalContext context, unsigned long long lease, int **labels);
+
+/*!
+ * \brief  Gives the host memory of the bounding boxes of an acquired output batch, per image of the batch
+ * \ingroup group_rocal_data_transfer
+ * The boxes of an image are stored as box_counts[i] groups of 4 floats (l, t, r, b) and their labels as box_counts[i] ints.
+ * \param [in] context Rocal context
+ * \param [in] lease The lease returned by rocalAcquireOutputBatch()
+ * \param [out] boxes User's array of batch size pointers filled with the address of the boxes of each image
+ * \param [out] box_labels User's array of batch size pointers filled with the address of the box labels of each image
+ * \param [out] box_counts User's array of batch size ints filled with the number of boxes of each image
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetOutputBatchBoundingBoxes(RocalContext context, unsigned long long lease, float **boxes, int **box_labels, int *box_counts);
+
+/*!
+ * \brief  Gives the device memory of the boxes and labels encoded by the box encoder for an acquired output batch
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context Rocal context
+ * \param [in] lease The lease returned by rocalAcquireOutputBatch()
+ * \param [out] boxes Set to the address of the encoded boxes, batch size * number of anchors * 4 floats, nullptr if not available
+ * \param [out] labels Set to the address of the encoded labels, batch size * number of anchors ints, nullptr if not available
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetOutputBatchEncodedBoxes(RocalContext context, unsigned long long lease, float **boxes, int **labels);
+
+/*!
+ * \brief  Gives the host memory of the key point heatmaps and target weights generated for an acquired output batch, see rocalKeyPointHeatmaps()
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context Rocal context
+ * \param [in] lease The lease returned by rocalAcquireOutputBatch()
+ * \param [out] heatmaps Set to the address of the heatmaps, nullptr if not generated
+ * \param [out] target_weights Set to the address of the target weights, nullptr if not generated
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetOutputBatchHeatmaps(RocalContext context, unsigned long long lease, float **heatmaps, float **target_weights);
+
+/*!
+ * \brief  Gives the host memory of the soft labels generated for an acquired output batch, see rocalBatchMix()
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context Rocal context
+ * \param [in] lease The lease returned by rocalAcquireOutputBatch()
+ * \param [out] soft_labels Set to the address of the soft labels, nullptr if not generated
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetOutputBatchSoftLabels(RocalContext context, unsigned long long lease, float **soft_labels);
+
 #endif // MIVISIONX_ROCAL_API_DATA_TRANSFER_H
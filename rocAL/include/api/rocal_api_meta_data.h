@@ -152,6 +152,25 @@ extern "C" RocalMetaData ROCAL_API_CALL rocalCreateCaffe2LMDBReaderDetection(Roc
  */
 extern "C" RocalMetaData ROCAL_API_CALL rocalCreateMXNetReader(RocalContext rocal_context, const char *source_path, bool is_output);
 
+/*!
+ * \brief  rocalCreateTarShardLabelReader
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param source_path path to the tar shards read with rocalTarShardSource, the labels are the .cls members of the samples
+ * \return RocalMetaData object, can be used to inquire about the rocal's output (processed) tensors
+ */
+extern "C" RocalMetaData ROCAL_API_CALL rocalCreateTarShardLabelReader(RocalContext rocal_context, const char *source_path);
+
+/*!
+ * \brief  rocalCreateTarShardReaderDetection
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param source_path path to the tar shards read with rocalTarShardSource, the boxes are the .json members of the samples:
+ * {"width": W, "height": H, "boxes": [[x, y, w, h], ...], "labels": [l, ...]} with the boxes in pixels
+ * \return RocalMetaData object, can be used to inquire about the rocal's output (processed) tensors
+ */
+extern "C" RocalMetaData ROCAL_API_CALL rocalCreateTarShardReaderDetection(RocalContext rocal_context, const char *source_path, bool is_output);
+
 /*!
  * \brief  rocalGetImageName
  * \ingroup group_rocal_meta_data
@@ -281,6 +300,47 @@ extern "C" void ROCAL_API_CALL rocalCopyEncodedBoxesAndLables(RocalContext p_con
  */
 extern "C" void ROCAL_API_CALL rocalGetEncodedBoxesAndLables(RocalContext p_context, float **boxes_buf_ptr, int **labels_buf_ptr, int num_encoded_boxes);
 
+/*!
+ * \brief  rocalKeyPointHeatmaps
+ * \ingroup group_rocal_meta_data
+ * Generates the gaussian heatmaps and target weights of the joints of each output sample, as HRNet style trainers use them.
+ * The joints are moved to the pose output image with the person box center/scale/rotation, then a gaussian of the reader's sigma is drawn around each of them.
+ * Needs to be called after rocalCreateCOCOReaderKeyPoints() and before rocalVerify().
+ * \param heatmap_width  width of the heatmaps, usually the pose output width / 4
+ * \param heatmap_height height of the heatmaps, usually the pose output height / 4
+ */
+extern "C" void ROCAL_API_CALL rocalKeyPointHeatmaps(RocalContext p_context, unsigned heatmap_width, unsigned heatmap_height);
+
+/*!
+ * \brief  rocalGetKeyPointHeatmaps
+ * \ingroup group_rocal_meta_data
+ * \param heatmaps_buf_ptr  set to the host buffer holding the heatmaps of the output batch, batch size x 17 x heatmap height x heatmap width floats
+ * \param target_weights_buf_ptr  set to the host buffer holding the target weights of the output batch, batch size x 17 floats
+ */
+extern "C" void ROCAL_API_CALL rocalGetKeyPointHeatmaps(RocalContext p_context, float **heatmaps_buf_ptr, float **target_weights_buf_ptr);
+
+/*!
+ * \brief  rocalBatchMix
+ * \ingroup group_rocal_meta_data
+ * Mixes the samples of each output batch in pairs (sample i with sample batch size - 1 - i) and generates their soft labels, in the pipeline's
+ * processing thread, so that MixUp / CutMix and one-hot encoding don't need another pass over the batch in the training framework.
+ * The soft labels use the class layout of rocalGetOneHotImageLabels(), the labels returned by rocalGetImageLabels() stay the original ones.
+ * Needs to be called after the label reader is created and before rocalVerify(). MixUp and CutMix need the augmentations to run on the CPU.
+ * \param mode ROCAL_BATCH_MIX_NONE only generates the soft labels
+ * \param num_classes number of classes of the soft labels
+ * \param alpha the mixing ratio of a pair is drawn from Beta(alpha, alpha)
+ * \param probability probability of a pair to be mixed
+ * \param label_smoothing the one-hot labels are (1 - label_smoothing) x one-hot + label_smoothing / num_classes, 0 for none
+ */
+extern "C" void ROCAL_API_CALL rocalBatchMix(RocalContext p_context, RocalBatchMixMode mode, unsigned num_classes, float alpha, float probability, float label_smoothing);
+
+/*!
+ * \brief  rocalGetSoftLabels
+ * \ingroup group_rocal_meta_data
+ * \param soft_labels_buf_ptr  set to the host buffer holding the soft labels of the output batch, batch size x num_classes floats
+ */
+extern "C" void ROCAL_API_CALL rocalGetSoftLabels(RocalContext p_context, float **soft_labels_buf_ptr);
+
 /*!
  * \brief  rocalGetImageId
  * \ingroup group_rocal_meta_data
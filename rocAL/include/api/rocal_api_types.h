@@ -90,6 +90,18 @@ struct TimingInfo
     long long unsigned transfer_time;
 };
 
+/*! \brief Autotune Result struct, the configuration picked by the autotuner
+ * \ingroup group_rocal_types
+ */
+struct RocalAutotuneResult
+{
+    unsigned decode_threads;//!< decode threads of each loader shard
+    unsigned graph_threads;//!< CPU threads the augmentation graph runs with
+    unsigned prefetch_depth;//!< batches each loader shard loads ahead
+    float batches_per_second;//!< throughput measured with this configuration
+    bool done;//!< false while the pipeline is still being tuned
+};
+
 /*! \brief rocAL Joints Data struct - HRNet training expects meta data (joints_data) in below format, so added here as a type for exposing to user
  * \ingroup group_rocal_types
  */
@@ -288,6 +300,51 @@ enum RocalOutputMemType
  */
 #define ROCAL_MEMCPY_IS_PINNED 4
 
+/*! \brief rocAL Shard Scheduling enum
+ * \ingroup group_rocal_types
+ */
+enum RocalShardScheduling
+{
+    /*! \brief the batches are taken from the internal shards in turn, deterministic order
+     */
+    ROCAL_SHARD_ROUND_ROBIN = 0,
+    /*! \brief the next batch is taken from whichever internal shard has one ready, the order of the batches of each shard is kept
+     */
+    ROCAL_SHARD_ANY_READY = 1
+};
+
+/*! \brief rocAL Synthetic Meta Data enum
+ * \ingroup group_rocal_types
+ */
+enum RocalSyntheticMetaData
+{
+    /*! \brief the synthetic source only generates images
+     */
+    ROCAL_SYNTHETIC_NO_META_DATA = 0,
+    /*! \brief one label per image
+     */
+    ROCAL_SYNTHETIC_LABELS = 1,
+    /*! \brief bounding boxes and their labels, the boxes are drawn into the images
+     */
+    ROCAL_SYNTHETIC_BOXES = 2
+};
+
+/*! \brief rocAL Batch Mix Mode enum
+ * \ingroup group_rocal_types
+ */
+enum RocalBatchMixMode
+{
+    /*! \brief the samples are not mixed, only their (smoothed) one-hot labels are generated
+     */
+    ROCAL_BATCH_MIX_NONE = 0,
+    /*! \brief MixUp: the two samples of a pair are alpha-blended
+     */
+    ROCAL_BATCH_MIX_MIXUP = 1,
+    /*! \brief CutMix: a box is swapped between the two samples of a pair
+     */
+    ROCAL_BATCH_MIX_CUTMIX = 2
+};
+
 /*! \brief rocAL Resize Scaling Mode enum
  * \ingroup group_rocal_types
  */
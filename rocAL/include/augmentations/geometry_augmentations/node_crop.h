@@ -37,6 +37,9 @@ public:
     unsigned int get_dst_width() { return _outputs[0]->info().width(); }
     unsigned int get_dst_height() { return _outputs[0]->info().height_single(); }
     std::shared_ptr<RocalCropParam> get_crop_param() { return _crop_param; }
+    //! Only fixed size crops can change size
+    bool output_size_adjustable() const override { return !_crop_param->is_random(); }
+    void set_output_size(unsigned width, unsigned height) override { _crop_param->crop_w = width; _crop_param->crop_h = height; }
 protected:
     void create_node() override ;
     void update_node() override;
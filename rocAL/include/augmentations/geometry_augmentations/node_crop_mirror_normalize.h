@@ -33,9 +33,12 @@ public:
     CropMirrorNormalizeNode() = delete;
     void init(int crop_h, int crop_w, float start_x, float start_y, float mean, float std_dev, IntParam *mirror);
     vx_array return_mirror(){ return _mirror.default_array();  }
+    const std::vector<int>& return_mirror_values() const { return _mirror.default_array_values(); }
     std::shared_ptr<RocalCropParam> return_crop_param() { return _crop_param; }
     vx_array get_src_width() { return _src_roi_width; }
     vx_array get_src_height() { return _src_roi_height; }
+    bool output_size_adjustable() const override { return !_crop_param->is_random(); }
+    void set_output_size(unsigned width, unsigned height) override { _crop_param->crop_w = width; _crop_param->crop_h = height; }
 protected:
     void create_node() override ;
     void update_node() override;
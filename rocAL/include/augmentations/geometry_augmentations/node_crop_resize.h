@@ -35,6 +35,8 @@ public:
     unsigned int get_dst_width() { return _outputs[0]->info().width(); }
     unsigned int get_dst_height() { return _outputs[0]->info().height_single(); }
     std::shared_ptr<RocalRandomCropParam> get_crop_param() { return _crop_param; }
+    bool output_size_adjustable() const override { return true; }
+    void set_output_size(unsigned width, unsigned height) override;
 protected:
     void create_node() override;
     void update_node() override;
@@ -44,6 +46,8 @@ private:
     size_t _dest_height;
     std::shared_ptr<RocalRandomCropParam> _crop_param;
     vx_array _dst_roi_width ,_dst_roi_height;
+    bool _dst_roi_changed = false;//!< set_output_size() was called since the last update
+    std::vector<uint32_t> _dst_roi_width_vec, _dst_roi_height_vec;
 };
 
 
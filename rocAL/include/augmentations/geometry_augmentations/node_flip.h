@@ -37,6 +37,7 @@ public:
     vx_array get_src_width() { return _src_roi_width; }
     vx_array get_src_height() { return _src_roi_height; }
     vx_array get_flip_axis() { return _flip_axis.default_array(); }
+    const std::vector<int>& get_flip_axis_values() const { return _flip_axis.default_array_values(); }
 protected:
     void create_node() override;
     void update_node() override;
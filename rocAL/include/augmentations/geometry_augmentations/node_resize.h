@@ -35,6 +35,8 @@ public:
     void init(unsigned dest_width, unsigned dest_height, RocalResizeScalingMode scaling_mode,
               const std::vector<unsigned>& max_size, RocalResizeInterpolationType interpolation_type);
     void adjust_out_roi_size();
+    bool output_size_adjustable() const override { return true; }
+    void set_output_size(unsigned width, unsigned height) override { _out_width = width; _out_height = height; }
 protected:
     void create_node() override;
     void update_node() override;
@@ -39,6 +39,7 @@ public:
     unsigned int get_dst_height() { return _outputs[0]->info().height_single(); }
     std::shared_ptr<RocalCropParam> get_crop_param() { return _crop_param; }
     vx_array get_mirror() { return _mirror.default_array(); }
+    const std::vector<int>& get_mirror_values() const { return _mirror.default_array_values(); }
 protected:
     void create_node() override;
     void update_node() override;
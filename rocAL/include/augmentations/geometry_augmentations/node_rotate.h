@@ -38,6 +38,7 @@ public:
     vx_array get_src_width() { return _src_roi_width; }
     vx_array get_src_height() { return _src_roi_height; }
     vx_array get_angle() { return _angle.default_array(); }
+    const std::vector<float>& get_angle_values() const { return _angle.default_array_values(); }
 
 protected:
     void create_node() override;
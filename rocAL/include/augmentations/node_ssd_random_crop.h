@@ -23,41 +23,7 @@ THE SOFTWARE.
 #include "node.h"
 #include "parameter_factory.h"
 #include "parameter_crop_factory.h"
-
-
-// todo:: move this to common header
-template<typename T = std::mt19937, std::size_t state_size = T::state_size>
-class SeededRNG {
-  /*
-  * @param batch_size How many RNGs to store
-  * @param state_size How many seed are used to initialize one RNG. Used to lower probablity of
-  * collisions between seeds used to initialize RNGs in different operators.
-  */
-public:
-  SeededRNG (int batch_size = 128) {
-      std::random_device source;
-      _batch_size = batch_size;
-      std::size_t _random_data_size = state_size * batch_size ;
-      std::vector<std::random_device::result_type> random_data(_random_data_size);
-      std::generate(random_data.begin(), random_data.end(), std::ref(source));
-      _rngs.reserve(batch_size);
-      for (int i=0; i < (int)(_batch_size*state_size); i += state_size) {
-        std::seed_seq seeds(std::begin(random_data) + i, std::begin(random_data)+ i +state_size);
-        _rngs.emplace_back(T(seeds));
-      }
-  }
-
-  /**
-   * Returns engine corresponding to given sample ID
-   */
-   T &operator[](int sample) noexcept {
-    return _rngs[sample % _batch_size];
-  }
-
-private:
-    std::vector<T> _rngs;
-    int _batch_size;
-};
+#include "bbox_crop_sampler.h"
 
 class SSDRandomCropNode : public Node
 {
@@ -69,9 +35,18 @@ public:
     unsigned int get_dst_height() { return _outputs[0]->info().height_single(); }
     std::shared_ptr<RocalRandomCropParam> get_crop_param() { return _crop_param; }
     float get_threshold(){return _threshold;}
-    std::vector<std::pair<float,float>> get_iou_range(){return _iou_range;}
+    const std::vector<std::pair<float,float>>& get_iou_range() const {return _iou_range;}
+    //! Crop windows picked for the images of the last batch
+    const std::vector<uint>& get_x1_values() const {return _x1_val;}
+    const std::vector<uint>& get_y1_values() const {return _y1_val;}
+    const std::vector<uint>& get_crop_width_values() const {return _crop_width_val;}
+    const std::vector<uint>& get_crop_height_values() const {return _crop_height_val;}
     bool is_entire_iou(){return _entire_iou;}
     void set_meta_data_batch() {}
+    //! Picks the crop windows of the node, the same for the same sample and epoch wherever they are picked
+    std::shared_ptr<BBoxCropSampler> get_bbox_crop_sampler() { return _sampler; }
+    //! Names and epoch of the next batch, with the windows the loader has picked for it (empty if it has not, they are then picked in update_node())
+    void set_batch_crop_windows(const std::vector<std::string> &names, size_t epoch, const std::vector<BBoxCropWindow> &windows);
 
 protected:
     void create_node() override;
@@ -90,6 +65,8 @@ private:
     int _num_of_attempts = 20;
     bool _entire_iou = false;
     std::shared_ptr<RocalRandomCropParam> _crop_param;
-    SeededRNG<std::mt19937, 4> _rngs;     // setting the state_size to 4 for 4 random parameters.
-
+    std::shared_ptr<BBoxCropSampler> _sampler;
+    std::vector<std::string> _names;
+    size_t _epoch = 0;
+    std::vector<BBoxCropWindow> _windows;
 };
\ No newline at end of file
@@ -36,6 +36,7 @@ enum class DecoderType
     HW_JPEG_DEC  = 3,
     SKIP_DECODE  = 4, //!< For skipping decoding in case of uncompressed data from reader
     OVX_FFMPEG,//!< Uses FFMPEG to decode video streams, can decode up to 4 video streams simultaneously
+    SYNTHETIC, //!< Generates the images described by the synthetic reader, no actual decoding
 };
 
 
@@ -0,0 +1,60 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <cstddef>
+
+enum class ImageFormat
+{
+    UNKNOWN = 0,
+    JPEG,
+    PNG,
+    WEBP,
+    BMP
+};
+
+//! Format of the encoded image, from its leading magic bytes
+ImageFormat sniff_image_format(const unsigned char* data, size_t size);
+
+//! Reads the dimensions and the number of color components from the header of the encoded image, without decoding it
+/*!
+ \return false if the header is not valid or is truncated
+*/
+bool probe_image_header(const unsigned char* data, size_t size, ImageFormat format, int* width, int* height, int* color_comps);
+
+//! Little endian BMP header fields needed by the decoders
+struct BmpInfo
+{
+    int width = 0;
+    int height = 0;//!< always positive, see top_down
+    bool top_down = false;
+    unsigned bits_per_pixel = 0;
+    unsigned compression = 0;
+    size_t data_offset = 0;
+    size_t row_stride = 0;//!< rows are padded to 4 bytes
+    size_t palette_offset = 0;
+    unsigned palette_entry_size = 4;
+    unsigned palette_size = 0;
+};
+
+//! Parses the BMP file and info headers, false if not a valid BMP
+bool parse_bmp_header(const unsigned char* data, size_t size, BmpInfo& info);
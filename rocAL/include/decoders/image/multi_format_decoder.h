@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "decoder.h"
+#include "image_format.h"
+#include "turbo_jpeg_decoder.h"
+#if ENABLE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/*! \brief Writes the rows of a 3 channel image into a decoder output slot, converting them to the slot's color format
+ *
+ * The rows are pushed top to bottom. If the output is smaller than the input, every output pixel is the average of the
+ * input pixels it covers, computed while the rows are pushed so that the full size image is never stored.
+ */
+class DecodedRowWriter
+{
+public:
+    void init(unsigned char* output, size_t output_stride, unsigned input_width, unsigned input_height,
+              unsigned output_width, unsigned output_height, Decoder::ColorFormat color_format, bool bgr_input);
+    void push(const unsigned char* row);
+    //! Output row the next input row goes to if it needs no conversion, nullptr otherwise: the decoders can write it there and push() it without a copy
+    unsigned char* direct_row() const;
+private:
+    void write_pixel(unsigned char* dst, unsigned r, unsigned g, unsigned b) const;
+    unsigned char* _output = nullptr;
+    size_t _output_stride = 0;
+    unsigned _input_width = 0, _input_height = 0, _output_width = 0, _output_height = 0;
+    Decoder::ColorFormat _color_format = Decoder::ColorFormat::RGB;
+    bool _bgr_input = false;
+    unsigned _input_row = 0, _output_row = 0;
+    std::vector<unsigned> _column_start;//!< first input column of every output column, _output_width + 1 entries
+    std::vector<uint64_t> _sums;//!< running sums of the current output row
+};
+
+/*! \brief Decoder dispatching every sample by its content
+ *
+ * JPEG goes to the TurboJpeg decoder, PNG (libpng), WebP (libwebp) and BMP are decoded natively right into the output slot
+ * at its stride and color order, and are downscaled keeping their aspect ratio when bigger than the maximum decoded size.
+ * Other formats are decoded with OpenCV when available.
+ */
+class MultiFormatDecoder : public Decoder {
+public:
+    MultiFormatDecoder();
+    Status decode_info(unsigned char* input_buffer, size_t input_size, int* width, int* height, int* color_comps) override;
+    Decoder::Status decode(unsigned char *input_buffer, size_t input_size, unsigned char *output_buffer,
+                           size_t max_decoded_width, size_t max_decoded_height,
+                           size_t original_image_width, size_t original_image_height,
+                           size_t &actual_decoded_width, size_t &actual_decoded_height,
+                           Decoder::ColorFormat desired_decoded_color_format, DecoderConfig config, bool keep_original_size=false) override;
+    ~MultiFormatDecoder() override = default;
+    void initialize(int device_id) override {};
+    bool is_partial_decoder() override { return false; }
+    void set_bbox_coords(std::vector <float> bbox_coord) override { _bbox_coord = bbox_coord; }
+    void set_crop_window(CropWindow &crop_window) override { _crop_window = crop_window; }
+    std::vector <float> get_bbox_coords() override { return _bbox_coord; }
+private:
+    Status decode_png(unsigned char* input_buffer, size_t input_size, unsigned width, unsigned height);
+    Status decode_webp(unsigned char* input_buffer, size_t input_size, unsigned width, unsigned height);
+    Status decode_bmp(unsigned char* input_buffer, size_t input_size);
+    Status decode_other(unsigned char* input_buffer, size_t input_size);
+    TJDecoder _jpeg_decoder;
+    DecodedRowWriter _writer;
+    unsigned char* _output = nullptr;
+    size_t _output_stride = 0;
+    unsigned _output_width = 0, _output_height = 0;
+    Decoder::ColorFormat _color_format = Decoder::ColorFormat::RGB;
+    std::vector<unsigned char> _row;//!< scratch row, and full image for the interlaced PNG
+    std::vector<unsigned char*> _row_pointers;
+#if ENABLE_OPENCV
+    //! Image decoded by decode_info() for the formats without a header probe, reused by the following decode()
+    cv::Mat _other_image;
+    const unsigned char* _other_image_source = nullptr;
+#endif
+    std::vector <float> _bbox_coord;
+    CropWindow _crop_window;
+};
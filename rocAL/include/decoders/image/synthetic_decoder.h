@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "decoder.h"
+#include "synthetic_data.h"
+
+//! Generates the images described by the SyntheticDataReader straight into the output buffer, to run the pipeline without decoding cost
+class SyntheticDecoder : public Decoder {
+public:
+    //! Reads the size of the image from the SyntheticImageDesc in input_buffer
+    Status decode_info(unsigned char* input_buffer, size_t input_size, int* width, int* height, int* color_comps) override;
+
+    //! Generates the image at the size the TurboJpeg decoder would have decoded it to
+    /*!
+      \param max_decoded_width The maximum width user wants the decoded image to be. Image will be downscaled if bigger.
+      \param max_decoded_height The maximum height user wants the decoded image to be. Image will be downscaled if bigger.
+      \param keep_original_size if true the image is generated at its own size with each side clamped to the maximum, a clamped image
+      keeps its whole content, squeezed to the clamped size instead of cut
+    */
+    Decoder::Status decode(unsigned char *input_buffer, size_t input_size, unsigned char *output_buffer,
+                           size_t max_decoded_width, size_t max_decoded_height,
+                           size_t original_image_width, size_t original_image_height,
+                           size_t &actual_decoded_width, size_t &actual_decoded_height,
+                           Decoder::ColorFormat desired_decoded_color_format, DecoderConfig config, bool keep_original_size=false) override;
+
+    void initialize(int device_id) override {};
+    bool is_partial_decoder() override { return false; }
+    void set_bbox_coords(std::vector <float> bbox_coord) override { _bbox_coord = bbox_coord; }
+    void set_crop_window(CropWindow &crop_window) override { }
+    std::vector <float> get_bbox_coords() override { return _bbox_coord; }
+private:
+    std::vector <float> _bbox_coord;
+};
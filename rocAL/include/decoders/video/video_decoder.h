@@ -79,7 +79,8 @@ public:
         BGR
     };
     virtual VideoDecoder::Status Initialize(const char *src_filename) = 0;
-    virtual VideoDecoder::Status Decode(unsigned char *output_buffer, unsigned seek_frame_number, size_t sequence_length, size_t stride, int out_width, int out_height, int out_stride, AVPixelFormat out_format) = 0;
+    //! Decodes the frames seek_frame_number + i * stride for i < frame_slots.size(), frame i is converted into the image frame_slots[i] of output_buffer, or skipped if it is negative
+    virtual VideoDecoder::Status Decode(unsigned char *output_buffer, unsigned seek_frame_number, const std::vector<int> &frame_slots, size_t stride, int out_width, int out_height, int out_stride, AVPixelFormat out_format) = 0;
     virtual int seek_frame(AVRational avg_frame_rate, AVRational time_base, unsigned frame_number) = 0;
     virtual void release() = 0;
     virtual ~VideoDecoder() = default;
@@ -22,14 +22,14 @@ THE SOFTWARE.
 
 #pragma once
 #include <vector>
-#include <condition_variable>
 #if ENABLE_OPENCL
     #include <CL/cl.h>
 #endif
-#include <queue>
+#include "slot_ring.h"
 #include "device_manager.h"
 #include "device_manager_hip.h"
 #include "commons.h"
+#include "bbox_crop_sampler.h"
 struct decoded_image_info
 {
     std::vector<std::string> _image_names;
@@ -37,12 +37,15 @@ struct decoded_image_info
     std::vector<uint32_t> _roi_height;
     std::vector<uint32_t> _original_width;
     std::vector<uint32_t> _original_height;
+    size_t _epoch = 0;//!< The epoch this batch was loaded for, batches of an epoch that has been reset are dropped by the loader
 };
 
 struct crop_image_info
 {
     //Batch of Image Crop Coordinates in "xywh" format
     std::vector<std::vector<float>> _crop_image_coords;
+    //! Windows of the SSD random crop picked by the loader, empty if the batch was loaded without a BBoxCropSampler
+    std::vector<BBoxCropWindow> _bbox_crop_windows;
 };
 class CircularBuffer
 {
@@ -56,8 +59,8 @@ public:
     void unblock_writer();// Unblocks the thread currently waiting on get_write_buffer
     void push();// The latest write goes through, effectively adds one element to the buffer
     void pop();// The oldest write will be erased and overwritten in upcoming writes
-    void set_image_info(const decoded_image_info& info) { _last_image_info = info; }
-    void set_crop_image_info(const crop_image_info& info) { _last_crop_image_info = info; }
+    void set_image_info(const decoded_image_info& info) { _circ_image_info[_slots.write_index()] = info; }
+    void set_crop_image_info(const crop_image_info& info) { _circ_crop_image_info[_slots.write_index()] = info; }
     decoded_image_info& get_image_info();
     crop_image_info& get_cropped_image_info();
     bool random_bbox_crop_flag = false;
@@ -66,20 +69,18 @@ public:
     unsigned char*  get_write_buffer(); // blocks the caller if the buffer is full
     size_t level();// Returns the number of elements stored
     void reset();// sets the buffer level to 0
-    void block_if_empty();// blocks the caller if the buffer is empty
-    void block_if_full();// blocks the caller if the buffer is full
+    void first_touch();// Writes the host buffers from the calling thread, so that their pages are placed on its NUMA node
+    bool block_if_empty();// blocks the caller if the buffer is empty, returns false if unblocked while still empty
+    bool block_if_full();// blocks the caller if the buffer is full, returns false if unblocked while still full
+    void set_prefetch_limit(size_t depth) { _slots.set_write_limit(depth); }// uses only depth of the buff_depth slots, can be called while loading
 
 private:
-    void increment_read_ptr();
-    void increment_write_ptr();
     bool full();
     bool empty();
     size_t _buff_depth;
-    decoded_image_info _last_image_info;
-    std::queue<decoded_image_info> _circ_image_info;//!< Stores the loaded images names, decoded_width and decoded_height(data is stored in the _circ_buff)
-    crop_image_info _last_crop_image_info; // for Random BBox crop coordinates
-    std::queue<crop_image_info> _circ_crop_image_info;//!< Stores the crop coordinates of the images for random bbox crop (data is stored in the _circ_buff)
-    std::mutex _names_buff_lock;
+    SlotRing _slots;//!< Lock-free index ring shared by the loader thread (producer) and the output thread (consumer)
+    std::vector<decoded_image_info> _circ_image_info;//!< Stores the loaded images names, decoded_width and decoded_height per slot (data is stored in the _host_buffer_ptrs)
+    std::vector<crop_image_info> _circ_crop_image_info;//!< Stores the crop coordinates of the images for random bbox crop per slot (data is stored in the _host_buffer_ptrs)
     /*
      *  Pinned memory allocated on the host used for fast host to device memory transactions,
      *  or the regular host memory buffers in the host processing case.
@@ -95,14 +96,8 @@ private:
     std::vector<void *> _dev_buffer;// Actual memory allocated on the device (in the case of GPU affinity)
     std::vector<unsigned char*> _host_buffer_ptrs;
     std::vector<std::vector<unsigned char>> _actual_host_buffers;
-    std::condition_variable _wait_for_load;
-    std::condition_variable _wait_for_unload;
-    std::mutex _lock;
     RocalMemType _output_mem_type;
     size_t _output_mem_size;
     bool _initialized = false;
     const size_t MEM_ALIGNMENT = 256;
-    size_t _write_ptr;
-    size_t _read_ptr;
-    size_t _level;
 };
\ No newline at end of file
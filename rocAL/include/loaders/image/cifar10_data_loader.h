@@ -66,6 +66,7 @@ private:
     std::thread _load_thread;
     std::vector<unsigned char *> _load_buff;
     std::vector<size_t> _actual_read_size;
+    std::vector<const unsigned char *> _sample_views;//!< records of the batch being loaded, in place in the reader's memory
     std::vector<std::string> _output_names;
     CircularBuffer _circ_buff;
     size_t _prefetch_queue_depth;
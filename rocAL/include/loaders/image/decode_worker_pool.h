@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstddef>
+
+/*! \brief Decode thread budget shared by the loaders of the shards of an ImageLoaderSharded
+ *
+ * Every shard decodes with its own share of the decode threads, on top of that a shard can borrow the share of the
+ * shards that are not decoding at the moment (e.g. waiting with a full buffer), so a shard slowed down by larger images or
+ * a slower disk gets more threads instead of throttling the consumer. The threads in use never exceed the pool: a shard
+ * whose share is lent out waits for the borrower to finish its batch and hand the share back.
+ */
+class DecodeWorkerPool
+{
+public:
+    explicit DecodeWorkerPool(size_t worker_count): _worker_count(worker_count) {}
+    //! Returns the number of threads the caller can decode with, at least own_share (within the pool) and at most max_count
+    size_t acquire(size_t own_share, size_t max_count)
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        const size_t needed = std::max<size_t>(1, std::min({own_share, max_count, _worker_count}));
+        _idle_available.wait(lock, [&] { return idle_workers() >= needed; });
+        const size_t count = std::max(needed, std::min(max_count, idle_workers()));
+        _workers_in_use += count;
+        return count;
+    }
+    //! Hands back the threads taken by a previous acquire() call
+    void release(size_t count)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _workers_in_use -= count;
+        }
+        _idle_available.notify_all();
+    }
+    //! Changes the size of the pool, a smaller pool is reached as the threads in use are handed back
+    void set_worker_count(size_t worker_count)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _worker_count = worker_count;
+        }
+        _idle_available.notify_all();
+    }
+    //! Holds the threads acquired for one batch, hands them back when going out of scope (also when decoding throws)
+    class Lease
+    {
+    public:
+        Lease(DecodeWorkerPool *pool, size_t own_share, size_t max_count):
+                _pool(pool), _count(pool ? pool->acquire(own_share, max_count) : own_share) {}
+        ~Lease() { if (_pool) _pool->release(_count); }
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        size_t count() const { return _count; }
+    private:
+        DecodeWorkerPool *_pool;
+        size_t _count;
+    };
+private:
+    //! Threads not decoding at the moment, the shares of the idle shards
+    size_t idle_workers() const { return _worker_count > _workers_in_use ? _worker_count - _workers_in_use : 0; }
+    std::mutex _lock;
+    std::condition_variable _idle_available;
+    size_t _worker_count;
+    size_t _workers_in_use = 0;
+};
@@ -25,6 +25,8 @@ THE SOFTWARE.
 #include <string>
 #include <thread>
 #include <vector>
+#include <mutex>
+#include <condition_variable>
 #include "commons.h"
 #include "circular_buffer.h"
 #include "image_read_and_decode.h"
@@ -41,7 +43,7 @@ public:
     void set_output_image (Image* output_image) override;
     void set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_MetaDataReader> randombboxcrop_meta_data_reader) override;
     size_t remaining_count() override; // returns number of remaining items to be loaded
-    void reset() override; // Resets the loader to load from the beginning of the media
+    void reset() override; // Moves the loader to the next epoch, does not stop the internal thread
     Timing timing() override;
     void start_loading() override;
     LoaderModuleStatus set_cpu_affinity(cpu_set_t cpu_mask);
@@ -52,6 +54,21 @@ public:
     crop_image_info get_crop_image_info() override;
     void set_prefetch_queue_depth(size_t prefetch_queue_depth)  override;
     void shut_down() override;
+    //! Returns true if load_next() would not block: a batch is loaded or the loader is stopped
+    bool is_ready();
+    //! The event is signaled every time a batch is loaded, shared by the loaders of the shards to wait for any of them
+    void set_batch_ready_event(std::shared_ptr<FutexEvent> batch_ready_event) { _batch_ready_event = batch_ready_event; }
+    void set_decode_worker_pool(std::shared_ptr<DecodeWorkerPool> decode_worker_pool);
+    //! Should be called before start_loading(), only the first CPU set is used
+    void set_numa_placement(const std::vector<std::vector<unsigned>> &shard_cpus) override;
+    //! Can be called while the internal thread is loading
+    void set_bbox_crop_sampler(std::shared_ptr<BBoxCropSampler> bbox_crop_sampler) override;
+    //! Should be called after initialize(), take effect from the next batch loaded
+    void set_decode_thread_count(size_t thread_count) override;
+    void set_prefetch_limit(size_t prefetch_depth) override;
+    bool get_position(LoaderPosition &position) override;
+    //! Only takes the first shard of the position
+    void set_start_position(const LoaderPosition &position) override;
 private:
     bool is_out_of_data();
     void de_init();
@@ -59,8 +76,11 @@ private:
     std::shared_ptr<ImageReadAndDecode> _image_loader;
     LoaderModuleStatus update_output_image();
     LoaderModuleStatus load_routine();
+    void start_epoch(size_t epoch);
+    void wait_for_epoch_request(size_t epoch);
 
     std::shared_ptr<RandomBBoxCrop_MetaDataReader> _randombboxcrop_meta_data_reader = nullptr;
+    std::shared_ptr<BBoxCropSampler> _bbox_crop_sampler = nullptr;//!< Accessed with std::atomic_load / std::atomic_store
     Image* _output_image;
     std::vector<std::string> _output_names;//!< image name/ids that are stores in the _output_image
     size_t _output_mem_size;
@@ -82,6 +102,17 @@ private:
     size_t _prefetch_queue_depth; // Used for circular buffer's internal buffer
     size_t _image_counter = 0;//!< How many images have been loaded already
     size_t _remaining_image_count;//!< How many images are there yet to be loaded
+    size_t _epoch_image_count = 0;//!< How many images are loaded in a whole epoch
+    size_t _loader_epoch = 0;//!< The epoch the internal thread is loading, only accessed by the internal thread
+    size_t _output_epoch = 0;//!< The epoch the batches handed to the user belong to
+    size_t _requested_epoch = 0;//!< The epoch the internal thread is asked to load, guarded by _epoch_lock
+    size_t _output_batch_count = 0;//!< Batches of the output epoch handed out
+    uint64_t _total_output_batch_count = 0;//!< Batches handed out in all the epochs
+    std::unique_ptr<LoaderPosition> _start_position;//!< Applied by start_loading()
+    std::mutex _epoch_lock;
+    std::condition_variable _epoch_cv;//!< Wakes up the internal thread parked at the end of data on reset() or shut down
+    std::shared_ptr<FutexEvent> _batch_ready_event = nullptr;
+    std::vector<unsigned> _numa_cpus;//!< If not empty the internal thread and its decode threads run on these CPUs and the buffers are placed on their node
     bool _decoder_keep_original = false;
     int _device_id;
 };
@@ -26,6 +26,8 @@ THE SOFTWARE.
 //
 // ImageLoaderSharded Can be used to run load and decode in multiple shards, each shard by a single loader instance,
 // It improves load and decode performance since each loader loads the images in parallel using an internal thread
+// The shards are either consumed in turn (ROUND_ROBIN) or the next batch is taken from whichever shard has one ready (ANY_READY),
+// so that a slow shard (larger images, slower disk) does not throttle the others
 //
 class ImageLoaderSharded : public LoaderModule
 {
@@ -45,16 +47,48 @@ public:
     Timing timing() override;
     void set_prefetch_queue_depth(size_t prefetch_queue_depth) override;
     void shut_down() override;
+    //! Should be called before initialize()
+    void set_shard_scheduling(ShardScheduling scheduling, bool share_decode_threads) override;
+    //! Should be called before start_loading()
+    void set_numa_placement(const std::vector<std::vector<unsigned>> &shard_cpus) override { _shard_cpus = shard_cpus; }
+    void set_bbox_crop_sampler(std::shared_ptr<BBoxCropSampler> bbox_crop_sampler) override;
+    //! Applied to the loaders of all the shards, and kept for the loaders rebuilt by set_sequence_rearrange()
+    void set_decode_thread_count(size_t thread_count) override;
+    void set_prefetch_limit(size_t prefetch_depth) override;
+    size_t internal_shard_count() override { return _shard_count; }
+    void set_prefetch_memory_budget(size_t memory_budget, size_t min_depth) override;
+    bool get_position(LoaderPosition &position) override;
+    //! Should be called before start_loading(), the position has to be one of a loader with the same number of shards
+    void set_start_position(const LoaderPosition &position) override;
+    //! Rebuilds the loaders of a sequence reader so that they read only the frames of new_order, in that order, into output_image
+    void set_sequence_rearrange(Image *output_image, const std::vector<unsigned> &new_order);
 private:
     void increment_loader_idx();
+    void select_ready_loader();
     void *_dev_resources;
     bool _initialized = false;
     std::vector<std::shared_ptr<ImageLoader>> _loaders;
     size_t _loader_idx;
     size_t _shard_count = 1;
+    size_t _batch_size = 1;
     void fast_forward_through_empty_loaders();
     size_t _prefetch_queue_depth;
+    size_t _prefetch_memory_budget = 0;//!< For the buffers of all the shards, 0 if not limited
+    size_t _prefetch_min_depth = 0;
+    ShardScheduling _scheduling = ShardScheduling::ROUND_ROBIN;
+    bool _share_decode_threads = false;
+    std::shared_ptr<FutexEvent> _batch_ready_event;//!< Signaled by the loaders of all the shards when a batch is loaded
+    std::shared_ptr<DecodeWorkerPool> _decode_worker_pool = nullptr;
+    std::vector<std::vector<unsigned>> _shard_cpus;//!< NUMA placement of the shards, shard i runs on _shard_cpus[i % size]
 
     Image *_output_image;
+    ReaderConfig _reader_cfg = ReaderConfig(StorageType::FILE_SYSTEM);
+    DecoderConfig _decoder_cfg;
+    RocalMemType _mem_type = RocalMemType::HOST;
+    bool _keep_orig_size = false;
     std::shared_ptr<RandomBBoxCrop_MetaDataReader> _randombboxcrop_meta_data_reader = nullptr;
+    std::shared_ptr<BBoxCropSampler> _bbox_crop_sampler = nullptr;
+    size_t _decode_thread_count = 0;//!< 0 till set by set_decode_thread_count(), the reader config's count is used
+    size_t _prefetch_limit = 0;//!< 0 till set by set_prefetch_limit(), the whole prefetch queue is used
+    std::unique_ptr<LoaderPosition> _start_position;//!< Applied to the loaders of the shards by start_loading()
 };
\ No newline at end of file
@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "timing_debug.h"
 #include "loader_module.h"
 #include "parameter_random_crop_decoder.h"
+#include "decode_worker_pool.h"
+#include "sample_quarantine.h"
 
 /**
  * Compute the scaled value of <tt>dimension</tt> using the given scaling
@@ -52,6 +54,15 @@ public:
     void set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_MetaDataReader> randombboxcrop_meta_data_reader);
     std::vector<std::vector <float>> get_batch_random_bbox_crop_coords();
     void set_batch_random_bbox_crop_coords(std::vector<std::vector <float>> batch_crop_coords);
+    //! Epoch of the batches loaded next, the random bbox crops of a sample are picked per epoch
+    void set_epoch(size_t epoch) { _epoch = epoch; }
+    //! Moves to the given item of the given epoch as if the batches before had been loaded, without decoding them
+    /// \param batch_count batches loaded before in all the epochs, the random decoder crops are keyed by it
+    void seek(size_t epoch, size_t item_count, uint64_t batch_count);
+    //! Decode threads are taken from the pool (at least the _num_threads own share) instead of using a fixed count
+    void set_decode_worker_pool(std::shared_ptr<DecodeWorkerPool> decode_worker_pool) { _decode_worker_pool = decode_worker_pool; }
+    //! Decode threads used from the next batch on, can be called while loading
+    void set_num_threads(size_t num_threads) { _num_threads.store(std::max<size_t>(1, num_threads)); }
 
     //! Loads a decompressed batch of images into the buffer indicated by buff
     /// \param buff User's buffer provided to be filled with decoded image samples
@@ -82,6 +93,7 @@ private:
     std::vector<std::vector<unsigned char>> _compressed_buff;
     std::vector<size_t> _actual_read_size;
     std::vector<std::string> _image_names;
+    std::vector<std::string> _sample_paths;//!< Keys of the samples in the quarantine, their paths relative to the dataset root
     std::vector<size_t> _compressed_image_size;
     std::vector<unsigned char*> _decompressed_buff_ptrs;
     std::vector<size_t> _actual_decoded_width;
@@ -90,12 +102,27 @@ private:
     std::vector<size_t> _original_height;
     static const size_t MAX_COMPRESSED_SIZE = 1*1024*1024; // 1 Meg
     TimingDBG _file_load_time, _decode_time;
-    size_t _batch_size, _shard_count, _num_threads;
+    size_t _batch_size, _shard_count;
+    std::atomic<size_t> _num_threads;//!< Can be changed by the autotuner while loading, read once per batch
     DecoderConfig _decoder_config;
     bool decoder_keep_original;
     std::vector<std::vector <float>> _bbox_coords, _crop_coords_batch;
     std::shared_ptr<RandomBBoxCrop_MetaDataReader> _randombboxcrop_meta_data_reader = nullptr;
+    size_t _epoch = 0;
     pCropCord _CropCord;
     RocalRandomCropDecParam *_random_crop_dec_param = nullptr;
+    std::shared_ptr<DecodeWorkerPool> _decode_worker_pool = nullptr;
+    std::shared_ptr<SampleQuarantine> _quarantine = nullptr;
+    std::vector<char> _header_decoded;//!< Per sample of the batch: the header was decoded, its size is in _original_width / _original_height
+    //! Copy of a sample known to decode, put in place of the samples failing to decode or quarantined
+    struct SpareSample
+    {
+        std::vector<unsigned char> data;
+        size_t size = 0, width = 0, height = 0;
+        std::string name, path;
+        bool valid = false;
+    } _spare;
+    void replace_sample(size_t index, size_t donor);
+    void replace_with_spare(size_t index);
 };
 
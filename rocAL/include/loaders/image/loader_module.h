@@ -22,6 +22,8 @@ THE SOFTWARE.
 
 #pragma  once
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include "image_reader.h"
 #include "decoder.h"
 #include "commons.h"
@@ -41,6 +43,22 @@ enum class LoaderModuleStatus
     NOT_INITIALIZED
 };
 
+/*! \brief Defines the order the batches loaded by the shards of a sharded loader are handed out */
+enum class ShardScheduling
+{
+    ROUND_ROBIN = 0,//!< One batch from each shard in turn, deterministic
+    ANY_READY//!< The next batch ready in any of the shards, batches of each shard are still handed out in the order they are loaded
+};
+
+/*! \brief Where a loader is in its data, after the last batch handed out by load_next() */
+struct LoaderPosition
+{
+    size_t epoch = 0;
+    std::vector<size_t> shard_batch_counts;//!< Batches of the epoch handed out from each shard
+    std::vector<uint64_t> shard_total_batch_counts;//!< Batches handed out from each shard since the start, the random decoder crops are keyed by it
+    size_t shard_idx = 0;//!< Shard the last batch came from
+};
+
 /*! \class LoaderModule The interface defining the API and requirements of loader modules*/
 class LoaderModule
 {
@@ -60,6 +78,23 @@ public:
     // introduce meta data reader
     virtual void set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_MetaDataReader> randombboxcrop_meta_data_reader) = 0;
     virtual void shut_down() = 0;
+    //! Only used by the loaders running multiple shards
+    virtual void set_shard_scheduling(ShardScheduling scheduling, bool share_decode_threads) {}
+    //! The CPUs (of one NUMA node) each shard's loader thread, decode threads and buffers are placed on, shard i uses shard_cpus[i % size]
+    virtual void set_numa_placement(const std::vector<std::vector<unsigned>> &shard_cpus) {}
+    //! The loader picks the SSD random crop windows of the batches it loads from now on, handed out with get_crop_image_info()
+    virtual void set_bbox_crop_sampler(std::shared_ptr<BBoxCropSampler> bbox_crop_sampler) {}
+    //! Runtime knobs of the autotuner, can be changed while loading: decode threads of each shard, and batches loaded ahead (up to the prefetch queue depth)
+    virtual void set_decode_thread_count(size_t thread_count) {}
+    virtual void set_prefetch_limit(size_t prefetch_depth) {}
+    //! Number of shards loading in parallel, each with its own decode threads and prefetch buffers
+    virtual size_t internal_shard_count() { return 1; }
+    //! Caps the prefetch buffers of all the shards together to memory_budget bytes, keeping at least min_depth of them per shard, called before initialize()
+    virtual void set_prefetch_memory_budget(size_t memory_budget, size_t min_depth) {}
+    //! Returns false if the loader cannot be resumed from a position
+    virtual bool get_position(LoaderPosition &position) { return false; }
+    //! Resumes from a position get_position() returned for the same data, should be called before start_loading()
+    virtual void set_start_position(const LoaderPosition &position) { THROW("The loader cannot be resumed from a saved position") }
 };
 
 using pLoaderModule = std::shared_ptr<LoaderModule>;
\ No newline at end of file
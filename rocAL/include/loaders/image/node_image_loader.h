@@ -43,10 +43,21 @@ public:
     void init(unsigned internal_shard_count, unsigned cpu_num_threads, const std::string &source_path, const std::string &json_path, const std::map<std::string, std::string> feature_key_map, StorageType storage_type, DecoderType decoder_type, bool shuffle, bool loop,
               size_t load_batch_count, RocalMemType mem_type, std::shared_ptr<MetaDataReader> meta_data_reader, bool decoder_keep_orig = false, const char *prefix = "", unsigned sequence_length = 0, unsigned step = 0, unsigned stride = 0);
 
+    //! Describes the samples of a StorageType::SYNTHETIC loader, to be set before init()
+    void set_synthetic_data_config(const SyntheticDataConfig &config) { _synthetic_data_config = config; }
+    //! Shape of the samples of the raw tensor files of a StorageType::NUMPY_DATA loader, to be set before init()
+    void set_raw_sample_shape(const RawSampleShape &shape) { _raw_sample_shape = shape; }
+    //! Number of samples the StorageType::TAR_SHARDS loader shuffles in memory, to be set before init()
+    void set_shuffle_buffer_size(size_t size) { _shuffle_buffer_size = size; }
     std::shared_ptr<LoaderModule> get_loader_module();
+    //! Makes the loader write only the frames of new_order of each sequence, in that order, into output instead of its current output image
+    void set_sequence_rearrange(Image *output, const std::vector<unsigned> &new_order);
 protected:
     void create_node() override{};
     void update_node() override{};
 private:
     std::shared_ptr<ImageLoaderSharded> _loader_module = nullptr;
+    SyntheticDataConfig _synthetic_data_config;
+    RawSampleShape _raw_sample_shape;
+    size_t _shuffle_buffer_size = 0;
 };
\ No newline at end of file
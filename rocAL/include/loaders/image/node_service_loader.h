@@ -0,0 +1,44 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include "node.h"
+#include "service_data_loader.h"
+#include "graph.h"
+
+class ServiceLoaderNode: public Node
+{
+public:
+    ServiceLoaderNode(Image *output, void *device_resources);
+    ~ServiceLoaderNode() override;
+    ServiceLoaderNode() = delete;
+    ///
+    /// \param batch_ring The ring of this rank, attached to by the caller to learn the size of the images it carries
+    void init(std::shared_ptr<ShmBatchRing> batch_ring, RocalMemType mem_type);
+
+    std::shared_ptr<LoaderModule> get_loader_module();
+protected:
+    void create_node() override {};
+    void update_node() override {};
+private:
+    std::shared_ptr<ServiceDataLoader> _loader_module = nullptr;
+};
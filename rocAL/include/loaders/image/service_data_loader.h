@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include "loader_module.h"
+#include "timing_debug.h"
+#include "shm_batch_ring.h"
+
+/*! \brief Loader of a client pipeline of the rocAL service: hands out the batches the service publishes for this rank
+ *
+ * The batches come decoded and augmented from the ring of the rank in shared memory, the output image is pointed at the images of
+ * the slot in place (no copy) and the slot is handed back to the service when the next batch is loaded. Each rank gets the same
+ * number of batches per epoch; reset() skips what is left of the current epoch so that the next one starts at its first batch.
+ * Only runs with the host memory type, the device copy is left to the output of the client pipeline.
+ */
+class ServiceDataLoader : public LoaderModule
+{
+public:
+    explicit ServiceDataLoader(void *dev_resources);
+    ~ServiceDataLoader() override;
+    LoaderModuleStatus load_next() override;
+    //! The ring has to be set with set_batch_ring() before
+    void initialize(ReaderConfig reader_cfg, DecoderConfig decoder_cfg, RocalMemType mem_type, unsigned batch_size, bool keep_orig_size=true) override;
+    void set_output_image(Image* output_image) override;
+    void set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_MetaDataReader> randombboxcrop_meta_data_reader) override {}
+    size_t remaining_count() override;
+    void reset() override;
+    void start_loading() override {}
+    std::vector<std::string> get_id() override { return _output_names; }
+    decoded_image_info get_decode_image_info() override { return _output_decoded_img_info; }
+    crop_image_info get_crop_image_info() override { return {}; }
+    Timing timing() override;
+    //! The depth of the ring is set by the service
+    void set_prefetch_queue_depth(size_t prefetch_queue_depth) override {}
+    void shut_down() override;
+    void set_batch_ring(std::shared_ptr<ShmBatchRing> batch_ring) { _batch_ring = batch_ring; }
+private:
+    void release_slot();
+    std::shared_ptr<ShmBatchRing> _batch_ring = nullptr;
+    Image *_output_image = nullptr;
+    size_t _batch_size = 0;
+    size_t _epoch_batch_index = 0;//!< Batches of the current epoch loaded so far
+    bool _slot_in_use = false;//!< The output image points at the slot at the read index of the ring
+    bool _initialized = false;
+    std::vector<std::string> _output_names;
+    decoded_image_info _output_decoded_img_info;
+    TimingDBG _wait_time, _swap_handle_time;
+};
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "reader_factory.h"
 #include "timing_debug.h"
 #include "loader_module.h"
+#include "sample_quarantine.h"
 enum class ImageSourceEvaluatorStatus
 {
     OK = 0,
@@ -67,6 +68,7 @@ private:
     std::shared_ptr<Decoder> _decoder;
     std::shared_ptr<Reader> _reader;
     std::shared_ptr<MetaDataReader> _meta_data_reader;
+    std::shared_ptr<SampleQuarantine> _quarantine;
     std::vector<unsigned char> _header_buff;
     static const size_t COMPRESSED_SIZE = 1024 * 1024; // 1 MB
 };
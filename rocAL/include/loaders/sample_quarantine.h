@@ -0,0 +1,56 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*! \brief Persistent list of the samples of a data source that failed to decode
+ *
+ * The samples are identified by their path relative to the source, Reader::sample_path(), so that files of the same
+ * name in different sub folders are told apart, and recorded with the reason of the failure in a sidecar text file,
+ * one "<id>\t<reason>" line each: <source>/.rocal_quarantine for a directory, <source>.rocal_quarantine for a file,
+ * or in $ROCAL_CACHE_DIR (/tmp by default) if that location is read-only. The file is read back by the next runs, so the
+ * readers can drop these samples from their lists up front, and the loaders replace them without reading them again
+ * on the following epochs. Setting ROCAL_DISABLE_QUARANTINE turns it off.
+ */
+class SampleQuarantine
+{
+public:
+    //! Quarantine of the given source, shared by all the readers, loaders and evaluators of that source in the process. Null if disabled
+    static std::shared_ptr<SampleQuarantine> open(const std::string &source_path);
+    explicit SampleQuarantine(const std::string &source_path);
+    bool contains(const std::string &id) const;
+    //! Records the sample and appends it to the sidecar file, does nothing if it is already quarantined
+    void add(const std::string &id, const std::string &reason);
+    size_t size() const { return _count.load(std::memory_order_acquire); }
+private:
+    void load(const std::string &path);
+    const std::string _source_path;
+    std::string _sidecar_path;
+    mutable std::mutex _lock;
+    std::unordered_map<std::string, std::string> _samples;//!< id -> reason
+    std::atomic<size_t> _count = {0};
+};
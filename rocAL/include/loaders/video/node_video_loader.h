@@ -42,6 +42,8 @@ public:
     void init(unsigned internal_shard_count, const std::string &source_path, VideoStorageType storage_type, VideoDecoderType decoder_type, DecodeMode decoder_mode,
               unsigned sequence_length, unsigned step, unsigned stride, VideoProperties &video_prop, bool shuffle, bool loop, size_t load_batch_count, RocalMemType mem_type);
     std::shared_ptr<VideoLoaderModule> get_loader_module();
+    //! Makes the loader write only the frames of new_order of each sequence, in that order, into output instead of its current output image
+    void set_sequence_rearrange(Image *output, const std::vector<unsigned> &new_order);
 protected:
     void create_node() override{};
     void update_node() override{};
@@ -46,6 +46,8 @@ public:
     std::vector<size_t> get_sequence_start_frame_number() override;
     std::vector<std::vector<float>> get_sequence_frame_timestamps() override;
     Timing timing() override;
+    //! Rebuilds the loaders so that they write only the frames of new_order, in that order, into output_image
+    void set_sequence_rearrange(Image *output_image, const std::vector<unsigned> &new_order);
 private:
     void increment_loader_idx();
     void *_dev_resources;
@@ -56,5 +58,9 @@ private:
     void fast_forward_through_empty_loaders();
     size_t _prefetch_queue_depth; // Used for circular buffer's internal buffer
     Image *_output_image;
+    VideoReaderConfig _reader_cfg = VideoReaderConfig(VideoStorageType::VIDEO_FILE_SYSTEM);
+    VideoDecoderConfig _decoder_cfg;
+    RocalMemType _mem_type = RocalMemType::HOST;
+    bool _keep_orig_size = false;
 };
 #endif
@@ -104,12 +104,16 @@ private:
     size_t _batch_size;
     size_t _sequence_count;
     size_t _sequence_length;
+    size_t _output_sequence_length; //!< Frames per output sequence, the length of _new_order
+    std::vector<unsigned> _new_order; //!< Position in the read sequence of each frame of the output sequences
+    std::vector<int> _frame_slots; //!< First output position of each read frame up to the last one referenced, -1 if the frame is not used
     size_t _stride;
     size_t _video_count;
     float _frame_rate;
     size_t _max_decoded_width;
     size_t _max_decoded_height;
     size_t _max_decoded_stride;
+    size_t _decoded_image_size;
     AVPixelFormat _out_pix_fmt;
     VideoDecoderConfig _video_decoder_config;
 };
@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "meta_data.h"
+
+class MetaDataReader;
+
+//! One of the constraint sets a crop window is picked for
+struct BBoxCropOption
+{
+    float min_iou;
+    float max_iou;
+    bool whole_image;//!< The option picks the whole image, no window is drawn
+};
+
+//! Normalized crop window of a sample, with the IoU range of the option it was picked for
+struct BBoxCropWindow
+{
+    BoundingBoxCord window;
+    float min_iou;
+    float max_iou;
+};
+
+/*! \brief Picks the SSD style random crop windows of a batch, keeping the bounding boxes in view
+ *
+ * For every attempt an option is drawn, then up to attempts_per_option windows of 0.3 to 1 of the image side with an aspect ratio
+ * within [0.5, 2]. A window is accepted if (with check_overlap) the IoU of every box with it is within the option's range and the
+ * center of at least one box lies inside it; the boxes are tested 8 at a time with AVX2. Once total_attempts windows have been
+ * drawn the whole image is used.
+ * The random values of a sample come from the Philox stream keyed by the seed, the sampler's stream, the sample's name and the epoch,
+ * so the windows are the same whatever thread, shard or stage picks them, and the samples of a batch are picked in parallel.
+ * The values are mapped from the Philox words directly, the std distributions would give other windows with other standard libraries.
+ */
+class BBoxCropSampler
+{
+public:
+    BBoxCropSampler(std::vector<BBoxCropOption> options, bool iou_over_union, bool check_overlap, unsigned attempts_per_option,
+                    unsigned total_attempts, uint64_t seed, uint32_t stream);
+    //! \param image_width if not 0, the left side of the windows is aligned down to 8 pixels of an image of that width (for the cropping jpeg decoder)
+    BBoxCropWindow sample(const BoundingBoxCords &boxes, uint64_t key, unsigned image_width = 0) const;
+    //! Picks the windows of the samples of a batch in parallel, boxes[i] are the boxes of the sample names[i] (image_widths[i] its width, if given)
+    void sample_batch(const std::vector<const BoundingBoxCords *> &boxes, const std::vector<std::string> &names, size_t epoch,
+                      std::vector<BBoxCropWindow> &windows, const std::vector<unsigned> &image_widths = {}) const;
+    //! Same, the boxes are looked up by name in the meta data reader set with set_meta_data_reader()
+    void sample_batch(const std::vector<std::string> &names, size_t epoch, std::vector<BBoxCropWindow> &windows) const;
+    //! The reader's content is only read, it has to be loaded before the batches are sampled
+    void set_meta_data_reader(std::shared_ptr<MetaDataReader> meta_data_reader) { _meta_data_reader = meta_data_reader; }
+    //! Number of threads sample_batch() picks the windows on, the CPU thread count of the pipeline
+    void set_num_threads(size_t num_threads) { _num_threads = std::max<size_t>(num_threads, 1); }
+    //! Random stream key of a sample for an epoch
+    static uint64_t sample_key(const std::string &name, size_t epoch);
+private:
+    bool accept(const BBoxCropOption &option, const BoundingBoxCord &window, const float *l, const float *t, const float *r, const float *b, size_t count) const;
+    const std::vector<BBoxCropOption> _options;
+    const bool _iou_over_union;
+    const bool _check_overlap;
+    const unsigned _attempts_per_option;
+    const unsigned _total_attempts;
+    const uint64_t _seed;
+    const uint32_t _stream;
+    std::shared_ptr<MetaDataReader> _meta_data_reader = nullptr;
+    size_t _num_threads = 1;
+};
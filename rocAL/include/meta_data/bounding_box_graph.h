@@ -30,5 +30,7 @@ public:
     void process(MetaDataBatch* meta_data) override;
     void update_random_bbox_meta_data(MetaDataBatch* meta_data, decoded_image_info decoded_image_info,crop_image_info crop_image_info) override;
     void update_box_encoder_meta_data(std::vector<float> *anchors, pMetaDataBatch full_batch_meta_data ,float criteria, bool offset , float scale, std::vector<float>& means, std::vector<float>& stds) override;
+    void update_keypoint_heatmaps(pMetaDataBatch full_batch_meta_data, float *heatmaps, float *target_weights, unsigned image_width, unsigned image_height,
+                                  unsigned heatmap_width, unsigned heatmap_height, float sigma, size_t num_threads) override;
 };
 
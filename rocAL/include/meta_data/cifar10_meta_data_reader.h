@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "commons.h"
 #include "meta_data.h"
 #include "meta_data_reader.h"
+#include "mapped_file.h"
 
 class Cifar10MetaDataReader: public MetaDataReader
 {
@@ -57,4 +58,5 @@ private:
     std::vector<unsigned> _file_offsets;
     std::vector<unsigned> _file_idx;
     std::vector<std::string> _subfolder_file_names;
+    std::vector<std::shared_ptr<const MappedFile>> _mapped_files;//!< batch files the labels are read from, kept for the data reader to share
 };
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "meta_data.h"
+
+/*! \brief Compiled binary form of a COCO annotations file, so that the JSON is parsed only once
+ *
+ * Written next to the JSON file (or in $ROCAL_CACHE_DIR, /tmp by default, if that directory is read-only) after the first parse,
+ * then memory mapped by the following runs. It holds the images table sorted by name with the range of records of each image,
+ * the records themselves (boxes with their continuous labels, or key points) and the category map.
+ * Once opened the cache stays mapped and the images are looked up in place by a binary search of the table, nothing is copied
+ * but the records of the images asked for.
+ * A cache is only used if it was built from a file of the same size and with the same parameters. A file of another modification
+ * time is hashed, the cache is used if the content hash is the same (and the new time is then recorded in the cache).
+ * Setting ROCAL_DISABLE_ANNOTATION_CACHE turns it off.
+ */
+class CocoAnnotationCache
+{
+public:
+    enum class Kind : uint32_t { BOUNDING_BOX = 1, KEY_POINTS = 2 };
+    //! \param params values the records depend on besides the JSON file (e.g. the output size for the key points), stored and checked as well
+    CocoAnnotationCache(const std::string &json_path, Kind kind, std::vector<uint32_t> params = {});
+    ~CocoAnnotationCache();
+    //! Maps a valid cache file for the lookups and reads its category map, returns false if there is none
+    bool open(std::map<int, int> &label_info);
+    void close() { unmap_file(); }
+    bool contains(const std::string &name) const;
+    //! Copies the boxes of an image out of the open cache, returns false if the image is not in it
+    bool find_boxes(const std::string &name, BoundingBoxCords &boxes, BoundingBoxLabels &labels, ImgSize &image_size) const;
+    //! Copies the key points of an image out of the open cache, returns false if the image has none
+    bool find_key_points(const std::string &name, JointsData &joints_data, ImgSize &image_size) const;
+    //! Copies every image of the open cache into the map, for the users of the whole content
+    void fill(std::map<std::string, std::shared_ptr<MetaData>> &map_content) const;
+    //! open(), fill() and close()
+    bool load(std::map<std::string, std::shared_ptr<MetaData>> &map_content, std::map<int, int> &label_info);
+    //! Writes the cache file, failing to do so is not an error, the JSON file is parsed again next time
+    void store(const std::map<std::string, std::shared_ptr<MetaData>> &map_content, const std::map<int, int> &label_info);
+private:
+    struct Header;
+    struct ImageRecord;
+    struct BoxRecord;
+    struct KeyPointRecord;
+    std::vector<std::string> cache_paths() const;
+    bool source_stat(uint64_t &size, uint64_t &mtime) const;
+    bool source_hash(uint64_t &hash);
+    bool map_file(const std::string &path);
+    bool validate(const std::string &path);
+    void unmap_file();
+    const ImageRecord *find(const std::string &name) const;
+    std::string_view image_name(const ImageRecord &image) const;
+    void read_boxes(const ImageRecord &image, BoundingBoxCords &boxes, BoundingBoxLabels &labels) const;
+    void read_key_points(const ImageRecord &image, JointsData &joints_data) const;
+    const std::string _json_path;
+    const Kind _kind;
+    const std::vector<uint32_t> _params;
+    const bool _enabled;
+    bool _source_hashed = false;
+    uint64_t _source_hash = 0;
+    const char *_mapped = nullptr;
+    size_t _mapped_size = 0;
+    //! Tables of the open cache, in the mapping
+    const Header *_header = nullptr;
+    const ImageRecord *_images = nullptr;
+    const char *_records = nullptr;
+    const int32_t *_categories = nullptr;
+    const char *_strings = nullptr;
+};
@@ -22,9 +22,12 @@ THE SOFTWARE.
 
 #pragma once
 #include <map>
+#include <memory>
+#include <mutex>
 #include "commons.h"
 #include "meta_data.h"
 #include "meta_data_reader.h"
+#include "coco_annotation_cache.h"
 #include "timing_debug.h"
 
 class COCOMetaDataReader: public MetaDataReader
@@ -38,7 +41,8 @@ public:
     void print_map_contents();
     bool set_timestamp_mode() override { return false; }
     MetaDataBatch * get_output() override { return _output; }
-    const std::map<std::string, std::shared_ptr<MetaData>> & get_map_content() override { return _map_content;}
+    //! Filled from the annotation cache on the first call, the lookups read the cache in place
+    const std::map<std::string, std::shared_ptr<MetaData>> & get_map_content() override;
     COCOMetaDataReader();
     ~COCOMetaDataReader() override { delete _output; }
 private:
@@ -53,6 +57,9 @@ private:
     std::map<std::string, ImgSize> ::iterator itr;
     std::map<int, int> _label_info;
     std::map<int, int> ::iterator _it_label;
+    std::unique_ptr<CocoAnnotationCache> _annotation_cache;//!< Open if the annotations were read from the cache
+    bool _map_filled = false;
+    std::mutex _map_fill_lock;
     TimingDBG _coco_metadata_read_time;
 };
 
@@ -36,6 +36,9 @@ public:
     virtual void process(MetaDataBatch* meta_data) = 0;
     virtual void update_random_bbox_meta_data(MetaDataBatch* meta_data, decoded_image_info decoded_image_info,crop_image_info crop_image_info) = 0;
     virtual void update_box_encoder_meta_data(std::vector<float> *anchors, pMetaDataBatch full_batch_meta_data , float criteria, bool offset , float scale, std::vector<float> &means, std::vector<float> &stds) = 0;
+    //! Writes the gaussian heatmaps (batch x joints x heatmap_height x heatmap_width) and the target weights (batch x joints) of the key points, on num_threads threads
+    virtual void update_keypoint_heatmaps(pMetaDataBatch full_batch_meta_data, float *heatmaps, float *target_weights, unsigned image_width, unsigned image_height,
+                                          unsigned heatmap_width, unsigned heatmap_height, float sigma, size_t num_threads) = 0;
     std::list<std::shared_ptr<MetaNode>> _meta_nodes;
 };
 
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <memory>
 #include <map>
 #include "meta_data.h"
+#include "synthetic_data.h"
 
 enum class MetaDataReaderType
 {
@@ -41,7 +42,10 @@ enum class MetaDataReaderType
     CAFFE2_DETECTION_META_DATA_READER,
     TF_DETECTION_META_DATA_READER,
     VIDEO_LABEL_READER,
-    MXNET_META_DATA_READER
+    MXNET_META_DATA_READER,
+    SYNTHETIC_META_DATA_READER, // labels or boxes of the synthetic data source
+    TAR_SHARD_META_DATA_READER, // labels or boxes stored next to the images in tar shards
+    SERVICE_META_DATA_READER // labels or boxes published by the rocAL service along with the batches
 };
 enum class MetaDataType
 {
@@ -63,6 +67,7 @@ private:
     unsigned _frame_stride;
     unsigned _out_img_width;
     unsigned _out_img_height;
+    SyntheticDataConfig _synthetic_data_config;
 
 public:
     MetaDataConfig(const MetaDataType& type, const MetaDataReaderType& reader_type, const std::string& path, const std::map<std::string, std::string> &feature_key_map=std::map<std::string, std::string>(), const std::string file_prefix=std::string(), const unsigned& sequence_length = 3, const unsigned& frame_step = 3, const unsigned& frame_stride = 1)
@@ -80,6 +85,8 @@ public:
     unsigned out_img_height() const { return _out_img_height; }
     void set_out_img_width(unsigned out_img_width) { _out_img_width = out_img_width; }
     void set_out_img_height(unsigned out_img_height) { _out_img_height = out_img_height; }
+    const SyntheticDataConfig &synthetic_data_config() const { return _synthetic_data_config; }
+    void set_synthetic_data_config(const SyntheticDataConfig &config) { _synthetic_data_config = config; }
 };
 
 
@@ -37,6 +37,20 @@ public:
     double BBoxIntersectionOverUnion(const BoundingBoxCord &box1, const BoundingBoxCord &box2, bool is_iou) const;
     int _batch_size;
     float _iou_threshold = 0.25;
+protected:
+    /*! \brief Crops the boxes of every sample of the batch to its window and keeps the ones the window covers at least _iou_threshold of
+     * \param windows one crop window per sample, in the same coordinates as the boxes
+     * \param mirror if not null, the kept boxes of the samples with a non zero entry are flipped horizontally after the crop
+     * \param fill_empty if true a sample left without any box gets the whole image as a box of label 0
+     * The batch is transformed as a flat structure of arrays, the boxes and labels are compacted in place in the batch
+     */
+    void crop_boxes(MetaDataBatch *input_meta_data, const std::vector<BoundingBoxCord> &windows, const int *mirror, bool fill_empty);
+    std::vector<BoundingBoxCord> _crop_windows;//!< Per sample windows handed to crop_boxes(), kept to avoid reallocating it every batch
+private:
+    //! Boxes of the whole batch as a structure of arrays, sample i owns [_box_offsets[i], _box_offsets[i+1])
+    std::vector<float> _box_l, _box_t, _box_r, _box_b;
+    std::vector<int> _box_keep;
+    std::vector<size_t> _box_offsets;
 };
 
 inline double MetaNode::BBoxIntersectionOverUnion(const BoundingBoxCord &box1, const BoundingBoxCord &box2, bool is_iou = false) const
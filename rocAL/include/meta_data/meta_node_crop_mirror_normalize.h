@@ -35,8 +35,5 @@ class CropMirrorNormalizeMetaNode:public MetaNode
         void update_parameters(MetaDataBatch* input_meta_data)override;
         std::shared_ptr<CropMirrorNormalizeNode> _node = nullptr;
     private:
-        void initialize();
         std::shared_ptr<RocalCropParam> _meta_crop_param;
-        vx_array _dstImgWidth, _dstImgHeight, _x1, _y1, _mirror, _src_width, _src_height;
-        std::vector<uint> _width_val, _height_val, _x1_val, _y1_val, _mirror_val,_src_width_val,_src_height_val;
 };
@@ -36,10 +36,4 @@ class FlipMetaNode:public MetaNode
         FlipMetaNode() {};
         void update_parameters(MetaDataBatch* input_meta_data)override;
         std::shared_ptr<FlipNode> _node = nullptr;
-    private:
-        void initialize();
-        vx_array _src_width, _src_height;
-        std::vector<uint> _src_width_val, _src_height_val;
-        vx_array _flip_axis;
-        std::vector<int> _flip_axis_val;
 };
\ No newline at end of file
@@ -34,7 +34,4 @@ class ResizeMetaNode:public MetaNode
         ResizeMetaNode() {};
         void update_parameters(MetaDataBatch* input_meta_data)override;
         std::shared_ptr<ResizeNode> _node = nullptr;
-    private:
-        void initialize();
-        std::vector<uint> _src_width_val, _src_height_val;
 };
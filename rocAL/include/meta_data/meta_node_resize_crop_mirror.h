@@ -35,10 +35,7 @@ class ResizeCropMirrorMetaNode:public MetaNode
         void update_parameters(MetaDataBatch* input_meta_data)override;
         std::shared_ptr<ResizeCropMirrorNode> _node = nullptr;
     private:
-        void initialize();
         std::shared_ptr<RocalCropParam> _meta_crop_param;
-        unsigned int _dst_width, _dst_height, _crop_w, _crop_h;
-        vx_array _x1, _y1, _x2, _y2, _mirror;
-        std::vector<uint> _x1_val, _y1_val, _x2_val, _y2_val, _mirror_val;
+        unsigned int _dst_width, _dst_height;
         float _dst_to_src_width_ratio, _dst_to_src_height_ratio;
 };
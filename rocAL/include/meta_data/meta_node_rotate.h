@@ -39,10 +39,5 @@ class RotateMetaNode:public MetaNode
         void update_parameters(MetaDataBatch* input_meta_data)override;
         std::shared_ptr<RotateNode> _node = nullptr;
     private:
-        void initialize();
-        vx_array _src_width, _src_height;
-        std::vector<uint> _src_width_val, _src_height_val;
         unsigned int _dst_width, _dst_height;
-        vx_array _angle;
-        std::vector<float> _angle_val;
 };
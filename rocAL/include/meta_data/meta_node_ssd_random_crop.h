@@ -43,11 +43,8 @@ public:
 
 private:
     std::shared_ptr<RocalRandomCropParam> _meta_crop_param;
-    vx_array _crop_width, _crop_height, _x1, _y1;
-    std::vector<uint> _crop_width_val, _crop_height_val, _x1_val, _y1_val;
     unsigned int _dst_width, _dst_height;
     float _threshold = 0.5;
     int   _num_of_attempts = 20;
     bool  _enitire_iou = true; // For entire_iou - true and For relative iou - false
-    void initialize();
 };
\ No newline at end of file
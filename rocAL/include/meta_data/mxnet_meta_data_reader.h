@@ -22,17 +22,16 @@ THE SOFTWARE.
 
 #pragma once
 #include <map>
-#include <dirent.h>
 #include <memory>
 #include <list>
 #include <variant>
-#include <fstream>
 #include <string>
 #include "commons.h"
 #include "meta_data.h"
 #include "meta_data_reader.h"
-#include "image_reader.h"
+#include "mxnet_recordio_index.h"
 
+//! Class labels of the records of MXNet RecordIO files, the first label of the multi-label records (with a warning)
 class MXNetMetaDataReader: public MetaDataReader
 {
 public :
@@ -51,16 +50,9 @@ private:
     void read_images();
     bool exists(const std::string &image_name) override;
     void add(std::string image_name, int label);
-    uint32_t DecodeFlag(uint32_t rec) {return (rec >> 29U) & 7U; };
-    uint32_t DecodeLength(uint32_t rec) {return rec & ((1U << 29U) - 1U); };
-    std::vector<std::tuple<int64_t, int64_t>> _indices; // used to store seek position and record size for a particular record.
-    std::ifstream _file_contents;
-    ImageRecordIOHeader _hdr;
-    const uint32_t _kMagic = 0xced7230a;
+    std::shared_ptr<const MXNetRecordIOIndex> _index;
     std::map<std::string, std::shared_ptr<MetaData>> _map_content;
     std::string _path;
-    DIR *_src_dir;
-    struct dirent *_entity;
     LabelBatch* _output;
     std::vector<std::string> _image_name;
 };
\ No newline at end of file
@@ -54,11 +54,12 @@ private:
     FloatParam* _scaling;
     int _total_num_attempts;
     int64_t _seed;
+    size_t _num_threads;
 public:
     RandomBBoxCrop_MetaDataConfig(const RandomBBoxCrop_MetaDataType& type, const RandomBBoxCrop_MetaDataReaderType& reader_type, const bool& all_boxes_overlap,
                         const bool& no_crop, FloatParam* aspect_ratio, const bool& has_shape, const int& crop_width, const int& crop_height, const int& num_attempts,
-                        FloatParam* scaling, const int& total_num_attempts, const int64_t& seed):  _type(type), _reader_type(reader_type), _all_boxes_overlap(all_boxes_overlap), _no_crop(no_crop), _aspect_ratio(aspect_ratio),
-                        _has_shape(has_shape), _crop_width(crop_width), _crop_height(crop_height), _num_attempts(num_attempts), _scaling(scaling), _total_num_attempts(total_num_attempts), _seed(seed){}
+                        FloatParam* scaling, const int& total_num_attempts, const int64_t& seed, size_t num_threads = 1):  _type(type), _reader_type(reader_type), _all_boxes_overlap(all_boxes_overlap), _no_crop(no_crop), _aspect_ratio(aspect_ratio),
+                        _has_shape(has_shape), _crop_width(crop_width), _crop_height(crop_height), _num_attempts(num_attempts), _scaling(scaling), _total_num_attempts(total_num_attempts), _seed(seed), _num_threads(num_threads){}
     RandomBBoxCrop_MetaDataConfig() = delete;
     RandomBBoxCrop_MetaDataType type() const { return _type; }
     RandomBBoxCrop_MetaDataReaderType reader_type() const { return _reader_type; }
@@ -72,6 +73,7 @@ public:
     int num_attempts() const { return _num_attempts; }
     int total_num_attempts() const { return _total_num_attempts; }
     int seed() const { return _seed; }
+    size_t num_threads() const { return _num_threads; }//!< CPU threads the crop windows of a batch are picked on
 };
 
 class RandomBBoxCrop_MetaDataReader
@@ -85,7 +87,7 @@ public:
     virtual void init(const RandomBBoxCrop_MetaDataConfig& cfg) = 0;
     virtual void read_all() = 0;// Reads all the meta data information
     virtual void lookup(const std::vector<std::string>& image_names) = 0;// finds meta_data info associated with given names and fills the output
-    virtual std::vector<std::vector <float>>  get_batch_crop_coords(const std::vector<std::string>& image_names) = 0; // returns the crop coords for a batch
+    virtual std::vector<std::vector <float>>  get_batch_crop_coords(const std::vector<std::string>& image_names, size_t epoch) = 0; // returns the crop coords for a batch, the same for the same names and epoch
     virtual void release() = 0; // Deletes the loaded information
     virtual void set_meta_data(std::shared_ptr<MetaDataReader> meta_data_reader) = 0;
     virtual CropCordBatch *get_output() = 0;
@@ -33,48 +33,14 @@ THE SOFTWARE.
 #include "caffe_meta_data_reader_detection.h"
 #include "caffe2_meta_data_reader_detection.h"
 #include "tf_meta_data_reader_detection.h"
-#include <random>
-
-// todo:: move this to common header
-template<typename T = std::mt19937, std::size_t state_size = T::state_size>
-class SeededRNG {
-  /*
-  * @param batch_size How many RNGs to store
-  * @param state_size How many seed are used to initialize one RNG. Used to lower probablity of
-  * collisions between seeds used to initialize RNGs in different operators.
-  */
-public:
-  SeededRNG (int batch_size = 128) {
-      std::random_device source;
-      _batch_size = batch_size;
-      std::size_t _random_data_size = state_size * batch_size ;
-      std::vector<std::random_device::result_type> random_data(_random_data_size);
-      std::generate(random_data.begin(), random_data.end(), std::ref(source));
-      _rngs.reserve(batch_size);
-      for (int i=0; i < (int)(_batch_size*state_size); i += state_size) {
-        std::seed_seq seeds(std::begin(random_data) + i, std::begin(random_data)+ i +state_size);
-        _rngs.emplace_back(T(seeds));
-      }
-  }
-
-  /**
-   * Returns engine corresponding to given sample ID
-   */
-   T &operator[](int sample) noexcept {
-    return _rngs[sample % _batch_size];
-  }
-
-private:
-    std::vector<T> _rngs;
-    int _batch_size;
-};
+#include "bbox_crop_sampler.h"
 
 class RandomBBoxCropReader: public RandomBBoxCrop_MetaDataReader
 {
 public:
     void init(const RandomBBoxCrop_MetaDataConfig& cfg) override;
     void lookup(const std::vector<std::string>& image_names) override;
-    std::vector<std::vector <float>>  get_batch_crop_coords(const std::vector<std::string>& image_names) override ;
+    std::vector<std::vector <float>>  get_batch_crop_coords(const std::vector<std::string>& image_names, size_t epoch) override;
     void read_all() override;
     void release() override;
     void print_map_contents();
@@ -88,7 +54,6 @@ public:
 
 private:
     std::shared_ptr<MetaDataReader> _meta_data_reader = nullptr;
-    std::map<std::string, std::shared_ptr<MetaData>> _meta_bbox_map_content;
     bool _all_boxes_overlap;
     bool _no_crop;
     bool _has_shape;
@@ -100,12 +65,10 @@ private:
     int _user_batch_size;
     int64_t _seed;
     void add(std::string image_name, BoundingBoxCord bbox);
-    std::vector<std::vector <float>> _crop_coords;
     bool exists(const std::string &image_name);
     std::map<std::string, std::shared_ptr<CropCord>> _map_content;
     std::map<std::string, std::shared_ptr<CropCord>>::iterator _itr;
     std::shared_ptr<Graph> _graph = nullptr;
     CropCordBatch* _output;
-    SeededRNG<std::mt19937, 4> _rngs;     // setting the state_size to 4 for 4 random parameters.
-    size_t _sample_cnt;
+    std::shared_ptr<BBoxCropSampler> _sampler = nullptr;
 };
@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <map>
+#include "commons.h"
+#include "meta_data.h"
+#include "meta_data_reader.h"
+#include "tar_shard_index.h"
+
+/*! \brief Labels (MetaDataType::Label) or boxes (MetaDataType::BoundingBox) of the samples of tar shards, read with the TarShardReader
+ *
+ * The label of a sample is the class index stored as text in its .cls member. The boxes are stored in its .json member as
+ * {"width": W, "height": H, "boxes": [[x, y, w, h], ...], "labels": [l, ...]}, the boxes in pixels like the COCO annotations.
+ */
+class TarShardMetaDataReader: public MetaDataReader
+{
+public:
+    void init(const MetaDataConfig& cfg) override;
+    void lookup(const std::vector<std::string>& image_names) override;
+    void read_all(const std::string& path) override;
+    void release() override;
+    bool set_timestamp_mode() override { return false; }
+    MetaDataBatch * get_output() override { return _output; }
+    const std::map<std::string, std::shared_ptr<MetaData>> & get_map_content() override { return _map_content; }
+    TarShardMetaDataReader();
+    ~TarShardMetaDataReader() override { delete _output; }
+private:
+    bool exists(const std::string &image_name) override;
+    void add_boxes(const std::string &key, std::string &json);
+    MetaDataBatch* _output = nullptr;
+    MetaDataType _type = MetaDataType::Label;
+    std::shared_ptr<const TarShardIndex> _index;
+    std::map<std::string, std::shared_ptr<MetaData>> _map_content;
+};
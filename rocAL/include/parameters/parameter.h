@@ -21,6 +21,8 @@ THE SOFTWARE.
 */
 
 #pragma once
+#include <cstddef>
+#include <cstdint>
 
 template <typename T>
 class Parameter
@@ -34,9 +36,25 @@ public:
     /// used to internally renew state of the parameter if needed (for random parameters)
     virtual void renew() {};
 
+    /// renews the parameter count times and writes the successive values, random parameters generate the whole batch at once
+    virtual void renew_batch(T* values, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            renew();
+            values[i] = get();
+        }
+    }
+
     virtual ~Parameter() {}
     ///
     /// \return returns if this parameter takes a single value (vs a range of values or many values)
     virtual bool single_value() const = 0;
+
+    /// Random parameters draw from their own stream of the seed's generator, 0 for the others
+    virtual unsigned stream() const { return 0; }
+    /// Number of values drawn from the stream so far, can be set back to resume a run
+    virtual uint64_t draw_position() const { return 0; }
+    virtual void set_draw_position(uint64_t position) {}
 };
 
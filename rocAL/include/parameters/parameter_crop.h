@@ -58,6 +58,7 @@ public:
         in_height = in_height_;
     }
     void set_random() {_random = true;}
+    bool is_random() const { return _random; }
     void set_fixed_crop(float anchor_x, float anchor_y) { _is_fixed_crop = true; _random = false; _crop_anchor[0] = anchor_x; _crop_anchor[1] = anchor_y;}
     void set_x_drift_factor(Parameter<float>* x_drift);
     void set_y_drift_factor(Parameter<float>* y_drift);
@@ -71,10 +72,12 @@ public:
     virtual void update_array() {};
     Parameter<float> * get_x_drift_factor() {return x_drift_factor;}
     Parameter<float> * get_y_drift_factor() {return y_drift_factor;}
-    std::vector<uint32_t> get_x1_arr_val() {return x1_arr_val;}
-    std::vector<uint32_t> get_y1_arr_val() {return y1_arr_val;}
-    std::vector<uint32_t> get_croph_arr_val() {return croph_arr_val;}
-    std::vector<uint32_t> get_cropw_arr_val() {return cropw_arr_val;}
+    const std::vector<uint32_t>& get_x1_arr_val() const {return x1_arr_val;}
+    const std::vector<uint32_t>& get_y1_arr_val() const {return y1_arr_val;}
+    const std::vector<uint32_t>& get_x2_arr_val() const {return x2_arr_val;}
+    const std::vector<uint32_t>& get_y2_arr_val() const {return y2_arr_val;}
+    const std::vector<uint32_t>& get_croph_arr_val() const {return croph_arr_val;}
+    const std::vector<uint32_t>& get_cropw_arr_val() const {return cropw_arr_val;}
     void get_crop_dimensions(std::vector<uint32_t> &crop_w_dim, std::vector<uint32_t> &crop_h_dim);
 protected:
     constexpr static float CROP_X_DRIFT_RANGE [2]  = {0.01, 0.99};
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <thread>
 #include <mutex>
 #include <memory>
+#include <vector>
 #include "parameter_random.h"
 #include "parameter_simple.h"
 
@@ -78,10 +79,16 @@ public:
     void set_seed(unsigned seed);
     unsigned get_seed();
     void generate_seed();
+    //! Id of the next random stream, every random parameter draws from its own stream of the seed's Philox generator
+    unsigned next_stream() { return ++_stream_count; }
+    //! (stream, values drawn) of every random parameter, sorted by stream
+    std::vector<std::pair<unsigned, uint64_t>> draw_positions();
+    //! Sets the random parameters back to positions returned by draw_positions() for the same pipeline
+    void set_draw_positions(const std::vector<std::pair<unsigned, uint64_t>> &positions);
 
     template<typename T>
     Parameter<T>* create_uniform_rand_param(T start, T end){
-        auto gen = new UniformRand<T>(start, end, _seed);
+        auto gen = new UniformRand<T>(start, end, _seed, next_stream());
         _parameters.insert(gen);
         return gen;
     }
@@ -106,6 +113,7 @@ public:
     FloatParam* create_single_value_float_param(float value);
 private:
     long long unsigned _seed;
+    unsigned _stream_count = 0;
     std::set<pParamCore> _parameters; //<! Keeps the random generators used to randomized the augmentation parameters
     static ParameterFactory* _instance;
     static std::mutex _mutex;
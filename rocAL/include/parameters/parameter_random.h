@@ -31,21 +31,25 @@ THE SOFTWARE.
 #include <vector>
 #include <thread>
 #include <random>
+#include <atomic>
+#include <mutex>
 #include "parameter.h"
+#include "philox.h"
 #include "log.h"
+//! Random values of a parameter are drawn in sequence from its own Philox stream, the n-th value only depends on (seed, stream, n)
 template <typename T>
 class UniformRand: public Parameter<T>
 {
 public:
 
-    UniformRand(T start, T end, unsigned seed = 0):_generator(seed)
+    UniformRand(T start, T end, unsigned seed = 0, unsigned stream = 0):_seed(seed), _stream(stream)
     {
         update(start, end);
         renew();
     }
 
-    explicit UniformRand(T start, unsigned seed = 0):
-            UniformRand(start, start, seed) {}
+    explicit UniformRand(T start, unsigned seed = 0, unsigned stream = 0):
+            UniformRand(start, start, seed, stream) {}
 
     T default_value() const override
     {
@@ -58,21 +62,36 @@ public:
     };
     void renew() override
     {
-        std::unique_lock<std::mutex> lock(_lock);
-        auto val =_generator();
-
+        uint32_t word = 0;
+        const uint64_t draw = _draws.fetch_add(1);
+        if(!single_value())
+            philox::fill(_seed, _stream, draw, &word, 1);
+        _updated_val = value(word);
+    }
+    void renew_batch(T* values, size_t count) override
+    {
         if(single_value())
         {
             // If there is only a single value possible for the random variable
             // don't waste time on calling the rand function , just return it.
+            std::fill(values, values + count, _start);
+            _draws.fetch_add(count);
             _updated_val = _start;
-        } else {
-            _updated_val = static_cast<T>(
-                    ((double)val / (double) _generator.max()) * ((double) _end - (double) _start) + (double) _start);
+            return;
         }
+        const uint64_t first = _draws.fetch_add(count);
+        uint32_t words[BATCH_CHUNK];
+        for(size_t i = 0; i < count; i += BATCH_CHUNK)
+        {
+            size_t chunk = std::min(count - i, BATCH_CHUNK);
+            philox::fill(_seed, _stream, first + i, words, chunk);
+            for(size_t j = 0; j < chunk; j++)
+                values[i + j] = value(words[j]);
+        }
+        if(count)
+            _updated_val = values[count - 1];
     }
     int update(T start, T end) {
-        std::unique_lock<std::mutex> lock(_lock);
         if(end < start)
             end = start;
 
@@ -84,12 +103,23 @@ public:
     {
         return (_start == _end);
     }
+    unsigned stream() const override { return _stream; }
+    uint64_t draw_position() const override { return _draws.load(); }
+    void set_draw_position(uint64_t position) override { _draws.store(position); }
 private:
+    T value(uint32_t word) const
+    {
+        if(single_value())
+            return _start;
+        return static_cast<T>(philox::unit(word) * ((double) _end - (double) _start) + (double) _start);
+    }
+    static constexpr size_t BATCH_CHUNK = 256;
     T _start;
     T _end;
     T _updated_val;
-    std::mt19937 _generator;
-    std::mutex _lock;
+    uint64_t _seed;
+    uint32_t _stream;
+    std::atomic<uint64_t> _draws = {0};//!< number of values drawn so far, position of the next one in the stream
 };
 
 
@@ -102,7 +132,7 @@ struct CustomRand: public Parameter<T>
     (
         const T values[],
         const double frequencies[],
-        size_t size, unsigned seed = 0):_generator(seed)
+        size_t size, unsigned seed = 0, unsigned stream = 0):_seed(seed), _stream(stream)
     {
         update(values, frequencies, size);
         renew();
@@ -161,25 +191,26 @@ struct CustomRand: public Parameter<T>
     }
     void renew() override
     {
-        std::unique_lock<std::mutex> lock(_lock);
-        if(single_value())
+        uint32_t word = 0;
+        const uint64_t draw = _draws.fetch_add(1);
+        if(!single_value())
+            philox::fill(_seed, _stream, draw, &word, 1);
+        _updated_val = value(word);
+    }
+    void renew_batch(T* values, size_t count) override
+    {
+        const uint64_t first = _draws.fetch_add(count);
+        uint32_t words[BATCH_CHUNK] = {};
+        for(size_t i = 0; i < count; i += BATCH_CHUNK)
         {
-            // If there is only a single value possible for the random variable
-            // don't waste time on calling the rand function , just return it.
-            _updated_val =  _values[0];
-        }
-        else {
-            // Generate a value between [0 1]
-            double rand_val = (double) _generator() / (double) _generator.max();
-
-            // Find the iterators pointing to the first element bigger than idx
-            auto it = std::upper_bound(_comltv_dist.begin(), _comltv_dist.end(), rand_val);
-
-            // Get the index and return the associated value
-            unsigned idx = std::distance(_comltv_dist.begin(), it);
-
-            _updated_val = _values[idx];
+            size_t chunk = std::min(count - i, BATCH_CHUNK);
+            if(!single_value())
+                philox::fill(_seed, _stream, first + i, words, chunk);
+            for(size_t j = 0; j < chunk; j++)
+                values[i + j] = value(words[j]);
         }
+        if(count)
+            _updated_val = values[count - 1];
     }
     T get() override
     {
@@ -190,12 +221,37 @@ struct CustomRand: public Parameter<T>
     {
         return (_values.size() == 1);
     }
+    unsigned stream() const override { return _stream; }
+    uint64_t draw_position() const override { return _draws.load(); }
+    void set_draw_position(uint64_t position) override { _draws.store(position); }
 private:
+    T value(uint32_t word) const
+    {
+        if(single_value())
+        {
+            // If there is only a single value possible for the random variable
+            // don't waste time on calling the rand function , just return it.
+            return _values[0];
+        }
+        // Generate a value between [0 1]
+        double rand_val = philox::unit(word);
+
+        // Find the iterators pointing to the first element bigger than idx
+        auto it = std::upper_bound(_comltv_dist.begin(), _comltv_dist.end(), rand_val);
+
+        // Get the index and return the associated value, clamped for rand_val == 1 hitting past the rounded last partial sum
+        unsigned idx = std::min<size_t>(std::distance(_comltv_dist.begin(), it), _values.size() - 1);
+
+        return _values[idx];
+    }
+    static constexpr size_t BATCH_CHUNK = 256;
     std::vector<T> _values;//!< Values
     std::vector<double> _frequencies;//!< Probabilities
     std::vector<double> _comltv_dist;//!< commulative probabilities
     double _mean;
     T _updated_val;
-    std::mt19937 _generator;
+    uint64_t _seed;
+    uint32_t _stream;
+    std::atomic<uint64_t> _draws = {0};
     std::mutex _lock;
 };
\ No newline at end of file
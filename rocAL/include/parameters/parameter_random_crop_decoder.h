@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "parameter_factory.h"
 #include <thread>
 #include <random>
+#include "philox.h"
 
 struct CropWindow {
   unsigned x, y, H, W;
@@ -45,19 +46,22 @@ class RocalRandomCropDecParam {
     int64_t seed = time(0),
     int num_attempts = 10,
     int batch_size = 256);
+  //! Crop window of the batch's sample at instance, only depends on the seed, the number of batches generated before and the instance
   CropWindow generate_crop_window(const Shape& shape, const int instance);
+  //! Moves on to the next batch's crop windows
   void generate_random_seeds();
+  //! Number of batches generated before, to resume a run
+  void set_batch_index(uint64_t batch_idx) { _batch_idx = batch_idx; }
  private:
-  CropWindow generate_crop_window_implementation(const Shape& shape);
+  CropWindow generate_crop_window_implementation(const Shape& shape, PhiloxEngine& rand_gen);
   AspectRatioRange _aspect_ratio_range;
   // Aspect ratios are uniformly distributed on logarithmic scale.
   // This provides natural symmetry and smoothness of the distribution.
   std::uniform_real_distribution<float> _aspect_ratio_log_dis;
   std::uniform_real_distribution<float> _area_dis;
-  // thread_local is needed to call it from multiple threads async, so each thread will have its own copy
-  static thread_local std::mt19937 _rand_gen;
   int64_t _seed;
-  std::vector<int> _seeds;
+  unsigned _stream;
+  uint64_t _batch_idx = 0;
   int _num_attempts;
   int _batch_size;
 };
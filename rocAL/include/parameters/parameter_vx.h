@@ -85,6 +85,11 @@ public:
     {
         return _array;
     }
+    //! Host copy of the values last written to default_array()
+    const std::vector<T>& default_array_values() const
+    {
+        return _arrVal;
+    }
     vx_scalar default_scalar(std::shared_ptr<Graph> _graph, vx_enum data_type)
     {
         _scalar = vxCreateScalar(vxGetContext((vx_reference)_graph->get()), data_type, &_val);
@@ -110,11 +115,7 @@ public:
     void update_array( )
     {
         vx_status status;
-        for (uint i=0; i < _batch_size ; i++ )
-        {
-            _arrVal[i] = renew();
-            //INFO("update_array: " + TOSTR(i) + "," + TOSTR(_arrVal[i]));
-        }
+        _param->renew_batch(_arrVal.data(), _batch_size);
         status = vxCopyArrayRange((vx_array)_array, 0, _batch_size, sizeof(T), _arrVal.data(), VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
         if(status != 0)
             THROW(" vxCopyArrayRange failed in update_array (ParameterVX): "+ TOSTR(status))
@@ -0,0 +1,113 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+/*! \brief Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+ *
+ * Every block of four 32-bit words is a pure function of the 64-bit key (the seed) and of a 128-bit counter,
+ * so the random values of a parameter can be computed in any order, from any thread and ahead of time, without sharing any state.
+ * The rocAL counter layout is {block, stream, sample (low), sample (high)}: the stream identifies the parameter and the sample the draw.
+ */
+namespace philox
+{
+const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+inline void round(uint32_t ctr[4], const uint32_t key[2])
+{
+    const uint64_t p0 = uint64_t(M0) * ctr[0];
+    const uint64_t p1 = uint64_t(M1) * ctr[2];
+    const uint32_t c0 = uint32_t(p1 >> 32) ^ ctr[1] ^ key[0];
+    const uint32_t c2 = uint32_t(p0 >> 32) ^ ctr[3] ^ key[1];
+    ctr[1] = uint32_t(p1);
+    ctr[3] = uint32_t(p0);
+    ctr[0] = c0;
+    ctr[2] = c2;
+}
+
+//! Encrypts the counter in place, it then holds the four random words of the block
+inline void block(uint32_t ctr[4], uint64_t seed)
+{
+    uint32_t key[2] = {uint32_t(seed), uint32_t(seed >> 32)};
+    for(unsigned r = 0; r < 10; r++)
+    {
+        if(r)
+        {
+            key[0] += W0;
+            key[1] += W1;
+        }
+        round(ctr, key);
+    }
+}
+
+//! Word n of a stream is word n % 4 of the block {0, stream, n / 4}, fills out with the words first .. first + count - 1 (AVX2 when built with ENABLE_SIMD)
+void fill(uint64_t seed, uint32_t stream, uint64_t first, uint32_t *out, size_t count);
+
+//! Maps a random word to [0, 1], the same way the std::mt19937 words were mapped before
+inline double unit(uint32_t word)
+{
+    return double(word) / double(std::numeric_limits<uint32_t>::max());
+}
+}
+
+/*! \brief UniformRandomBitGenerator over the blocks {1, 2, ..., stream, sample}, to be used with the std distributions
+ *
+ * Cheap to construct, one engine is meant to be created for every sample needing a variable amount of random values.
+ * The std distributions are implementation defined, uniform() and bounded() give the same values on every platform.
+ */
+class PhiloxEngine
+{
+public:
+    using result_type = uint32_t;
+    PhiloxEngine(uint64_t seed, uint32_t stream, uint64_t sample): _seed(seed), _stream(stream), _sample(sample) {}
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    result_type operator()()
+    {
+        if(_word == 4)
+        {
+            // Block 0 is the one philox::fill() uses for the same stream and sample
+            _block[0] = ++_block_idx;
+            _block[1] = _stream;
+            _block[2] = uint32_t(_sample);
+            _block[3] = uint32_t(_sample >> 32);
+            philox::block(_block, _seed);
+            _word = 0;
+        }
+        return _block[_word++];
+    }
+    //! Float in [0, 1) from the 24 high bits of the next word
+    float uniform() { return ((*this)() >> 8) * 0x1p-24f; }
+    //! Integer in [0, n) from the high half of the product of the next word and n
+    uint32_t bounded(uint32_t n) { return uint32_t((uint64_t((*this)()) * n) >> 32); }
+private:
+    uint64_t _seed;
+    uint32_t _stream;
+    uint64_t _sample;
+    uint32_t _block_idx = 0;
+    uint32_t _block[4];
+    unsigned _word = 4;
+};
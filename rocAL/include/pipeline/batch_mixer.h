@@ -0,0 +1,82 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*! \brief How the samples of an output batch are mixed */
+enum class BatchMixMode
+{
+    NONE = 0,//!< Samples are left as they are, only the (smoothed) one-hot labels are generated
+    MIXUP,//!< The two samples of a pair are alpha-blended
+    CUTMIX//!< A box of the same place is swapped between the two samples of a pair
+};
+
+/*! \brief Mixes the samples of the output batches in pairs and generates the matching soft labels
+ *
+ * Sample i is paired with sample n - 1 - i (the batch flipped, the way timm pairs them), so both samples of a pair are mixed in place
+ * in one pass without copying the batch. A pair is mixed with the given probability, its ratio lambda is drawn from Beta(alpha, alpha)
+ * (for CutMix the box covers 1 - lambda of the image, lambda is then corrected to the box clipped to the image).
+ * Labels are laid out the way rocalGetOneHotImageLabels() does it: label l in [1, num_classes] is class l - 1, label 0 the last class.
+ * The soft label of a sample is lambda x its smoothed one-hot label + (1 - lambda) x the one of its pair, smoothing being
+ * (1 - label_smoothing) x one-hot + label_smoothing / num_classes.
+ * The random values of a batch come from the Philox stream of the mixer keyed by the batch index, so runs with the same seed mix the same way.
+ * The Beta draws are done on the Philox words (Marsaglia and Tsang's gamma), not by the std distributions, so they do not change with the standard library.
+ */
+class BatchMixer
+{
+public:
+    BatchMixer(BatchMixMode mode, unsigned num_classes, float alpha, float probability, float label_smoothing, uint64_t seed, uint32_t stream);
+    unsigned num_classes() const { return _num_classes; }
+    //! Batches mixed so far, the random values of the next batch are keyed by it
+    uint64_t batch_count() const { return _batch_count; }
+    void set_batch_count(uint64_t batch_count) { _batch_count = batch_count; }
+    //! Number of threads the pairs of a batch are mixed on, the CPU thread count of the pipeline
+    void set_num_threads(size_t num_threads) { _num_threads = std::max<size_t>(num_threads, 1); }
+    //! Mixes a batch in place and writes its soft labels
+    /// \param images the output buffers of the batch (one per augmentation branch), each holding image_count images of width x height x depth bytes
+    /// \param planar true if the channels of an image are stored one after the other instead of interleaved
+    /// \param labels one label per image
+    /// \param soft_labels image_count x num_classes floats
+    void process(const std::vector<void *> &images, size_t image_count, size_t width, size_t height, size_t depth, bool planar,
+                 const std::vector<int> &labels, float *soft_labels);
+private:
+    struct PairMix
+    {
+        float lambda = 1.0f;
+        size_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;//!< CutMix box, in pixels
+    };
+    PairMix draw(uint64_t batch, size_t pair, size_t width, size_t height) const;
+    void one_hot(int label, float weight, float *soft_label) const;
+    const BatchMixMode _mode;
+    const unsigned _num_classes;
+    const float _alpha;
+    const float _probability;
+    const float _label_smoothing;
+    const uint64_t _seed;
+    const uint32_t _stream;
+    uint64_t _batch_count = 0;//!< Batches mixed so far, only used by the output routine
+    size_t _num_threads = 1;
+};
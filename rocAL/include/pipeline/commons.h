@@ -93,6 +93,7 @@ struct Timing
     long long unsigned copy_to_output = 0;
     long long unsigned image_process_time= 0;
     long long unsigned bb_process_time= 0;
+    long long unsigned meta_data_process_time= 0;
     long long unsigned mask_process_time= 0;
     long long unsigned label_load_time= 0;
     long long unsigned bb_load_time= 0;
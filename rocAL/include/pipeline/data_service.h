@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include "shm_batch_ring.h"
+
+class MasterGraph;
+
+/*! \brief Runs a built pipeline as the node-local rocAL service, publishing its output batches to the training processes (ranks) of the host
+ *
+ * One process reads, decodes and augments for all the ranks: batch b of an epoch goes to rank b % rank_count through the ShmBatchRing
+ * of that rank, where the client pipeline of the rank (rocalServiceSource) picks it up. Every rank gets the same number of batches
+ * per epoch, the batches of the epoch that do not make a full round over the ranks are dropped. The rings are created once the first
+ * batch is processed, since its meta data type is then known. Their names and meta data region is sized for the longest name and
+ * the most boxes of the meta data reader's samples, so a batch never overflows it while serving.
+ */
+class DataService
+{
+public:
+    DataService(MasterGraph *master_graph, size_t batch_size, const std::string &service_name, unsigned rank_count, unsigned ring_depth);
+    //! Publishes epoch_count epochs (0 for no end), the caller is blocked till then; the rings are then closed
+    void serve(unsigned epoch_count);
+private:
+    void create_rings(size_t epoch_batch_count);
+    void publish(size_t rank);
+    MasterGraph *_master_graph;
+    const size_t _batch_size;
+    const std::string _service_name;
+    const unsigned _rank_count;
+    const unsigned _ring_depth;
+    std::vector<std::shared_ptr<ShmBatchRing>> _rings;
+};
@@ -34,6 +34,8 @@ public:
     Status verify();
     Status process();
     Status release();
+    //! Changes the CPU threads the nodes run with, the graph is verified again so that the nodes pick up the new count
+    Status set_cpu_num_threads(size_t cpu_num_threads);
     vx_graph get() { return _graph; }
 private:
     RocalMemType _mem_type;
@@ -173,6 +173,8 @@ struct Image
     int create_from_handle(vx_context context);
     int create_virtual(vx_context context, vx_graph graph);
     bool is_handle_set() { return (vx_handle != 0); }
+    //! Releases the OpenVX image, the image cannot be used in a graph anymore
+    void release();
 
 private:
     vx_image vx_handle = nullptr;//!< The OpenVX image
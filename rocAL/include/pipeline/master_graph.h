@@ -25,6 +25,10 @@ THE SOFTWARE.
 #include <list>
 #include <variant>
 #include <map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
 #include "graph.h"
 #include "ring_buffer.h"
 #include "timing_debug.h"
@@ -36,6 +40,8 @@ THE SOFTWARE.
 #include "node_video_loader.h"
 #include "node_video_loader_single_shard.h"
 #include "node_cifar10_loader.h"
+#include "node_service_loader.h"
+#include "node_ssd_random_crop.h"
 #include "meta_data_reader.h"
 #include "meta_data_graph.h"
 #if ENABLE_HIP
@@ -44,6 +50,10 @@ THE SOFTWARE.
 #endif
 #include "randombboxcrop_meta_data_reader.h"
 #include "rocal_api_types.h"
+#include "numa_topology.h"
+#include "batch_mixer.h"
+#include "pipeline_autotuner.h"
+#include "pipeline_state.h"
 #define MAX_STRING_LENGTH 100
 class MasterGraph
 {
@@ -69,6 +79,10 @@ public:
     RocalColorFormat output_color_format();
     Status build();
     Status run();
+    //! Same as run() if it would not block, otherwise sets ran to false and returns right away
+    Status try_run(bool &ran);
+    bool next_output_ready();//!< True if run() would return without waiting for the internal thread
+    int output_ready_fd();//!< File descriptor readable when next_output_ready() may be true, -1 if not supported
     Timing timing();
     RocalMemType mem_type();
     void release();
@@ -85,21 +99,59 @@ public:
     MetaDataBatch *create_caffe2_lmdb_record_meta_data_reader(const char *source_path, MetaDataReaderType reader_type,  MetaDataType label_type);
     MetaDataBatch* create_cifar10_label_reader(const char *source_path, const char *file_prefix);
     MetaDataBatch *create_mxnet_label_reader(const char *source_path, bool is_output);
+    MetaDataBatch *create_synthetic_meta_data_reader(const SyntheticDataConfig &synthetic_config, MetaDataType label_type, bool is_output);
+    MetaDataBatch *create_tar_shard_meta_data_reader(const char *source_path, MetaDataType label_type, bool is_output);
+    //! Meta data published by the rocAL service in the ring of the given segment, always part of the output
+    MetaDataBatch *create_service_meta_data_reader(const std::string &segment, MetaDataType label_type);
     void box_encoder(std::vector<float> &anchors, float criteria, const std::vector<float> &means, const std::vector<float> &stds, bool offset, float scale);
+    void keypoint_heatmaps(unsigned heatmap_width, unsigned heatmap_height);
+    //! Mixes the samples of the output batches and generates their soft labels, see BatchMixer
+    void batch_mix(BatchMixMode mode, unsigned num_classes, float alpha, float probability, float label_smoothing);
     void create_randombboxcrop_reader(RandomBBoxCrop_MetaDataReaderType reader_type, RandomBBoxCrop_MetaDataType label_type, bool all_boxes_overlap, bool no_crop, FloatParam* aspect_ratio, bool has_shape, int crop_width, int crop_height, int num_attempts, FloatParam* scaling, int total_num_attempts, int64_t seed=0);
     const std::pair<ImageNameBatch,pMetaDataBatch>& meta_data();
+    //! Keeps the output batch returned by the last run() in the ring buffer so that it can be accessed in place, till release_output_batch() is called
+    uint64_t acquire_output_batch();
+    void release_output_batch(uint64_t lease);
+    std::vector<void*> output_batch_buffers(uint64_t lease);//!< One buffer per augmentation branch, on the device if the graph runs on the GPU
+    const std::pair<ImageNameBatch,pMetaDataBatch>& output_batch_meta_data(uint64_t lease);
+    std::pair<void*, void*> output_batch_encoded_boxes(uint64_t lease);
+    std::pair<void*, void*> output_batch_heatmaps(uint64_t lease);
+    void* output_batch_soft_labels(uint64_t lease);
     void set_loop(bool val) { _loop = val; }
+    void set_shard_scheduling(ShardScheduling scheduling, bool share_decode_threads);
+    void set_numa_placement(bool enable, int output_numa_node, const std::vector<int> &shard_numa_nodes);
+    //! Tunes the decode threads, graph threads and prefetch depth during the first tuning_batch_count batches, see PipelineAutotuner
+    /*! memory_budget: bytes the prefetch buffers of the loader may take across all its shards, 0 for no limit besides MAX_AUTOTUNE_PREFETCH_DEPTH */
+    void set_autotune(bool enable, size_t tuning_batch_count, size_t memory_budget);
+    //! Returns true once tuning is done, config is the best configuration measured so far and batches_per_second what it delivered
+    bool autotune_result(AutotuneConfig &config, double &batches_per_second);
+    //! Keeps the state after every batch so that save_state() can be called, should be called before build()
+    void set_state_tracking(bool enable);
+    //! State of the pipeline after the last batch handed out by run(), see PipelineState
+    PipelineState save_state();
+    //! Resumes from a saved state: should be called before the loader is created, the rest is applied by build()
+    void load_state(const PipelineState &state);
+    //! Changes the size of the output images from the next epoch on (from the first batch if called before build()), within the size they were created with
+    void set_output_size(unsigned width, unsigned height);
     void set_output_images(const std::vector<Image*> &output_images, unsigned int num_of_outputs)
     {
         _output_images.resize(num_of_outputs);
         _output_images = output_images;
     }
     void set_output(Image* output_image);
+    //! Makes the video loader or sequence reader writing input load only the frames of new_order of each sequence, into the returned image of the given info
+    /*! Returns nullptr if input is not written by such a loader or is already used by another node, the rearrangement is then left to a graph node.
+     *  Otherwise input is released and cannot be used anymore, adding a node reading it or setting it as an output throws */
+    Image *fold_sequence_rearrange(Image *input, const ImageInfo &info, const std::vector<unsigned> &new_order);
+    //! Has the loader pick the crop windows of the SSD random crop node while it loads the batches, only done for the first such node
+    void set_ssd_random_crop_sampler(std::shared_ptr<SSDRandomCropNode> node);
     size_t calculate_cpu_num_threads(size_t shard_count);
     bool empty() { return (remaining_count() < (_is_sequence_reader_output ? _sequence_batch_size : _user_batch_size)); }
     size_t sequence_batch_size() { return _sequence_batch_size; }
     std::shared_ptr<MetaDataGraph> meta_data_graph() { return _meta_data_graph; }
     std::shared_ptr<MetaDataReader> meta_data_reader() { return _meta_data_reader; }
+    //! Boxes of every sample of the output meta data once encoded, 0 without a box encoder
+    size_t box_encoder_anchor_count() { return _is_box_encoder ? _num_anchors : 0; }
     bool is_random_bbox_crop() {return _is_random_bbox_crop; }
     void set_video_loader_flag() { _is_video_loader = true; }
     bool is_video_loader() {return _is_video_loader; }
@@ -111,6 +163,8 @@ public:
         _sequence_batch_size = _user_batch_size * sequence_length;
     }
     Status get_bbox_encoded_buffers(float **boxes_buf_ptr, int **labels_buf_ptr, size_t num_encoded_boxes);
+    Status get_keypoint_heatmap_buffers(float **heatmaps_buf_ptr, float **target_weights_buf_ptr);
+    Status get_soft_label_buffer(float **soft_labels_buf_ptr);
     size_t bounding_box_batch_count(int* buf, pMetaDataBatch meta_data_batch);
 #if ENABLE_OPENCL
     cl_command_queue get_ocl_cmd_q() { return _device.resources()->cmd_queue; }
@@ -122,6 +176,19 @@ private:
     void create_single_graph();
     void start_processing();
     void stop_processing();
+    void set_processing(bool processing);
+    void wait_for_next_epoch();
+    void reset_loaders();
+    void place_output_thread();
+    size_t loader_prefetch_queue_depth(Image *loader_output);//!< Depth the loader buffers are allocated with
+    void start_autotune();
+    void autotune(double output_wait, double load_wait, double process);//!< Called by the output routine for every batch
+    void apply_autotune_config(const AutotuneConfig &config);
+    void apply_output_size();//!< Applies the size given to set_output_size(), called while the output routine is not processing
+    void compact_output_images(const std::vector<void*> &buffers);//!< Packs the output images of the ring buffer slot to the current output size
+    void start_state_tracking();//!< Applies the state given to load_state()
+    PipelineState current_state();//!< Called while the output routine is not running or by it
+    void hand_out_batch_state(bool pop);//!< Called by run() as the user moves on to the next batch
     void output_routine();
     void output_routine_video();
     void decrease_image_count();
@@ -136,11 +203,17 @@ private:
     CropCordBatch* _random_bbox_crop_cords_data = nullptr;
     std::thread _output_thread;
     ImageInfo _output_image_info;//!< Keeps the information about ROCAL's output image , it includes all images of a batch stacked on top of each other
+    size_t _output_width = 0, _output_height = 0;//!< Size of a single output image, smaller than the one of _output_image_info once set_output_size() has been applied
+    bool _output_size_pending = false;
+    unsigned _pending_output_width = 0, _pending_output_height = 0;
+    void *_output_compact_buffer = nullptr;//!< Device scratch buffer used to pack the output images when they are smaller than their allocation, as large as the allocation
     std::vector<Image*> _output_images;//!< Keeps the ovx images that are used to store the augmented output (there is an image per augmentation branch)
     std::list<Image*> _internal_images;//!< Keeps all the ovx images (virtual/non-virtual) either intermediate images, or input images that feed the graph
+    std::list<Image*> _consumed_images;//!< Loader images replaced by the image of a sequence rearrangement folded into the loader, nothing writes them anymore
     std::list<std::shared_ptr<Node>> _nodes;//!< List of all the nodes
     std::list<std::shared_ptr<Node>> _root_nodes;//!< List of all root nodes (image/video loaders)
     std::list<std::shared_ptr<Node>> _meta_data_nodes;//!< List of nodes where meta data has to be updated after augmentation
+    std::shared_ptr<SSDRandomCropNode> _loader_sampled_ssd_node = nullptr;//!< The SSD random crop node whose windows are picked by the loader
     std::map<Image*, std::shared_ptr<Node>> _image_map;//!< key: image, value : Parent node
     void * _output_tensor;//!< In the GPU processing case , is used to convert the U8 samples to float32 before they are being transfered back to host
 #if ENABLE_HIP
@@ -156,20 +229,32 @@ private:
 #ifdef ROCAL_VIDEO
     pVideoLoaderModule _video_loader_module; //!< Keeps the video loader module used to feed the input sequences of the graph
 #endif
-    TimingDBG _convert_time, _process_time, _bencode_time;
+    TimingDBG _convert_time, _process_time, _bencode_time, _meta_data_time;
     const size_t _user_batch_size;//!< Batch size provided by the user
     vx_context _context;
     const RocalMemType _mem_type;//!< Is set according to the _affinity, if GPU, is set to CL, otherwise host
     std::shared_ptr<MetaDataReader> _meta_data_reader = nullptr;
     std::shared_ptr<MetaDataGraph> _meta_data_graph = nullptr;
     std::shared_ptr<RandomBBoxCrop_MetaDataReader> _randombboxcrop_meta_data_reader = nullptr;
-    bool _first_run = true;
+    std::atomic<bool> _first_run = {true};//!< Read by the output routine too, when signaling the output ready eventfd
     bool _processing;//!< Indicates if internal processing thread should keep processing or not
     const static unsigned SAMPLE_SIZE = sizeof(unsigned char);
     int _remaining_count;//!< Keeps the count of remaining images yet to be processed for the user,
     bool _loop;//!< Indicates if user wants to indefinitely loops through images or not
     size_t _prefetch_queue_depth;
+    ShardScheduling _shard_scheduling = ShardScheduling::ROUND_ROBIN;//!< Applies to the loaders running multiple internal shards
+    bool _share_decode_threads = false;//!< If true the decode threads of the internal shards are shared between them
+    std::vector<std::vector<unsigned>> _numa_shard_cpus;//!< CPUs of the NUMA node each loader shard is placed on, empty if NUMA placement is off
+    std::vector<unsigned> _numa_output_cpus;//!< CPUs of the NUMA node the output thread and the ring buffer are placed on
+    bool _output_buffers_placed = false;
     bool _output_routine_finished_processing = false;
+    bool _output_routine_parked = false;//!< Set by the internal thread when it is waiting for reset() at the end of data, guarded by _epoch_lock
+    std::mutex _epoch_lock;
+    std::condition_variable _epoch_cv;//!< Wakes up the internal thread parked at the end of data on reset() or stop_processing()
+    std::atomic<int> _output_ready_fd = {-1};//!< eventfd signaled when a processed batch makes the next output ready, created on the first output_ready_fd() call
+    std::mutex _output_ready_fd_lock;
+    void signal_output_ready();
+    void update_output_ready();
     const RocalTensorDataType _out_data_type;
     bool _is_random_bbox_crop = false;
     bool _is_video_loader = false; //!< Set to true if Video Loader is invoked.
@@ -182,6 +267,26 @@ private:
     bool _is_box_encoder = false; //bool variable to set the box encoder
     std::vector<float> _anchors; // Anchors to be used for encoding, as the array of floats is in the ltrb format of size 8732x4
     size_t _num_anchors;       // number of bbox anchors
+    bool _is_keypoint_heatmap = false;//!< Set if the key point heatmaps and target weights are generated for the output batches
+    unsigned _heatmap_width = 0, _heatmap_height = 0;
+    float _pose_sigma = 0;//!< Sigma of the heatmap gaussians, given to the key points reader
+    unsigned _pose_output_width = 0, _pose_output_height = 0;//!< Size of the output image the joints are transformed to
+    std::unique_ptr<BatchMixer> _batch_mixer = nullptr;//!< Set if the output batches are mixed and get soft labels
+    static const size_t MAX_AUTOTUNE_PREFETCH_DEPTH = 8;
+    size_t _autotune_batch_count = 0;//!< Batches the pipeline is tuned on, 0 if autotuning is off
+    size_t _autotune_memory_budget = 0;
+    size_t _autotune_prefetch_depth = 0;//!< Prefetch depth the loader buffers were allocated with, the most the autotuner can pick
+    size_t _autotune_loader_buffer_size = 0;//!< Size of one loader buffer, of one shard
+    std::unique_ptr<PipelineAutotuner> _autotuner = nullptr;
+    AutotuneConfig _autotune_applied;//!< Configuration the pipeline runs with
+    std::mutex _autotune_lock;//!< Guards _autotuner between the output routine and autotune_result()
+    std::unique_ptr<PipelineState> _start_state = nullptr;//!< Set by load_state()
+    bool _state_tracking_enabled = false;//!< Set by set_state_tracking() and load_state()
+    bool _track_state = false;//!< Set by build() if state tracking is enabled and the loader can be resumed from a position
+    uint64_t _processed_batch_count = 0;//!< Batches processed since the pipeline was built, only used by the output routine
+    std::deque<PipelineState> _batch_states;//!< State after each batch of the ring buffer, the first one is the batch the user has
+    PipelineState _resume_state;//!< State after the last batch handed out by run()
+    std::mutex _state_lock;//!< Guards _batch_states and _resume_state
     float _criteria = 0.5; // Threshold IoU for matching bounding boxes with anchors. The value needs to be between 0 and 1.
     float _scale; // Rescales the box and anchor values before the offset is calculated (for example, to return to the absolute values).
     bool _offset; // Returns normalized offsets ((encoded_bboxes*scale - anchors*scale) - mean) / stds in EncodedBBoxes that use std and the mean and scale arguments if offset="True"
@@ -195,6 +300,9 @@ private:
 template <typename T>
 std::shared_ptr<T> MasterGraph::add_node(const std::vector<Image *> &inputs, const std::vector<Image *> &outputs)
 {
+    for(auto& input: inputs)
+        if(std::find(_consumed_images.begin(), _consumed_images.end(), input) != _consumed_images.end())
+            THROW("Input image is consumed by the sequence rearrangement folded into its loader, use the output of the rearrangement instead")
     auto node = std::make_shared<T>(inputs, outputs);
     _nodes.push_back(node);
 
@@ -238,7 +346,11 @@ template<> inline std::shared_ptr<ImageLoaderNode> MasterGraph::add_node(const s
     auto node = std::make_shared<ImageLoaderNode>(outputs[0], nullptr);
 #endif
     _loader_module = node->get_loader_module();
-    _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_prefetch_queue_depth(loader_prefetch_queue_depth(outputs[0]));
+    _loader_module->set_numa_placement(_numa_shard_cpus);
+    if(_start_state)
+        _loader_module->set_start_position(_start_state->loader);
+    _loader_module->set_shard_scheduling(_shard_scheduling, _share_decode_threads);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
         _image_map.insert(std::make_pair(output, node));
@@ -255,7 +367,10 @@ template<> inline std::shared_ptr<ImageLoaderSingleShardNode> MasterGraph::add_n
     auto node = std::make_shared<ImageLoaderSingleShardNode>(outputs[0], nullptr);
 #endif    
     _loader_module = node->get_loader_module();
-    _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_prefetch_queue_depth(loader_prefetch_queue_depth(outputs[0]));
+    _loader_module->set_numa_placement(_numa_shard_cpus);
+    if(_start_state)
+        _loader_module->set_start_position(_start_state->loader);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
         _image_map.insert(std::make_pair(output, node));
@@ -272,7 +387,11 @@ template<> inline std::shared_ptr<FusedJpegCropNode> MasterGraph::add_node(const
     auto node = std::make_shared<FusedJpegCropNode>(outputs[0], nullptr);
 #endif
     _loader_module = node->get_loader_module();
-    _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_prefetch_queue_depth(loader_prefetch_queue_depth(outputs[0]));
+    _loader_module->set_numa_placement(_numa_shard_cpus);
+    if(_start_state)
+        _loader_module->set_start_position(_start_state->loader);
+    _loader_module->set_shard_scheduling(_shard_scheduling, _share_decode_threads);
     _loader_module->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
@@ -291,7 +410,10 @@ template<> inline std::shared_ptr<FusedJpegCropSingleShardNode> MasterGraph::add
     auto node = std::make_shared<FusedJpegCropSingleShardNode>(outputs[0], nullptr);
 #endif    
     _loader_module = node->get_loader_module();
-    _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_prefetch_queue_depth(loader_prefetch_queue_depth(outputs[0]));
+    _loader_module->set_numa_placement(_numa_shard_cpus);
+    if(_start_state)
+        _loader_module->set_start_position(_start_state->loader);
     _loader_module->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
@@ -314,6 +436,33 @@ template<> inline std::shared_ptr<Cifar10LoaderNode> MasterGraph::add_node(const
 #endif
     _loader_module = node->get_loader_module();
     _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_numa_placement(_numa_shard_cpus);
+    if(_start_state)
+        _loader_module->set_start_position(_start_state->loader);
+    _root_nodes.push_back(node);
+    for(auto& output: outputs)
+        _image_map.insert(std::make_pair(output, node));
+
+    return node;
+}
+
+/*
+ * Explicit specialization for ServiceLoaderNode
+ */
+template<> inline std::shared_ptr<ServiceLoaderNode> MasterGraph::add_node(const std::vector<Image*>& inputs, const std::vector<Image*>& outputs)
+{
+    if(_loader_module)
+        THROW("A loader already exists, cannot have more than one loader")
+#if ENABLE_HIP || ENABLE_OPENCL
+    auto node = std::make_shared<ServiceLoaderNode>(outputs[0], (void *)_device.resources());
+#else
+    auto node = std::make_shared<ServiceLoaderNode>(outputs[0], nullptr);
+#endif
+    _loader_module = node->get_loader_module();
+    _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_numa_placement(_numa_shard_cpus);
+    if(_start_state)
+        _loader_module->set_start_position(_start_state->loader);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
         _image_map.insert(std::make_pair(output, node));
@@ -38,10 +38,17 @@ public:
     void update_parameters();
     std::vector<Image*> input() { return _inputs; };
     std::vector<Image*> output() { return _outputs; };
+    //! Host copy of the per image widths / heights written to the ROI arrays of the node input on the last update
+    const std::vector<uint32_t>& get_src_roi_width_values() const { return _inputs[0]->info().get_roi_width_vec(); }
+    const std::vector<uint32_t>& get_src_roi_height_values() const { return _inputs[0]->info().get_roi_height_vec(); }
     void add_next(const std::shared_ptr<Node>& node) {} // To be implemented
     void add_previous(const std::shared_ptr<Node>& node) {} //To be implemented
     std::shared_ptr<Graph> graph() { return _graph; }
     void set_meta_data(MetaDataBatch* meta_data_info){_meta_data_info = meta_data_info;}
+    //! True if the node can change the size of the images it writes once the graph is built, see set_output_size()
+    virtual bool output_size_adjustable() const { return false; }
+    //! Makes the node write images of up to width x height, within the dimensions of its output image, from its next update on
+    virtual void set_output_size(unsigned width, unsigned height) {}
     bool _is_ssd = false;
 protected:
     virtual void create_node() = 0;
@@ -0,0 +1,48 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <map>
+#include <vector>
+#include <string>
+
+/*! \brief NUMA topology of the host, read from sysfs (/sys/devices/system/node)
+ *
+ * If the topology can't be read (non Linux hosts, containers without sysfs) the host is seen as a single node 0 with all the CPUs.
+ */
+class NumaTopology
+{
+public:
+    NumaTopology();
+    size_t node_count() const { return _node_cpus.size(); }
+    std::vector<int> nodes() const;
+    bool has_node(int node) const { return _node_cpus.find(node) != _node_cpus.end(); }
+    const std::vector<unsigned> &cpus(int node) const;
+    //! Returns the node of the CPU the calling thread is running on
+    int current_node() const;
+    //! Restricts the calling thread (and the threads it creates after this call, e.g. its OpenMP team) to the given CPUs
+    static bool bind_current_thread(const std::vector<unsigned> &cpus);
+    //! Parses a sysfs cpu list such as "0-15,32-47"
+    static std::vector<unsigned> parse_cpu_list(const std::string &cpu_list);
+private:
+    std::map<int, std::vector<unsigned>> _node_cpus;
+};
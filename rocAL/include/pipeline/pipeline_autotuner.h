@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <string>
+#include <cstddef>
+
+/*! \brief The runtime knobs of a pipeline the autotuner picks */
+struct AutotuneConfig
+{
+    size_t decode_threads = 1;//!< Decode threads of each loader shard
+    size_t graph_threads = 1;//!< CPU threads the graph nodes run with
+    size_t prefetch_depth = 2;//!< Batches each loader shard loads ahead, buffers included
+    bool operator==(const AutotuneConfig &other) const
+    {
+        return decode_threads == other.decode_threads && graph_threads == other.graph_threads && prefetch_depth == other.prefetch_depth;
+    }
+    bool operator!=(const AutotuneConfig &other) const { return !(*this == other); }
+    std::string to_string() const;
+};
+
+/*! \brief Tunes the decode threads, graph threads and prefetch depth of a pipeline while it runs, for the most output batches per second
+ *
+ * Fed with the time the output routine spends per batch waiting for a free output slot (the user is the bottleneck), waiting for the
+ * loader (decoding is) and processing (the graph is). Batches are measured in windows, the first window and the batches right after a
+ * change are left out since the loaders and caches are still settling. After each window the knob of the current bottleneck is raised
+ * (decode threads, then prefetch depth for the loader, graph threads for the graph); the change is kept if the window gets at least
+ * MIN_GAIN faster, otherwise the previous configuration is restored and that knob is not tried again till another change is kept. Tuning stops when the user is the
+ * bottleneck, when no knob is left or after tuning_batch_count batches, leaving the best configuration measured in place.
+ */
+class PipelineAutotuner
+{
+public:
+    //! Knobs start at initial and are raised up to max
+    PipelineAutotuner(const AutotuneConfig &initial, const AutotuneConfig &max, size_t tuning_batch_count);
+    //! Times of one output batch in seconds, returns true if config() changed and should be applied before the next batch
+    bool add_batch(double output_wait, double load_wait, double process);
+    const AutotuneConfig &config() const { return _config; }
+    const AutotuneConfig &best() const { return _best; }
+    double best_rate() const { return _best_rate; }//!< Batches per second delivered with best(), 0 till the first window is measured
+    bool done() const { return _done; }
+private:
+    enum class Knob { DECODE_THREADS = 0, PREFETCH_DEPTH, GRAPH_THREADS };
+    static const size_t KNOB_COUNT = 3;
+    static const size_t WINDOW_BATCH_COUNT = 8;
+    static const size_t SETTLE_BATCH_COUNT = 2;//!< Batches left out after a change
+    static constexpr double MIN_GAIN = 0.03;
+    static constexpr double CONSUMER_BOUND_SHARE = 0.5;//!< Share of the time waiting for the user above which nothing is left to gain
+    bool end_window();
+    bool raise(Knob knob);
+    static size_t &knob_value(AutotuneConfig &config, Knob knob);
+    AutotuneConfig _config, _best, _max;
+    const size_t _tuning_batch_count;
+    size_t _batch_count = 0;
+    size_t _settle_count = WINDOW_BATCH_COUNT;//!< The whole first window is left out
+    size_t _window_batch_count = 0;
+    double _window_output_wait = 0, _window_load_wait = 0, _window_process = 0;
+    double _best_rate = 0;
+    double _best_load_share = 0, _best_process_share = 0, _best_output_share = 0;//!< Where the time went with best()
+    bool _trial = false;//!< _config differs from _best in _trial_knob and is being measured
+    Knob _trial_knob = Knob::DECODE_THREADS;
+    bool _exhausted[KNOB_COUNT] = {};
+    bool _done = false;
+};
@@ -0,0 +1,47 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "loader_module.h"
+
+/*! \brief Where a pipeline is in its data and in its random streams, saved to resume a preempted run
+ *
+ * Taken for every output batch once it is processed, the state of the last batch handed to the user is the one saved:
+ * the batches prefetched past it are loaded and processed again when the run is resumed. The pipeline resumed has to be
+ * created the same way (same sources, internal shard count and augmentations) after the state is loaded, as the random
+ * parameters are matched by their stream.
+ */
+struct PipelineState
+{
+    uint64_t seed = 0;//!< Seed of the ParameterFactory, the random parameters and the reader shuffles derive from it
+    uint64_t batch_count = 0;//!< Batches processed since the pipeline was built, in all the epochs
+    LoaderPosition loader;
+    std::vector<std::pair<unsigned, uint64_t>> parameter_draws;//!< (stream, values drawn) of every random parameter
+    //! Samples of the current epoch handed to the user
+    size_t epoch_sample_offset(size_t batch_size) const;
+    //! Compact, versioned binary form
+    std::vector<unsigned char> serialize() const;
+    static PipelineState deserialize(const unsigned char *data, size_t size);
+};
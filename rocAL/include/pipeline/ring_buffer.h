@@ -23,11 +23,12 @@ THE SOFTWARE.
 #pragma once
 #include "commons.h"
 #include <vector>
-#include <condition_variable>
+#include <mutex>
+#include <atomic>
 #if ENABLE_OPENCL
 #include <CL/cl.h>
 #endif
-#include <queue>
+#include "slot_ring.h"
 #include "meta_data.h"
 #include "device_manager.h"
 #include "commons.h"
@@ -40,19 +41,30 @@ public:
     explicit RingBuffer(unsigned buffer_depth);
     ~RingBuffer();
     size_t level();
+    //! Number of batches the reader can get without blocking: the batches pushed, less the ones popped by the user and still leased
+    size_t readable_count();
     bool empty();
+    bool full();//!< True when the producer has no slot left to write, the popped slots still leased included
     ///\param mem_type
     ///\param dev
     ///\param sub_buffer_size
     ///\param sub_buffer_count
     void init(RocalMemType mem_type, void *dev, unsigned sub_buffer_size, unsigned sub_buffer_count);
     void initBoxEncoderMetaData(RocalMemType mem_type, size_t encoded_bbox_size, size_t encoded_labels_size);
+    //! Allocates the host side buffers of the key point heatmaps and target weights of each slot
+    void initKeyPointHeatmapMetaData(size_t heatmaps_size, size_t target_weights_size);
+    //! Allocates the host side buffer of the soft labels of each slot
+    void initSoftLabelMetaData(size_t soft_labels_size);
     void release_gpu_res();
     std::vector<void*> get_read_buffers() ;
     void* get_host_master_read_buffer();
     std::vector<void*> get_write_buffers();
     std::pair<void*, void*> get_box_encode_write_buffers();
     std::pair<void*, void*> get_box_encode_read_buffers();
+    std::pair<void*, void*> get_heatmap_write_buffers();
+    std::pair<void*, void*> get_heatmap_read_buffers();
+    void* get_soft_label_write_buffer();
+    void* get_soft_label_read_buffer();
     MetaDataNamePair& get_meta_data();
     void set_meta_data(ImageNameBatch names, pMetaDataBatch meta_data);
     void reset();
@@ -65,29 +77,42 @@ public:
     void block_if_empty();
     void block_if_full();
     void release_if_empty();
+    void first_touch();// Writes the host buffers from the calling thread, so that their pages are placed on its NUMA node
+    //! Keeps the slot of the current read batch from being handed back to the producer by pop() till release_read_slot() is called
+    /// \return the lease id used to access the slot, it stays valid across reset(), the slot is kept from the producer till it is released.
+    /// The id carries a generation next to the slot index, a released id is rejected even once the slot holds a new batch
+    uint64_t acquire_read_slot();
+    void release_read_slot(uint64_t lease);
+    std::vector<void*> get_leased_buffers(uint64_t lease);
+    std::pair<void*, void*> get_leased_box_encode_buffers(uint64_t lease);
+    std::pair<void*, void*> get_leased_heatmap_buffers(uint64_t lease);
+    void* get_leased_soft_label_buffer(uint64_t lease);
+    MetaDataNamePair& get_leased_meta_data(uint64_t lease);
 private:
-    std::queue<MetaDataNamePair> _meta_ring_buffer;
-    MetaDataNamePair _last_image_meta_data;
-    void increment_read_ptr();
-    void increment_write_ptr();
-    bool full();
+    size_t read_slot();
+    void release_popped_slots();
+    size_t leased_slot(uint64_t lease);
+    std::vector<MetaDataNamePair> _meta_ring_buffer;//!< Image names and meta data of each slot, written by the producer before the slot is pushed
     const unsigned BUFF_DEPTH;
+    SlotRing _slots;//!< Lock-free index ring shared by the output routine (producer) and the user's thread (consumer)
     unsigned _sub_buffer_size;
     unsigned _sub_buffer_count;
-    std::mutex _lock;
-    std::condition_variable _wait_for_load;
-    std::condition_variable _wait_for_unload;
     std::vector<std::vector<void*>> _dev_sub_buffer;
     std::vector<void*> _host_master_buffers;
     std::vector<std::vector<void*>> _host_sub_buffers;
     std::vector<void *> _dev_bbox_buffer;
     std::vector<void *> _dev_labels_buffer;
-    bool _dont_block = false;
+    std::vector<void *> _host_heatmap_buffer;//!< Key point heatmaps of each slot, always in host memory
+    std::vector<void *> _host_target_weight_buffer;
+    std::vector<void *> _host_soft_label_buffer;//!< Soft labels of each slot, always in host memory
     RocalMemType _mem_type;
     void *_dev;
-    size_t _write_ptr;
-    size_t _read_ptr;
-    size_t _level;
-    std::mutex  _names_buff_lock;
     const size_t MEM_ALIGNMENT = 256;
+    std::mutex _lease_lock;//!< Guards the consumer side bookkeeping below, leases can be released from any thread
+    std::vector<std::vector<uint32_t>> _slot_leases;//!< Generations of the leases not released yet on each slot
+    uint32_t _lease_generation = 0;//!< Generation of the last lease taken, stored in the upper half of the lease id
+    size_t _popped_leased = 0;//!< Number of slots popped by the user that are still leased, the slot handed to the user comes after them
+    //! Number of leases not released yet, while zero _popped_leased is zero too and the consumer does not take _lease_lock.
+    /// Only the consumer thread takes leases, so a zero seen by it stays zero till it takes one itself
+    std::atomic<size_t> _lease_count = {0};
 };
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "slot_ring.h"
+#include "meta_data.h"
+#include "meta_data_reader.h"
+
+/*! \brief What the service publishes in the batch ring of each rank, written by the service and read by its clients */
+struct ShmBatchRingLayout
+{
+    uint32_t width = 0, height = 0, planes = 0;//!< Size of one image of the batch
+    uint32_t batch_size = 0;
+    int32_t color_format = 0;//!< RocalColorFormat
+    uint32_t has_meta_data = 0;
+    int32_t meta_data_type = 0;//!< MetaDataType, labels or bounding boxes
+    uint32_t depth = 0;//!< Slots of the ring
+    uint64_t image_bytes = 0;//!< Images of a batch
+    uint64_t meta_data_bytes = 0;//!< Room for the names and meta data of a batch
+    uint64_t epoch_batch_count = 0;//!< Batches each rank gets per epoch, the same for all the ranks
+};
+
+struct ShmSegmentHeader;
+
+/*! \brief Ring of output batches in POSIX shared memory, between the rocAL service process (producer) and the pipeline of one rank (consumer)
+ *
+ * The segment holds a header with the layout, a process shared SlotRing (futex signaling) and depth slots, each with the names
+ * and meta data of the batch followed by its images. The consumer works on the slot in place: it reads the images straight from
+ * the segment and only hands the slot back with commit_read() once it is done with it.
+ * The service creates the segment (replacing a stale one of the same name) and unlinks it when it is destroyed, the clients
+ * attach to it by name and keep their mapping till they are destroyed. The header holds the pid of the service, its clients
+ * have to run in the same pid namespace.
+ */
+class ShmBatchRing
+{
+public:
+    ~ShmBatchRing();
+    //! Name of the segment of a rank of a service
+    static std::string segment_name(const std::string &service_name, unsigned rank);
+    //! Room the names and meta data of a batch need in a slot, for names of up to max_name_length bytes and samples of up to max_box_count boxes
+    static size_t meta_data_bytes(size_t batch_size, bool has_meta_data, MetaDataType meta_data_type, size_t max_name_length, size_t max_box_count);
+    //! Service side, the segment is ready for the clients once this returns
+    static std::shared_ptr<ShmBatchRing> create(const std::string &segment, const ShmBatchRingLayout &layout);
+    //! Client side, waits up to timeout_ms for the service to create the segment
+    static std::shared_ptr<ShmBatchRing> attach(const std::string &segment, unsigned timeout_ms);
+    const ShmBatchRingLayout &layout() const;
+
+    //! Producer: wait_until_writable() -> write_images() / write_meta_data() -> commit_write(), returns false if the ring is closed
+    bool wait_until_writable();
+    unsigned char *write_images();
+    void write_meta_data(const ImageNameBatch &names, MetaDataBatch *meta_data);
+    void commit_write() { _ring->commit_write(); }
+    //! No more batches are published, the clients get the ones already in the ring and then run out of data
+    void close();
+
+    //! Consumer: wait_until_readable() -> read_images() / read_meta_data() -> commit_read(), returns false once the ring is closed and drained
+    /// Throws if the service process exits without closing the ring, it is checked every second while the ring is empty
+    bool wait_until_readable();
+    unsigned char *read_images();
+    //! meta_data can be nullptr to only read the names
+    void read_meta_data(ImageNameBatch &names, MetaDataBatch *meta_data);
+    void commit_read() { _ring->commit_read(); }
+private:
+    ShmBatchRing() = default;
+    unsigned char *slot(size_t index) const { return _slots + index * _slot_stride; }
+    std::string _segment;
+    bool _owner = false;//!< The service side unlinks the segment
+    void *_base = nullptr;
+    size_t _size = 0;
+    ShmSegmentHeader *_header = nullptr;
+    SlotRing *_ring = nullptr;
+    unsigned char *_slots = nullptr;
+    size_t _slot_stride = 0;
+};
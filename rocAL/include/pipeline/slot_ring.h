@@ -0,0 +1,200 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#if defined(__linux__)
+#include <climits>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <ctime>
+#include <linux/futex.h>
+#endif
+
+/*! \brief Futex backed event used by the SlotRing to park a thread only when it has nothing to do
+ *
+ * The 32-bit word is bumped on every signal, waiters sleep in the kernel only if the word still holds the value
+ * they observed, so a signal issued between the caller's check and the sleep is never lost.
+ */
+class FutexEvent
+{
+public:
+    //! process_shared: the event lives in memory shared between processes (it is then woken up with the non-private futex ops)
+    explicit FutexEvent(bool process_shared = false): _process_shared(process_shared) {}
+    uint32_t value() const { return _word.load(std::memory_order_seq_cst); }
+    //! timeout_ms: wakes up after that long even without a signal, 0 to wait for the signal only
+    void wait(uint32_t observed, unsigned timeout_ms = 0)
+    {
+        _waiters.fetch_add(1, std::memory_order_seq_cst);
+        if(_word.load(std::memory_order_seq_cst) == observed)
+        {
+#if defined(__linux__)
+            struct timespec timeout = {time_t(timeout_ms / 1000), long(timeout_ms % 1000) * 1000000L};
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_word), _process_shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, observed,
+                    timeout_ms ? &timeout : nullptr, nullptr, 0);
+#else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+        }
+        _waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    void signal()
+    {
+        _word.fetch_add(1, std::memory_order_seq_cst);
+        // Only go to the kernel when somebody is actually parked on the word
+        if(_waiters.load(std::memory_order_seq_cst) == 0)
+            return;
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_word), _process_shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word needs to be a plain 32-bit integer");
+    std::atomic<uint32_t> _word = {0};
+    std::atomic<uint32_t> _waiters = {0};
+    const bool _process_shared;
+};
+
+/*! \brief Lock-free single producer / single consumer slot index ring
+ *
+ * Keeps track of which of the `depth` slots of a buffer are filled, the slots themselves (memory, meta data) are
+ * owned by the user of this class and indexed with write_index() / read_index().
+ * Producer: wait_until_writable() -> fill slot write_index() -> commit_write()
+ * Consumer: wait_until_readable() -> use slot read_index() -> commit_read()
+ * One slot is always kept free, since the consumer keeps using the last slot it has released till it asks for the next one.
+ * A process_shared ring can be constructed in shared memory and used by a producer and a consumer living in different processes.
+ */
+class SlotRing
+{
+public:
+    explicit SlotRing(size_t depth = 2, bool process_shared = false): _depth(depth), _write_limit(depth), _data_event(process_shared), _space_event(process_shared) {}
+    void init(size_t depth) { _depth = depth; _write_limit.store(depth, std::memory_order_relaxed); reset(); }
+    //! Not thread safe, should only be called when neither the producer nor the consumer is active
+    void reset()
+    {
+        _head.store(0, std::memory_order_relaxed);
+        _tail.store(0, std::memory_order_relaxed);
+        _dont_block.store(false, std::memory_order_relaxed);
+    }
+    //! Lets the waits block again after release_all_waits(), keeping the slots filled and released so far
+    void resume_waits() { _dont_block.store(false, std::memory_order_seq_cst); }
+    size_t depth() const { return _depth; }
+    size_t level() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+    bool empty() const { return level() == 0; }
+    bool full() const { return level() >= _write_limit.load(std::memory_order_acquire) - 1; }
+    //! Lets the producer run ahead of the consumer by only depth slots (2 <= depth <= depth()), can be changed while both are active
+    void set_write_limit(size_t depth)
+    {
+        depth = std::max<size_t>(2, std::min(depth, _depth));
+        _write_limit.store(depth, std::memory_order_seq_cst);
+        // A producer parked on a full ring might have room now
+        _space_event.signal();
+    }
+    size_t write_limit() const { return _write_limit.load(std::memory_order_relaxed); }
+    size_t write_index() const { return _head.load(std::memory_order_relaxed) % _depth; }
+    size_t read_index() const { return _tail.load(std::memory_order_relaxed) % _depth; }
+    //! Number of slots released by the consumer so far, slot of position p is at index p % depth()
+    size_t read_position() const { return _tail.load(std::memory_order_relaxed); }
+    //! Blocks the producer while the ring is full, returns false if woken up by interrupt_writer() with the ring still full
+    bool wait_until_writable() { return wait(_space_event, _writer_interrupts, [this]() { return !full(); }); }
+    //! Blocks the consumer while the ring is empty, returns false if woken up by interrupt_reader() with the ring still empty
+    bool wait_until_readable() { return wait(_data_event, _reader_interrupts, [this]() { return !empty(); }); }
+    //! Same as wait_until_readable() for the slot of the given position, for consumers keeping the slots they have read for a while
+    bool wait_until_readable(size_t position) { return wait(_data_event, _reader_interrupts, [this, position]() { return _head.load(std::memory_order_acquire) > position; }); }
+    //! Same as wait_until_readable(), also returns false once timeout_ms have passed with the ring still empty
+    bool wait_until_readable_for(unsigned timeout_ms) { return wait(_data_event, _reader_interrupts, [this]() { return !empty(); }, timeout_ms); }
+    //! Publishes the slot at write_index() to the consumer
+    void commit_write()
+    {
+        _head.fetch_add(1, std::memory_order_seq_cst);
+        _data_event.signal();
+    }
+    //! Hands the slot at read_index() back to the producer
+    void commit_read()
+    {
+        _tail.fetch_add(1, std::memory_order_seq_cst);
+        _space_event.signal();
+    }
+    void interrupt_reader()
+    {
+        _reader_interrupts.fetch_add(1, std::memory_order_seq_cst);
+        _data_event.signal();
+    }
+    void interrupt_writer()
+    {
+        _writer_interrupts.fetch_add(1, std::memory_order_seq_cst);
+        _space_event.signal();
+    }
+    //! Makes all the current and upcoming waits return immediately, till reset() is called
+    void release_all_waits()
+    {
+        _dont_block.store(true, std::memory_order_seq_cst);
+        interrupt_reader();
+        interrupt_writer();
+    }
+private:
+    template <typename Ready>
+    bool wait(FutexEvent &event, std::atomic<uint32_t> &interrupts, Ready ready, unsigned timeout_ms = 0)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        // Interrupts issued before the call are not meant for this wait
+        const uint32_t interrupt_count = interrupts.load(std::memory_order_seq_cst);
+        for(unsigned spin = 0; spin < SPIN_COUNT; spin++)
+        {
+            if(ready())
+                return true;
+            std::this_thread::yield();
+        }
+        while(true)
+        {
+            const uint32_t observed = event.value();
+            if(ready())
+                return true;
+            if(_dont_block.load(std::memory_order_seq_cst) || interrupts.load(std::memory_order_seq_cst) != interrupt_count)
+                return false;
+            if(!timeout_ms)
+            {
+                event.wait(observed);
+                continue;
+            }
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if(left <= 0)
+                return false;
+            event.wait(observed, left);
+        }
+    }
+    const unsigned SPIN_COUNT = 64;
+    size_t _depth;
+    std::atomic<size_t> _write_limit;//!< Slots actually used out of the _depth ones, the rest stays allocated but idle
+    alignas(64) std::atomic<size_t> _head = {0};//!< Number of slots committed by the producer
+    alignas(64) std::atomic<size_t> _tail = {0};//!< Number of slots released by the consumer
+    alignas(64) FutexEvent _data_event;
+    alignas(64) FutexEvent _space_event;
+    std::atomic<uint32_t> _reader_interrupts = {0};
+    std::atomic<uint32_t> _writer_interrupts = {0};
+    std::atomic<bool> _dont_block = {false};
+};
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <vector>
 #include <string>
 #include <memory>
+#include <random>
 #include <dirent.h>
 #include <map>
 #include <iterator>
@@ -95,6 +96,7 @@ private:
     size_t _in_batch_read_count = 0;
     bool _loop;
     bool _shuffle;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
     int _read_counter = 0;
     uint _file_byte_size;
     void incremenet_read_ptr();
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <vector>
 #include <string>
 #include <memory>
+#include <random>
 #include <dirent.h>
 #include <map>
 #include <iterator>
@@ -92,6 +93,7 @@ private:
     size_t _in_batch_read_count = 0;
     bool _loop;
     bool _shuffle;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
     int _read_counter = 0;
     MDB_env* _mdb_env,  *_read_mdb_env;
     MDB_dbi _mdb_dbi, _read_mdb_dbi;
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <memory>
 #include <dirent.h>
 #include "image_reader.h"
+#include "mapped_file.h"
 
 
 class CIFAR10DataReader : public Reader {
@@ -47,6 +48,14 @@ public:
     */
     size_t open() override;
 
+    //! Gives the opened record in place from the mapping of its batch file, its three 32x32 planes follow each other
+    /*!
+     Unlike other readers the view stays valid after close(), as long as the reader lives
+    */
+    bool view(ReaderItemView &item_view) override;
+
+    bool skip(size_t count) override;
+
     //! Resets the object's state to read from the first file in the folder
     void reset() override;
 
@@ -71,21 +80,20 @@ private:
     DIR *_src_dir;
     DIR *_sub_dir;
     struct dirent *_entity;
-    std::vector<std::string> _file_names;
+    std::vector<std::shared_ptr<const MappedFile>> _mapped_files;//!< one per batch file, held in memory for the whole run
+    std::vector<std::string> _mapped_file_ids;//!< the batch file names the record ids are made of
+    std::vector<unsigned> _file_mapping_idx;//!< batch file of each record
     std::vector<unsigned> _file_offsets;
     std::vector<unsigned> _file_idx;
     unsigned  _curr_file_idx;
-    FILE* _current_fPtr;
-    unsigned _current_file_size;
+    const unsigned char *_current_data = nullptr;//!< pixels of the opened record, in the mapping
     std::string _last_id;
-    std::string _last_file_name;
     unsigned _last_file_idx;        // index of individual raw file in a batched file
     // hard_coding the following for now. Eventually needs to add in the ReaderConfig
     //!< file_name_prefix tells the reader to read only files with the prefix:: eventually needs to be passed through ReaderConfig
     std::string _file_name_prefix;// = "data_batch_";
     //!< _raw_file_size of each file to read
     const size_t _raw_file_size = (32*32*3 + 1);    // todo:: need to add an option in reader config to take this.
-    size_t _total_file_size;
     //!< _batch_count Defines the quantum count of the images to be read. It's usually equal to the user's batch size.
     /// The loader will repeat images if necessary to be able to have images available in multiples of the load_batch_count,
     /// for instance if there are 10 images in the dataset and _batch_count is 3, the loader repeats 2 images as if there are 12 images available.
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <memory>
 #include <fstream>
 #include <dirent.h>
+#include <random>
 #include "image_reader.h"
 #include "meta_data_reader.h"
 #include "meta_data_graph.h"
@@ -60,6 +61,8 @@ public:
 
     unsigned count_items() override;
 
+    bool skip(size_t count) override;
+
     ~COCOFileSourceReader() override;
 
     int close() override;
@@ -94,6 +97,7 @@ private:
     size_t _in_batch_read_count = 0;
     bool _loop;
     bool _shuffle;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
     int _read_counter = 0;
     //!< _file_count_all_shards total_number of files in to figure out the max_batch_size (usually needed for distributed training).
     size_t  _file_count_all_shards;
@@ -25,9 +25,12 @@ THE SOFTWARE.
 #include <string>
 #include <memory>
 #include <dirent.h>
+#include <random>
+#include <unordered_set>
 #include "image_reader.h"
 #include "commons.h"
 #include "timing_debug.h"
+#include "sample_quarantine.h"
 
 
 class FileSourceReader : public Reader {
@@ -55,8 +58,13 @@ public:
     //! Returns the name of the latest file opened
     std::string id() override { return _last_id;};
 
+    //! Returns the path of the latest file opened relative to the dataset root, the same file name can be in several sub folders
+    std::string sample_path() override { return _last_sample_path; }
+
     unsigned count_items() override;
 
+    bool skip(size_t count) override;
+
     ~FileSourceReader() override;
 
     int close() override;
@@ -68,6 +76,7 @@ private:
     Reader::Status open_folder();
     Reader::Status subfolder_reading();
     std::string _folder_path;
+    std::string _root_path;//!< The dataset root, the path given to the reader
     DIR *_src_dir;
     DIR *_sub_dir;
     struct dirent *_entity;
@@ -76,6 +85,7 @@ private:
     FILE* _current_fPtr;
     unsigned _current_file_size;
     std::string _last_id;
+    std::string _last_sample_path;
     std::string _last_file_name;
     size_t _shard_id = 0;
     size_t _shard_count = 1;// equivalent of batch size
@@ -87,13 +97,19 @@ private:
     size_t _in_batch_read_count = 0;
     bool _loop;
     bool _shuffle;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
     int _read_counter = 0;
     //!< _file_count_all_shards total_number of files in to figure out the max_batch_size (usually needed for distributed training).
     size_t  _file_count_all_shards;
+    std::shared_ptr<SampleQuarantine> _quarantine;//!< Files that failed decoding on earlier runs, replaced in the list of this shard
+    std::unordered_set<std::string> _quarantined_files;//!< Files of this shard in the quarantine when the reader was created
+    size_t _quarantined_count = 0;
     void incremenet_read_ptr();
     int release();
     size_t get_file_shard_id();
     void incremenet_file_id() { _file_id++; }
+    void replace_quarantined_files();
+    std::string relative_path(const std::string &file_path) const { return file_path.substr(_root_path.size() + 1); }
     void replicate_last_image_to_fill_last_shard();
     void replicate_last_batch_to_pad_partial_shard();
 };
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include <tuple>
 #include <lmdb.h>
 #include "meta_data_reader.h"
+#include "synthetic_data.h"
 
 #define CHECK_LMDB_RETURN_STATUS(status)          \
     do {                            \
@@ -45,6 +46,23 @@ enum class StorageType
     COCO_FILE_SYSTEM = 5,
     SEQUENCE_FILE_SYSTEM = 6,
     MXNET_RECORDIO = 7,
+    SYNTHETIC = 8, // generated in memory, see SyntheticDataConfig
+    NUMPY_DATA = 9, // memory mapped uint8 .npy arrays or headerless raw tensor files, served uncompressed
+    TAR_SHARDS = 10, // WebDataset style tar files, streamed sequentially
+};
+
+//! Height x width x channels of an uncompressed uint8 sample stored in HWC order
+struct RawSampleShape
+{
+    unsigned width = 0, height = 0, channels = 0;
+    size_t size() const { return (size_t)width * height * channels; }
+};
+
+//! In place access to an uncompressed item held in memory by a reader, see Reader::view()
+struct ReaderItemView
+{
+    const unsigned char *data = nullptr;
+    RawSampleShape shape;//!< rows are shape.width * shape.channels bytes apart
 };
 
 struct ReaderConfig
@@ -70,6 +88,8 @@ struct ReaderConfig
     void set_sequence_length(unsigned sequence_length) { _sequence_length = sequence_length; }
     void set_frame_step(unsigned step) { _step = step; }
     void set_frame_stride(unsigned stride) { _stride = stride; }
+    //! Positions within the read sequence of the frames of each output sequence, the frames left out are not read. Empty keeps the read order
+    void set_sequence_rearrange(const std::vector<unsigned> &new_order) { _sequence_rearrange = new_order; }
     size_t get_shard_count() { return _shard_count; }
     size_t get_shard_id() { return _shard_id; }
     size_t get_cpu_num_threads() { return _cpu_num_threads; }
@@ -77,12 +97,21 @@ struct ReaderConfig
     size_t get_sequence_length() { return _sequence_length; }
     size_t get_frame_step() { return _step; }
     size_t get_frame_stride() { return _stride; }
+    const std::vector<unsigned> &get_sequence_rearrange() const { return _sequence_rearrange; }
     std::string path() { return _path; }
     std::string json_path() { return _json_path; }
     std::map<std::string, std::string> feature_key_map() { return _feature_key_map; }
     void set_file_prefix(const std::string &prefix) { _file_prefix = prefix; }
     std::string file_prefix() { return _file_prefix; }
     std::shared_ptr<MetaDataReader> meta_data_reader() { return _meta_data_reader; }
+    void set_synthetic_data_config(const SyntheticDataConfig &config) { _synthetic_data_config = config; }
+    const SyntheticDataConfig &synthetic_data_config() const { return _synthetic_data_config; }
+    //! Shape of the samples of headerless raw tensor files, only used by the numpy reader
+    void set_raw_sample_shape(const RawSampleShape &shape) { _raw_sample_shape = shape; }
+    const RawSampleShape &raw_sample_shape() const { return _raw_sample_shape; }
+    //! Number of samples held in memory to shuffle the streamed samples, only used by the tar shard reader
+    void set_shuffle_buffer_size(size_t size) { _shuffle_buffer_size = size; }
+    size_t shuffle_buffer_size() const { return _shuffle_buffer_size; }
 private:
     StorageType _type = StorageType::FILE_SYSTEM;
     std::string _path = "";
@@ -95,10 +124,14 @@ private:
     size_t _sequence_length = 1; // Video reader module sequence length
     size_t _step;
     size_t _stride = 1;
+    std::vector<unsigned> _sequence_rearrange; //!< only used by the sequence reader
     bool _shuffle = false;
     bool _loop = false;
     std::string _file_prefix = ""; //!< to read only files with prefix. supported only for cifar10_data_reader and tf_record_reader
     std::shared_ptr<MetaDataReader> _meta_data_reader = nullptr;
+    SyntheticDataConfig _synthetic_data_config; //!< only used by the synthetic reader
+    RawSampleShape _raw_sample_shape; //!< only used by the numpy reader
+    size_t _shuffle_buffer_size = 0; //!< only used by the tar shard reader
 };
 
 // MXNet image recordio struct - used to read the contents from the MXNet recordIO files.
@@ -150,8 +183,25 @@ public:
 
     //! Returns the name/identifier of the last item opened in this resource
     virtual std::string id() = 0;
+    //! Returns the path of the last item opened relative to the root of this resource, the key of the sample quarantine
+    /*!
+     \return id() by default, readers whose ids can repeat across the sub folders of the resource return the relative path instead
+    */
+    virtual std::string sample_path() { return id(); }
     //! Returns the number of items remained in this resource
     virtual unsigned count_items() = 0;
+
+    //! Gives access to the data of the opened item in place, without copying it, valid till close() is called
+    /*!
+     \return false if the reader does not hold the item uncompressed in memory, read_data() has to be used then
+    */
+    virtual bool view(ReaderItemView &item_view) { return false; }
+
+    //! Moves past the next count items without reading them, to resume a run
+    /*!
+     \return false if the reader cannot skip items, they have to be opened and closed one by one then
+    */
+    virtual bool skip(size_t count) { return false; }
     
     virtual ~Reader() = default;
 };
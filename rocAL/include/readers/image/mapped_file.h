@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+
+//! A binary file held read-only in memory for the whole run, shared by the readers of the same path
+/*!
+ The file is memory mapped and its pages are read in once; when it cannot be mapped, or ROCAL_DISABLE_MMAP is set, it is read into a heap buffer instead.
+ A data reader and a meta data reader opening the same path get the same mapping, so the samples and their labels are read from one copy.
+*/
+class MappedFile
+{
+public:
+    //! Returns the mapping of the file at path, mapping it if no one holds it yet, nullptr if it can't be read
+    static std::shared_ptr<const MappedFile> open(const std::string &path);
+    const unsigned char *data() const { return _data; }
+    size_t size() const { return _size; }
+    const std::string &path() const { return _path; }
+    //! False if the file was read into a heap buffer
+    bool mapped() const { return _address != nullptr; }
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+private:
+    explicit MappedFile(const std::string &path): _path(path) {}
+    bool load();
+    std::string _path;
+    const unsigned char *_data = nullptr;
+    size_t _size = 0;
+    void *_address = nullptr;//!< the mapping, nullptr if the file was read into _buffer
+    std::vector<unsigned char> _buffer;
+};
@@ -0,0 +1,66 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <vector>
+
+//! Contiguous bytes of a record's payload within its .rec file
+struct MXNetRecordPiece
+{
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+/*! \brief Location and header of one image record of an MXNet RecordIO file
+ *
+ * The payload is made of one piece, or of several ones if the writer had to split the record around magic numbers found in the data,
+ * in which case the pieces are joined back with a magic number between each of them (dmlc RecordIO multi-part records).
+ */
+struct MXNetRecord
+{
+    unsigned file = 0;//!< index of the .rec file in MXNetRecordIOIndex::rec_files
+    std::vector<MXNetRecordPiece> pieces;
+    size_t image_offset = 0;//!< offset of the encoded image within the payload, right after the header and the labels
+    size_t image_size = 0;
+    uint64_t id = 0;//!< image_id[0] of the header
+    std::string key;//!< id as text, the name of the image for the readers
+    std::vector<float> labels;//!< the header's label, or all its flag labels for the multi-label records
+};
+
+/*! \brief Image records of a folder of MXNet RecordIO .rec/.idx pairs, found by reading the record headers only
+ *
+ * The records are named by their image id, building the index fails if two records have the same id, within a .rec file or across them.
+ */
+struct MXNetRecordIOIndex
+{
+    std::vector<std::string> rec_files;//!< sorted by path
+    std::vector<MXNetRecord> records;//!< in the order of the .rec files then of the records within a file
+};
+
+//! Indexes the RecordIO files at the path, the index is built once and shared by the readers using the same path at the same time
+std::shared_ptr<const MXNetRecordIOIndex> load_mxnet_recordio_index(const std::string &path);
+
+//! Copies size bytes of the record's payload starting at begin into dst, fd being the record's .rec file opened for reading; returns false on a failed or short read
+bool read_mxnet_record_payload(int fd, const MXNetRecord &record, size_t begin, size_t size, unsigned char *dst);
@@ -24,12 +24,13 @@ THE SOFTWARE.
 #include <vector>
 #include <string>
 #include <memory>
+#include <random>
 #include <dirent.h>
 #include <map>
 #include <iterator>
 #include <algorithm>
-#include <fstream>
 #include "image_reader.h"
+#include "mxnet_recordio_index.h"
 #include "timing_debug.h"
 
 class MXNetRecordIOReader : public Reader{
@@ -69,17 +70,13 @@ private:
     Reader::Status record_reading();
     Reader::Status MXNet_reader();
     std::string _path;
-    DIR *_src_dir;
-    struct dirent *_entity;
-    std::string _image_key;
+    std::shared_ptr<const MXNetRecordIOIndex> _index;
+    std::vector<int> _rec_fds;//!< one per .rec file of the index, read with pread() so concurrent reads share no file position
     std::vector<std::string> _file_names;
-    std::map<std::string, std::tuple<unsigned int, int64_t, int64_t> > _record_properties;
+    std::map<std::string, const MXNetRecord*> _record_properties;
     unsigned  _curr_file_idx;
     unsigned _current_file_size;
     std::string _last_id, _last_file_name;
-    unsigned int _last_file_size;
-    int64_t _last_seek_pos;
-    int64_t _last_data_size;
     size_t _shard_id = 0;
     size_t _shard_count = 1;// equivalent of batch size
     //!< _batch_count Defines the quantum count of the images to be read. It's usually equal to the user's batch size.
@@ -90,6 +87,7 @@ private:
     size_t _in_batch_read_count = 0;
     bool _loop;
     bool _shuffle;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
     int _read_counter = 0;
     //!< _file_count_all_shards total_number of files in to figure out the max_batch_size (usually needed for distributed training).
     size_t  _file_count_all_shards;
@@ -99,14 +97,6 @@ private:
     void incremenet_file_id() { _file_id++; }
     void replicate_last_image_to_fill_last_shard();
     void replicate_last_batch_to_pad_partial_shard();
-    void read_image(unsigned char* buff, int64_t seek_position, int64_t data_size);
     void read_image_names();
-    uint32_t DecodeFlag(uint32_t rec) {return (rec >> 29U) & 7U; };
-    uint32_t DecodeLength(uint32_t rec) {return rec & ((1U << 29U) - 1U); };
-    std::vector<std::tuple<int64_t, int64_t>> _indices;// used to store seek position and record size for a particular record.
-    std::ifstream _file_contents;
-    const uint32_t _kMagic = 0xced7230a;
-    int64_t _seek_pos, _data_size_to_read;
-    ImageRecordIOHeader _hdr;
 };
 
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+#include "image_reader.h"
+
+//! Layout of the samples of a .npy or raw tensor file, read once from its header (or from the raw sample shape) when the reader is initialized
+struct NumpyFileInfo
+{
+    std::string path;
+    std::string name;//!< file name without the folder
+    RawSampleShape shape;//!< shape of every sample of the file
+    size_t data_offset = 0;//!< start of the array data, after the .npy header
+    size_t sample_count = 0;
+    size_t file_size = 0;
+};
+
+/*! \brief Parses the header of a .npy file (format versions 1.0 to 3.0)
+ *
+ * Only C ordered uint8 arrays are accepted, the samples are (H, W) or (H, W, C) with C = 1 or 3.
+ * If has_sample_axis is set the first dimension is the sample axis: (N, H, W) or (N, H, W, C), otherwise the file is a single (H, W) or (H, W, C) sample
+ * and a 4 dimensional array is still read as (N, H, W, C).
+ * \return false if the buffer does not start with the .npy magic string, throws if the header is invalid or describes an array that is not supported
+ */
+bool parse_numpy_header(const unsigned char *buffer, size_t size, bool has_sample_axis, NumpyFileInfo &info);
+
+/*! \brief Reader of memory mapped .npy arrays and headerless raw tensor files, for the pre-decoded data sets loaded with DecoderType::SKIP_DECODE
+ *
+ * The path is either a single file holding all the samples along its first axis, or a folder of files holding one sample each
+ * (or several along their first axis for 4 dimensional arrays). The files without the .npy extension are raw tensor files, read
+ * as consecutive samples of the shape given with ReaderConfig::set_raw_sample_shape().
+ * Files holding several samples stay mapped while the reader is alive, single sample files are only mapped between open() and close().
+ * The samples are served in place through view(), read_data() copies them.
+ */
+class NumpyDataReader : public Reader {
+public:
+    Reader::Status initialize(ReaderConfig desc) override;
+    size_t read_data(unsigned char* buf, size_t max_size) override;
+    size_t open() override;
+    void reset() override;
+    std::string id() override { return _last_id; }
+    unsigned count_items() override;
+    int close() override;
+    bool view(ReaderItemView &item_view) override;
+    NumpyDataReader() = default;
+    ~NumpyDataReader() override;
+private:
+    struct Mapping
+    {
+        void *address = nullptr;
+        size_t size = 0;
+    };
+    void add_file(const std::string &path, bool has_sample_axis);
+    const unsigned char *map_file(size_t file_idx);
+    void unmap_file(size_t file_idx);
+    void shuffle();
+    std::vector<NumpyFileInfo> _files;
+    std::vector<Mapping> _mappings;//!< one per file
+    std::vector<std::pair<unsigned, size_t>> _samples;//!< file index and sample index within the file, of the samples of this shard
+    RawSampleShape _raw_shape;
+    const unsigned char *_current_data = nullptr;
+    RawSampleShape _current_shape;
+    unsigned _current_file = 0;
+    std::string _last_id;
+    size_t _curr_sample_idx = 0;
+    size_t _read_counter = 0;
+    size_t _shard_id = 0;
+    size_t _shard_count = 1;
+    size_t _batch_count = 1;
+    bool _loop = false;
+    bool _shuffle = false;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
+};
@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "meta_data.h"
+
+/*! \brief Describes the samples of the synthetic data source (StorageType::SYNTHETIC)
+ *
+ * Sample i is named synthetic_<i> and shows image variant i % distinct_images, so that the width, height, pixels and boxes
+ * of a sample only depend on the seed and its variant, the label depends on the sample itself.
+ * Everything is generated from the seed, two runs with the same config see exactly the same data.
+ */
+struct SyntheticDataConfig
+{
+    size_t sample_count = 1024;
+    unsigned min_width = 640, max_width = 640;   //!< the widths of the images are uniformly distributed in [min_width, max_width]
+    unsigned min_height = 480, max_height = 480; //!< the heights of the images are uniformly distributed in [min_height, max_height]
+    unsigned distinct_images = 64;
+    bool jpeg_encoded = false;  //!< images are handed to the decoder as in-memory JPEGs instead of being generated straight into the decoder's output
+    unsigned jpeg_quality = 90;
+    unsigned num_classes = 1000;
+    unsigned max_boxes = 0;     //!< every image gets 1 to max_boxes boxes, drawn into its pixels as well
+    uint64_t seed = 0;
+};
+
+/*! \brief What the synthetic reader hands to the SyntheticDecoder when the images are not JPEG encoded
+ *
+ * It carries everything needed to generate the pixels of an image, at any size.
+ */
+struct SyntheticImageDesc
+{
+    char magic[8];
+    uint64_t seed;
+    uint32_t variant;
+    uint32_t width;
+    uint32_t height;
+    uint32_t max_boxes;
+    uint32_t num_classes;
+    uint32_t reserved;
+};
+
+std::string synthetic_sample_name(size_t index);
+//! Returns false if the name is not the one of a synthetic sample
+bool synthetic_sample_index(const std::string &name, size_t &index);
+SyntheticImageDesc synthetic_image_desc(const SyntheticDataConfig &config, size_t index);
+//! Returns false if the buffer does not hold a SyntheticImageDesc
+bool synthetic_parse_image_desc(const unsigned char *buffer, size_t size, SyntheticImageDesc &desc);
+int synthetic_label(const SyntheticDataConfig &config, size_t index);
+//! Boxes of the image in normalized ltrb coordinates, with their labels in [1, num_classes]
+void synthetic_boxes(const SyntheticImageDesc &desc, BoundingBoxCords &boxes, BoundingBoxLabels &labels);
+//! Generates the image at width x height (its content is scaled accordingly) into the interleaved output, rows stride bytes apart
+void synthetic_render(const SyntheticImageDesc &desc, unsigned char *output, unsigned width, unsigned height, size_t stride, unsigned planes, bool bgr);
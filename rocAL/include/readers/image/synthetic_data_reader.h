@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include "image_reader.h"
+#include "synthetic_data.h"
+
+/*! \brief Reader of the synthetic data source, nothing is read from the storage
+ *
+ * Hands out the samples described by the SyntheticDataConfig, either as SyntheticImageDesc records for the SyntheticDecoder,
+ * or as JPEG images encoded once in memory (shared by all the shards with the same config) for the regular decoders.
+ */
+class SyntheticDataReader : public Reader {
+public:
+    Reader::Status initialize(ReaderConfig desc) override;
+    size_t read_data(unsigned char* buf, size_t max_size) override;
+    size_t open() override;
+    void reset() override;
+    std::string id() override { return _last_id; }
+    unsigned count_items() override;
+    int close() override { return 0; }
+    SyntheticDataReader() = default;
+    ~SyntheticDataReader() override = default;
+private:
+    void shuffle();
+    SyntheticDataConfig _config;
+    std::vector<size_t> _sample_indices;//!< indices of the samples of this shard, padded to the same count for every shard
+    std::shared_ptr<const std::vector<std::vector<unsigned char>>> _jpeg_images;//!< encoded images, one per variant
+    SyntheticImageDesc _current_desc;
+    const unsigned char *_current_data = nullptr;
+    size_t _current_size = 0;
+    std::string _last_id;
+    size_t _curr_sample_idx = 0;
+    size_t _read_counter = 0;
+    size_t _shard_id = 0;
+    size_t _shard_count = 1;
+    size_t _batch_count = 1;
+    unsigned _epoch = 0;
+    bool _loop = false;
+    bool _shuffle = false;
+};
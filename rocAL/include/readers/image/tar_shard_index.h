@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+//! Location of a member's data within its tar file
+struct TarMember
+{
+    size_t offset = 0;
+    size_t size = 0;
+    bool valid() const { return size > 0; }
+};
+
+//! Members of a tar file sharing the same key (the member path up to the first dot of its file name), WebDataset style
+struct TarShardSample
+{
+    std::string key;
+    TarMember image;//!< .jpg, .jpeg or .png member
+    TarMember label;//!< .cls member, the class index as text
+    TarMember boxes;//!< .json member, see TarShardMetaDataReader
+};
+
+struct TarShardFile
+{
+    std::string path;
+    std::vector<TarShardSample> samples;//!< in the order of their images in the file
+};
+
+/*! \brief Samples of a folder of tar shards (or of a single .tar file), found by reading the member headers only
+ *
+ * Used by the TarShardReader to know the samples of its shards up front and by the TarShardMetaDataReader to find the label and box members.
+ * The members without an image are ignored.
+ */
+struct TarShardIndex
+{
+    std::vector<TarShardFile> files;//!< sorted by path
+    size_t sample_count() const;
+};
+
+//! Indexes the tar shards at the path, the index is built once and shared by the readers using the same path at the same time
+std::shared_ptr<const TarShardIndex> load_tar_shard_index(const std::string &path);
@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include "image_reader.h"
+#include "tar_shard_index.h"
+
+/*! \brief Streams the images of WebDataset style tar shards sequentially
+ *
+ * The path is a folder of .tar files or a single one, the members are grouped into samples by their key (see TarShardSample),
+ * the labels and boxes of the samples are read by the TarShardMetaDataReader and the id of a sample is its key.
+ * The tar files are dealt round robin to the shards, each shard reads its files from start to end in large sequential reads.
+ * When shuffling, the order of the files is shuffled every epoch and the streamed samples go through a shuffle buffer of
+ * ReaderConfig::shuffle_buffer_size() samples, from which a random one is picked and replaced by the next streamed sample.
+ */
+class TarShardReader : public Reader {
+public:
+    Reader::Status initialize(ReaderConfig desc) override;
+    size_t read_data(unsigned char* buf, size_t max_size) override;
+    size_t open() override;
+    void reset() override;
+    std::string id() override { return _last_id; }
+    unsigned count_items() override;
+    int close() override;
+    TarShardReader() = default;
+    ~TarShardReader() override;
+private:
+    struct BufferedSample
+    {
+        std::string key;
+        std::vector<unsigned char> data;
+    };
+    void start_epoch();
+    //! Reads the next sample of the epoch from the tar files, the returned data stays valid till the next call
+    bool stream_next(const TarShardSample *&sample, const unsigned char *&data);
+    const unsigned char *fetch(unsigned file_idx, const TarMember &member);
+    void close_stream();
+    std::shared_ptr<const TarShardIndex> _index;
+    std::vector<unsigned> _files;//!< indices of the tar files of this shard, in the order of the current epoch
+    size_t _shard_size = 0;//!< samples per epoch including the padding, the same for all the shards
+    // Stream position
+    size_t _file_pos = 0;
+    size_t _sample_pos = 0;
+    size_t _streamed_count = 0;
+    int _fd = -1;
+    unsigned _stream_file = 0;
+    size_t _stream_file_size = 0;
+    std::vector<unsigned char> _stream_buffer;
+    size_t _stream_buffer_offset = 0;//!< file offset of the first byte of the buffer
+    size_t _stream_buffer_size = 0;//!< valid bytes in the buffer
+    // Shuffle buffer
+    std::vector<BufferedSample> _shuffle_buffer;
+    size_t _shuffle_buffer_capacity = 0;
+    BufferedSample _current_sample;//!< sample picked from the shuffle buffer
+    const unsigned char *_current_data = nullptr;
+    size_t _current_size = 0;
+    std::string _last_id;
+    size_t _read_counter = 0;
+    size_t _shard_id = 0;
+    size_t _shard_count = 1;
+    size_t _batch_count = 1;
+    bool _loop = false;
+    bool _shuffle = false;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
+};
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <vector>
 #include <string>
 #include <memory>
+#include <random>
 #include <dirent.h>
 #include <map>
 #include <iterator>
@@ -97,6 +98,7 @@ private:
     size_t _in_batch_read_count = 0;
     bool _loop;
     bool _shuffle;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
     int _read_counter = 0;
     size_t  _file_count_all_shards;
     //!< _record_name_prefix tells the reader to read only files with the prefix
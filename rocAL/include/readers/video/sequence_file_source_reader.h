@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <vector>
 #include <string>
 #include <memory>
+#include <random>
 #include <dirent.h>
 #include "image_reader.h"
 #include "commons.h"
@@ -84,6 +85,7 @@ private:
     size_t _sequence_length;
     size_t _step;
     size_t _stride;
+    std::vector<unsigned> _new_order; //!< Frame positions kept in each sequence, in their output order, empty for all the frames
     size_t _shard_id = 0;
     size_t _shard_count = 1;// equivalent of batch size
     //!< _batch_count Defines the quantum count of the images to be read. It's usually equal to the user's batch size.
@@ -95,6 +97,7 @@ private:
     size_t _in_batch_read_count = 0;
     bool _loop;
     bool _shuffle;
+    std::mt19937 _rng;//!< Seeded with the pipeline seed, so that the order of every epoch can be replayed
     int _read_counter = 0;
     //!< _sequence_count_all_shards total_number of sequences in to figure out the max_batch_size (usually needed for distributed training).
     size_t  _sequence_count_all_shards;
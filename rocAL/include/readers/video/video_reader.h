@@ -57,6 +57,8 @@ struct VideoReaderConfig
     void set_frame_stride(unsigned stride) { _video_frame_stride = stride; }
     void set_total_frames_count(size_t total) { _total_frames_count = total; }
     void set_video_properties(VideoProperties video_prop) { _video_prop = video_prop;}
+    //! Positions within the read sequence of the frames of each output sequence, the frames left out are not decoded. Empty keeps the read order
+    void set_sequence_rearrange(const std::vector<unsigned> &new_order) { _sequence_rearrange = new_order; }
     size_t get_shard_count() { return _shard_count; }
     size_t get_shard_id() { return _shard_id; }
     size_t get_batch_size() { return _batch_count; }
@@ -65,6 +67,7 @@ struct VideoReaderConfig
     size_t get_frame_stride() { return _video_frame_stride; }
     size_t get_total_frames_count() { return _total_frames_count; }
     VideoProperties get_video_properties() { return _video_prop; }
+    const std::vector<unsigned> &get_sequence_rearrange() const { return _sequence_rearrange; }
     std::string path() { return _path; }
     std::shared_ptr<MetaDataReader> meta_data_reader() { return _meta_data_reader; }
 private:
@@ -77,6 +80,7 @@ private:
     size_t _video_frame_step;
     size_t _video_frame_stride = 1;
     VideoProperties _video_prop;
+    std::vector<unsigned> _sequence_rearrange;
     size_t _total_frames_count;
     bool _shuffle = false;
     bool _loop = false;
@@ -22,9 +22,11 @@ THE SOFTWARE.
 
 #include <string>
 #include <exception>
+#include <cstring>
 #include "commons.h"
 #include "context.h"
 #include "rocal_api.h"
+#include "data_service.h"
 
 RocalStatus ROCAL_API_CALL
 rocalRelease(RocalContext p_context)
@@ -100,6 +102,231 @@ rocalRun(RocalContext p_context)
     return ROCAL_OK;
 }
 
+RocalStatus ROCAL_API_CALL
+rocalTryRun(RocalContext p_context, bool *ran)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        bool batch_ran = false;
+        auto ret = context->master_graph->try_run(batch_ran);
+        if(ran)
+            *ran = batch_ran;
+        if(ret != MasterGraph::Status::OK)
+            return ROCAL_RUNTIME_ERROR;
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalServe(RocalContext p_context, const char *service_name, unsigned rank_count, unsigned epoch_count, unsigned ring_depth)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        DataService service(context->master_graph.get(), context->user_batch_size(), service_name, rank_count, ring_depth);
+        service.serve(epoch_count);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalSetStateTracking(RocalContext p_context, bool enable)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        context->master_graph->set_state_tracking(enable);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_INVALID_PARAMETER_TYPE;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalSaveState(RocalContext p_context, void *buffer, size_t *size)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if(!size)
+            THROW("Null size passed to rocalSaveState")
+        auto state = context->master_graph->save_state().serialize();
+        const size_t buffer_size = *size;
+        *size = state.size();
+        if(buffer)
+        {
+            if(buffer_size < state.size())
+                THROW("The buffer of " + TOSTR(buffer_size) + " bytes is too small for the state of " + TOSTR(state.size()) + " bytes")
+            memcpy(buffer, state.data(), state.size());
+        }
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalLoadState(RocalContext p_context, const void *buffer, size_t size)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        context->master_graph->load_state(PipelineState::deserialize(static_cast<const unsigned char *>(buffer), size));
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_INVALID_PARAMETER_TYPE;
+    }
+    return ROCAL_OK;
+}
+
+int ROCAL_API_CALL
+rocalGetOutputReadyFd(RocalContext p_context)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        return context->master_graph->output_ready_fd();
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+    }
+    return -1;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalSetShardScheduling(RocalContext p_context, RocalShardScheduling scheduling, bool share_decode_threads)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        auto translate_shard_scheduling = [](RocalShardScheduling shard_scheduling)
+        {
+            switch(shard_scheduling)
+            {
+                case ROCAL_SHARD_ROUND_ROBIN:
+                    return ShardScheduling::ROUND_ROBIN;
+                case ROCAL_SHARD_ANY_READY:
+                    return ShardScheduling::ANY_READY;
+                default:
+                    THROW("Unkown Rocal shard scheduling")
+            }
+        };
+        context->master_graph->set_shard_scheduling(translate_shard_scheduling(scheduling), share_decode_threads);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_INVALID_PARAMETER_TYPE;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalSetNumaPlacement(RocalContext p_context, bool enable, int output_numa_node, const int *shard_numa_nodes, unsigned shard_numa_node_count)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        std::vector<int> shard_nodes;
+        if(shard_numa_nodes)
+            shard_nodes.assign(shard_numa_nodes, shard_numa_nodes + shard_numa_node_count);
+        context->master_graph->set_numa_placement(enable, output_numa_node, shard_nodes);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_INVALID_PARAMETER_TYPE;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalSetAutotune(RocalContext p_context, bool enable, unsigned tuning_batch_count, size_t memory_budget)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        context->master_graph->set_autotune(enable, tuning_batch_count, memory_budget);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_INVALID_PARAMETER_TYPE;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalGetAutotuneResult(RocalContext p_context, RocalAutotuneResult *result)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if(!result)
+            THROW("Null result passed to rocalGetAutotuneResult")
+        AutotuneConfig config;
+        double batches_per_second;
+        result->done = context->master_graph->autotune_result(config, batches_per_second);
+        result->decode_threads = config.decode_threads;
+        result->graph_threads = config.graph_threads;
+        result->prefetch_depth = config.prefetch_depth;
+        result->batches_per_second = batches_per_second;
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalSetOutputSize(RocalContext p_context, unsigned width, unsigned height)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        context->master_graph->set_output_size(width, height);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_INVALID_PARAMETER_TYPE;
+    }
+    return ROCAL_OK;
+}
+
 RocalStatus ROCAL_API_CALL
 rocalVerify(RocalContext p_context)
 {
@@ -48,12 +48,26 @@ rocalSequenceRearrange(
     {
         if(sequence_length == 0)
             THROW("sequence_length passed should be bigger than 0")
+        if(new_sequence_length == 0)
+            THROW("new_sequence_length passed should be bigger than 0")
         auto input = static_cast<Image*>(p_input);
         auto info = ImageInfo(input->info().width(), input->info().height_single(),
                               context->user_batch_size() * new_sequence_length,
                               input->info().color_plane_count(),
                               context->master_graph->mem_type(),
                               input->info().color_format() );
+        // Straight out of a video loader or sequence reader, the loader reads only the frames of the new order, already in place
+        std::vector<unsigned> order(new_order, new_order + new_sequence_length);
+        if(auto loader_output = context->master_graph->fold_sequence_rearrange(input, info, order))
+        {
+            output = loader_output;
+            if(is_output)
+            {
+                output = context->master_graph->create_image(info, is_output);
+                context->master_graph->add_node<CopyNode>({loader_output}, {output});
+            }
+            return output;
+        }
         output = context->master_graph->create_image(info, is_output);
         std::shared_ptr<SequenceRearrangeNode> sequence_rearrange_node =  context->master_graph->add_node<SequenceRearrangeNode>({input}, {output});
         sequence_rearrange_node->init(new_order, new_sequence_length, sequence_length, context->user_batch_size());
@@ -2010,6 +2024,7 @@ rocalSSDRandomCrop(
         crop_node->init(crop_area_factor, crop_aspect_ratio, x_drift, y_drift, num_of_attempts);
         if (context->master_graph->meta_data_graph())
             context->master_graph->meta_add_node<SSDRandomCropMetaNode,SSDRandomCropNode>(crop_node);
+        context->master_graph->set_ssd_random_crop_sampler(crop_node);
     }
     catch(const std::exception& e)
     {
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "node_image_loader.h"
 #include "node_image_loader_single_shard.h"
 #include "node_cifar10_loader.h"
+#include "node_service_loader.h"
 #include "image_source_evaluator.h"
 #include "node_copy.h"
 #include "node_fused_jpeg_crop.h"
@@ -2558,6 +2559,54 @@ rocalRawCIFAR10Source(
 }
 
 
+RocalImage ROCAL_API_CALL
+rocalServiceSource(
+                 RocalContext p_context,
+                 const char* service_name,
+                 unsigned rank,
+                 bool is_output,
+                 unsigned timeout_ms)
+{
+    Image* output = nullptr;
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if(context->affinity != RocalAffinity::CPU)
+            THROW("The client of a rocAL service only runs on the CPU")
+        auto segment = ShmBatchRing::segment_name(service_name, rank);
+        auto batch_ring = ShmBatchRing::attach(segment, timeout_ms);
+        auto &layout = batch_ring->layout();
+        if(layout.batch_size != context->user_batch_size())
+            THROW("The batch size of the rocAL service " + TOSTR(layout.batch_size) + " does not match the one of the context " + TOSTR(context->user_batch_size()))
+
+        INFO("Internal buffer size width = "+ TOSTR(layout.width)+ " height = "+ TOSTR(layout.height) + " depth = "+ TOSTR(layout.planes))
+
+        auto info = ImageInfo(layout.width, layout.height,
+                              context->user_batch_size(),
+                              layout.planes,
+                              context->master_graph->mem_type(),
+                              static_cast<RocalColorFormat>(layout.color_format));
+        output = context->master_graph->create_loader_output_image(info);
+
+        context->master_graph->add_node<ServiceLoaderNode>({}, {output})->init(batch_ring, context->master_graph->mem_type());
+        if(layout.has_meta_data)
+            context->master_graph->create_service_meta_data_reader(segment, static_cast<MetaDataType>(layout.meta_data_type));
+
+        if(is_output)
+        {
+            auto actual_output = context->master_graph->create_image(info, is_output);
+            context->master_graph->add_node<CopyNode>({output}, {actual_output});
+        }
+
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        std::cerr << e.what() << '\n';
+    }
+    return output;
+}
+
 RocalStatus ROCAL_API_CALL
 rocalResetLoaders(RocalContext p_context)
 {
@@ -2574,3 +2623,254 @@ rocalResetLoaders(RocalContext p_context)
     }
     return ROCAL_OK;
 }
+
+RocalImage  ROCAL_API_CALL
+rocalSyntheticSource(
+        RocalContext p_context,
+        RocalImageColor rocal_color_format,
+        unsigned internal_shard_count,
+        bool is_output,
+        unsigned num_samples,
+        unsigned min_width,
+        unsigned max_width,
+        unsigned min_height,
+        unsigned max_height,
+        RocalSyntheticMetaData meta_data,
+        unsigned num_classes,
+        unsigned max_boxes,
+        bool jpeg_encoded,
+        unsigned seed,
+        bool shuffle,
+        bool loop)
+{
+    Image* output = nullptr;
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if(internal_shard_count < 1 )
+            THROW("Shard count should be bigger than 0")
+        if(num_samples == 0 || min_width == 0 || min_height == 0 || min_width > max_width || min_height > max_height)
+            THROW("Invalid synthetic source sample count or size range")
+
+        SyntheticDataConfig synthetic_config;
+        synthetic_config.sample_count = num_samples;
+        synthetic_config.min_width = min_width;
+        synthetic_config.max_width = max_width;
+        synthetic_config.min_height = min_height;
+        synthetic_config.max_height = max_height;
+        synthetic_config.jpeg_encoded = jpeg_encoded;
+        synthetic_config.num_classes = num_classes;
+        synthetic_config.max_boxes = (meta_data == ROCAL_SYNTHETIC_BOXES) ? max_boxes : 0;
+        synthetic_config.seed = seed;
+        if(meta_data == ROCAL_SYNTHETIC_BOXES && max_boxes == 0)
+            THROW("Synthetic boxes need max_boxes to be bigger than 0")
+        if(meta_data != ROCAL_SYNTHETIC_NO_META_DATA)
+            context->master_graph->create_synthetic_meta_data_reader(synthetic_config,
+                                                                     meta_data == ROCAL_SYNTHETIC_BOXES ? MetaDataType::BoundingBox : MetaDataType::Label,
+                                                                     true);
+
+        auto [color_format, num_of_planes] = convert_color_format(rocal_color_format);
+
+        INFO("Internal buffer size width = "+ TOSTR(max_width)+ " height = "+ TOSTR(max_height) + " depth = "+ TOSTR(num_of_planes))
+
+        auto info = ImageInfo(max_width, max_height,
+                              context->user_batch_size(),
+                              num_of_planes,
+                              context->master_graph->mem_type(),
+                              color_format );
+        output = context->master_graph->create_loader_output_image(info);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(1);
+
+        auto loader_node = context->master_graph->add_node<ImageLoaderNode>({}, {output});
+        loader_node->set_synthetic_data_config(synthetic_config);
+        // The images keep their own size within the output, as with ROCAL_USE_MAX_SIZE_RESTRICTED
+        loader_node->init(internal_shard_count, cpu_num_threads,
+                          "", "",
+                          std::map<std::string, std::string>(),
+                          StorageType::SYNTHETIC,
+                          jpeg_encoded ? DecoderType::TURBO_JPEG : DecoderType::SYNTHETIC,
+                          shuffle,
+                          loop,
+                          context->user_batch_size(),
+                          context->master_graph->mem_type(),
+                          context->master_graph->meta_data_reader(),
+                          true);
+        context->master_graph->set_loop(loop);
+
+        if(is_output)
+        {
+            auto actual_output = context->master_graph->create_image(info, is_output);
+            context->master_graph->add_node<CopyNode>({output}, {actual_output});
+        }
+
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        std::cerr << e.what() << '\n';
+    }
+    return output;
+}
+
+RocalImage  ROCAL_API_CALL
+rocalNumpyFileSource(
+        RocalContext p_context,
+        const char* source_path,
+        RocalImageColor rocal_color_format,
+        unsigned internal_shard_count,
+        bool is_output,
+        unsigned max_width,
+        unsigned max_height,
+        bool shuffle,
+        bool loop,
+        unsigned raw_width,
+        unsigned raw_height)
+{
+    Image* output = nullptr;
+    if (p_context == nullptr) {
+        ERR("Invalid ROCAL context or invalid input image")
+        return output;
+    }
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if(internal_shard_count < 1 )
+            THROW("Shard count should be bigger than 0")
+        if(max_width == 0 || max_height == 0)
+            THROW("Invalid output width and height")
+        if((raw_width == 0) != (raw_height == 0))
+            THROW("Both the raw sample width and height need to be set for raw tensor files")
+
+        auto [color_format, num_of_planes] = convert_color_format(rocal_color_format);
+        RawSampleShape raw_shape;
+        if(raw_width && raw_height)
+        {
+            raw_shape.width = raw_width;
+            raw_shape.height = raw_height;
+            raw_shape.channels = num_of_planes;
+        }
+
+        INFO("Internal buffer size width = "+ TOSTR(max_width)+ " height = "+ TOSTR(max_height) + " depth = "+ TOSTR(num_of_planes))
+
+        auto info = ImageInfo(max_width, max_height,
+                              context->user_batch_size(),
+                              num_of_planes,
+                              context->master_graph->mem_type(),
+                              color_format );
+        output = context->master_graph->create_loader_output_image(info);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(1);
+
+        auto loader_node = context->master_graph->add_node<ImageLoaderNode>({}, {output});
+        loader_node->set_raw_sample_shape(raw_shape);
+        loader_node->init(internal_shard_count, cpu_num_threads,
+                          source_path, "",
+                          std::map<std::string, std::string>(),
+                          StorageType::NUMPY_DATA,
+                          DecoderType::SKIP_DECODE,
+                          shuffle,
+                          loop,
+                          context->user_batch_size(),
+                          context->master_graph->mem_type(),
+                          context->master_graph->meta_data_reader(),
+                          true);
+        context->master_graph->set_loop(loop);
+
+        if(is_output)
+        {
+            auto actual_output = context->master_graph->create_image(info, is_output);
+            context->master_graph->add_node<CopyNode>({output}, {actual_output});
+        }
+
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        std::cerr << e.what() << '\n';
+    }
+    return output;
+}
+
+RocalImage ROCAL_API_CALL
+rocalTarShardSource(
+        RocalContext p_context,
+        const char* source_path,
+        RocalImageColor rocal_color_format,
+        unsigned internal_shard_count,
+        bool is_output,
+        bool shuffle,
+        bool loop,
+        RocalImageSizeEvaluationPolicy decode_size_policy,
+        unsigned max_width,
+        unsigned max_height,
+        RocalDecoderType dec_type,
+        unsigned shuffle_buffer_size)
+{
+    Image* output = nullptr;
+    if (p_context == nullptr) {
+        ERR("Invalid ROCAL context or invalid input image")
+        return output;
+    }
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        bool use_input_dimension = (decode_size_policy == ROCAL_USE_USER_GIVEN_SIZE) || (decode_size_policy == ROCAL_USE_USER_GIVEN_SIZE_RESTRICTED);
+        bool decoder_keep_original = (decode_size_policy == ROCAL_USE_USER_GIVEN_SIZE_RESTRICTED) || (decode_size_policy == ROCAL_USE_MAX_SIZE_RESTRICTED);
+        DecoderType decType = DecoderType::TURBO_JPEG; // default
+        if (dec_type == ROCAL_DECODER_OPENCV) decType = DecoderType::OPENCV_DEC;
+
+        if(internal_shard_count < 1 )
+            THROW("Shard count should be bigger than 0")
+
+        if(use_input_dimension && (max_width == 0 || max_height == 0))
+        {
+            THROW("Invalid input max width and height");
+        }
+        else
+        {
+            LOG("User input size " + TOSTR(max_width) + " x " + TOSTR(max_height))
+        }
+
+        auto [width, height] = use_input_dimension? std::make_tuple(max_width, max_height):
+                               evaluate_image_data_set(decode_size_policy, StorageType::TAR_SHARDS, DecoderType::TURBO_JPEG, source_path, "");
+
+        auto [color_format, num_of_planes] = convert_color_format(rocal_color_format);
+
+        INFO("Internal buffer size width = "+ TOSTR(width)+ " height = "+ TOSTR(height) + " depth = "+ TOSTR(num_of_planes))
+
+        auto info = ImageInfo(width, height,
+                              context->user_batch_size(),
+                              num_of_planes,
+                              context->master_graph->mem_type(),
+                              color_format );
+        output = context->master_graph->create_loader_output_image(info);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(1);
+
+        auto loader_node = context->master_graph->add_node<ImageLoaderNode>({}, {output});
+        loader_node->set_shuffle_buffer_size(shuffle_buffer_size);
+        loader_node->init(internal_shard_count, cpu_num_threads,
+                          source_path, "",
+                          std::map<std::string, std::string>(),
+                          StorageType::TAR_SHARDS,
+                          decType,
+                          shuffle,
+                          loop,
+                          context->user_batch_size(),
+                          context->master_graph->mem_type(),
+                          context->master_graph->meta_data_reader(),
+                          decoder_keep_original);
+        context->master_graph->set_loop(loop);
+
+        if(is_output)
+        {
+            auto actual_output = context->master_graph->create_image(info, is_output);
+            context->master_graph->add_node<CopyNode>({output}, {actual_output});
+        }
+
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        std::cerr << e.what() << '\n';
+    }
+    return output;
+}
@@ -127,4 +127,162 @@ ROCAL_API_CALL rocalSetOutputs(RocalContext p_context, unsigned int num_of_outpu
     }
 }
 
+RocalStatus ROCAL_API_CALL
+rocalAcquireOutputBatch(RocalContext p_context, unsigned long long *lease)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if(!lease)
+            THROW("Null lease pointer passed to rocalAcquireOutputBatch")
+        *lease = context->master_graph->acquire_output_batch();
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalReleaseOutputBatch(RocalContext p_context, unsigned long long lease)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        context->master_graph->release_output_batch(lease);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalGetOutputBatchImages(RocalContext p_context, unsigned long long lease, void **image_buffers, unsigned buffer_count, RocalOutputMemType *mem_type)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        auto buffers = context->master_graph->output_batch_buffers(lease);
+        if(!image_buffers || buffer_count < buffers.size())
+            THROW("Output batch has " + TOSTR(buffers.size()) + " images, buffer count passed is " + TOSTR(buffer_count))
+        for(unsigned i = 0; i < buffers.size(); i++)
+            image_buffers[i] = buffers[i];
+        if(mem_type)
+            *mem_type = (context->master_graph->mem_type() == RocalMemType::HOST) ? ROCAL_MEMCPY_HOST : ROCAL_MEMCPY_GPU;
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalGetOutputBatchLabels(RocalContext p_context, unsigned long long lease, int **labels)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        auto& meta_data = context->master_graph->output_batch_meta_data(lease);
+        *labels = (meta_data.second && !meta_data.second->get_label_batch().empty()) ? meta_data.second->get_label_batch().data() : nullptr;
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
 
+RocalStatus ROCAL_API_CALL
+rocalGetOutputBatchBoundingBoxes(RocalContext p_context, unsigned long long lease, float **boxes, int **box_labels, int *box_counts)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        auto& meta_data = context->master_graph->output_batch_meta_data(lease);
+        if(!meta_data.second)
+            THROW("No bounding box has been loaded for the output batch")
+        auto& bb_cords = meta_data.second->get_bb_cords_batch();
+        auto& bb_labels = meta_data.second->get_bb_labels_batch();
+        for(unsigned i = 0; i < bb_cords.size(); i++)
+        {
+            // BoundingBoxCord is a plain struct of 4 floats, the coordinates of a sample are stored contiguously
+            boxes[i] = bb_cords[i].empty() ? nullptr : reinterpret_cast<float*>(bb_cords[i].data());
+            box_labels[i] = bb_labels[i].empty() ? nullptr : bb_labels[i].data();
+            box_counts[i] = bb_cords[i].size();
+        }
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalGetOutputBatchEncodedBoxes(RocalContext p_context, unsigned long long lease, float **boxes, int **labels)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        auto encoded_boxes_and_labels = context->master_graph->output_batch_encoded_boxes(lease);
+        *boxes = static_cast<float*>(encoded_boxes_and_labels.first);
+        *labels = static_cast<int*>(encoded_boxes_and_labels.second);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalGetOutputBatchHeatmaps(RocalContext p_context, unsigned long long lease, float **heatmaps, float **target_weights)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        auto heatmaps_and_weights = context->master_graph->output_batch_heatmaps(lease);
+        *heatmaps = static_cast<float*>(heatmaps_and_weights.first);
+        *target_weights = static_cast<float*>(heatmaps_and_weights.second);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalGetOutputBatchSoftLabels(RocalContext p_context, unsigned long long lease, float **soft_labels)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        *soft_labels = static_cast<float*>(context->master_graph->output_batch_soft_labels(lease));
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
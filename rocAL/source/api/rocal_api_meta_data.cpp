@@ -152,6 +152,26 @@ ROCAL_API_CALL rocalCreateMXNetReader(RocalContext p_context, const char* source
 
 }
 
+RocalMetaData
+ROCAL_API_CALL rocalCreateTarShardLabelReader(RocalContext p_context, const char* source_path)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalCreateTarShardLabelReader")
+    auto context = static_cast<Context*>(p_context);
+
+    return context->master_graph->create_tar_shard_meta_data_reader(source_path, MetaDataType::Label, false);
+}
+
+RocalMetaData
+ROCAL_API_CALL rocalCreateTarShardReaderDetection(RocalContext p_context, const char* source_path, bool is_output)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalCreateTarShardReaderDetection")
+    auto context = static_cast<Context*>(p_context);
+
+    return context->master_graph->create_tar_shard_meta_data_reader(source_path, MetaDataType::BoundingBox, is_output);
+}
+
 RocalMetaData
 ROCAL_API_CALL rocalCreateTextFileBasedLabelReader(RocalContext p_context, const char* source_path) {
 
@@ -322,10 +342,13 @@ ROCAL_API_CALL rocalGetOneHotImageLabels(RocalContext p_context, void* buf, int
     if(context->user_batch_size() != meta_data_batch_size)
         THROW("meta data batch size is wrong " + TOSTR(meta_data_batch_size) + " != "+ TOSTR(context->user_batch_size() ))
 
-    int labels_buf[meta_data_batch_size];
-    int one_hot_encoded[meta_data_batch_size*numOfClasses];
+    // Encoded straight into the user's buffer when it is on the host
+    std::vector<int> device_staging;
+    if (dest != 0)
+        device_staging.resize(meta_data_batch_size * numOfClasses);
+    int *one_hot_encoded = (dest == 0) ? static_cast<int *>(buf) : device_staging.data();
+    const int *labels_buf = meta_data.second->get_label_batch().data();
     memset(one_hot_encoded, 0, sizeof(int) * meta_data_batch_size * numOfClasses);
-    memcpy(labels_buf, meta_data.second->get_label_batch().data(),  sizeof(int)*meta_data_batch_size);
 
     for(uint i = 0; i < meta_data_batch_size; i++)
     {
@@ -341,9 +364,7 @@ ROCAL_API_CALL rocalGetOneHotImageLabels(RocalContext p_context, void* buf, int
         }
 
     }
-    if (dest == 0) // HOST DESTINATION
-        memcpy(buf, one_hot_encoded, sizeof(int) * meta_data_batch_size * numOfClasses);
-    else
+    if (dest != 0)
     {
 #if ENABLE_HIP
         hipError_t err = hipMemcpy(buf, one_hot_encoded, sizeof(int) * meta_data_batch_size * numOfClasses, hipMemcpyHostToDevice);
@@ -498,6 +519,54 @@ ROCAL_API_CALL rocalGetEncodedBoxesAndLables(RocalContext p_context, float **box
     }
 }
 
+void ROCAL_API_CALL rocalKeyPointHeatmaps(RocalContext p_context, unsigned heatmap_width, unsigned heatmap_height)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalKeyPointHeatmaps")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->keypoint_heatmaps(heatmap_width, heatmap_height);
+}
+
+void
+ROCAL_API_CALL rocalGetKeyPointHeatmaps(RocalContext p_context, float **heatmaps_buf_ptr, float **target_weights_buf_ptr)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetKeyPointHeatmaps")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->get_keypoint_heatmap_buffers(heatmaps_buf_ptr, target_weights_buf_ptr);
+}
+
+void ROCAL_API_CALL rocalBatchMix(RocalContext p_context, RocalBatchMixMode mode, unsigned num_classes, float alpha, float probability, float label_smoothing)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalBatchMix")
+    auto context = static_cast<Context *>(p_context);
+    auto translate_batch_mix_mode = [](RocalBatchMixMode batch_mix_mode)
+    {
+        switch(batch_mix_mode)
+        {
+            case ROCAL_BATCH_MIX_NONE:
+                return BatchMixMode::NONE;
+            case ROCAL_BATCH_MIX_MIXUP:
+                return BatchMixMode::MIXUP;
+            case ROCAL_BATCH_MIX_CUTMIX:
+                return BatchMixMode::CUTMIX;
+            default:
+                THROW("Unknown Rocal batch mix mode")
+        }
+    };
+    context->master_graph->batch_mix(translate_batch_mix_mode(mode), num_classes, alpha, probability, label_smoothing);
+}
+
+void
+ROCAL_API_CALL rocalGetSoftLabels(RocalContext p_context, float **soft_labels_buf_ptr)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetSoftLabels")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->get_soft_label_buffer(soft_labels_buf_ptr);
+}
+
 void
 ROCAL_API_CALL rocalGetJointsDataPtr(RocalContext p_context, RocalJointsData **joints_data)
 {
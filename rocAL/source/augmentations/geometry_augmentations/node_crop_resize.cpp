@@ -28,7 +28,7 @@ THE SOFTWARE.
 CropResizeNode::CropResizeNode(const std::vector<Image *> &inputs, const std::vector<Image *> &outputs) :
         Node(inputs, outputs),
         _dest_width(_outputs[0]->info().width()),
-        _dest_height(_outputs[0]->info().height_batch())
+        _dest_height(_outputs[0]->info().height_single())
 {
     _crop_param = std::make_shared<RocalRandomCropParam>(_batch_size);
 }
@@ -68,6 +68,26 @@ void CropResizeNode::update_node()
 {
     _crop_param->set_image_dimensions(_inputs[0]->info().get_roi_width_vec(), _inputs[0]->info().get_roi_height_vec());
     _crop_param->update_array();
+    if(_dst_roi_changed)
+    {
+        vx_status width_status, height_status;
+        width_status = vxCopyArrayRange((vx_array)_dst_roi_width, 0, _batch_size, sizeof(vx_uint32), _dst_roi_width_vec.data(), VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
+        height_status = vxCopyArrayRange((vx_array)_dst_roi_height, 0, _batch_size, sizeof(vx_uint32), _dst_roi_height_vec.data(), VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
+        if(width_status != 0 || height_status != 0)
+            WRN("ERROR: vxCopyArrayRange _dst_roi_width or _dst_roi_height failed " + TOSTR(width_status) + "  " + TOSTR(height_status));
+        _dst_roi_changed = false;
+    }
+    if(!_dst_roi_width_vec.empty())
+        _outputs[0]->update_image_roi(_dst_roi_width_vec, _dst_roi_height_vec);
+}
+
+void CropResizeNode::set_output_size(unsigned width, unsigned height)
+{
+    _dest_width = std::min<size_t>(width, _outputs[0]->info().width());
+    _dest_height = std::min<size_t>(height, _outputs[0]->info().height_single());
+    _dst_roi_width_vec.assign(_batch_size, _dest_width);
+    _dst_roi_height_vec.assign(_batch_size, _dest_height);
+    _dst_roi_changed = true;
 }
 
 void CropResizeNode::init(float area, float aspect_ratio, float x_center_drift, float y_center_drift)
@@ -20,6 +20,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
+#include <algorithm>
 #include <vx_ext_rpp.h>
 #include <graph.h>
 #include "node_ssd_random_crop.h"
@@ -57,149 +58,43 @@ void SSDRandomCropNode::create_node()
         THROW("Error adding the crop resize node (vxExtrppNode_ResizeCropbatchPD    ) failed: " + TOSTR(status))
 }
 
-inline double ssd_BBoxIntersectionOverUnion(const BoundingBoxCord &box1, const BoundingBoxCord &box2, bool is_iou = false)
+void SSDRandomCropNode::set_batch_crop_windows(const std::vector<std::string> &names, size_t epoch, const std::vector<BBoxCropWindow> &windows)
 {
-    double iou;
-    float xA = std::max(box1.l, box2.l);
-    float yA = std::max(box1.t, box2.t);
-    float xB = std::min(box1.r, box2.r);
-    float yB = std::min(box1.b, box2.b);
-    float intersection_area = std::max((float)0.0, xB - xA) * std::max((float)0.0, yB - yA);
-    float box1_h, box1_w, box2_h, box2_w;
-    box1_w = box1.r - box1.l;
-    box2_w = box2.r - box2.l;
-    box1_h = box1.b - box1.t;
-    box2_h = box2.b - box2.t;
-    float box1_area = box1_h * box1_w;
-    float box2_area = box2_h * box2_w;
-    if (is_iou)
-        iou = intersection_area / float(box1_area + box2_area - intersection_area);
-    else
-        iou = intersection_area / float(box1_area);
-
-    return iou;
+    _names = names;
+    _epoch = epoch;
+    _windows = windows;
 }
 
 void SSDRandomCropNode::update_node()
 {
     _crop_param->set_image_dimensions(_inputs[0]->info().get_roi_width_vec(), _inputs[0]->info().get_roi_height_vec());
     _crop_param->update_array();
-    // std::cerr<<"\n batch_size:: "<<_batch_size<<"\n meta array size:: "<<_meta_data_info->size();
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 6);
-    const std::vector<std::pair<float, float>> IOU = {std::make_pair(0.0f, 1.0f), std::make_pair(0.1f, 1.0f), std::make_pair(0.3f, 1.0f),
-                                            std::make_pair(0.5f, 1.0f), std::make_pair(0.45f, 1.0f), std::make_pair(0.35f, 1.0f), std::make_pair(0.0f, 1.0f) };
-    int sample_option;
-    std::pair<float, float> iou;
-    float min_iou, max_iou;
-    float w_factor = 0.0f, h_factor = 0.0f;
     in_width = _crop_param->in_width;
     in_height = _crop_param->in_height;
-    bool invalid_bboxes = true;
     _entire_iou = true;
-    BoundingBoxCord crop_box, jth_box;
-    _x1_val = _crop_param->get_x1_arr_val();
-    _y1_val = _crop_param->get_y1_arr_val();
-    _crop_width_val = _crop_param->get_cropw_arr_val();
-    _crop_height_val = _crop_param->get_croph_arr_val();
-    std::uniform_real_distribution<float> _float_dis(0.3, 1.0);
-    size_t sample = 0;
+    if (_windows.size() != _batch_size)
+    {
+        // Not picked by the loader (batch loaded before the sampler was handed to it), picked here the same way from the batch's boxes
+        if (_names.size() != _batch_size)
+            THROW("SSD random crop needs the names of the " + TOSTR(_batch_size) + " images of the batch, got " + TOSTR(_names.size()))
+        std::vector<const BoundingBoxCords *> boxes(_batch_size);
+        for (uint i = 0; i < _batch_size; i++)
+            boxes[i] = &_meta_data_info->get_bb_cords_batch()[i];
+        _sampler->sample_batch(boxes, _names, _epoch, _windows);
+    }
     for (uint i = 0; i < _batch_size; i++)
     {
-        int bb_count = _meta_data_info->get_bb_labels_batch()[i].size();
-        std::vector<int> labels_buf(bb_count);
-        memcpy(labels_buf.data(), _meta_data_info->get_bb_labels_batch()[i].data(), sizeof(int) * bb_count);
-        std::vector<float> coords_buf(bb_count * 4);
-        memcpy(coords_buf.data(), _meta_data_info->get_bb_cords_batch()[i].data(), _meta_data_info->get_bb_cords_batch()[i].size() * sizeof(BoundingBoxCord));
-
-        crop_box.b = _y1_val[i] + _crop_height_val[i];
-        crop_box.r = _x1_val[i] + _crop_width_val[i];
-        crop_box.l = _x1_val[i];
-        crop_box.t = _y1_val[i];
-        while (true)
-        {
-            sample_option = dis(gen);
-            iou =  IOU[sample_option];
-            _iou_range[i] = iou;
-            min_iou = iou.first;
-            max_iou = iou.second;
-            //sample_option = 0;
-            if (!sample_option)
-            {
-                crop_box.l = 0;
-                crop_box.t = 0;
-                crop_box.r = 1;
-                crop_box.b = 1;
-                break;
-            }
-            float aspect_ratio;
-            for (int j = 0; j < _num_of_attempts; j++)
-            {
-
-                // Setting width and height factor btw 0.3 and 1.0";
-                float w_factor = _float_dis(_rngs[sample]);
-                float h_factor = _float_dis(_rngs[sample]);
-                //aspect ratio check
-                aspect_ratio = w_factor/h_factor;
-                if ((aspect_ratio < 0.5) || (aspect_ratio > 2.))
-                    continue;
-            }
-            if ((aspect_ratio < 0.5) || (aspect_ratio > 2.))
-                continue;
-
-
-            // Setting width factor btw 0 and 1 - width_factor and height factor btw 0 and 1 - height_factor
-            std::uniform_real_distribution<float> l_dis(0.0, 1.0 - w_factor), t_dis(0.0, 1.0-h_factor);
-            float x_factor = l_dis(_rngs[sample]);
-            float y_factor = t_dis(_rngs[sample]);
-            //Got the crop
-            crop_box.l = x_factor;
-            crop_box.t = y_factor;
-            crop_box.r = crop_box.l + w_factor;
-            crop_box.b = crop_box.t + h_factor;
-
-            invalid_bboxes = false;
-
-            for (int j = 0; j < bb_count; j++)
-            {
-                int m = j * 4;
-                jth_box.l = coords_buf[m];
-                jth_box.t = coords_buf[m + 1];
-                jth_box.r = coords_buf[m + 2];
-                jth_box.b = coords_buf[m + 3];
-                float bb_iou = ssd_BBoxIntersectionOverUnion(jth_box, crop_box, _entire_iou);
-                if (bb_iou < min_iou || bb_iou > max_iou )
-                {
-                    invalid_bboxes = true;
-                    break;
-                }
-            }
-
-            if (invalid_bboxes)
-                continue;
-            int valid_bbox_count = 0;
-            auto left = crop_box.l, top = crop_box.t, right = crop_box.r, bottom = crop_box.b;
-            for (int j = 0; j < bb_count; j++)
-            {
-                int m = j * 4;
-                auto x_c = 0.5f * (2 * coords_buf[m] + coords_buf[m + 2]);
-                auto y_c = 0.5f * (2 * coords_buf[m + 1] + coords_buf[m + 3]);
-                if ((x_c >= left) && (x_c <= right) && (y_c >= top) && (y_c <= bottom))
-                    valid_bbox_count++;
-            }
-            if (valid_bbox_count == 0)
-                continue;
-            break;
-        } // while loop
+        const BoundingBoxCord &crop_box = _windows[i].window;
+        _iou_range[i] = std::make_pair(_windows[i].min_iou, _windows[i].max_iou);
         _x1_val[i] = (crop_box.l) * in_width[i];
         _y1_val[i] = (crop_box.t) * in_height[i];
         _crop_width_val[i] = (crop_box.r - crop_box.l) * in_width[i];
         _crop_height_val[i] = (crop_box.b - crop_box.t) * in_height[i];
         _x2_val[i] =  (crop_box.r) * in_width[i];
         _y2_val[i] =  (crop_box.b) * in_height[i];
-
     }
+    // Used once, the next batch brings its own
+    _windows.clear();
     vxCopyArrayRange((vx_array)_crop_param->cropw_arr, 0, _batch_size, sizeof(uint), _crop_width_val.data(), VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
     vxCopyArrayRange((vx_array)_crop_param->croph_arr, 0, _batch_size, sizeof(uint), _crop_height_val.data(), VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
     vxCopyArrayRange((vx_array)_crop_param->x1_arr, 0, _batch_size, sizeof(uint), _x1_val.data(), VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
@@ -213,5 +108,10 @@ void SSDRandomCropNode::init(FloatParam *crop_area_factor, FloatParam *crop_aspe
     _crop_param->set_y_drift_factor(core(y_drift));
     _crop_param->set_area_factor(core(crop_area_factor));
     _crop_param->set_aspect_ratio(core(crop_aspect_ratio));
-    _num_of_attempts = num_of_attempts;
+    _num_of_attempts = std::max(num_of_attempts, 1);
+    // Option 0 keeps the whole image, the others need the IoU of every box with the window to be in their range
+    const std::vector<BBoxCropOption> options = {{0.0f, 1.0f, true}, {0.1f, 1.0f, false}, {0.3f, 1.0f, false}, {0.5f, 1.0f, false},
+                                                 {0.45f, 1.0f, false}, {0.35f, 1.0f, false}, {0.0f, 1.0f, false}};
+    _sampler = std::make_shared<BBoxCropSampler>(options, true, true, _num_of_attempts, _num_of_attempts * options.size(),
+                                                 ParameterFactory::instance()->get_seed(), ParameterFactory::instance()->next_stream());
 }
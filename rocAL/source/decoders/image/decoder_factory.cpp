@@ -26,6 +26,8 @@ THE SOFTWARE.
 #include <fused_crop_decoder.h>
 #include <open_cv_decoder.h>
 #include <hw_jpeg_decoder.h>
+#include <synthetic_decoder.h>
+#include <multi_format_decoder.h>
 #include "decoder_factory.h"
 #include "commons.h"
 
@@ -33,11 +35,15 @@ std::shared_ptr<Decoder> create_decoder(DecoderConfig config) {
     switch(config.type())
     {
         case DecoderType::TURBO_JPEG:
-            return std::make_shared<TJDecoder>();
+            // TurboJpeg for the JPEG images, and the other formats of mixed datasets by their own decoders
+            return std::make_shared<MultiFormatDecoder>();
             break;
         case DecoderType::FUSED_TURBO_JPEG:
             return std::make_shared<FusedCropTJDecoder>();
             break;
+        case DecoderType::SYNTHETIC:
+            return std::make_shared<SyntheticDecoder>();
+            break;
 #if ENABLE_OPENCV
         case DecoderType::OPENCV_DEC:
             return std::make_shared<CVDecoder>();
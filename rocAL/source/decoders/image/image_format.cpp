@@ -0,0 +1,185 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <cstdint>
+#include "image_format.h"
+
+namespace
+{
+uint16_t read_le16(const unsigned char* p) { return p[0] | (p[1] << 8); }
+uint32_t read_le32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24); }
+uint16_t read_be16(const unsigned char* p) { return (p[0] << 8) | p[1]; }
+uint32_t read_be32(const unsigned char* p) { return (uint32_t(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+
+bool probe_jpeg(const unsigned char* data, size_t size, int* width, int* height, int* color_comps)
+{
+    size_t pos = 2;
+    while (pos + 4 <= size)
+    {
+        if (data[pos] != 0xFF)
+            return false;
+        unsigned char marker = data[pos + 1];
+        if (marker == 0xFF) {// fill byte
+            pos++;
+            continue;
+        }
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD9)) {// markers without a segment
+            pos += 2;
+            continue;
+        }
+        size_t length = read_be16(data + pos + 2);
+        // Start of frame markers, except DHT (C4), JPG (C8) and DAC (CC)
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            if (pos + 10 > size)
+                return false;
+            *height = read_be16(data + pos + 5);
+            *width = read_be16(data + pos + 7);
+            *color_comps = data[pos + 9];
+            return *width > 0 && *height > 0;
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+bool probe_png(const unsigned char* data, size_t size, int* width, int* height, int* color_comps)
+{
+    if (size < 26 || memcmp(data + 12, "IHDR", 4) != 0)
+        return false;
+    *width = read_be32(data + 16);
+    *height = read_be32(data + 20);
+    switch (data[25])
+    {
+        case 0: *color_comps = 1; break;// gray
+        case 4: *color_comps = 2; break;// gray + alpha
+        case 6: *color_comps = 4; break;// RGBA
+        default: *color_comps = 3;// RGB, palette
+    }
+    return *width > 0 && *height > 0;
+}
+
+bool probe_webp(const unsigned char* data, size_t size, int* width, int* height, int* color_comps)
+{
+    if (size < 30)
+        return false;
+    const unsigned char* chunk = data + 12;
+    *color_comps = 3;
+    if (memcmp(chunk, "VP8 ", 4) == 0) {
+        // Lossy: 3 bytes of frame tag, the 9d 01 2a start code, then the 14 bit dimensions
+        if (chunk[11] != 0x9d || chunk[12] != 0x01 || chunk[13] != 0x2a)
+            return false;
+        *width = read_le16(chunk + 14) & 0x3fff;
+        *height = read_le16(chunk + 16) & 0x3fff;
+    } else if (memcmp(chunk, "VP8L", 4) == 0) {
+        // Lossless: 0x2f signature, then the 14 bit width - 1, height - 1 and the alpha hint
+        if (chunk[8] != 0x2f)
+            return false;
+        uint32_t bits = read_le32(chunk + 9);
+        *width = (bits & 0x3fff) + 1;
+        *height = ((bits >> 14) & 0x3fff) + 1;
+        *color_comps = ((bits >> 28) & 1) ? 4 : 3;
+    } else if (memcmp(chunk, "VP8X", 4) == 0) {
+        // Extended: flags, 3 reserved bytes, then the 24 bit canvas width - 1 and height - 1
+        *color_comps = (chunk[8] & 0x10) ? 4 : 3;
+        *width = (chunk[12] | (chunk[13] << 8) | (chunk[14] << 16)) + 1;
+        *height = (chunk[15] | (chunk[16] << 8) | (chunk[17] << 16)) + 1;
+    } else {
+        return false;
+    }
+    return *width > 0 && *height > 0;
+}
+}
+
+ImageFormat sniff_image_format(const unsigned char* data, size_t size)
+{
+    static const unsigned char PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    if (size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF)
+        return ImageFormat::JPEG;
+    if (size >= 8 && memcmp(data, PNG_SIGNATURE, 8) == 0)
+        return ImageFormat::PNG;
+    if (size >= 12 && memcmp(data, "RIFF", 4) == 0 && memcmp(data + 8, "WEBP", 4) == 0)
+        return ImageFormat::WEBP;
+    if (size >= 18 && data[0] == 'B' && data[1] == 'M')
+        return ImageFormat::BMP;
+    return ImageFormat::UNKNOWN;
+}
+
+bool parse_bmp_header(const unsigned char* data, size_t size, BmpInfo& info)
+{
+    if (size < 26 || data[0] != 'B' || data[1] != 'M')
+        return false;
+    info.data_offset = read_le32(data + 10);
+    const uint32_t dib_size = read_le32(data + 14);
+    int32_t height;
+    if (dib_size == 12) {// OS/2 BITMAPCOREHEADER
+        info.width = read_le16(data + 18);
+        height = static_cast<int16_t>(read_le16(data + 20));
+        info.bits_per_pixel = read_le16(data + 24);
+        info.compression = 0;
+        info.palette_entry_size = 3;
+        info.palette_size = 0;
+    } else if (dib_size >= 40 && size >= 14 + 40) {
+        info.width = static_cast<int32_t>(read_le32(data + 18));
+        height = static_cast<int32_t>(read_le32(data + 22));
+        info.bits_per_pixel = read_le16(data + 28);
+        info.compression = read_le32(data + 30);
+        info.palette_entry_size = 4;
+        info.palette_size = read_le32(data + 46);
+    } else {
+        return false;
+    }
+    if (info.width <= 0 || height == 0)
+        return false;
+    info.top_down = height < 0;
+    info.height = height < 0 ? -height : height;
+    info.palette_offset = 14 + dib_size;
+    if (info.bits_per_pixel <= 8 && info.palette_size == 0)
+        info.palette_size = 1u << info.bits_per_pixel;
+    info.row_stride = ((size_t(info.bits_per_pixel) * info.width + 31) / 32) * 4;
+    return true;
+}
+
+bool probe_image_header(const unsigned char* data, size_t size, ImageFormat format, int* width, int* height, int* color_comps)
+{
+    switch (format)
+    {
+        case ImageFormat::JPEG:
+            return probe_jpeg(data, size, width, height, color_comps);
+        case ImageFormat::PNG:
+            return probe_png(data, size, width, height, color_comps);
+        case ImageFormat::WEBP:
+            return probe_webp(data, size, width, height, color_comps);
+        case ImageFormat::BMP:
+        {
+            BmpInfo info;
+            if (!parse_bmp_header(data, size, info))
+                return false;
+            *width = info.width;
+            *height = info.height;
+            *color_comps = info.bits_per_pixel == 32 ? 4 : 3;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
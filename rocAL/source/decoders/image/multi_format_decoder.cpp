@@ -0,0 +1,409 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <csetjmp>
+#include <commons.h>
+#include "multi_format_decoder.h"
+#if ENABLE_PNG
+#include <png.h>
+#endif
+#if ENABLE_WEBP
+#include <webp/decode.h>
+#endif
+
+void DecodedRowWriter::init(unsigned char* output, size_t output_stride, unsigned input_width, unsigned input_height,
+                            unsigned output_width, unsigned output_height, Decoder::ColorFormat color_format, bool bgr_input)
+{
+    _output = output;
+    _output_stride = output_stride;
+    _input_width = input_width;
+    _input_height = input_height;
+    _output_width = output_width;
+    _output_height = output_height;
+    _color_format = color_format;
+    _bgr_input = bgr_input;
+    _input_row = 0;
+    _output_row = 0;
+    if (_input_width != _output_width || _input_height != _output_height) {
+        _column_start.resize(_output_width + 1);
+        for (unsigned x = 0; x <= _output_width; x++)
+            _column_start[x] = (uint64_t)x * _input_width / _output_width;
+        _sums.assign(_output_width * 3, 0);
+    }
+}
+
+unsigned char* DecodedRowWriter::direct_row() const
+{
+    if (_input_width != _output_width || _input_height != _output_height || _input_row >= _input_height ||
+        _color_format == Decoder::ColorFormat::GRAY || _bgr_input != (_color_format == Decoder::ColorFormat::BGR))
+        return nullptr;
+    return _output + _input_row * _output_stride;
+}
+
+inline void DecodedRowWriter::write_pixel(unsigned char* dst, unsigned c0, unsigned c1, unsigned c2) const
+{
+    const unsigned r = _bgr_input ? c2 : c0, g = c1, b = _bgr_input ? c0 : c2;
+    switch (_color_format)
+    {
+        case Decoder::ColorFormat::GRAY:
+            dst[0] = (77 * r + 150 * g + 29 * b + 128) >> 8;
+            break;
+        case Decoder::ColorFormat::BGR:
+            dst[0] = b; dst[1] = g; dst[2] = r;
+            break;
+        default:
+            dst[0] = r; dst[1] = g; dst[2] = b;
+    }
+}
+
+void DecodedRowWriter::push(const unsigned char* row)
+{
+    if (_input_row >= _input_height)
+        return;
+    const unsigned planes = (_color_format == Decoder::ColorFormat::GRAY) ? 1 : 3;
+    if (_input_width == _output_width && _input_height == _output_height) {
+        unsigned char* dst = _output + _input_row * _output_stride;
+        if (row != dst)
+            for (unsigned x = 0; x < _input_width; x++)
+                write_pixel(dst + x * planes, row[3 * x], row[3 * x + 1], row[3 * x + 2]);
+        _input_row++;
+        return;
+    }
+    for (unsigned x = 0; x < _output_width; x++) {
+        uint64_t s0 = 0, s1 = 0, s2 = 0;
+        for (unsigned in_x = _column_start[x]; in_x < _column_start[x + 1]; in_x++) {
+            s0 += row[3 * in_x];
+            s1 += row[3 * in_x + 1];
+            s2 += row[3 * in_x + 2];
+        }
+        _sums[3 * x] += s0;
+        _sums[3 * x + 1] += s1;
+        _sums[3 * x + 2] += s2;
+    }
+    _input_row++;
+    // Every output row is the average of the input rows [row * in_h / out_h, (row + 1) * in_h / out_h)
+    const unsigned row_start = (uint64_t)_output_row * _input_height / _output_height;
+    const unsigned row_end = (uint64_t)(_output_row + 1) * _input_height / _output_height;
+    if (_input_row < row_end)
+        return;
+    unsigned char* dst = _output + _output_row * _output_stride;
+    for (unsigned x = 0; x < _output_width; x++) {
+        const uint64_t count = (uint64_t)(_column_start[x + 1] - _column_start[x]) * (row_end - row_start);
+        write_pixel(dst + x * planes, (_sums[3 * x] + count / 2) / count, (_sums[3 * x + 1] + count / 2) / count, (_sums[3 * x + 2] + count / 2) / count);
+    }
+    std::fill(_sums.begin(), _sums.end(), 0);
+    _output_row++;
+}
+
+#if ENABLE_PNG
+namespace
+{
+struct PngSource
+{
+    const unsigned char* data;
+    size_t size;
+    size_t position;
+};
+
+void png_read_from_memory(png_structp png, png_bytep out, png_size_t length)
+{
+    auto source = static_cast<PngSource*>(png_get_io_ptr(png));
+    if (source->position + length > source->size)
+        png_error(png, "truncated PNG");
+    memcpy(out, source->data + source->position, length);
+    source->position += length;
+}
+
+void png_ignore_warning(png_structp, png_const_charp) {}
+}
+#endif
+
+MultiFormatDecoder::MultiFormatDecoder()
+{
+}
+
+Decoder::Status MultiFormatDecoder::decode_info(unsigned char* input_buffer, size_t input_size, int* width, int* height, int* color_comps)
+{
+    auto format = sniff_image_format(input_buffer, input_size);
+    if (format == ImageFormat::JPEG)
+        return _jpeg_decoder.decode_info(input_buffer, input_size, width, height, color_comps);
+    if (format != ImageFormat::UNKNOWN) {
+        if (!probe_image_header(input_buffer, input_size, format, width, height, color_comps)) {
+            WRN("MultiFormatDecoder: image header decode failed")
+            return Status::HEADER_DECODE_FAILED;
+        }
+        return Status::OK;
+    }
+#if ENABLE_OPENCV
+    // No header probe for the other formats, the image is decoded here and kept for decode()
+    _other_image = cv::imdecode(cv::Mat(1, input_size, CV_8UC1, input_buffer), cv::IMREAD_COLOR);
+    if (_other_image.empty()) {
+        _other_image_source = nullptr;
+        WRN("MultiFormatDecoder: unknown image format")
+        return Status::HEADER_DECODE_FAILED;
+    }
+    _other_image_source = input_buffer;
+    *width = _other_image.cols;
+    *height = _other_image.rows;
+    *color_comps = 3;
+    return Status::OK;
+#else
+    WRN("MultiFormatDecoder: unknown image format")
+    return Status::HEADER_DECODE_FAILED;
+#endif
+}
+
+Decoder::Status MultiFormatDecoder::decode(unsigned char *input_buffer, size_t input_size, unsigned char *output_buffer,
+                                           size_t max_decoded_width, size_t max_decoded_height,
+                                           size_t original_image_width, size_t original_image_height,
+                                           size_t &actual_decoded_width, size_t &actual_decoded_height,
+                                           Decoder::ColorFormat desired_decoded_color_format, DecoderConfig config, bool keep_original_size)
+{
+    auto format = sniff_image_format(input_buffer, input_size);
+    if (format == ImageFormat::JPEG)
+        return _jpeg_decoder.decode(input_buffer, input_size, output_buffer, max_decoded_width, max_decoded_height,
+                                    original_image_width, original_image_height, actual_decoded_width, actual_decoded_height,
+                                    desired_decoded_color_format, config, keep_original_size);
+    if (original_image_width == 0 || original_image_height == 0 || max_decoded_width == 0 || max_decoded_height == 0)
+        return Status::HEADER_DECODE_FAILED;
+    // Downscaled to fit the maximum size keeping the aspect ratio, never upscaled
+    size_t width = original_image_width, height = original_image_height;
+    if (width > max_decoded_width || height > max_decoded_height) {
+        if (width * max_decoded_height > height * max_decoded_width) {
+            height = std::max<size_t>(1, height * max_decoded_width / width);
+            width = max_decoded_width;
+        } else {
+            width = std::max<size_t>(1, width * max_decoded_height / height);
+            height = max_decoded_height;
+        }
+    }
+    actual_decoded_width = _output_width = width;
+    actual_decoded_height = _output_height = height;
+    _output = output_buffer;
+    _color_format = desired_decoded_color_format;
+    _output_stride = max_decoded_width * ((_color_format == Decoder::ColorFormat::GRAY) ? 1 : 3);
+
+    Status status = Status::UNSUPPORTED;
+    switch (format)
+    {
+#if ENABLE_PNG
+        case ImageFormat::PNG:
+            status = decode_png(input_buffer, input_size, original_image_width, original_image_height);
+            break;
+#endif
+#if ENABLE_WEBP
+        case ImageFormat::WEBP:
+            status = decode_webp(input_buffer, input_size, original_image_width, original_image_height);
+            break;
+#endif
+        case ImageFormat::BMP:
+            status = decode_bmp(input_buffer, input_size);
+            break;
+        default:
+            break;
+    }
+    if (status == Status::UNSUPPORTED)
+        status = decode_other(input_buffer, input_size);
+    if (status != Status::OK)
+        WRN("MultiFormatDecoder: image decode failed")
+    return status;
+}
+
+#if ENABLE_PNG
+Decoder::Status MultiFormatDecoder::decode_png(unsigned char* input_buffer, size_t input_size, unsigned width, unsigned height)
+{
+    PngSource source = {input_buffer, input_size, 0};
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, png_ignore_warning);
+    if (!png)
+        return Status::NO_MEMORY;
+    png_infop info = png_create_info_struct(png);
+    if (!info) {
+        png_destroy_read_struct(&png, nullptr, nullptr);
+        return Status::NO_MEMORY;
+    }
+    // libpng reports the errors by a longjmp back here, everything it may skip is either a member or trivially destructible
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_read_struct(&png, &info, nullptr);
+        return Status::CONTENT_DECODE_FAILED;
+    }
+    png_set_read_fn(png, &source, png_read_from_memory);
+    png_read_info(png, info);
+    if (png_get_image_width(png, info) != width || png_get_image_height(png, info) != height)
+        png_error(png, "size differs from the header probed");
+    // Everything is read as 8 bit RGB, in the BGR order right away if that is the output's
+    const int color_type = png_get_color_type(png, info);
+    const int bit_depth = png_get_bit_depth(png, info);
+    if (color_type == PNG_COLOR_TYPE_PALETTE)
+        png_set_palette_to_rgb(png);
+    if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
+        png_set_expand_gray_1_2_4_to_8(png);
+    if (bit_depth == 16)
+        png_set_strip_16(png);
+    if (color_type & PNG_COLOR_MASK_ALPHA)
+        png_set_strip_alpha(png);
+    if (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+        png_set_gray_to_rgb(png);
+    const bool bgr = (_color_format == Decoder::ColorFormat::BGR);
+    if (bgr)
+        png_set_bgr(png);
+    const int passes = png_set_interlace_handling(png);
+    png_read_update_info(png, info);
+    if (png_get_rowbytes(png, info) != (size_t)width * 3)
+        png_error(png, "unexpected row size");
+    _writer.init(_output, _output_stride, width, height, _output_width, _output_height, _color_format, bgr);
+    if (passes == 1) {
+        _row.resize((size_t)width * 3);
+        for (unsigned y = 0; y < height; y++) {
+            unsigned char* row = _writer.direct_row();
+            if (!row)
+                row = _row.data();
+            png_read_row(png, row, nullptr);
+            _writer.push(row);
+        }
+    } else {
+        // Interlaced images are only complete after the last pass
+        _row.resize((size_t)width * 3 * height);
+        _row_pointers.resize(height);
+        for (unsigned y = 0; y < height; y++)
+            _row_pointers[y] = _row.data() + (size_t)y * width * 3;
+        png_read_image(png, _row_pointers.data());
+        for (unsigned y = 0; y < height; y++)
+            _writer.push(_row_pointers[y]);
+    }
+    png_destroy_read_struct(&png, &info, nullptr);
+    return Status::OK;
+}
+#endif
+
+#if ENABLE_WEBP
+Decoder::Status MultiFormatDecoder::decode_webp(unsigned char* input_buffer, size_t input_size, unsigned width, unsigned height)
+{
+    WebPDecoderConfig webp_config;
+    if (!WebPInitDecoderConfig(&webp_config))
+        return Status::UNSUPPORTED;
+    if (WebPGetFeatures(input_buffer, input_size, &webp_config.input) != VP8_STATUS_OK)
+        return Status::HEADER_DECODE_FAILED;
+    if (_output_width != width || _output_height != height) {
+        webp_config.options.use_scaling = 1;
+        webp_config.options.scaled_width = _output_width;
+        webp_config.options.scaled_height = _output_height;
+    }
+    // libwebp decodes and scales right into the slot, only gray goes through a scratch image
+    const bool gray = (_color_format == Decoder::ColorFormat::GRAY);
+    webp_config.output.colorspace = (_color_format == Decoder::ColorFormat::BGR) ? MODE_BGR : MODE_RGB;
+    webp_config.output.is_external_memory = 1;
+    if (gray) {
+        _row.resize((size_t)_output_width * 3 * _output_height);
+        webp_config.output.u.RGBA.rgba = _row.data();
+        webp_config.output.u.RGBA.stride = _output_width * 3;
+        webp_config.output.u.RGBA.size = _row.size();
+    } else {
+        webp_config.output.u.RGBA.rgba = _output;
+        webp_config.output.u.RGBA.stride = _output_stride;
+        webp_config.output.u.RGBA.size = _output_stride * _output_height;
+    }
+    auto webp_status = WebPDecode(input_buffer, input_size, &webp_config);
+    WebPFreeDecBuffer(&webp_config.output);
+    if (webp_status != VP8_STATUS_OK)
+        return Status::CONTENT_DECODE_FAILED;
+    if (gray) {
+        _writer.init(_output, _output_stride, _output_width, _output_height, _output_width, _output_height, _color_format, false);
+        for (unsigned y = 0; y < _output_height; y++)
+            _writer.push(_row.data() + (size_t)y * _output_width * 3);
+    }
+    return Status::OK;
+}
+#endif
+
+Decoder::Status MultiFormatDecoder::decode_bmp(unsigned char* input_buffer, size_t input_size)
+{
+    BmpInfo info;
+    if (!parse_bmp_header(input_buffer, input_size, info))
+        return Status::HEADER_DECODE_FAILED;
+    const unsigned bpp = info.bits_per_pixel;
+    bool supported = (info.compression == 0 && (bpp == 1 || bpp == 4 || bpp == 8 || bpp == 24 || bpp == 32));
+    if (bpp == 32 && info.compression == 3 && info.palette_offset >= 14 + 40 && 14 + 40 + 12 <= input_size) {
+        // BI_BITFIELDS, only the usual BGRX layout
+        const unsigned char* masks = input_buffer + 14 + 40;
+        supported = (masks[0] == 0 && masks[1] == 0 && masks[2] == 0xff && masks[3] == 0) &&
+                    (masks[4] == 0 && masks[5] == 0xff && masks[6] == 0 && masks[7] == 0) &&
+                    (masks[8] == 0xff && masks[9] == 0 && masks[10] == 0 && masks[11] == 0);
+    }
+    if (!supported)
+        return Status::UNSUPPORTED;// RLE and 16 bit images
+    if (info.data_offset + info.row_stride * info.height > input_size ||
+        (bpp <= 8 && info.palette_offset + (size_t)info.palette_size * info.palette_entry_size > input_size))
+        return Status::CONTENT_DECODE_FAILED;
+    const unsigned width = info.width, height = info.height;
+    _writer.init(_output, _output_stride, width, height, _output_width, _output_height, _color_format, true);
+    _row.resize((size_t)width * 3);
+    const unsigned char* palette = input_buffer + info.palette_offset;
+    for (unsigned y = 0; y < height; y++) {
+        // Rows are stored bottom-up unless the height is negative
+        const unsigned char* src = input_buffer + info.data_offset + (info.top_down ? y : height - 1 - y) * info.row_stride;
+        if (bpp == 24) {
+            _writer.push(src);
+            continue;
+        }
+        unsigned char* row = _row.data();
+        if (bpp == 32) {
+            for (unsigned x = 0; x < width; x++) {
+                row[3 * x] = src[4 * x];
+                row[3 * x + 1] = src[4 * x + 1];
+                row[3 * x + 2] = src[4 * x + 2];
+            }
+        } else {
+            const unsigned mask = (1u << bpp) - 1;
+            for (unsigned x = 0; x < width; x++) {
+                const size_t bit = (size_t)x * bpp;
+                unsigned index = (src[bit / 8] >> (8 - bpp - bit % 8)) & mask;
+                if (index >= info.palette_size)
+                    index = 0;
+                const unsigned char* color = palette + index * info.palette_entry_size;
+                row[3 * x] = color[0];
+                row[3 * x + 1] = color[1];
+                row[3 * x + 2] = color[2];
+            }
+        }
+        _writer.push(row);
+    }
+    return Status::OK;
+}
+
+Decoder::Status MultiFormatDecoder::decode_other(unsigned char* input_buffer, size_t input_size)
+{
+#if ENABLE_OPENCV
+    if (_other_image_source != input_buffer || _other_image.empty())
+        _other_image = cv::imdecode(cv::Mat(1, input_size, CV_8UC1, input_buffer), cv::IMREAD_COLOR);
+    _other_image_source = nullptr;
+    if (_other_image.empty() || _other_image.type() != CV_8UC3)
+        return Status::CONTENT_DECODE_FAILED;
+    _writer.init(_output, _output_stride, _other_image.cols, _other_image.rows, _output_width, _output_height, _color_format, true);
+    for (int y = 0; y < _other_image.rows; y++)
+        _writer.push(_other_image.ptr<unsigned char>(y));
+    _other_image.release();
+    return Status::OK;
+#else
+    return Status::UNSUPPORTED;
+#endif
+}
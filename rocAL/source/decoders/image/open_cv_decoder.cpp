@@ -22,6 +22,7 @@ THE SOFTWARE.
 #include <stdio.h>
 #include <commons.h>
 #include "open_cv_decoder.h"
+#include "image_format.h"
 
 #if ENABLE_OPENCV
 int handleError( int status, const char* func_name,
@@ -37,19 +38,11 @@ CVDecoder::CVDecoder() {
 }
 
 Decoder::Status CVDecoder::decode_info(unsigned char* input_buffer, size_t input_size, int* width, int* height, int* color_comps) {
-    //TODO: OpenCV seems not able to decode header separately, remove the imdecode from this call if possible and replace it with a proper function for decoding the header only
-#if 0
-    m_mat_orig = cv::imdecode(cv::Mat(1, input_size, CV_8UC1, input_buffer), cv::IMREAD_UNCHANGED);
-    if(m_mat_orig.rows == 0 || m_mat_orig.cols == 0) {
-        WRN("CVDecoder::Jpeg header decode failed ");
-        return Status::HEADER_DECODE_FAILED;
-    }
-    *width = m_mat_orig.cols;
-    *height = m_mat_orig.rows;
-#else
+    // OpenCV cannot decode the header alone, the formats rocAL knows are probed without it
+    if (probe_image_header(input_buffer, input_size, sniff_image_format(input_buffer, input_size), width, height, color_comps))
+        return Status::OK;
     *width = 0;
     *height = 0;
-#endif
     *color_comps = 0;       // not known
     return Status::OK;
 }
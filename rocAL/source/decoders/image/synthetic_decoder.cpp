@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "synthetic_decoder.h"
+
+Decoder::Status SyntheticDecoder::decode_info(unsigned char* input_buffer, size_t input_size, int* width, int* height, int* color_comps)
+{
+    SyntheticImageDesc desc;
+    if(!synthetic_parse_image_desc(input_buffer, input_size, desc))
+    {
+        WRN("Synthetic image header decode failed, the synthetic decoder can only be used with the synthetic reader")
+        return Status::HEADER_DECODE_FAILED;
+    }
+    *width = desc.width;
+    *height = desc.height;
+    *color_comps = 3;
+    return Status::OK;
+}
+
+Decoder::Status SyntheticDecoder::decode(unsigned char *input_buffer, size_t input_size, unsigned char *output_buffer,
+                                         size_t max_decoded_width, size_t max_decoded_height,
+                                         size_t original_image_width, size_t original_image_height,
+                                         size_t &actual_decoded_width, size_t &actual_decoded_height,
+                                         Decoder::ColorFormat desired_decoded_color_format, DecoderConfig config, bool keep_original_size)
+{
+    SyntheticImageDesc desc;
+    if(!synthetic_parse_image_desc(input_buffer, input_size, desc))
+        return Status::CONTENT_DECODE_FAILED;
+    const unsigned planes = (desired_decoded_color_format == Decoder::ColorFormat::GRAY) ? 1 : 3;
+    if(keep_original_size)
+    {
+        actual_decoded_width = std::min<size_t>(desc.width, max_decoded_width);
+        actual_decoded_height = std::min<size_t>(desc.height, max_decoded_height);
+    }
+    else
+    {
+        // Same sizes as the TurboJpeg decoder: the largest of its n/8 scaling factors (up to 2) that fits the maximum size
+        actual_decoded_width = max_decoded_width;
+        actual_decoded_height = max_decoded_height;
+        for(unsigned num = 16; num > 0; num--)
+        {
+            size_t scaled_width = (desc.width * num + 7) / 8, scaled_height = (desc.height * num + 7) / 8;
+            if(scaled_width <= max_decoded_width && scaled_height <= max_decoded_height)
+            {
+                actual_decoded_width = scaled_width;
+                actual_decoded_height = scaled_height;
+                break;
+            }
+        }
+    }
+    synthetic_render(desc, output_buffer, actual_decoded_width, actual_decoded_height, max_decoded_width * planes, planes,
+                     desired_decoded_color_format == Decoder::ColorFormat::BGR);
+    return Status::OK;
+}
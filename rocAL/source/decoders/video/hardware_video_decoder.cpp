@@ -50,7 +50,7 @@ int HardWareVideoDecoder::hw_decoder_init(AVCodecContext *ctx, const enum AVHWDe
 }
 
 // Seeks to the frame_number in the video file and decodes each frame in the sequence.
-VideoDecoder::Status HardWareVideoDecoder::Decode(unsigned char *out_buffer, unsigned seek_frame_number, size_t sequence_length, size_t stride, int out_width, int out_height, int out_stride, AVPixelFormat out_pix_format)
+VideoDecoder::Status HardWareVideoDecoder::Decode(unsigned char *out_buffer, unsigned seek_frame_number, const std::vector<int> &frame_slots, size_t stride, int out_width, int out_height, int out_stride, AVPixelFormat out_pix_format)
 {
     VideoDecoder::Status status = Status::OK;
 
@@ -126,7 +126,8 @@ VideoDecoder::Status HardWareVideoDecoder::Decode(unsigned char *out_buffer, uns
             ret = avcodec_receive_frame(_video_dec_ctx, dec_frame);
             if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) break;
             if ((dec_frame->pts < select_frame_pts) || (ret < 0)) continue;
-            if (frame_count % stride == 0)
+            // Frames that are not referenced by any output slot are decoded only to move the stream forward
+            if ((frame_count % stride == 0) && (frame_slots[frame_count / stride] >= 0))
             {
                 //retrieve data from GPU to CPU
                 if ((av_hwframe_transfer_data(sw_frame, dec_frame, 0)) < 0) {
@@ -134,21 +135,21 @@ VideoDecoder::Status HardWareVideoDecoder::Decode(unsigned char *out_buffer, uns
                     return Status::FAILED;
                 }
 
-                dst_data[0] = out_buffer;
+                unsigned char *out_image = out_buffer + (size_t)frame_slots[frame_count / stride] * image_size;
+                dst_data[0] = out_image;
                 dst_linesize[0] = out_stride;
                 if (swsctx)
                     sws_scale(swsctx, sw_frame->data, sw_frame->linesize, 0, sw_frame->height, dst_data, dst_linesize);
                 else
                 {
                     // copy from frame to out_buffer
-                    memcpy(out_buffer, sw_frame->data[0], sw_frame->linesize[0] * out_height);
+                    memcpy(out_image, sw_frame->data[0], sw_frame->linesize[0] * out_height);
                 }
-                out_buffer = out_buffer + image_size;
             }
             ++frame_count;
             av_frame_unref(sw_frame);
             av_frame_unref(dec_frame);
-            if (frame_count == sequence_length * stride)
+            if (frame_count == (frame_slots.size() - 1) * stride + 1)
             {
                 sequence_filled = true;
                 break;
@@ -21,12 +21,10 @@ THE SOFTWARE.
 */
 
 #include "circular_buffer.h"
+#include <cstring>
 #include "log.h"
 
-CircularBuffer::CircularBuffer(void* devres):
-          _write_ptr(0),
-          _read_ptr(0),
-          _level(0)
+CircularBuffer::CircularBuffer(void* devres)
 {
 #if ENABLE_OPENCL
     DeviceResources *ocl = static_cast<DeviceResources *> (devres);
@@ -39,16 +37,7 @@ CircularBuffer::CircularBuffer(void* devres):
 
 void CircularBuffer::reset()
 {
-    _write_ptr = 0;
-    _read_ptr = 0;
-    _level = 0;
-    while(!_circ_image_info.empty())
-        _circ_image_info.pop();
-    if (random_bbox_crop_flag == true)
-    {
-        while(!_circ_crop_image_info.empty())
-        _circ_crop_image_info.pop();
-    }
+    _slots.reset();
 }
 
 void CircularBuffer::unblock_reader()
@@ -56,7 +45,7 @@ void CircularBuffer::unblock_reader()
     if(!_initialized)
         return;
     // Wake up the reader thread in case it's waiting for a load
-    _wait_for_load.notify_one();
+    _slots.interrupt_reader();
 }
 
 void CircularBuffer::unblock_writer()
@@ -64,14 +53,14 @@ void CircularBuffer::unblock_writer()
     if(!_initialized)
         return;
     // Wake up the writer thread in case it's waiting for an unload
-    _wait_for_unload.notify_one();
+    _slots.interrupt_writer();
 }
 
 
 void* CircularBuffer::get_read_buffer_dev()
 {
     block_if_empty();
-    return _dev_buffer[_read_ptr];
+    return _dev_buffer[_slots.read_index()];
 }
 
 unsigned char* CircularBuffer::get_read_buffer_host()
@@ -79,7 +68,7 @@ unsigned char* CircularBuffer::get_read_buffer_host()
     if(!_initialized)
         THROW("Circular buffer not initialized")
     block_if_empty();
-    return _host_buffer_ptrs[_read_ptr];
+    return _host_buffer_ptrs[_slots.read_index()];
 }
 
 unsigned char*  CircularBuffer::get_write_buffer()
@@ -87,7 +76,7 @@ unsigned char*  CircularBuffer::get_write_buffer()
     if(!_initialized)
         THROW("Circular buffer not initialized")
     block_if_full();
-    return(_host_buffer_ptrs[_write_ptr]);
+    return(_host_buffer_ptrs[_slots.write_index()]);
 }
 
 void CircularBuffer::sync()
@@ -95,11 +84,12 @@ void CircularBuffer::sync()
     if(!_initialized)
         return;
 #if ENABLE_OPENCL
+    const size_t write_ptr = _slots.write_index();
     cl_int err = CL_SUCCESS;
     if(_output_mem_type== RocalMemType::OCL)
     {
     #if 0
-        if(clEnqueueWriteBuffer(_cl_cmdq, _dev_sub_buffer[_write_ptr], CL_TRUE, 0, _output_mem_size, _host_buffer_ptrs[_write_ptr], 0, NULL, NULL) != CL_SUCCESS)
+        if(clEnqueueWriteBuffer(_cl_cmdq, _dev_sub_buffer[write_ptr], CL_TRUE, 0, _output_mem_size, _host_buffer_ptrs[write_ptr], 0, NULL, NULL) != CL_SUCCESS)
             THROW("clEnqueueMapBuffer of size "+ TOSTR(_output_mem_size) + " failed " + TOSTR(err));
 
     #else
@@ -107,9 +97,9 @@ void CircularBuffer::sync()
         // an unmap/map cen be done to make sure data is copied from the host to device, it's fast
         //NOTE: Using clEnqueueUnmapMemObject/clEnqueuenmapMemObject when buffer is allocated with
         // CL_MEM_ALLOC_HOST_PTR adds almost no overhead
-        clEnqueueUnmapMemObject(_cl_cmdq, (cl_mem)_dev_buffer[_write_ptr], _host_buffer_ptrs[_write_ptr], 0, NULL, NULL);
-        _host_buffer_ptrs[_write_ptr] = (unsigned char*) clEnqueueMapBuffer(_cl_cmdq,
-                                                                            (cl_mem)_dev_buffer[_write_ptr] ,
+        clEnqueueUnmapMemObject(_cl_cmdq, (cl_mem)_dev_buffer[write_ptr], _host_buffer_ptrs[write_ptr], 0, NULL, NULL);
+        _host_buffer_ptrs[write_ptr] = (unsigned char*) clEnqueueMapBuffer(_cl_cmdq,
+                                                                            (cl_mem)_dev_buffer[write_ptr] ,
                                                                             CL_FALSE,
                                                                             CL_MAP_WRITE,
                                                                             0,
@@ -122,10 +112,11 @@ void CircularBuffer::sync()
     } 
     else {
 #elif ENABLE_HIP
+    const size_t write_ptr = _slots.write_index();
     if (_output_mem_type== RocalMemType::HIP){
         // copy memory to host only if needed
         if (!_hip_canMapHostMemory) {
-            hipError_t err = hipMemcpy((void *)(_dev_buffer[_write_ptr]), _host_buffer_ptrs[_write_ptr], _output_mem_size, hipMemcpyHostToDevice);
+            hipError_t err = hipMemcpy((void *)(_dev_buffer[write_ptr]), _host_buffer_ptrs[write_ptr], _output_mem_size, hipMemcpyHostToDevice);
             if (err != hipSuccess) {
                 THROW("hipMemcpy of size "+ TOSTR(_output_mem_size) + " failed " + TOSTR(err));
             }
@@ -147,24 +138,16 @@ void CircularBuffer::push()
     if(!_initialized)
         return;
     sync();
-    // Pushing to the _circ_buff and _circ_buff_names must happen all at the same time
-    std::unique_lock<std::mutex> lock(_names_buff_lock);
-    _circ_image_info.push(_last_image_info);
-    if (random_bbox_crop_flag == true)
-      _circ_crop_image_info.push(_last_crop_image_info);
-    increment_write_ptr();
+    // The image info of the slot has already been written by set_image_info(), publishing the slot makes both visible to the reader
+    _slots.commit_write();
 }
 
 void CircularBuffer::pop()
 {
     if(!_initialized)
         return;
-    // Pushing to the _circ_buff and _circ_buff_names must happen all at the same time
-    std::unique_lock<std::mutex> lock(_names_buff_lock);
-    increment_read_ptr();
-    _circ_image_info.pop();
-    if (random_bbox_crop_flag == true)
-        _circ_crop_image_info.pop();
+    // Wakes up the writer thread (in case waiting) since there is an empty spot to write to
+    _slots.commit_read();
 }
 void CircularBuffer::init(RocalMemType output_mem_type, size_t output_mem_size, size_t buffer_depth)
 {
@@ -179,6 +162,9 @@ void CircularBuffer::init(RocalMemType output_mem_type, size_t output_mem_size,
     _output_mem_size = output_mem_size;
     if(_buff_depth < 2)
         THROW ("Error internal buffer size for the circular buffer should be greater than one")
+    _slots.init(_buff_depth);
+    _circ_image_info.resize(_buff_depth);
+    _circ_crop_image_info.resize(_buff_depth);
 
     // Allocating buffers
 #if ENABLE_OPENCL
@@ -263,6 +249,16 @@ void CircularBuffer::init(RocalMemType output_mem_type, size_t output_mem_size,
     _initialized = true;
 }
 
+void CircularBuffer::first_touch()
+{
+    if(!_initialized || _output_mem_type != RocalMemType::HOST)
+        return;
+    // The host buffers are allocated with aligned_alloc() and not touched before, the pages are placed on the node of the
+    // thread writing them first (pinned memory used for the device buffers is already placed when allocated)
+    for(size_t buffIdx = 0; buffIdx < _buff_depth; buffIdx++)
+        memset(_host_buffer_ptrs[buffIdx], 0, _output_mem_size);
+}
+
 void CircularBuffer::release()
 {
     for(size_t buffIdx = 0; buffIdx < _buff_depth; buffIdx++)
@@ -305,9 +301,7 @@ void CircularBuffer::release()
 
     _dev_buffer.clear();
     _host_buffer_ptrs.clear();
-    _write_ptr = 0;
-    _read_ptr = 0;
-    _level = 0;
+    _slots.reset();
 #if ENABLE_OPENCL
     _cl_cmdq = 0;
     _cl_context = 0;
@@ -321,57 +315,29 @@ void CircularBuffer::release()
 
 bool CircularBuffer::empty()
 {
-    return (_level <= 0);
+    return _slots.empty();
 }
 
 bool CircularBuffer::full()
 {
-    return (_level >= _buff_depth - 1);
+    return _slots.full();
 }
 
 size_t CircularBuffer::level()
 {
-    return _level;
+    return _slots.level();
 }
 
-void CircularBuffer::increment_read_ptr()
+bool CircularBuffer::block_if_empty()
 {
-    std::unique_lock<std::mutex> lock(_lock);
-    _read_ptr = (_read_ptr+1)%_buff_depth;
-    _level--;
-    lock.unlock();
-    // Wake up the writer thread (in case waiting) since there is an empty spot to write to,
-    _wait_for_unload.notify_all();
-
+    // if the current read buffer is being written wait on it, the thread is only parked if the buffer is still empty after a short spin
+    return _slots.wait_until_readable();
 }
 
-void CircularBuffer::increment_write_ptr()
+bool CircularBuffer:: block_if_full()
 {
-    std::unique_lock<std::mutex> lock(_lock);
-    _write_ptr = (_write_ptr+1)%_buff_depth;
-    _level++;
-    lock.unlock();
-    // Wake up the reader thread (in case waiting) since there is a new load to be read
-    _wait_for_load.notify_all();
-}
-
-void CircularBuffer::block_if_empty()
-{
-    std::unique_lock<std::mutex> lock(_lock);
-    if(empty())
-    { // if the current read buffer is being written wait on it
-        _wait_for_load.wait(lock);
-    }
-}
-
-void CircularBuffer:: block_if_full()
-{
-    std::unique_lock<std::mutex> lock(_lock);
     // Write the whole buffer except for the last spot which is being read by the reader thread
-    if(full())
-    {
-        _wait_for_unload.wait(lock);
-    }
+    return _slots.wait_until_writable();
 }
 
 CircularBuffer::~CircularBuffer()
@@ -382,17 +348,11 @@ CircularBuffer::~CircularBuffer()
 decoded_image_info &CircularBuffer::get_image_info()
 {
     block_if_empty();
-    std::unique_lock<std::mutex> lock(_names_buff_lock);
-    if(_level != _circ_image_info.size())
-        THROW("CircularBuffer internals error, image and image info sizes not the same "+TOSTR(_level) + " != "+TOSTR(_circ_image_info.size()))
-    return  _circ_image_info.front();
+    return  _circ_image_info[_slots.read_index()];
 }
 
 crop_image_info &CircularBuffer::get_cropped_image_info()
 {
     block_if_empty();
-    std::unique_lock<std::mutex> lock(_names_buff_lock);
-    if(_level != _circ_crop_image_info.size())
-        THROW("CircularBuffer internals error, image and image info sizes not the same "+TOSTR(_level) + " != "+TOSTR(_circ_crop_image_info.size()))
-    return  _circ_crop_image_info.front();
+    return  _circ_crop_image_info[_slots.read_index()];
 }
@@ -22,6 +22,8 @@ THE SOFTWARE.
 
 #include <thread>
 #include <chrono>
+#include <cstring>
+#include <algorithm>
 #include "cifar10_data_loader.h"
 #include "vx_ext_amd.h"
 
@@ -138,6 +140,7 @@ CIFAR10DataLoader::initialize(ReaderConfig reader_cfg, DecoderConfig decoder_cfg
         throw;
     }
     _actual_read_size.resize(batch_size);
+    _sample_views.resize(batch_size);
     _raw_img_info._image_names.resize(_batch_size);
     _raw_img_info._roi_width.resize(_batch_size);           // used to store the individual image in a big raw file
     _raw_img_info._roi_height.resize(batch_size);
@@ -181,7 +184,6 @@ CIFAR10DataLoader::load_routine()
     while(_internal_thread_running)
     {
         auto data = _circ_buff.get_write_buffer();
-        auto cifar10reader = std::dynamic_pointer_cast<CIFAR10DataReader>(_reader);
 
         if(!_internal_thread_running)
             break;
@@ -199,13 +201,26 @@ CIFAR10DataLoader::load_routine()
                     WRN("Opened file " + _reader->id() + " of size 0");
                     continue;
                 }
-                _actual_read_size[file_counter] = _reader->read_data(read_ptr, readSize);
+                // Records held in memory by the reader are gathered into the slot below, all at once,
+                // the CIFAR10 reader's views stay valid after close() since its batch files are held for the whole run
+                ReaderItemView item_view;
+                if (_reader->view(item_view)) {
+                    _sample_views[file_counter] = item_view.data;
+                    _actual_read_size[file_counter] = std::min(item_view.shape.size(), _image_size);
+                } else {
+                    _sample_views[file_counter] = nullptr;
+                    _actual_read_size[file_counter] = _reader->read_data(read_ptr, readSize);
+                }
                 _raw_img_info._image_names[file_counter] = _reader->id();
                 _raw_img_info._roi_width[file_counter] = _output_image->info().width();
                 _raw_img_info._roi_height[file_counter] = _output_image->info().height_single();
                 _reader->close();
                 file_counter++;
             }
+            #pragma omp parallel for if(file_counter > 1)
+            for (int i = 0; i < (int)file_counter; i++)
+                if (_sample_views[i])
+                    memcpy(data + _image_size * i, _sample_views[i], _actual_read_size[i]);
             _file_load_time.end();// Debug timing
             _circ_buff.set_image_info(_raw_img_info);
             _circ_buff.push();
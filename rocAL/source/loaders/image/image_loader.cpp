@@ -22,9 +22,11 @@ THE SOFTWARE.
 
 #include <thread>
 #include <chrono>
+#include <algorithm>
 #include "image_loader.h"
 #include "image_read_and_decode.h"
 #include "vx_ext_amd.h"
+#include "numa_topology.h"
 
 ImageLoader::ImageLoader(void *dev_resources):
       _circ_buff(dev_resources),
@@ -75,22 +77,19 @@ ImageLoader::remaining_count()
 
 void ImageLoader::reset()
 {
-    // stop the writer thread and empty the internal circular buffer
-    _internal_thread_running = false;
+    // The internal thread keeps running, it is only asked to start the next epoch. If it has already reached the end of the
+    // current epoch it has started loading the next one in the background and the batches it has loaded so far are used as is,
+    // otherwise it restarts from the beginning of the media and the batches left from the current epoch are dropped on read
+    {
+        std::unique_lock<std::mutex> lock(_epoch_lock);
+        _output_epoch++;
+        _requested_epoch = _output_epoch;
+    }
+    _output_batch_count = 0;
+    _epoch_cv.notify_all();
+    // Wake up the internal thread in case it's waiting for space while holding batches of the previous epoch
     _circ_buff.unblock_writer();
-
-    if (_load_thread.joinable())
-        _load_thread.join();
-
-    // Emptying the internal circular buffer
-    _circ_buff.reset();
-
-    // resetting the reader thread to the start of the media
-    _image_counter = 0;
-    _image_loader->reset();
-
-    // Start loading (writer thread) again
-    start_loading();
+    _remaining_image_count = _epoch_image_count;
 }
 
 void ImageLoader::de_init()
@@ -120,10 +119,53 @@ void ImageLoader::set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_Met
     _circ_buff.random_bbox_crop_flag = true;
 }
 
+void ImageLoader::set_bbox_crop_sampler(std::shared_ptr<BBoxCropSampler> bbox_crop_sampler)
+{
+    std::atomic_store(&_bbox_crop_sampler, bbox_crop_sampler);
+}
+
+void ImageLoader::set_decode_thread_count(size_t thread_count)
+{
+    if(!_is_initialized)
+        THROW("set_decode_thread_count() should be called after initialize() function");
+    _image_loader->set_num_threads(thread_count);
+}
+
+void ImageLoader::set_prefetch_limit(size_t prefetch_depth)
+{
+    if(!_is_initialized)
+        THROW("set_prefetch_limit() should be called after initialize() function");
+    _circ_buff.set_prefetch_limit(prefetch_depth);
+}
+
+bool ImageLoader::get_position(LoaderPosition &position)
+{
+    position.epoch = _output_epoch;
+    position.shard_batch_counts = {_output_batch_count};
+    position.shard_total_batch_counts = {_total_output_batch_count};
+    position.shard_idx = 0;
+    return true;
+}
+
+void ImageLoader::set_start_position(const LoaderPosition &position)
+{
+    if (_internal_thread_running)
+        THROW("set_start_position() should be called before start_loading() function is called")
+    if (position.shard_batch_counts.empty() || position.shard_total_batch_counts.size() != position.shard_batch_counts.size())
+        THROW("Invalid loader position")
+    _start_position = std::make_unique<LoaderPosition>(position);
+}
+
 void ImageLoader::stop_internal_thread()
 {
-    _internal_thread_running = false;
+    {
+        std::unique_lock<std::mutex> lock(_epoch_lock);
+        _internal_thread_running = false;
+    }
+    _epoch_cv.notify_all();
     _stopped = true;
+    if (_batch_ready_event)
+        _batch_ready_event->signal();
     _circ_buff.unblock_reader();
     _circ_buff.unblock_writer();
     _circ_buff.reset();
@@ -176,20 +218,67 @@ void ImageLoader::start_loading()
     if (!_is_initialized)
         THROW("start_loading() should be called after initialize() function is called")
 
-    _remaining_image_count = _image_loader->count();
+    _epoch_image_count = _image_loader->count();
+    _remaining_image_count = _epoch_image_count;
+    if (_start_position)
+    {
+        // The batches handed out before are skipped by the reader, not loaded
+        const size_t epoch = _start_position->epoch, batch_count = _start_position->shard_batch_counts[0];
+        _image_loader->seek(epoch, batch_count * _batch_size, _start_position->shard_total_batch_counts[0]);
+        _loader_epoch = _output_epoch = _requested_epoch = epoch;
+        _output_batch_count = batch_count;
+        _total_output_batch_count = _start_position->shard_total_batch_counts[0];
+        _image_counter = batch_count * _batch_size;
+        if (!_loop)
+            _remaining_image_count = (_epoch_image_count > _image_counter) ? _epoch_image_count - _image_counter : 0;
+        _start_position = nullptr;
+    }
     _internal_thread_running = true;
     _load_thread = std::thread(&ImageLoader::load_routine, this);
 }
 
+void ImageLoader::start_epoch(size_t epoch)
+{
+    // Runs on the internal thread, so that the reshuffle of the reader happens in the background of the user's processing
+    _image_loader->reset();
+    // The random bbox crops are keyed by the image name and the epoch, a new epoch gets new crops without touching the shared reader
+    _image_loader->set_epoch(epoch);
+    _image_counter = 0;
+    _loader_epoch = epoch;
+}
+
+void ImageLoader::wait_for_epoch_request(size_t epoch)
+{
+    // Parks the internal thread till reset() asks for the given epoch (or a later one), or the loader is shut down
+    std::unique_lock<std::mutex> lock(_epoch_lock);
+    _epoch_cv.wait(lock, [this, epoch]() { return !_internal_thread_running || _requested_epoch >= epoch; });
+}
+
 LoaderModuleStatus
 ImageLoader::load_routine()
 {
     LOG("Started the internal loader thread");
     LoaderModuleStatus last_load_status = LoaderModuleStatus::OK;
+    // Pinned before the first decode, so that the OpenMP decode threads created by this thread inherit its affinity,
+    // and the circular buffer pages are first touched (placed) on the same node
+    if (!_numa_cpus.empty() && NumaTopology::bind_current_thread(_numa_cpus))
+        _circ_buff.first_touch();
     // Initially record number of all the images that are going to be loaded, this is used to know how many still there
 
     while (_internal_thread_running)
     {
+        size_t requested_epoch;
+        {
+            std::unique_lock<std::mutex> lock(_epoch_lock);
+            requested_epoch = _requested_epoch;
+        }
+        // reset() was called before this thread got to the end of the current epoch, restart from the beginning of the media
+        if (requested_epoch > _loader_epoch)
+            start_epoch(requested_epoch);
+
+        // returns false if unblocked by reset() or shut down while the buffer is still full, the request is handled above
+        if (!_circ_buff.block_if_full())
+            continue;
         auto data = _circ_buff.get_write_buffer();
         if (!_internal_thread_running)
             break;
@@ -209,13 +298,21 @@ ImageLoader::load_routine()
 
             if (load_status == LoaderModuleStatus::OK)
             {
+                auto bbox_crop_sampler = std::atomic_load(&_bbox_crop_sampler);
+                if (bbox_crop_sampler)
+                    // Picked here, in the background of the processing of the previous batches
+                    bbox_crop_sampler->sample_batch(_decoded_img_info._image_names, _loader_epoch, _crop_image_info._bbox_crop_windows);
+                else
+                    _crop_image_info._bbox_crop_windows.clear();
                 if (_randombboxcrop_meta_data_reader)
-                {
                     _crop_image_info._crop_image_coords = _image_loader->get_batch_random_bbox_crop_coords();
+                if (_randombboxcrop_meta_data_reader || bbox_crop_sampler)
                     _circ_buff.set_crop_image_info(_crop_image_info);
-                }
+                _decoded_img_info._epoch = _loader_epoch;
                 _circ_buff.set_image_info(_decoded_img_info);
                 _circ_buff.push();
+                if (_batch_ready_event)
+                    _batch_ready_event->signal();
                 _image_counter += _output_image->info().batch_size();
             }
         }
@@ -235,19 +332,45 @@ ImageLoader::load_routine()
                 last_load_status = load_status;
             }
 
-            // Here it sets the out-of-data flag and signal the circular buffer's internal
-            // read semaphore using release() call
-            // , and calls the release() allows the reader thread to wake up and handle
-            // the out-of-data case properly
-            // It also slows down the reader thread since there is no more data to read,
-            // till program ends or till reset is called
+            // Wake up the reader thread in case it's waiting for a load, so that it can handle the out-of-data case
             _circ_buff.unblock_reader();
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            // At the end of the epoch the user is consuming, stream straight into the next one: the reader is reset and
+            // reshuffled here and the next batches are tagged with the new epoch, they are handed out after reset() is called.
+            // Otherwise (the epoch loaded ahead has no data either, or loading failed) wait for reset() or shut down
+            if (load_status == LoaderModuleStatus::NO_MORE_DATA_TO_READ && _loader_epoch == requested_epoch)
+            {
+                start_epoch(_loader_epoch + 1);
+                continue;
+            }
+            wait_for_epoch_request(std::max(requested_epoch + 1, _loader_epoch));
+        }
+        else
+        {
+            last_load_status = LoaderModuleStatus::OK;
         }
     }
     return LoaderModuleStatus::OK;
 }
 
+bool ImageLoader::is_ready()
+{
+    return _stopped || _circ_buff.level() > 0;
+}
+
+void ImageLoader::set_numa_placement(const std::vector<std::vector<unsigned>> &shard_cpus)
+{
+    if (_internal_thread_running)
+        THROW("set_numa_placement() should be called before start_loading() function is called")
+    _numa_cpus = shard_cpus.empty() ? std::vector<unsigned>() : shard_cpus[0];
+}
+
+void ImageLoader::set_decode_worker_pool(std::shared_ptr<DecodeWorkerPool> decode_worker_pool)
+{
+    if (!_is_initialized)
+        THROW("set_decode_worker_pool() should be called after initialize() function is called")
+    _image_loader->set_decode_worker_pool(decode_worker_pool);
+}
+
 bool ImageLoader::is_out_of_data()
 {
     return (remaining_count() < _batch_size);
@@ -262,6 +385,27 @@ ImageLoader::update_output_image()
     if (_stopped)
         return LoaderModuleStatus::OK;
 
+    // Drop the batches left from an epoch that has been reset, and stop at the first batch loaded ahead for the next epoch
+    while (true)
+    {
+        if (!_circ_buff.block_if_empty())
+        {
+            if (_stopped)
+                return LoaderModuleStatus::OK;
+            continue;
+        }
+        auto epoch = _circ_buff.get_image_info()._epoch;
+        if (epoch == _output_epoch)
+            break;
+        if (epoch > _output_epoch)
+        {
+            // The internal thread has run out of data for this epoch earlier than expected
+            _remaining_image_count = 0;
+            return LoaderModuleStatus::NO_MORE_DATA_TO_READ;
+        }
+        _circ_buff.pop();
+    }
+
     // _circ_buff.get_read_buffer_x() is blocking and puts the caller on sleep until new images are written to the _circ_buff
     if((_mem_type== RocalMemType::OCL) || (_mem_type== RocalMemType::HIP))
     {
@@ -283,7 +427,7 @@ ImageLoader::update_output_image()
         return LoaderModuleStatus::OK;
 
     _output_decoded_img_info = _circ_buff.get_image_info();
-    if (_randombboxcrop_meta_data_reader) {
+    if (_randombboxcrop_meta_data_reader || std::atomic_load(&_bbox_crop_sampler)) {
       _output_cropped_img_info = _circ_buff.get_cropped_image_info();
     }
     _output_names = _output_decoded_img_info._image_names;
@@ -292,6 +436,8 @@ ImageLoader::update_output_image()
     _circ_buff.pop();
     if (!_loop)
         _remaining_image_count -= _batch_size;
+    _output_batch_count++;
+    _total_output_batch_count++;
 
     return status;
 }
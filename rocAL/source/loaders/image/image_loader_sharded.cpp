@@ -28,6 +28,14 @@ ImageLoaderSharded::ImageLoaderSharded(void *dev_resources):
     _loader_idx = 0;
 }
 
+void ImageLoaderSharded::set_shard_scheduling(ShardScheduling scheduling, bool share_decode_threads)
+{
+    if(_initialized)
+        THROW("set_shard_scheduling() should be called before initialize() function");
+    _scheduling = scheduling;
+    _share_decode_threads = share_decode_threads;
+}
+
 void ImageLoaderSharded::set_prefetch_queue_depth(size_t prefetch_queue_depth)
 {
     if(prefetch_queue_depth <= 0)
@@ -61,21 +69,59 @@ void
 ImageLoaderSharded::fast_forward_through_empty_loaders()
 {
     int loaders_count = _loaders.size();
-    // reject empty loaders and get to a loader that still has images to play
-    while (_loaders[_loader_idx]->remaining_count() == 0 && loaders_count-- > 0)
+    // reject empty loaders and get to a loader that still has images to play, a partial batch left is not played (see ImageLoader::is_out_of_data)
+    while (_loaders[_loader_idx]->remaining_count() < _batch_size && loaders_count-- > 0)
         increment_loader_idx();
 }
 
+void
+ImageLoaderSharded::select_ready_loader()
+{
+    while (true)
+    {
+        // Read before checking the loaders, so that a batch loaded in between wakes this thread up right away
+        const uint32_t observed = _batch_ready_event->value();
+        bool has_data = false;
+        // Scan starting from the loader next to the last one used, so that the shards with a batch ready are served in turn
+        for (size_t i = 1; i <= _shard_count; i++)
+        {
+            size_t idx = (_loader_idx + i) % _shard_count;
+            if (_loaders[idx]->remaining_count() < _batch_size)
+                continue;
+            has_data = true;
+            if (_loaders[idx]->is_ready())
+            {
+                _loader_idx = idx;
+                return;
+            }
+        }
+        // All the shards have run out of data, load_next() on any of them returns NO_MORE_DATA_TO_READ
+        if (!has_data)
+        {
+            increment_loader_idx();
+            return;
+        }
+        _batch_ready_event->wait(observed);
+    }
+}
+
 LoaderModuleStatus ImageLoaderSharded::load_next()
 {
     if(!_initialized)
         return LoaderModuleStatus::NOT_INITIALIZED;
 
-    increment_loader_idx();
+    if (_scheduling == ShardScheduling::ANY_READY)
+    {
+        select_ready_loader();
+    }
+    else
+    {
+        increment_loader_idx();
 
-    // Since loaders may have different number of images loaded, some run out earlier than other.
-    // Fast forward through loaders that are empty to get to a loader that is not empty.
-    fast_forward_through_empty_loaders();
+        // Since loaders may have different number of images loaded, some run out earlier than other.
+        // Fast forward through loaders that are empty to get to a loader that is not empty.
+        fast_forward_through_empty_loaders();
+    }
 
     auto ret= _loaders[_loader_idx]->load_next();
 
@@ -88,11 +134,25 @@ ImageLoaderSharded::initialize(ReaderConfig reader_cfg, DecoderConfig decoder_cf
     if(_initialized)
         return;
     _shard_count = reader_cfg.get_shard_count();
+    _reader_cfg = reader_cfg;
+    _decoder_cfg = decoder_cfg;
+    _mem_type = mem_type;
+    _keep_orig_size = keep_orig_size;
+    _batch_size = batch_size;
+    _batch_ready_event = std::make_shared<FutexEvent>();
+    if (_prefetch_memory_budget)
+    {
+        size_t depth = _prefetch_memory_budget / (_output_image->info().data_size() * _shard_count);
+        _prefetch_queue_depth = std::max(_prefetch_min_depth, std::min(_prefetch_queue_depth, depth));
+    }
+    if (_share_decode_threads)
+        _decode_worker_pool = std::make_shared<DecodeWorkerPool>(_shard_count * reader_cfg.get_cpu_num_threads());
     // Create loader modules
     for(size_t i = 0; i < _shard_count; i++)
     {
         std::shared_ptr loader = std::make_shared<ImageLoader>(_dev_resources);
         loader->set_prefetch_queue_depth(_prefetch_queue_depth);
+        loader->set_batch_ready_event(_batch_ready_event);
         _loaders.push_back(loader);
     }
     // Initialize loader modules
@@ -100,17 +160,40 @@ ImageLoaderSharded::initialize(ReaderConfig reader_cfg, DecoderConfig decoder_cf
     {
         _loaders[idx]->set_output_image(_output_image);
         _loaders[idx]->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
+        _loaders[idx]->set_bbox_crop_sampler(_bbox_crop_sampler);
         _loaders[idx]->set_gpu_device_id(idx);
         reader_cfg.set_shard_count(_shard_count);
         reader_cfg.set_shard_id(idx);
         _loaders[idx]->initialize(reader_cfg, decoder_cfg, mem_type, batch_size, keep_orig_size);
+        if (_decode_worker_pool)
+            _loaders[idx]->set_decode_worker_pool(_decode_worker_pool);
+        if (_decode_thread_count)
+            _loaders[idx]->set_decode_thread_count(_decode_thread_count);
+        if (_prefetch_limit)
+            _loaders[idx]->set_prefetch_limit(_prefetch_limit);
     }
     _initialized = true;
 }
 void ImageLoaderSharded::start_loading()
 {
+    if(_start_position)
+    {
+        if(_start_position->shard_batch_counts.size() != _loaders.size() || _start_position->shard_total_batch_counts.size() != _loaders.size())
+            THROW("The position was saved with " + TOSTR(_start_position->shard_batch_counts.size()) + " internal shards, the loader has " + TOSTR(_loaders.size()))
+        _loader_idx = _start_position->shard_idx % _shard_count;
+    }
     for(unsigned i = 0; i < _loaders.size(); i++)
     {
+        if(!_shard_cpus.empty())
+            _loaders[i]->set_numa_placement({_shard_cpus[i % _shard_cpus.size()]});
+        if(_start_position)
+        {
+            LoaderPosition shard_position;
+            shard_position.epoch = _start_position->epoch;
+            shard_position.shard_batch_counts = {_start_position->shard_batch_counts[i]};
+            shard_position.shard_total_batch_counts = {_start_position->shard_total_batch_counts[i]};
+            _loaders[i]->set_start_position(shard_position);
+        }
         _loaders[i]->start_loading();
     //  Changing thread scheduling policy and it's priority does not help on latest Ubuntu builds
     //  and needs tweaking the Linux security settings , can be turned on for experimentation
@@ -139,6 +222,22 @@ void ImageLoaderSharded::shut_down()
 }
 
 
+void ImageLoaderSharded::set_sequence_rearrange(Image *output_image, const std::vector<unsigned> &new_order)
+{
+    if(!_initialized)
+        THROW("set_sequence_rearrange() should be called after initialize() function")
+    if(_reader_cfg.type() != StorageType::SEQUENCE_FILE_SYSTEM)
+        THROW("Sequence rearrangement can only be folded into a sequence reader")
+    // Releasing the loaders joins their threads, the frames they have prefetched are dropped and the new ones start from the beginning
+    _loaders.clear();
+    _initialized = false;
+    _loader_idx = 0;
+    _output_image = output_image;
+    _reader_cfg.set_sequence_rearrange(new_order);
+    initialize(_reader_cfg, _decoder_cfg, _mem_type, output_image->info().batch_size(), _keep_orig_size);
+    start_loading();
+}
+
 void ImageLoaderSharded::set_output_image (Image* output_image)
 {
     _output_image = output_image;
@@ -149,6 +248,61 @@ void ImageLoaderSharded::set_random_bbox_data_reader(std::shared_ptr<RandomBBoxC
     _randombboxcrop_meta_data_reader = randombboxcrop_meta_data_reader;
 }
 
+void ImageLoaderSharded::set_bbox_crop_sampler(std::shared_ptr<BBoxCropSampler> bbox_crop_sampler)
+{
+    _bbox_crop_sampler = bbox_crop_sampler;
+    for(auto &loader: _loaders)
+        loader->set_bbox_crop_sampler(_bbox_crop_sampler);
+}
+
+void ImageLoaderSharded::set_prefetch_memory_budget(size_t memory_budget, size_t min_depth)
+{
+    if(_initialized)
+        THROW("set_prefetch_memory_budget() should be called before initialize() function");
+    _prefetch_memory_budget = memory_budget;
+    _prefetch_min_depth = min_depth;
+}
+
+void ImageLoaderSharded::set_decode_thread_count(size_t thread_count)
+{
+    _decode_thread_count = thread_count;
+    if (_decode_worker_pool)
+        _decode_worker_pool->set_worker_count(_shard_count * thread_count);
+    for(auto &loader: _loaders)
+        loader->set_decode_thread_count(_decode_thread_count);
+}
+
+void ImageLoaderSharded::set_prefetch_limit(size_t prefetch_depth)
+{
+    _prefetch_limit = prefetch_depth;
+    for(auto &loader: _loaders)
+        loader->set_prefetch_limit(_prefetch_limit);
+}
+
+bool ImageLoaderSharded::get_position(LoaderPosition &position)
+{
+    if(!_initialized)
+        return false;
+    position.shard_batch_counts.resize(_loaders.size());
+    position.shard_total_batch_counts.resize(_loaders.size());
+    for(size_t i = 0; i < _loaders.size(); i++)
+    {
+        LoaderPosition shard_position;
+        _loaders[i]->get_position(shard_position);
+        position.epoch = shard_position.epoch;
+        position.shard_batch_counts[i] = shard_position.shard_batch_counts[0];
+        position.shard_total_batch_counts[i] = shard_position.shard_total_batch_counts[0];
+    }
+    position.shard_idx = _loader_idx;
+    return true;
+}
+
+void ImageLoaderSharded::set_start_position(const LoaderPosition &position)
+{
+    // Kept for the loaders rebuilt by set_sequence_rearrange(), that start over from the same position
+    _start_position = std::make_unique<LoaderPosition>(position);
+}
+
 size_t ImageLoaderSharded::remaining_count()
 {
     int sum = 0;
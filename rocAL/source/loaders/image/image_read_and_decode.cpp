@@ -75,6 +75,7 @@ ImageReadAndDecode::create(ReaderConfig reader_config, DecoderConfig decoder_con
     _decoder.resize(batch_size);
     _actual_read_size.resize(batch_size);
     _image_names.resize(batch_size);
+    _sample_paths.resize(batch_size);
     _compressed_image_size.resize(batch_size);
     _decompressed_buff_ptrs.resize(_batch_size);
     _actual_decoded_width.resize(_batch_size);
@@ -97,8 +98,11 @@ ImageReadAndDecode::create(ReaderConfig reader_config, DecoderConfig decoder_con
             _decoder[i]->initialize(device_id);
         }
     }
+    _header_decoded.resize(_batch_size);
     _num_threads = reader_config.get_cpu_num_threads();
     _reader = create_reader(reader_config);
+    if (_decoder_config._type != DecoderType::SKIP_DECODE)
+        _quarantine = SampleQuarantine::open(reader_config.path());
 }
 
 void
@@ -108,6 +112,28 @@ ImageReadAndDecode::reset()
     _reader->reset();
 }
 
+void
+ImageReadAndDecode::seek(size_t epoch, size_t item_count, uint64_t batch_count)
+{
+    // The reshuffles of the epochs before are replayed, the readers shuffle with the pipeline seed
+    for(size_t i = 0; i < epoch; i++)
+        _reader->reset();
+    _epoch = epoch;
+    if(!_reader->skip(item_count))
+    {
+        size_t skipped = 0;
+        for(; skipped < item_count && _reader->count_items() > 0; skipped++)
+        {
+            _reader->open();
+            _reader->close();
+        }
+        if(skipped < item_count)
+            WRN("Only " + TOSTR(skipped) + " of the " + TOSTR(item_count) + " samples to resume after are left in the epoch, the state does not match the data")
+    }
+    if(_random_crop_dec_param)
+        _random_crop_dec_param->set_batch_index(batch_count);
+}
+
 size_t
 ImageReadAndDecode::count()
 {
@@ -171,18 +197,40 @@ ImageReadAndDecode::load(unsigned char* buff,
                 continue;
             }
 
-            _actual_read_size[file_counter] = _reader->read_data(read_ptr, fsize);
-            if(_actual_read_size[file_counter] < fsize)
-                LOG("Reader read less than requested bytes of size: " + _actual_read_size[file_counter]);
+            ReaderItemView item_view;
+            if (_reader->view(item_view)) {
+                // The sample is copied once, straight from the reader's memory into its place in the batch, and keeps its own size as ROI
+                const auto &shape = item_view.shape;
+                if (shape.channels != output_planes)
+                    THROW("Sample " + _reader->id() + " has " + TOSTR(shape.channels) + " channels, the output image has " + TOSTR(output_planes))
+                if (shape.width > max_decoded_width || shape.height > max_decoded_height)
+                    THROW("Sample " + _reader->id() + " of size " + TOSTR(shape.width) + " x " + TOSTR(shape.height) + " is bigger than the output image " +
+                          TOSTR(max_decoded_width) + " x " + TOSTR(max_decoded_height))
+                const size_t row_size = (size_t)shape.width * output_planes;
+                const size_t output_stride = max_decoded_width * output_planes;
+                if (row_size == output_stride) {
+                    memcpy(read_ptr, item_view.data, shape.size());
+                } else {
+                    for (unsigned row = 0; row < shape.height; row++)
+                        memcpy(read_ptr + row * output_stride, item_view.data + row * row_size, row_size);
+                }
+                _actual_read_size[file_counter] = shape.size();
+                roi_width[file_counter] = actual_width[file_counter] = shape.width;
+                roi_height[file_counter] = actual_height[file_counter] = shape.height;
+            } else {
+                _actual_read_size[file_counter] = _reader->read_data(read_ptr, fsize);
+                if(_actual_read_size[file_counter] < fsize)
+                    LOG("Reader read less than requested bytes of size: " + TOSTR(_actual_read_size[file_counter]));
+                roi_width[file_counter] = max_decoded_width;
+                roi_height[file_counter] = max_decoded_height;
+                actual_width[file_counter] = max_decoded_width;
+                actual_height[file_counter] = max_decoded_height;
+            }
 
             _image_names[file_counter] = _reader->id();
             _reader->close();
            // _compressed_image_size[file_counter] = fsize;
             names[file_counter] = _image_names[file_counter];
-            roi_width[file_counter] = max_decoded_width;
-            roi_height[file_counter] = max_decoded_height;
-            actual_width[file_counter] = max_decoded_width;
-            actual_height[file_counter] = max_decoded_height;
             file_counter++;
         }
         //_file_load_time.end();// Debug timing
@@ -192,18 +240,29 @@ ImageReadAndDecode::load(unsigned char* buff,
             size_t fsize = _reader->open();
             if (fsize == 0) {
                 WRN("Opened file " + _reader->id() + " of size 0");
+                if (_quarantine)
+                    _quarantine->add(_reader->sample_path(), "empty or unreadable");
+                continue;
+            }
+            _image_names[file_counter] = _reader->id();
+            _sample_paths[file_counter] = _reader->sample_path();
+            _header_decoded[file_counter] = false;
+            if (_spare.valid && _quarantine && _quarantine->contains(_sample_paths[file_counter])) {
+                // Known to fail since an earlier epoch or run, not worth reading it again
+                _reader->close();
+                replace_with_spare(file_counter);
+                file_counter++;
                 continue;
             }
             _compressed_buff[file_counter].reserve(fsize);
             _actual_read_size[file_counter] = _reader->read_data(_compressed_buff[file_counter].data(), fsize);
-            _image_names[file_counter] = _reader->id();
             _reader->close();
             _compressed_image_size[file_counter] = fsize;
             file_counter++;
         }
         if (_randombboxcrop_meta_data_reader) {
             //Fetch the crop co-ordinates for a batch of images
-            _bbox_coords = _randombboxcrop_meta_data_reader->get_batch_crop_coords(_image_names);
+            _bbox_coords = _randombboxcrop_meta_data_reader->get_batch_crop_coords(_image_names, _epoch);
             set_batch_random_bbox_crop_coords(_bbox_coords);
         } else if (_random_crop_dec_param) {
             _random_crop_dec_param->generate_random_seeds();
@@ -217,39 +276,61 @@ ImageReadAndDecode::load(unsigned char* buff,
         for (size_t i = 0; i < _batch_size; i++)
             _decompressed_buff_ptrs[i] = buff + image_size * i;
 
-#pragma omp parallel for num_threads(_num_threads)  // default(none) TBD: option disabled in Ubuntu 20.04
+        // Borrow the decode threads of the shards that are idle at the moment, if shared across shards
+        const size_t own_threads = _num_threads.load();
+        DecodeWorkerPool::Lease decode_lease(_decode_worker_pool.get(), own_threads, _batch_size);
+        const size_t decode_threads = decode_lease.count();
+#pragma omp parallel for num_threads(decode_threads)  // default(none) TBD: option disabled in Ubuntu 20.04
         for (size_t i = 0; i < _batch_size; i++)
         {
-            // initialize the actual decoded height and width with the maximum
-            _actual_decoded_width[i] = max_decoded_width;
-            _actual_decoded_height[i] = max_decoded_height;
+            if (_header_decoded[i])
+                continue;
             int original_width, original_height, jpeg_sub_samp;
             if (_decoder[i]->decode_info(_compressed_buff[i].data(), _actual_read_size[i], &original_width, &original_height,
-                                         &jpeg_sub_samp) != Decoder::Status::OK) {
-                    // Substituting the image which failed decoding with other image from the same batch
-                    int j = ((i + 1) != _batch_size) ? _batch_size - 1 : _batch_size - 2;
-                    while ((j >= 0)) 
-                    {
-                        if (_decoder[i]->decode_info(_compressed_buff[j].data(), _actual_read_size[j], &original_width, &original_height,
-                            &jpeg_sub_samp) == Decoder::Status::OK) 
-                        {
-                                _image_names[i] =  _image_names[j];
-                                _compressed_buff[i] =  _compressed_buff[j];
-                                _actual_read_size[i] =  _actual_read_size[j];
-                                _compressed_image_size[i] =  _compressed_image_size[j];
-                                break;                                
-
-                        }
-                        else
-                            j--;
-                        if(j < 0) 
-                        {
-                            THROW("All images in the batch failed decoding\n");
-                        }                                    
-                    }
+                                         &jpeg_sub_samp) == Decoder::Status::OK) {
+                _original_width[i] = original_width;
+                _original_height[i] = original_height;
+                _header_decoded[i] = true;
+            }
+        }
+        // Substituting the images which failed decoding with the spare, or with another image of the same batch,
+        // their headers are already known so nothing gets decoded twice
+        for (size_t i = 0; i < _batch_size; i++)
+        {
+            if (_header_decoded[i])
+                continue;
+            if (_quarantine)
+                _quarantine->add(_sample_paths[i], "could not decode the header");
+            if (_spare.valid) {
+                replace_with_spare(i);
+                continue;
             }
-            _original_height[i] = original_height;
-            _original_width[i] = original_width;
+            size_t j = _batch_size;
+            while (j > 0 && !_header_decoded[j - 1])
+                j--;
+            if (j == 0)
+                THROW("All images in the batch failed decoding\n");
+            replace_sample(i, j - 1);
+        }
+        if (!_spare.valid) {
+            size_t donor = 0;
+            while (!_header_decoded[donor])
+                donor++;
+            _spare.data.assign(_compressed_buff[donor].data(), _compressed_buff[donor].data() + _actual_read_size[donor]);
+            _spare.size = _actual_read_size[donor];
+            _spare.width = _original_width[donor];
+            _spare.height = _original_height[donor];
+            _spare.name = _image_names[donor];
+            _spare.path = _sample_paths[donor];
+            _spare.valid = true;
+        }
+#pragma omp parallel for num_threads(decode_threads)  // default(none) TBD: option disabled in Ubuntu 20.04
+        for (size_t i = 0; i < _batch_size; i++)
+        {
+            // initialize the actual decoded height and width with the maximum
+            _actual_decoded_width[i] = max_decoded_width;
+            _actual_decoded_height[i] = max_decoded_height;
+            int original_width = _original_width[i], original_height = _original_height[i];
             // decode the image and get the actual decoded image width and height
             size_t scaledw, scaledh;
             if (_decoder[i]->is_partial_decoder()) {
@@ -266,6 +347,9 @@ ImageReadAndDecode::load(unsigned char* buff,
                                     original_width, original_height,
                                     scaledw, scaledh,
                                     decoder_color_format, _decoder_config, keep_original) != Decoder::Status::OK) {
+                // Too late to replace it in this batch, it is from the next epoch on
+                if (_quarantine && _sample_paths[i] != _spare.path)
+                    _quarantine->add(_sample_paths[i], "could not decode the image");
             }
             _actual_decoded_width[i] = scaledw;
             _actual_decoded_height[i] = scaledh;
@@ -282,3 +366,32 @@ ImageReadAndDecode::load(unsigned char* buff,
     _decode_time.end();// Debug timing
     return LoaderModuleStatus::OK;
 }
+
+void
+ImageReadAndDecode::replace_sample(size_t index, size_t donor)
+{
+    if (_compressed_buff[index].capacity() < _actual_read_size[donor])
+        _compressed_buff[index].reserve(_actual_read_size[donor]);
+    memcpy(_compressed_buff[index].data(), _compressed_buff[donor].data(), _actual_read_size[donor]);
+    _image_names[index] = _image_names[donor];
+    _sample_paths[index] = _sample_paths[donor];
+    _actual_read_size[index] = _actual_read_size[donor];
+    _compressed_image_size[index] = _compressed_image_size[donor];
+    _original_width[index] = _original_width[donor];
+    _original_height[index] = _original_height[donor];
+    _header_decoded[index] = true;
+}
+
+void
+ImageReadAndDecode::replace_with_spare(size_t index)
+{
+    if (_compressed_buff[index].capacity() < _spare.size)
+        _compressed_buff[index].reserve(_spare.size);
+    memcpy(_compressed_buff[index].data(), _spare.data.data(), _spare.size);
+    _image_names[index] = _spare.name;
+    _sample_paths[index] = _spare.path;
+    _actual_read_size[index] = _compressed_image_size[index] = _spare.size;
+    _original_width[index] = _spare.width;
+    _original_height[index] = _spare.height;
+    _header_decoded[index] = true;
+}
@@ -49,6 +49,9 @@ void ImageLoaderNode::init(unsigned internal_shard_count, unsigned cpu_num_threa
     reader_cfg.set_sequence_length(sequence_length);
     reader_cfg.set_frame_step(step);
     reader_cfg.set_frame_stride(stride);
+    reader_cfg.set_synthetic_data_config(_synthetic_data_config);
+    reader_cfg.set_raw_sample_shape(_raw_sample_shape);
+    reader_cfg.set_shuffle_buffer_size(_shuffle_buffer_size);
     _loader_module->initialize(reader_cfg, DecoderConfig(decoder_type),
                               mem_type,
                               _batch_size, decoder_keep_orig);
@@ -62,6 +65,15 @@ std::shared_ptr<LoaderModule> ImageLoaderNode::get_loader_module()
     return _loader_module;
 }
 
+void ImageLoaderNode::set_sequence_rearrange(Image *output, const std::vector<unsigned> &new_order)
+{
+    if(!_loader_module)
+        THROW("ERROR: loader module is not set for ImageLoaderNode, cannot rearrange the sequences")
+    _outputs[0] = output;
+    _batch_size = output->info().batch_size();
+    _loader_module->set_sequence_rearrange(output, new_order);
+}
+
 ImageLoaderNode::~ImageLoaderNode()
 {
     _loader_module = nullptr;
@@ -0,0 +1,53 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "node_service_loader.h"
+#include "exception.h"
+
+ServiceLoaderNode::ServiceLoaderNode(Image *output, void *device_resources):
+        Node({}, {output})
+{
+    _loader_module = std::make_shared<ServiceDataLoader>(device_resources);
+}
+
+void ServiceLoaderNode::init(std::shared_ptr<ShmBatchRing> batch_ring, RocalMemType mem_type)
+{
+    if(!_loader_module)
+        THROW("ERROR: loader module is not set for ServiceLoaderNode, cannot initialize")
+    _loader_module->set_output_image(_outputs[0]);
+    _loader_module->set_batch_ring(batch_ring);
+    // Nothing is read or decoded on the client side, the configs are only passed for api match
+    _loader_module->initialize(ReaderConfig(StorageType::FILE_SYSTEM), DecoderConfig(DecoderType::TURBO_JPEG), mem_type, _batch_size);
+    _loader_module->start_loading();
+}
+
+std::shared_ptr<LoaderModule> ServiceLoaderNode::get_loader_module()
+{
+    if(!_loader_module)
+        WRN("ServiceLoaderNode's loader module is null, not initialized")
+    return _loader_module;
+}
+
+ServiceLoaderNode::~ServiceLoaderNode()
+{
+    _loader_module = nullptr;
+}
@@ -0,0 +1,138 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "service_data_loader.h"
+#include "exception.h"
+
+ServiceDataLoader::ServiceDataLoader(void *dev_resources):
+        _wait_time("service wait time", DBG_TIMING),
+        _swap_handle_time("Swap_handle_time", DBG_TIMING)
+{
+}
+
+ServiceDataLoader::~ServiceDataLoader()
+{
+    shut_down();
+}
+
+void
+ServiceDataLoader::initialize(ReaderConfig reader_cfg, DecoderConfig decoder_cfg, RocalMemType mem_type, unsigned batch_size, bool keep_orig_size)
+{
+    if(_initialized)
+        return;
+    if(!_batch_ring)
+        THROW("The service ring should be set before initializing the service loader")
+    if(mem_type != RocalMemType::HOST)
+        THROW("The service source only runs with the host memory type (CPU affinity)")
+    const auto &layout = _batch_ring->layout();
+    if(layout.batch_size != batch_size)
+        THROW("The service publishes batches of " + TOSTR(layout.batch_size) + " images, the pipeline batch size is " + TOSTR(batch_size))
+    _batch_size = batch_size;
+    _output_decoded_img_info._roi_width.assign(_batch_size, layout.width);
+    _output_decoded_img_info._roi_height.assign(_batch_size, layout.height);
+    _output_decoded_img_info._original_width.assign(_batch_size, layout.width);
+    _output_decoded_img_info._original_height.assign(_batch_size, layout.height);
+    _initialized = true;
+}
+
+void
+ServiceDataLoader::set_output_image(Image* output_image)
+{
+    _output_image = output_image;
+}
+
+void
+ServiceDataLoader::release_slot()
+{
+    if(!_slot_in_use)
+        return;
+    _batch_ring->commit_read();
+    _slot_in_use = false;
+}
+
+LoaderModuleStatus
+ServiceDataLoader::load_next()
+{
+    if(!_initialized)
+        return LoaderModuleStatus::NOT_INITIALIZED;
+    // The graph is done with the previous batch by now, its slot goes back to the service
+    release_slot();
+    if(remaining_count() < _batch_size)
+        return LoaderModuleStatus::NO_MORE_DATA_TO_READ;
+    _wait_time.start();
+    bool ready = _batch_ring->wait_until_readable();
+    _wait_time.end();
+    if(!ready)
+        return LoaderModuleStatus::NO_MORE_DATA_TO_READ;// the service has stopped
+    _swap_handle_time.start();
+    if(_output_image->swap_handle(_batch_ring->read_images()) != 0)
+        return LoaderModuleStatus::HOST_BUFFER_SWAP_FAILED;
+    _batch_ring->read_meta_data(_output_names, nullptr);
+    _output_decoded_img_info._image_names = _output_names;
+    _swap_handle_time.end();
+    _slot_in_use = true;
+    _epoch_batch_index++;
+    return LoaderModuleStatus::OK;
+}
+
+size_t
+ServiceDataLoader::remaining_count()
+{
+    if(!_initialized)
+        return 0;
+    const size_t epoch_batch_count = _batch_ring->layout().epoch_batch_count;
+    return (epoch_batch_count > _epoch_batch_index) ? (epoch_batch_count - _epoch_batch_index) * _batch_size : 0;
+}
+
+void
+ServiceDataLoader::reset()
+{
+    if(!_initialized)
+        return;
+    release_slot();
+    // The service carries on with the batches of this rank in order, the ones left of the current epoch are skipped
+    const size_t epoch_batch_count = _batch_ring->layout().epoch_batch_count;
+    for(; _epoch_batch_index < epoch_batch_count; _epoch_batch_index++)
+    {
+        if(!_batch_ring->wait_until_readable())
+            break;
+        _batch_ring->commit_read();
+    }
+    _epoch_batch_index = 0;
+    _output_decoded_img_info._epoch++;
+}
+
+Timing
+ServiceDataLoader::timing()
+{
+    Timing t;
+    t.image_read_time = _wait_time.get_timing();
+    t.image_process_time = _swap_handle_time.get_timing();
+    return t;
+}
+
+void
+ServiceDataLoader::shut_down()
+{
+    if(_batch_ring)
+        release_slot();
+}
@@ -48,6 +48,7 @@ ImageSourceEvaluator::create(ReaderConfig reader_cfg, DecoderConfig decoder_cfg)
     
 
     // _header_buff.resize(COMPRESSED_SIZE);
+    _quarantine = SampleQuarantine::open(reader_cfg.path());
     _decoder = create_decoder(std::move(decoder_cfg));
     _reader = create_reader(std::move(reader_cfg));
     find_max_dimension();
@@ -63,7 +64,17 @@ ImageSourceEvaluator::find_max_dimension()
     {
         size_t fsize = _reader->open();
         if( (fsize) == 0 )
+        {
+            if(_quarantine)
+                _quarantine->add(_reader->sample_path(), "empty or unreadable");
             continue;
+        }
+        // Already known to fail, not read again
+        if(_quarantine && _quarantine->contains(_reader->sample_path()))
+        {
+            _reader->close();
+            continue;
+        }
         _header_buff.resize(fsize);
         auto actual_read_size = _reader->read_data(_header_buff.data(), fsize);
         _reader->close();
@@ -71,7 +82,10 @@ ImageSourceEvaluator::find_max_dimension()
         int width, height, jpeg_sub_samp;
         if(_decoder->decode_info(_header_buff.data(), actual_read_size, &width, &height, &jpeg_sub_samp ) != Decoder::Status::OK)
         {
-            WRN("Could not decode the header of the: "+ _reader->id())
+            if(_quarantine)
+                _quarantine->add(_reader->sample_path(), "could not decode the header");
+            else
+                WRN("Could not decode the header of the: "+ _reader->id())
             continue;
         }
         
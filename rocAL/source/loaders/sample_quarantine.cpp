@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <sys/stat.h>
+#include "commons.h"
+#include "sample_quarantine.h"
+
+namespace
+{
+std::vector<std::string> sidecar_paths(const std::string &source_path)
+{
+    std::string path = source_path;
+    while(path.size() > 1 && (path.back() == '/' || path.back() == '\\'))
+        path.pop_back();
+    struct stat st;
+    bool is_directory = stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    const char *cache_dir = std::getenv("ROCAL_CACHE_DIR");
+    auto base_name = path.substr(path.find_last_of("/\\") + 1);
+    std::stringstream fallback;
+    fallback << (cache_dir ? cache_dir : "/tmp") << "/" << base_name << "." << std::hex << std::hash<std::string>()(path) << ".rocal_quarantine";
+    return {is_directory ? path + "/.rocal_quarantine" : path + ".rocal_quarantine", fallback.str()};
+}
+}
+
+std::shared_ptr<SampleQuarantine> SampleQuarantine::open(const std::string &source_path)
+{
+    if(std::getenv("ROCAL_DISABLE_QUARANTINE") || source_path.empty())
+        return nullptr;
+    static std::mutex registry_lock;
+    static std::map<std::string, std::weak_ptr<SampleQuarantine>> registry;
+    std::unique_lock<std::mutex> lock(registry_lock);
+    auto quarantine = registry[source_path].lock();
+    if(!quarantine)
+    {
+        quarantine = std::make_shared<SampleQuarantine>(source_path);
+        registry[source_path] = quarantine;
+    }
+    return quarantine;
+}
+
+SampleQuarantine::SampleQuarantine(const std::string &source_path):
+        _source_path(source_path)
+{
+    for(auto &path : sidecar_paths(source_path))
+        load(path);
+    if(!_samples.empty())
+        INFO("Quarantine of " + _source_path + " holds " + TOSTR(_samples.size()) + " samples")
+}
+
+void SampleQuarantine::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if(!file)
+        return;
+    std::string line;
+    while(std::getline(file, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+        auto tab = line.find('\t');
+        _samples.emplace(line.substr(0, tab), tab == std::string::npos ? "" : line.substr(tab + 1));
+    }
+    _count.store(_samples.size(), std::memory_order_release);
+}
+
+bool SampleQuarantine::contains(const std::string &id) const
+{
+    if(size() == 0)
+        return false;
+    std::unique_lock<std::mutex> lock(_lock);
+    return _samples.find(id) != _samples.end();
+}
+
+void SampleQuarantine::add(const std::string &id, const std::string &reason)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    if(!_samples.emplace(id, reason).second)
+        return;
+    _count.store(_samples.size(), std::memory_order_release);
+    WRN("Quarantined sample " + id + ": " + reason)
+    // Appended right away so that the samples found so far are kept even if the run does not finish
+    if(_sidecar_path.empty())
+    {
+        for(auto &path : sidecar_paths(_source_path))
+        {
+            std::ofstream probe(path, std::ios::app);
+            if(probe)
+            {
+                _sidecar_path = path;
+                break;
+            }
+        }
+        if(_sidecar_path.empty())
+        {
+            WRN("Could not write the quarantine file of " + _source_path)
+            _sidecar_path = "-";
+        }
+    }
+    if(_sidecar_path == "-")
+        return;
+    std::ofstream file(_sidecar_path, std::ios::app);
+    std::string clean_reason = reason;
+    for(auto &c : clean_reason)
+        if(c == '\n' || c == '\t')
+            c = ' ';
+    file << id << '\t' << clean_reason << '\n';
+}
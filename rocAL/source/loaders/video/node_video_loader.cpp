@@ -60,6 +60,15 @@ std::shared_ptr<VideoLoaderModule> VideoLoaderNode::get_loader_module()
     return _loader_module;
 }
 
+void VideoLoaderNode::set_sequence_rearrange(Image *output, const std::vector<unsigned> &new_order)
+{
+    if(!_loader_module)
+        THROW("ERROR: loader module is not set for VideoLoaderNode, cannot rearrange the sequences")
+    _outputs[0] = output;
+    _batch_size = output->info().batch_size();
+    _loader_module->set_sequence_rearrange(output, new_order);
+}
+
 VideoLoaderNode::~VideoLoaderNode()
 {
     _loader_module = nullptr;
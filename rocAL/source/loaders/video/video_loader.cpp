@@ -128,7 +128,8 @@ void VideoLoader::initialize(VideoReaderConfig reader_cfg, VideoDecoderConfig de
     _mem_type = mem_type;
     _batch_size = batch_size;
     _loop = reader_cfg.loop();
-    _sequence_length = reader_cfg.get_sequence_length();
+    // Frames per sequence in the output, the loader can be set to keep only some of the frames it reads
+    _sequence_length = reader_cfg.get_sequence_rearrange().empty() ? reader_cfg.get_sequence_length() : reader_cfg.get_sequence_rearrange().size();
     _sequence_count = _batch_size / _sequence_length;
     _decoder_keep_original = decoder_keep_original;
     _video_loader = std::make_shared<VideoReadAndDecode>();
@@ -81,6 +81,10 @@ void VideoLoaderSharded::initialize(VideoReaderConfig reader_cfg, VideoDecoderCo
     if (_initialized)
         return;
     _shard_count = reader_cfg.get_shard_count();
+    _reader_cfg = reader_cfg;
+    _decoder_cfg = decoder_cfg;
+    _mem_type = mem_type;
+    _keep_orig_size = keep_orig_size;
 
     // Create loader modules
     for (size_t i = 0; i < _shard_count; i++)
@@ -130,6 +134,20 @@ void VideoLoaderSharded::shut_down()
 
 }
 
+void VideoLoaderSharded::set_sequence_rearrange(Image *output_image, const std::vector<unsigned> &new_order)
+{
+    if (!_initialized)
+        THROW("set_sequence_rearrange() should be called after initialize() function");
+    // Releasing the loaders joins their threads, the sequences they have prefetched are dropped and the new ones start from the beginning
+    _loaders.clear();
+    _initialized = false;
+    _loader_idx = 0;
+    _output_image = output_image;
+    _reader_cfg.set_sequence_rearrange(new_order);
+    initialize(_reader_cfg, _decoder_cfg, _mem_type, output_image->info().batch_size(), _keep_orig_size);
+    start_loading();
+}
+
 void VideoLoaderSharded::set_output_image(Image *output_image)
 {
     _output_image = output_image;
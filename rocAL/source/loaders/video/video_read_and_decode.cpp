@@ -20,6 +20,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
+#include <numeric>
+#include <algorithm>
 #include "video_decoder_factory.h"
 #include "video_read_and_decode.h"
 
@@ -76,7 +78,23 @@ void VideoReadAndDecode::create(VideoReaderConfig reader_config, VideoDecoderCon
     set_video_process_count(_video_count);
     _video_decoder.resize(_video_process_count);
     _video_names = _video_prop.video_file_names;
-    _sequence_count = _batch_size / _sequence_length;
+    _new_order = reader_config.get_sequence_rearrange();
+    if (_new_order.empty())
+    {
+        _new_order.resize(_sequence_length);
+        std::iota(_new_order.begin(), _new_order.end(), 0);
+    }
+    _output_sequence_length = _new_order.size();
+    // Each referenced frame is decoded once into the first output position using it, the frames after the last referenced one are not decoded at all
+    _frame_slots.assign(*std::max_element(_new_order.begin(), _new_order.end()) + 1, -1);
+    for (size_t position = 0; position < _output_sequence_length; position++)
+    {
+        if (_new_order[position] >= _sequence_length)
+            THROW("Rearranged frame position " + TOSTR(_new_order[position]) + " is out of the sequence of length " + TOSTR(_sequence_length))
+        if (_frame_slots[_new_order[position]] < 0)
+            _frame_slots[_new_order[position]] = position;
+    }
+    _sequence_count = _batch_size / _output_sequence_length;
     _decompressed_buff_ptrs.resize(_sequence_count);
     _actual_decoded_width.resize(_sequence_count);
     _actual_decoded_height.resize(_sequence_count);
@@ -134,9 +152,17 @@ float VideoReadAndDecode::convert_framenum_to_timestamp(size_t frame_number)
 
 void VideoReadAndDecode::decode_sequence(size_t sequence_index)
 {
-    if (_video_decoder[_sequence_video_idx[sequence_index]]->Decode(_decompressed_buff_ptrs[sequence_index], _sequence_start_frame_num[sequence_index], _sequence_length, _stride,
+    if (_video_decoder[_sequence_video_idx[sequence_index]]->Decode(_decompressed_buff_ptrs[sequence_index], _sequence_start_frame_num[sequence_index], _frame_slots, _stride,
                                                                     _max_decoded_width, _max_decoded_height, _max_decoded_stride, _out_pix_fmt) == VideoDecoder::Status::OK)
     {
+        // Frames repeated by the new order are copied from the position they were decoded into
+        unsigned char *sequence_buff = _decompressed_buff_ptrs[sequence_index];
+        for (size_t position = 0; position < _output_sequence_length; position++)
+        {
+            size_t decoded_position = _frame_slots[_new_order[position]];
+            if (decoded_position != position)
+                memcpy(sequence_buff + position * _decoded_image_size, sequence_buff + decoded_position * _decoded_image_size, _decoded_image_size);
+        }
         _actual_decoded_width[sequence_index] = _max_decoded_width;
         _actual_decoded_height[sequence_index] = _max_decoded_height;
     }
@@ -166,7 +192,7 @@ VideoReadAndDecode::load(unsigned char *buff,
     sequence_start_framenum.resize(_sequence_count);
     sequence_frame_timestamps.resize(_sequence_count);
     for (size_t it = 0; it < (_sequence_count); it++)
-        sequence_frame_timestamps[it].resize(_sequence_length);
+        sequence_frame_timestamps[it].resize(_output_sequence_length);
     const auto ret = video_interpret_color_format(output_color_format);
     const unsigned output_planes = std::get<1>(ret);
     _out_pix_fmt = std::get<2>(ret);
@@ -174,6 +200,7 @@ VideoReadAndDecode::load(unsigned char *buff,
     _max_decoded_width = max_decoded_width;
     _max_decoded_height = max_decoded_height;
     _max_decoded_stride = max_decoded_width * output_planes;
+    _decoded_image_size = image_size;
 
     _file_load_time.start(); // Debug timing
 
@@ -188,7 +215,7 @@ VideoReadAndDecode::load(unsigned char *buff,
         auto sequence_info = _video_reader->get_sequence_info();
         _sequence_start_frame_num[i] = sequence_info.start_frame_number;
         _sequence_video_path[i] = sequence_info.video_file_name;
-        _decompressed_buff_ptrs[i] = buff + (i * image_size * _sequence_length);
+        _decompressed_buff_ptrs[i] = buff + (i * image_size * _output_sequence_length);
 
         // Check if the video file is already initialized otherwise use an existing decoder instance to initialize the video
         // std::cerr << "\nThe source video is " << _sequence_video_path[i] << " MAP : "<<_video_file_name_map.find(_sequence_video_path[i])->second._video_map_idx << "\tThe start index is : " << _sequence_start_frame_num[i] << "\n";
@@ -265,11 +292,11 @@ VideoReadAndDecode::load(unsigned char *buff,
         substring_extraction(_sequence_video_path[i], delim, substrings2);
         std::string video_idx = substrings2[0];
         sequence_start_framenum[i] = _sequence_start_frame_num[i];
-        for (size_t s = 0; s < _sequence_length; s++)
+        for (size_t s = 0; s < _output_sequence_length; s++)
         {
-            sequence_frame_timestamps[i][s] = convert_framenum_to_timestamp(_sequence_start_frame_num[i] + (s * _stride));
-            roi_width[(i * _sequence_length) + s] = _actual_decoded_width[i];
-            roi_height[(i * _sequence_length) + s] = _actual_decoded_height[i];
+            sequence_frame_timestamps[i][s] = convert_framenum_to_timestamp(_sequence_start_frame_num[i] + (_new_order[s] * _stride));
+            roi_width[(i * _output_sequence_length) + s] = _actual_decoded_width[i];
+            roi_height[(i * _output_sequence_length) + s] = _actual_decoded_height[i];
         }
         names[i] = video_idx + "#" + file_name + "_" + std::to_string(_sequence_start_frame_num[i]);
     }
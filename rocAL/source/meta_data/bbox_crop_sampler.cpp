@@ -0,0 +1,229 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include "bbox_crop_sampler.h"
+#include "meta_data_reader.h"
+#include "philox.h"
+#include "commons.h"
+#include "exception.h"
+#if ENABLE_SIMD
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+namespace
+{
+// splitmix64 finalizer
+inline uint64_t mix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Boxes of the sample being picked, as separate l, t, r, b rows of a padded stride
+struct BoxRows
+{
+    std::vector<float> data;
+    size_t stride = 0;
+    void load(const BoundingBoxCords &boxes)
+    {
+        stride = (boxes.size() + 7) & ~size_t(7);
+        data.resize(stride * 4);
+        for(size_t i = 0; i < boxes.size(); i++)
+        {
+            data[i] = boxes[i].l;
+            data[stride + i] = boxes[i].t;
+            data[2 * stride + i] = boxes[i].r;
+            data[3 * stride + i] = boxes[i].b;
+        }
+    }
+};
+}
+
+BBoxCropSampler::BBoxCropSampler(std::vector<BBoxCropOption> options, bool iou_over_union, bool check_overlap, unsigned attempts_per_option,
+                                 unsigned total_attempts, uint64_t seed, uint32_t stream):
+        _options(std::move(options)), _iou_over_union(iou_over_union), _check_overlap(check_overlap), _attempts_per_option(attempts_per_option),
+        _total_attempts(total_attempts), _seed(seed), _stream(stream)
+{
+    if(_options.empty())
+        THROW("No crop option given to the bounding box crop sampler")
+    if(_attempts_per_option == 0 || _total_attempts == 0)
+        THROW("The bounding box crop sampler needs at least one attempt per option and in total")
+}
+
+uint64_t BBoxCropSampler::sample_key(const std::string &name, size_t epoch)
+{
+    // FNV-1a, so the key of a sample does not depend on the standard library's std::hash
+    uint64_t h = 0xCBF29CE484222325ull;
+    for(unsigned char c : name)
+        h = (h ^ c) * 0x100000001B3ull;
+    return mix(h ^ mix(epoch));
+}
+
+bool BBoxCropSampler::accept(const BBoxCropOption &option, const BoundingBoxCord &window, const float *l, const float *t, const float *r,
+                             const float *b, size_t count) const
+{
+    // Without any box there is nothing to keep in view
+    if(count == 0)
+        return true;
+    const float window_area = (window.r - window.l) * (window.b - window.t);
+    bool center_inside = false;
+    size_t i = 0;
+#if ENABLE_SIMD
+    const __m256 pWl = _mm256_set1_ps(window.l), pWt = _mm256_set1_ps(window.t);
+    const __m256 pWr = _mm256_set1_ps(window.r), pWb = _mm256_set1_ps(window.b);
+    const __m256 pWarea = _mm256_set1_ps(window_area);
+    const __m256 pMin = _mm256_set1_ps(option.min_iou), pMax = _mm256_set1_ps(option.max_iou);
+    const __m256 pZero = _mm256_setzero_ps(), pHalf = _mm256_set1_ps(0.5f);
+    const int last_lanes = (1 << (count & 7 ? count & 7 : 8)) - 1;
+    for(; i < count; i += 8)
+    {
+        // The rows are padded to 8, the lanes past the last box are masked out
+        const int lanes = (i + 8 <= count) ? 0xFF : last_lanes;
+        __m256 pL = _mm256_loadu_ps(l + i), pT = _mm256_loadu_ps(t + i);
+        __m256 pR = _mm256_loadu_ps(r + i), pB = _mm256_loadu_ps(b + i);
+        if(_check_overlap)
+        {
+            __m256 pIw = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(pR, pWr), _mm256_max_ps(pL, pWl)), pZero);
+            __m256 pIh = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(pB, pWb), _mm256_max_ps(pT, pWt)), pZero);
+            __m256 pInter = _mm256_mul_ps(pIw, pIh);
+            __m256 pArea = _mm256_mul_ps(_mm256_sub_ps(pR, pL), _mm256_sub_ps(pB, pT));
+            __m256 pDenom = _iou_over_union ? _mm256_sub_ps(_mm256_add_ps(pArea, pWarea), pInter) : pArea;
+            __m256 pIou = _mm256_div_ps(pInter, pDenom);
+            __m256 pOut = _mm256_or_ps(_mm256_cmp_ps(pIou, pMin, _CMP_LT_OQ), _mm256_cmp_ps(pIou, pMax, _CMP_GT_OQ));
+            if(_mm256_movemask_ps(pOut) & lanes)
+                return false;
+        }
+        if(!center_inside)
+        {
+            __m256 pXc = _mm256_mul_ps(_mm256_add_ps(pL, pR), pHalf);
+            __m256 pYc = _mm256_mul_ps(_mm256_add_ps(pT, pB), pHalf);
+            __m256 pIn = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(pXc, pWl, _CMP_GE_OQ), _mm256_cmp_ps(pXc, pWr, _CMP_LE_OQ)),
+                                       _mm256_and_ps(_mm256_cmp_ps(pYc, pWt, _CMP_GE_OQ), _mm256_cmp_ps(pYc, pWb, _CMP_LE_OQ)));
+            center_inside = _mm256_movemask_ps(pIn) & lanes;
+            // Nothing left to test once a center is in the window
+            if(center_inside && !_check_overlap)
+                return true;
+        }
+    }
+#else
+    for(; i < count; i++)
+    {
+        if(_check_overlap)
+        {
+            float inter = std::max(0.0f, std::min(r[i], window.r) - std::max(l[i], window.l)) *
+                          std::max(0.0f, std::min(b[i], window.b) - std::max(t[i], window.t));
+            float area = (r[i] - l[i]) * (b[i] - t[i]);
+            float iou = inter / (_iou_over_union ? area + window_area - inter : area);
+            if(iou < option.min_iou || iou > option.max_iou)
+                return false;
+        }
+        if(!center_inside)
+        {
+            float xc = 0.5f * (l[i] + r[i]), yc = 0.5f * (t[i] + b[i]);
+            center_inside = xc >= window.l && xc <= window.r && yc >= window.t && yc <= window.b;
+            if(center_inside && !_check_overlap)
+                return true;
+        }
+    }
+#endif
+    return center_inside;
+}
+
+BBoxCropWindow BBoxCropSampler::sample(const BoundingBoxCords &boxes, uint64_t key, unsigned image_width) const
+{
+    static thread_local BoxRows rows;
+    rows.load(boxes);
+    const float *l = rows.data.data(), *t = l + rows.stride, *r = t + rows.stride, *b = r + rows.stride;
+
+    PhiloxEngine rng(_seed, _stream, key);
+    BBoxCropWindow result;
+    unsigned drawn = 0;
+    while(drawn < _total_attempts)
+    {
+        const BBoxCropOption &option = _options[rng.bounded(_options.size())];
+        result.min_iou = option.min_iou;
+        result.max_iou = option.max_iou;
+        if(option.whole_image)
+        {
+            result.window = BoundingBoxCord(0, 0, 1, 1);
+            return result;
+        }
+        for(unsigned attempt = 0; attempt < _attempts_per_option && drawn < _total_attempts; attempt++, drawn++)
+        {
+            // sides in [0.3, 1), then the top left corner keeping the window in the image
+            float w_factor = 0.3f + 0.7f * rng.uniform();
+            float h_factor = 0.3f + 0.7f * rng.uniform();
+            float aspect_ratio = w_factor / h_factor;
+            if(aspect_ratio < 0.5f || aspect_ratio > 2.0f)
+                continue;
+            float x_factor = (1.0f - w_factor) * rng.uniform();
+            float y_factor = (1.0f - h_factor) * rng.uniform();
+            if(image_width)
+                x_factor = (float)(std::lround(x_factor * image_width) & ~7) / image_width;
+            result.window = BoundingBoxCord(x_factor, y_factor, x_factor + w_factor, y_factor + h_factor);
+            if(accept(option, result.window, l, t, r, b, boxes.size()))
+                return result;
+        }
+    }
+    // Out of attempts, the whole image always keeps every box
+    result.window = BoundingBoxCord(0, 0, 1, 1);
+    result.min_iou = 0.0f;
+    result.max_iou = 1.0f;
+    return result;
+}
+
+void BBoxCropSampler::sample_batch(const std::vector<const BoundingBoxCords *> &boxes, const std::vector<std::string> &names, size_t epoch,
+                                   std::vector<BBoxCropWindow> &windows, const std::vector<unsigned> &image_widths) const
+{
+    if(boxes.size() != names.size() || (!image_widths.empty() && image_widths.size() != names.size()))
+        THROW("Bounding boxes given for " + TOSTR(boxes.size()) + " samples, " + TOSTR(names.size()) + " names given")
+    windows.resize(names.size());
+    const BoundingBoxCords no_boxes;
+    // The rejection loop of a sample takes a varying number of attempts
+    #pragma omp parallel for schedule(dynamic) num_threads(_num_threads)
+    for(int i = 0; i < (int)names.size(); i++)
+        windows[i] = sample(boxes[i] ? *boxes[i] : no_boxes, sample_key(names[i], epoch), image_widths.empty() ? 0 : image_widths[i]);
+}
+
+void BBoxCropSampler::sample_batch(const std::vector<std::string> &names, size_t epoch, std::vector<BBoxCropWindow> &windows) const
+{
+    if(!_meta_data_reader)
+        THROW("No meta data reader set for the bounding box crop sampler")
+    const auto &map_content = _meta_data_reader->get_map_content();
+    std::vector<const BoundingBoxCords *> boxes(names.size());
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        auto it = map_content.find(names[i]);
+        if(it == map_content.end())
+            THROW("ERROR: Given name not present in the map" + names[i])
+        boxes[i] = &it->second->get_bb_cords();
+    }
+    sample_batch(boxes, names, epoch, windows);
+}
@@ -19,6 +19,8 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
+#include <cmath>
+#include <cstring>
 #include "bounding_box_graph.h"
 
 void BoundingBoxGraph::process(MetaDataBatch *meta_data)
@@ -225,3 +227,66 @@ void BoundingBoxGraph::update_box_encoder_meta_data(std::vector<float> *anchors,
     }
 }
 
+void BoundingBoxGraph::update_keypoint_heatmaps(pMetaDataBatch full_batch_meta_data, float *heatmaps, float *target_weights, unsigned image_width, unsigned image_height,
+                                                unsigned heatmap_width, unsigned heatmap_height, float sigma, size_t num_threads)
+{
+    auto &joints_data = full_batch_meta_data->get_joints_data_batch();
+    const int window_radius = sigma * 3; // Only the 6 sigma window around each joint is written
+    const float feat_stride_x = (float)image_width / heatmap_width;
+    const float feat_stride_y = (float)image_height / heatmap_height;
+    const float inv_two_sigma_square = 1.0f / (2 * sigma * sigma);
+    const size_t heatmap_size = (size_t)heatmap_width * heatmap_height;
+    const int batch_size = joints_data.joints_batch.size();
+    #pragma omp parallel num_threads(num_threads)
+    {
+        // The gaussian is separable, a row of the window is the 1D horizontal gaussian scaled by the vertical one
+        std::vector<float> gaussian_x(2 * window_radius + 1);
+        #pragma omp for
+        for (int i = 0; i < batch_size; i++)
+        {
+            float *sample_heatmaps = heatmaps + (size_t)i * NUMBER_OF_JOINTS * heatmap_size;
+            float *sample_weights = target_weights + (size_t)i * NUMBER_OF_JOINTS;
+            memset(sample_heatmaps, 0, NUMBER_OF_JOINTS * heatmap_size * sizeof(float));
+            // Affine transform of the (center, scale, rotation) person box to the output image, as done by the HRNet data loaders
+            const float center_x = joints_data.center_batch[i][0], center_y = joints_data.center_batch[i][1];
+            const float src_width = joints_data.scale_batch[i][0] * PIXEL_STD;
+            const float ratio = src_width > 0 ? image_width / src_width : 0;
+            const float angle = joints_data.rotation_batch[i] * M_PI / 180;
+            const float cos_ratio = std::cos(angle) * ratio, sin_ratio = std::sin(angle) * ratio;
+            for (unsigned j = 0; j < NUMBER_OF_JOINTS; j++)
+            {
+                float visibility = joints_data.joints_visibility_batch[i][j][0];
+                sample_weights[j] = visibility > 0 ? 1.0f : 0.0f;
+                if (visibility <= 0)
+                    continue;
+                float dx = joints_data.joints_batch[i][j][0] - center_x, dy = joints_data.joints_batch[i][j][1] - center_y;
+                float joint_x = cos_ratio * dx + sin_ratio * dy + image_width * 0.5f;
+                float joint_y = -sin_ratio * dx + cos_ratio * dy + image_height * 0.5f;
+                int mu_x = joint_x / feat_stride_x + 0.5f;
+                int mu_y = joint_y / feat_stride_y + 0.5f;
+                int left = mu_x - window_radius, top = mu_y - window_radius;
+                int right = mu_x + window_radius + 1, bottom = mu_y + window_radius + 1;
+                if (left >= (int)heatmap_width || top >= (int)heatmap_height || right < 0 || bottom < 0)
+                {
+                    // The joint falls outside of the heatmap
+                    sample_weights[j] = 0;
+                    continue;
+                }
+                int x_begin = std::max(left, 0), x_end = std::min(right, (int)heatmap_width);
+                int y_begin = std::max(top, 0), y_end = std::min(bottom, (int)heatmap_height);
+                int window_width = x_end - x_begin;
+                for (int x = x_begin; x < x_end; x++)
+                    gaussian_x[x - x_begin] = std::exp(-(float)((x - mu_x) * (x - mu_x)) * inv_two_sigma_square);
+                float *joint_heatmap = sample_heatmaps + j * heatmap_size;
+                for (int y = y_begin; y < y_end; y++)
+                {
+                    const float gaussian_y = std::exp(-(float)((y - mu_y) * (y - mu_y)) * inv_two_sigma_square);
+                    float *row = joint_heatmap + (size_t)y * heatmap_width + x_begin;
+                    #pragma omp simd
+                    for (int x = 0; x < window_width; x++)
+                        row[x] = gaussian_y * gaussian_x[x];
+                }
+            }
+        }
+    }
+}
@@ -158,10 +158,15 @@ void Cifar10MetaDataReader::read_files(const std::string& _path)
         if  (data_file_name.find(_file_prefix) != std::string::npos) {
             file_path.append("/");
             file_path.append(_entity->d_name);
-            FILE* fp = fopen(file_path.c_str(), "rb");// Open the file,
-            fseek(fp, 0, SEEK_END);// Take the file read pointer to the end
-            size_t total_file_size = ftell(fp);
-            size_t num_of_raw_files = _raw_file_size? total_file_size / _raw_file_size: 0;
+            // Shares the mapping of the batch file with the CIFAR10 data reader, the file is read in only once
+            auto mapped_file = MappedFile::open(file_path);
+            if(!mapped_file)
+            {
+                WRN("Cifar10MetaDataReader:: Could not read " + file_path)
+                continue;
+            }
+            _mapped_files.push_back(mapped_file);
+            size_t num_of_raw_files = _raw_file_size? mapped_file->size() / _raw_file_size: 0;
             unsigned file_offset = 0;
             std::string file_id;
             unsigned char label;
@@ -181,16 +186,14 @@ void Cifar10MetaDataReader::read_files(const std::string& _path)
                 file_id.append("_");
                 file_id.append(std::to_string(i));
                 // read first byte for each bin as label and add entry
-                fseek(fp, file_offset, SEEK_SET);
-                size_t n = fread((void *)&label, sizeof(unsigned char), 1, fp);
-                if ((n != 1)||(label <0) || (label > 9))
+                label = mapped_file->data()[file_offset];
+                if (label > 9)
                     WRN("Cifar10MetaDataReader:: Invalid label " + TOSTR(label) + "read");
                 add(file_id, (int)label);
                 //LOG("Cifar10MetaDataReader:: Added record ID: " + file_id + " label: " + TOSTR(label));
                 file_offset += _raw_file_size;
             }
             LOG("Cifar10MetaDataReader:: Added " + TOSTR(num_of_raw_files) + " Meta map " );
-            fclose (fp);
 
         }
     }
@@ -0,0 +1,502 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <cstddef>
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#if !(defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__))
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <process.h>
+#define getpid _getpid
+#endif
+#include "commons.h"
+#include "coco_annotation_cache.h"
+
+namespace
+{
+const char CACHE_MAGIC[8] = {'R', 'O', 'C', 'A', 'L', 'C', 'O', 'C'};
+const uint32_t CACHE_VERSION = 2;
+const unsigned MAX_CACHE_PARAMS = 4;
+
+inline uint64_t rotate_left(uint64_t value, unsigned bits) { return (value << bits) | (value >> (64 - bits)); }
+
+// 4 independent lanes mixing 8 byte words, fast enough to validate multi-GB annotation files at every startup
+uint64_t hash_bytes(const unsigned char *data, size_t size)
+{
+    const uint64_t PRIME_1 = 0x9E3779B97F4A7C15ULL, PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t lanes[4] = {size, PRIME_1, ~size, PRIME_2};
+    size_t i = 0;
+    for(; i + 32 <= size; i += 32)
+        for(unsigned lane = 0; lane < 4; lane++)
+        {
+            uint64_t word;
+            memcpy(&word, data + i + 8 * lane, sizeof(word));
+            lanes[lane] = rotate_left(lanes[lane] ^ (word * PRIME_1), 31) * PRIME_2;
+        }
+    uint64_t hash = lanes[0] ^ rotate_left(lanes[1], 7) ^ rotate_left(lanes[2], 13) ^ rotate_left(lanes[3], 29);
+    for(; i < size; i++)
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+}
+
+struct CocoAnnotationCache::Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint64_t source_size;
+    uint64_t source_mtime;//!< Nanoseconds, checked first, the file is only hashed if it differs
+    uint64_t source_hash;
+    uint32_t params[MAX_CACHE_PARAMS];
+    uint32_t param_count;
+    uint32_t record_size;
+    uint64_t image_count;
+    uint64_t record_count;
+    uint64_t category_count;//!< Pairs of (category id, continuous label)
+    uint64_t string_bytes;
+};
+
+struct CocoAnnotationCache::ImageRecord
+{
+    uint64_t name_offset;//!< In the string table
+    uint32_t name_length;
+    int32_t width;
+    int32_t height;
+    uint32_t first;//!< First record of the image
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct CocoAnnotationCache::BoxRecord
+{
+    float l, t, r, b;
+    int32_t label;//!< Continuous label
+};
+
+struct CocoAnnotationCache::KeyPointRecord
+{
+    int32_t image_id;
+    int32_t annotation_id;
+    float center[2];
+    float scale[2];
+    float joints[NUMBER_OF_JOINTS][2];
+    float joints_visibility[NUMBER_OF_JOINTS][2];
+    float score;
+    float rotation;
+};
+
+CocoAnnotationCache::CocoAnnotationCache(const std::string &json_path, Kind kind, std::vector<uint32_t> params):
+        _json_path(json_path),
+        _kind(kind),
+        _params(std::move(params)),
+        _enabled(std::getenv("ROCAL_DISABLE_ANNOTATION_CACHE") == nullptr)
+{
+    if(_params.size() > MAX_CACHE_PARAMS)
+        THROW("Annotation cache supports up to " + TOSTR(MAX_CACHE_PARAMS) + " parameters")
+}
+
+CocoAnnotationCache::~CocoAnnotationCache()
+{
+    unmap_file();
+}
+
+std::vector<std::string> CocoAnnotationCache::cache_paths() const
+{
+    const char *cache_dir = std::getenv("ROCAL_CACHE_DIR");
+    auto base_name = _json_path.substr(_json_path.find_last_of("/\\") + 1);
+    std::stringstream fallback;
+    fallback << (cache_dir ? cache_dir : "/tmp") << "/" << base_name << "." << std::hex << std::hash<std::string>()(_json_path) << ".rocalcache";
+    return {_json_path + ".rocalcache", fallback.str()};
+}
+
+bool CocoAnnotationCache::source_stat(uint64_t &size, uint64_t &mtime) const
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
+    return false;
+#else
+    struct stat st;
+    if(stat(_json_path.c_str(), &st) != 0 || st.st_size == 0)
+        return false;
+    size = st.st_size;
+    mtime = uint64_t(st.st_mtim.tv_sec) * 1000000000ULL + st.st_mtim.tv_nsec;
+    return true;
+#endif
+}
+
+bool CocoAnnotationCache::source_hash(uint64_t &hash)
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
+    return false;
+#else
+    if(!_source_hashed)
+    {
+        int fd = ::open(_json_path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return false;
+        struct stat st;
+        if(fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(data == MAP_FAILED)
+            return false;
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+        _source_hash = hash_bytes(static_cast<const unsigned char *>(data), st.st_size);
+        munmap(data, st.st_size);
+        _source_hashed = true;
+    }
+    hash = _source_hash;
+    return true;
+#endif
+}
+
+bool CocoAnnotationCache::map_file(const std::string &path)
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
+    return false;
+#else
+    unmap_file();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header))
+    {
+        ::close(fd);
+        return false;
+    }
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED)
+        return false;
+    _mapped = static_cast<const char *>(data);
+    _mapped_size = st.st_size;
+    return true;
+#endif
+}
+
+void CocoAnnotationCache::unmap_file()
+{
+#if !(defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__))
+    if(_mapped)
+        munmap(const_cast<char *>(_mapped), _mapped_size);
+#endif
+    _mapped = nullptr;
+    _mapped_size = 0;
+    _header = nullptr;
+}
+
+bool CocoAnnotationCache::validate(const std::string &path)
+{
+    const size_t record_size = (_kind == Kind::BOUNDING_BOX) ? sizeof(BoxRecord) : sizeof(KeyPointRecord);
+    auto header = reinterpret_cast<const Header *>(_mapped);
+    if(memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) || header->version != CACHE_VERSION || header->kind != (uint32_t)_kind ||
+       header->record_size != record_size || header->param_count != _params.size() || !std::equal(_params.begin(), _params.end(), header->params))
+        return false;
+    if(_mapped_size < sizeof(Header) + header->image_count * sizeof(ImageRecord) + header->record_count * record_size +
+                      header->category_count * 2 * sizeof(int32_t) + header->string_bytes)
+        return false;
+    // The size and modification time vouch for the JSON file, it is only hashed if it was touched or copied since
+    uint64_t source_size, source_mtime, source_hash;
+    if(!source_stat(source_size, source_mtime) || header->source_size != source_size)
+        return false;
+    if(header->source_mtime != source_mtime)
+    {
+        if(!this->source_hash(source_hash) || header->source_hash != source_hash)
+            return false;
+        // Same content, the next runs do not need to hash it again. Concurrent readers see either time, both are valid
+#if !(defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__))
+        int fd = ::open(path.c_str(), O_WRONLY);
+        if(fd >= 0)
+        {
+            if(pwrite(fd, &source_mtime, sizeof(source_mtime), offsetof(Header, source_mtime)) != sizeof(source_mtime))
+                INFO("Could not update the modification time in the annotation cache " + path)
+            ::close(fd);
+        }
+#endif
+    }
+    _images = reinterpret_cast<const ImageRecord *>(_mapped + sizeof(Header));
+    _records = reinterpret_cast<const char *>(_images + header->image_count);
+    _categories = reinterpret_cast<const int32_t *>(_records + header->record_count * record_size);
+    _strings = reinterpret_cast<const char *>(_categories + header->category_count * 2);
+    // The lookups trust the table from here on: every name and record range is in the file and the names are sorted
+    for(uint64_t i = 0; i < header->image_count; i++)
+    {
+        const auto &image = _images[i];
+        if(image.name_offset + image.name_length > header->string_bytes || (uint64_t)image.first + image.count > header->record_count ||
+           (i > 0 && !(image_name(_images[i - 1]) < image_name(image))))
+        {
+            WRN("Annotation cache " + path + " of " + _json_path + " is corrupted, parsing the annotations file")
+            return false;
+        }
+    }
+    _header = header;
+    return true;
+}
+
+bool CocoAnnotationCache::open(std::map<int, int> &label_info)
+{
+    unmap_file();
+    if(!_enabled)
+        return false;
+    for(auto &path: cache_paths())
+    {
+        if(!map_file(path))
+            continue;
+        if(validate(path))
+        {
+            label_info.clear();
+            for(uint64_t i = 0; i < _header->category_count; i++)
+                label_info.emplace_hint(label_info.end(), _categories[2 * i], _categories[2 * i + 1]);
+            return true;
+        }
+        INFO("Annotation cache " + path + " is stale or not valid, ignoring it")
+        unmap_file();
+    }
+    return false;
+}
+
+std::string_view CocoAnnotationCache::image_name(const ImageRecord &image) const
+{
+    return std::string_view(_strings + image.name_offset, image.name_length);
+}
+
+const CocoAnnotationCache::ImageRecord *CocoAnnotationCache::find(const std::string &name) const
+{
+    if(!_header)
+        return nullptr;
+    const std::string_view key(name);
+    auto end = _images + _header->image_count;
+    auto it = std::lower_bound(_images, end, key, [this](const ImageRecord &image, std::string_view key) { return image_name(image) < key; });
+    return (it != end && image_name(*it) == key) ? it : nullptr;
+}
+
+bool CocoAnnotationCache::contains(const std::string &name) const
+{
+    // Images without key points are not part of the key points annotations
+    auto image = find(name);
+    return image && (_kind == Kind::BOUNDING_BOX || image->count > 0);
+}
+
+void CocoAnnotationCache::read_boxes(const ImageRecord &image, BoundingBoxCords &boxes, BoundingBoxLabels &labels) const
+{
+    auto records = reinterpret_cast<const BoxRecord *>(_records) + image.first;
+    boxes.resize(image.count);
+    labels.resize(image.count);
+    for(unsigned j = 0; j < image.count; j++)
+    {
+        boxes[j] = BoundingBoxCord(records[j].l, records[j].t, records[j].r, records[j].b);
+        labels[j] = records[j].label;
+    }
+}
+
+bool CocoAnnotationCache::find_boxes(const std::string &name, BoundingBoxCords &boxes, BoundingBoxLabels &labels, ImgSize &image_size) const
+{
+    auto image = find(name);
+    if(!image || _kind != Kind::BOUNDING_BOX)
+        return false;
+    read_boxes(*image, boxes, labels);
+    image_size = {image->width, image->height};
+    return true;
+}
+
+void CocoAnnotationCache::read_key_points(const ImageRecord &image, JointsData &joints_data) const
+{
+    // A single set of key points is kept per image
+    const auto &key_points = reinterpret_cast<const KeyPointRecord *>(_records)[image.first];
+    joints_data.image_id = key_points.image_id;
+    joints_data.annotation_id = key_points.annotation_id;
+    joints_data.image_path.assign(image_name(image));
+    memcpy(joints_data.center, key_points.center, sizeof(joints_data.center));
+    memcpy(joints_data.scale, key_points.scale, sizeof(joints_data.scale));
+    joints_data.joints.resize(NUMBER_OF_JOINTS);
+    joints_data.joints_visibility.resize(NUMBER_OF_JOINTS);
+    for(unsigned j = 0; j < NUMBER_OF_JOINTS; j++)
+    {
+        joints_data.joints[j].assign(key_points.joints[j], key_points.joints[j] + 2);
+        joints_data.joints_visibility[j].assign(key_points.joints_visibility[j], key_points.joints_visibility[j] + 2);
+    }
+    joints_data.score = key_points.score;
+    joints_data.rotation = key_points.rotation;
+}
+
+bool CocoAnnotationCache::find_key_points(const std::string &name, JointsData &joints_data, ImgSize &image_size) const
+{
+    auto image = find(name);
+    if(!image || _kind != Kind::KEY_POINTS || image->count == 0)
+        return false;
+    read_key_points(*image, joints_data);
+    image_size = {image->width, image->height};
+    return true;
+}
+
+void CocoAnnotationCache::fill(std::map<std::string, std::shared_ptr<MetaData>> &map_content) const
+{
+    map_content.clear();
+    if(!_header)
+        return;
+    for(uint64_t i = 0; i < _header->image_count; i++)
+    {
+        const auto &image = _images[i];
+        ImgSize image_size = {image.width, image.height};
+        std::shared_ptr<MetaData> meta_data;
+        if(_kind == Kind::BOUNDING_BOX)
+        {
+            BoundingBoxCords bb_coords;
+            BoundingBoxLabels bb_labels;
+            read_boxes(image, bb_coords, bb_labels);
+            meta_data = std::make_shared<BoundingBox>(std::move(bb_coords), std::move(bb_labels), image_size);
+        }
+        else
+        {
+            if(image.count == 0)
+                continue;
+            JointsData joints_data;
+            read_key_points(image, joints_data);
+            meta_data = std::make_shared<KeyPoint>(image_size, &joints_data);
+        }
+        // Images are stored in the map order, appending at the end does not need a lookup
+        map_content.emplace_hint(map_content.end(), std::string(image_name(image)), std::move(meta_data));
+    }
+}
+
+bool CocoAnnotationCache::load(std::map<std::string, std::shared_ptr<MetaData>> &map_content, std::map<int, int> &label_info)
+{
+    if(!open(label_info))
+        return false;
+    fill(map_content);
+    close();
+    return true;
+}
+
+void CocoAnnotationCache::store(const std::map<std::string, std::shared_ptr<MetaData>> &map_content, const std::map<int, int> &label_info)
+{
+    if(!_enabled)
+        return;
+    Header header = {};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.kind = (uint32_t)_kind;
+    if(!source_stat(header.source_size, header.source_mtime) || !source_hash(header.source_hash))
+        return;
+    std::copy(_params.begin(), _params.end(), header.params);
+    header.param_count = _params.size();
+    header.record_size = (_kind == Kind::BOUNDING_BOX) ? sizeof(BoxRecord) : sizeof(KeyPointRecord);
+
+    std::vector<ImageRecord> images;
+    std::vector<BoxRecord> boxes;
+    std::vector<KeyPointRecord> key_points;
+    std::vector<int32_t> categories;
+    std::string strings;
+    images.reserve(map_content.size());
+    for(auto &elem: map_content)
+    {
+        ImageRecord image = {};
+        image.name_offset = strings.size();
+        image.name_length = elem.first.size();
+        strings += elem.first;
+        auto &image_size = elem.second->get_img_size();
+        image.width = image_size.w;
+        image.height = image_size.h;
+        if(_kind == Kind::BOUNDING_BOX)
+        {
+            auto &bb_coords = elem.second->get_bb_cords();
+            auto &bb_labels = elem.second->get_bb_labels();
+            image.first = boxes.size();
+            image.count = bb_coords.size();
+            for(unsigned j = 0; j < bb_coords.size(); j++)
+                boxes.push_back({bb_coords[j].l, bb_coords[j].t, bb_coords[j].r, bb_coords[j].b, j < bb_labels.size() ? bb_labels[j] : 0});
+        }
+        else
+        {
+            auto &joints_data = elem.second->get_joints_data();
+            KeyPointRecord record = {};
+            record.image_id = joints_data.image_id;
+            record.annotation_id = joints_data.annotation_id;
+            memcpy(record.center, joints_data.center, sizeof(record.center));
+            memcpy(record.scale, joints_data.scale, sizeof(record.scale));
+            for(unsigned j = 0; j < NUMBER_OF_JOINTS && j < joints_data.joints.size(); j++)
+                for(unsigned k = 0; k < 2 && k < joints_data.joints[j].size(); k++)
+                {
+                    record.joints[j][k] = joints_data.joints[j][k];
+                    record.joints_visibility[j][k] = joints_data.joints_visibility[j][k];
+                }
+            record.score = joints_data.score;
+            record.rotation = joints_data.rotation;
+            image.first = key_points.size();
+            image.count = 1;
+            key_points.push_back(record);
+        }
+        images.push_back(image);
+    }
+    for(auto &category: label_info)
+    {
+        categories.push_back(category.first);
+        categories.push_back(category.second);
+    }
+    header.image_count = images.size();
+    header.record_count = (_kind == Kind::BOUNDING_BOX) ? boxes.size() : key_points.size();
+    header.category_count = label_info.size();
+    header.string_bytes = strings.size();
+
+    for(auto &path: cache_paths())
+    {
+        // Written to a temporary file renamed at the end, so that concurrent readers (other ranks) never see a partial cache
+        auto temp_path = path + ".tmp." + TOSTR(getpid());
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if(!out)
+            continue;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(images.data()), images.size() * sizeof(ImageRecord));
+        if(_kind == Kind::BOUNDING_BOX)
+            out.write(reinterpret_cast<const char *>(boxes.data()), boxes.size() * sizeof(BoxRecord));
+        else
+            out.write(reinterpret_cast<const char *>(key_points.data()), key_points.size() * sizeof(KeyPointRecord));
+        out.write(reinterpret_cast<const char *>(categories.data()), categories.size() * sizeof(int32_t));
+        out.write(strings.data(), strings.size());
+        out.close();
+        if(out.fail() || std::rename(temp_path.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temp_path.c_str());
+            continue;
+        }
+        INFO("Annotation cache written to " + path)
+        return;
+    }
+    WRN("Could not write the annotation cache of " + _json_path)
+}
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <algorithm>
 #include <fstream>
 #include "lookahead_parser.h"
+#include "coco_annotation_cache.h"
 
 using namespace std;
 
@@ -37,9 +38,20 @@ void COCOMetaDataReader::init(const MetaDataConfig &cfg)
 
 bool COCOMetaDataReader::exists(const std::string &image_name)
 {
+    if (_annotation_cache)
+        return _annotation_cache->contains(image_name);
     return _map_content.find(image_name) != _map_content.end();
 }
 
+const std::map<std::string, std::shared_ptr<MetaData>> & COCOMetaDataReader::get_map_content()
+{
+    std::lock_guard<std::mutex> lock(_map_fill_lock);
+    if (_annotation_cache && !_map_filled)
+        _annotation_cache->fill(_map_content);
+    _map_filled = true;
+    return _map_content;
+}
+
 void COCOMetaDataReader::lookup(const std::vector<std::string> &image_names)
 {
 
@@ -54,6 +66,12 @@ void COCOMetaDataReader::lookup(const std::vector<std::string> &image_names)
     for (unsigned i = 0; i < image_names.size(); i++)
     {
         auto image_name = image_names[i];
+        if (_annotation_cache)
+        {
+            if (!_annotation_cache->find_boxes(image_name, _output->get_bb_cords_batch()[i], _output->get_bb_labels_batch()[i], _output->get_img_sizes_batch()[i]))
+                THROW("ERROR: Given name not present in the map" + image_name)
+            continue;
+        }
         auto it = _map_content.find(image_name);
         if (_map_content.end() == it)
             THROW("ERROR: Given name not present in the map" + image_name)
@@ -65,9 +83,9 @@ void COCOMetaDataReader::lookup(const std::vector<std::string> &image_names)
 
 void COCOMetaDataReader::add(std::string image_name, BoundingBoxCords bb_coords, BoundingBoxLabels bb_labels, ImgSize image_size)
 {
-    if (exists(image_name))
+    auto it = _map_content.find(image_name);
+    if (it != _map_content.end())
     {
-        auto it = _map_content.find(image_name);
         it->second->get_bb_cords().push_back(bb_coords[0]);
         it->second->get_bb_labels().push_back(bb_labels[0]);
         return;
@@ -83,7 +101,7 @@ void COCOMetaDataReader::print_map_contents()
     ImgSize img_size;
 
     std::cout << "\nBBox Annotations List: \n";
-    for (auto &elem : _map_content)
+    for (auto &elem : get_map_content())
     {
         std::cout << "\nName :\t " << elem.first;
         bb_coords = elem.second->get_bb_cords();
@@ -100,6 +118,14 @@ void COCOMetaDataReader::print_map_contents()
 void COCOMetaDataReader::read_all(const std::string &path)
 {
     _coco_metadata_read_time.start(); // Debug timing
+    auto annotation_cache = std::make_unique<CocoAnnotationCache>(path, CocoAnnotationCache::Kind::BOUNDING_BOX);
+    if (annotation_cache->open(_label_info))
+    {
+        // Kept open, the images are looked up in the cache
+        _annotation_cache = std::move(annotation_cache);
+        _coco_metadata_read_time.end();
+        return;
+    }
     std::ifstream f;
     f.open (path, std::ifstream::in|std::ios::binary);
     if (f.fail()) THROW("ERROR: Given annotations file not present " + path);
@@ -270,6 +296,7 @@ void COCOMetaDataReader::read_all(const std::string &path)
         }
         elem.second->set_bb_labels(continuous_label_id);
     }
+    annotation_cache->store(_map_content, _label_info);
     _coco_metadata_read_time.end(); // Debug timing
     //print_map_contents();
     // std::cout << "coco read time in sec: " << _coco_metadata_read_time.get_timing() / 1000 << std::endl;
@@ -289,6 +316,8 @@ void COCOMetaDataReader::release()
 {
     _map_content.clear();
     _map_img_sizes.clear();
+    _annotation_cache.reset();
+    _map_filled = false;
 }
 
 COCOMetaDataReader::COCOMetaDataReader() : _coco_metadata_read_time("coco meta read time", DBG_TIMING)
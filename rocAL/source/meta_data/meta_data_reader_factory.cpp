@@ -37,6 +37,9 @@ THE SOFTWARE.
 #include "tf_meta_data_reader_detection.h"
 #include "video_label_reader.h"
 #include "mxnet_meta_data_reader.h"
+#include "synthetic_meta_data_reader.h"
+#include "tar_shard_meta_data_reader.h"
+#include "service_meta_data_reader.h"
 
 std::shared_ptr<MetaDataReader> create_meta_data_reader(const MetaDataConfig& config) {
     switch(config.reader_type()) {
@@ -159,6 +162,33 @@ std::shared_ptr<MetaDataReader> create_meta_data_reader(const MetaDataConfig& co
             return ret;
         }
         break;
+        case MetaDataReaderType::SYNTHETIC_META_DATA_READER:
+        {
+            if(config.type() != MetaDataType::Label && config.type() != MetaDataType::BoundingBox)
+                THROW("SYNTHETIC_META_DATA_READER can only be used to load labels or bounding boxes")
+            auto ret = std::make_shared<SyntheticMetaDataReader>();
+            ret->init(config);
+            return ret;
+        }
+        break;
+        case MetaDataReaderType::TAR_SHARD_META_DATA_READER:
+        {
+            if(config.type() != MetaDataType::Label && config.type() != MetaDataType::BoundingBox)
+                THROW("TAR_SHARD_META_DATA_READER can only be used to load labels or bounding boxes")
+            auto ret = std::make_shared<TarShardMetaDataReader>();
+            ret->init(config);
+            return ret;
+        }
+        break;
+        case MetaDataReaderType::SERVICE_META_DATA_READER:
+        {
+            if(config.type() != MetaDataType::Label && config.type() != MetaDataType::BoundingBox)
+                THROW("SERVICE_META_DATA_READER can only be used to load labels or bounding boxes")
+            auto ret = std::make_shared<ServiceMetaDataReader>();
+            ret->init(config);
+            return ret;
+        }
+        break;
         default:
             THROW("MetaDataReader type is unsupported : "+ TOSTR(config.reader_type()));
     }
@@ -0,0 +1,154 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "meta_data_graph.h"
+#include "meta_node.h"
+#if ENABLE_SIMD
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+void MetaNode::crop_boxes(MetaDataBatch *input_meta_data, const std::vector<BoundingBoxCord> &windows, const int *mirror, bool fill_empty)
+{
+    auto &coords_batch = input_meta_data->get_bb_cords_batch();
+    auto &labels_batch = input_meta_data->get_bb_labels_batch();
+    const int batch_size = input_meta_data->size();
+    if(windows.size() < (size_t)batch_size)
+        THROW("Crop windows given for " + TOSTR(windows.size()) + " samples, the batch has " + TOSTR(batch_size))
+
+    // Gather the boxes of the batch in the structure of arrays, the buffers only grow so this does not allocate once warmed up
+    _box_offsets.resize(batch_size + 1);
+    size_t box_count = 0;
+    for(int i = 0; i < batch_size; i++)
+    {
+        _box_offsets[i] = box_count;
+        box_count += coords_batch[i].size();
+    }
+    _box_offsets[batch_size] = box_count;
+    _box_l.resize(box_count);
+    _box_t.resize(box_count);
+    _box_r.resize(box_count);
+    _box_b.resize(box_count);
+    _box_keep.resize(box_count);
+    for(int i = 0; i < batch_size; i++)
+    {
+        const BoundingBoxCord *boxes = coords_batch[i].data();
+        for(size_t j = 0, k = _box_offsets[i]; j < coords_batch[i].size(); j++, k++)
+        {
+            _box_l[k] = boxes[j].l;
+            _box_t[k] = boxes[j].t;
+            _box_r[k] = boxes[j].r;
+            _box_b[k] = boxes[j].b;
+        }
+    }
+
+    for(int i = 0; i < batch_size; i++)
+    {
+        const BoundingBoxCord &window = windows[i];
+        const float window_w = window.r - window.l, window_h = window.b - window.t;
+        const bool mirrored = mirror && mirror[i] != 0;
+        size_t j = _box_offsets[i];
+        const size_t end = _box_offsets[i + 1];
+#if ENABLE_SIMD
+        const __m256 pwl = _mm256_set1_ps(window.l), pwt = _mm256_set1_ps(window.t);
+        const __m256 pwr = _mm256_set1_ps(window.r), pwb = _mm256_set1_ps(window.b);
+        const __m256 pww = _mm256_set1_ps(window_w), pwh = _mm256_set1_ps(window_h);
+        const __m256 pthreshold = _mm256_set1_ps(_iou_threshold);
+        const __m256 pzero = _mm256_setzero_ps(), pone = _mm256_set1_ps(1.0f);
+        for(; j + 8 <= end; j += 8)
+        {
+            __m256 pl = _mm256_loadu_ps(&_box_l[j]);
+            __m256 pt = _mm256_loadu_ps(&_box_t[j]);
+            __m256 pr = _mm256_loadu_ps(&_box_r[j]);
+            __m256 pb = _mm256_loadu_ps(&_box_b[j]);
+            // std::max(a, b) is _mm256_max_ps(b, a) and std::min(a, b) is _mm256_min_ps(b, a), down to the signed zeros and NaNs, the results are the same bits as the scalar loop
+            __m256 pxa = _mm256_max_ps(pl, pwl), pya = _mm256_max_ps(pt, pwt);
+            __m256 pxb = _mm256_min_ps(pr, pwr), pyb = _mm256_min_ps(pb, pwb);
+            __m256 pintersection = _mm256_mul_ps(_mm256_max_ps(_mm256_sub_ps(pxb, pxa), pzero), _mm256_max_ps(_mm256_sub_ps(pyb, pya), pzero));
+            __m256 parea = _mm256_mul_ps(_mm256_sub_ps(pb, pt), _mm256_sub_ps(pr, pl));
+            __m256 pkeep = _mm256_cmp_ps(_mm256_div_ps(pintersection, parea), pthreshold, _CMP_GE_OQ);
+            pl = _mm256_div_ps(_mm256_sub_ps(pxa, pwl), pww);
+            pt = _mm256_div_ps(_mm256_sub_ps(pya, pwt), pwh);
+            pr = _mm256_div_ps(_mm256_sub_ps(pxb, pwl), pww);
+            pb = _mm256_div_ps(_mm256_sub_ps(pyb, pwt), pwh);
+            if(mirrored)
+            {
+                __m256 pmirrored_l = _mm256_sub_ps(pone, pr);
+                pr = _mm256_sub_ps(pone, pl);
+                pl = pmirrored_l;
+            }
+            _mm256_storeu_ps(&_box_l[j], pl);
+            _mm256_storeu_ps(&_box_t[j], pt);
+            _mm256_storeu_ps(&_box_r[j], pr);
+            _mm256_storeu_ps(&_box_b[j], pb);
+            _mm256_storeu_si256((__m256i *)&_box_keep[j], _mm256_castps_si256(pkeep));
+        }
+#endif
+        for(; j < end; j++)
+        {
+            float xA = std::max(window.l, _box_l[j]);
+            float yA = std::max(window.t, _box_t[j]);
+            float xB = std::min(window.r, _box_r[j]);
+            float yB = std::min(window.b, _box_b[j]);
+            float intersection_area = std::max(0.0f, xB - xA) * std::max(0.0f, yB - yA);
+            float box_area = (_box_b[j] - _box_t[j]) * (_box_r[j] - _box_l[j]);
+            _box_keep[j] = (intersection_area / box_area) >= _iou_threshold;
+            _box_l[j] = (xA - window.l) / window_w;
+            _box_t[j] = (yA - window.t) / window_h;
+            _box_r[j] = (xB - window.l) / window_w;
+            _box_b[j] = (yB - window.t) / window_h;
+            if(mirrored)
+            {
+                float l = 1 - _box_r[j];
+                _box_r[j] = 1 - _box_l[j];
+                _box_l[j] = l;
+            }
+        }
+    }
+
+    // Stream compaction of the kept boxes back into the batch, in place
+    for(int i = 0; i < batch_size; i++)
+    {
+        auto &boxes = coords_batch[i];
+        auto &labels = labels_batch[i];
+        size_t kept = 0;
+        for(size_t j = 0, k = _box_offsets[i]; k < _box_offsets[i + 1]; j++, k++)
+        {
+            if(!_box_keep[k])
+                continue;
+            boxes[kept] = {_box_l[k], _box_t[k], _box_r[k], _box_b[k]};
+            labels[kept] = labels[j];
+            kept++;
+        }
+        boxes.resize(kept);
+        labels.resize(kept);
+        if(kept == 0 && fill_empty)
+        {
+            boxes.push_back({0, 0, 1, 1});
+            labels.push_back(0);
+        }
+    }
+}
@@ -21,13 +21,7 @@ THE SOFTWARE.
 */
 
 #include "meta_node_resize.h"
-void ResizeMetaNode::initialize()
-{
-    _src_height_val.resize(_batch_size);
-    _src_width_val.resize(_batch_size);
-}
 void ResizeMetaNode::update_parameters(MetaDataBatch* input_meta_data)
 {
-    initialize();
     // nothing to do in normalized coordinates
 }
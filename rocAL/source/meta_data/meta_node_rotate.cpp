@@ -21,60 +21,44 @@ THE SOFTWARE.
 */
 
 #include "meta_node_rotate.h"
-void RotateMetaNode::initialize()
-{
-    _src_height_val.resize(_batch_size);
-    _src_width_val.resize(_batch_size);
-    _angle_val.resize(_batch_size);
-}
 void RotateMetaNode::update_parameters(MetaDataBatch* input_meta_data)
 {
-    initialize();
     if(_batch_size != input_meta_data->size())
     {
         _batch_size = input_meta_data->size();
     }
-    _src_width = _node->get_src_width();
-    _src_height = _node->get_src_height();
     _dst_width = _node->get_dst_width();
     _dst_height = _node->get_dst_height();
-    _angle = _node->get_angle();
-    vxCopyArrayRange((vx_array)_src_width, 0, _batch_size, sizeof(uint),_src_width_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_src_height, 0, _batch_size, sizeof(uint),_src_height_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_angle, 0, _batch_size, sizeof(float),_angle_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    BoundingBoxCord temp_box = {0, 0, 1, 1};
+    auto &src_width = _node->get_src_roi_width_values();
+    auto &src_height = _node->get_src_roi_height_values();
+    auto &angle = _node->get_angle_values();
+    BoundingBoxCord dest_image;
+    dest_image.l = dest_image.t = 0;
+    dest_image.r = _dst_width;
+    dest_image.b = _dst_height;
+    float dest_cx = _dst_width / 2;
+    float dest_cy = _dst_height / 2;
     for(int i = 0; i < _batch_size; i++)
     {
-        auto bb_count = input_meta_data->get_bb_labels_batch()[i].size();
-        int labels_buf[bb_count];
-        float coords_buf[bb_count*4];
-        memcpy(labels_buf, input_meta_data->get_bb_labels_batch()[i].data(),  sizeof(int)*bb_count);
-        memcpy(coords_buf, input_meta_data->get_bb_cords_batch()[i].data(), input_meta_data->get_bb_cords_batch()[i].size() * sizeof(BoundingBoxCord));
-        BoundingBoxCords bb_coords;
-        BoundingBoxLabels bb_labels;
-        BoundingBoxCord dest_image;
-        dest_image.l = dest_image.t = 0;
-        dest_image.r = _dst_width;
-        dest_image.b = _dst_height;
-        for(uint j = 0, m = 0; j < bb_count; j++)
+        auto &coords = input_meta_data->get_bb_cords_batch()[i];
+        auto &labels = input_meta_data->get_bb_labels_batch()[i];
+        float rotate[4];
+        float radian = RAD(angle[i]);
+        rotate[0] = rotate[3] = cos(radian);
+        rotate[1] = sin(radian);
+        rotate[2] = -1 * rotate[1];
+        float src_cx = src_width[i]/2;
+        float src_cy = src_height[i]/2;
+        // The boxes kept are compacted in place at the front of the sample's vectors
+        size_t kept = 0;
+        for(size_t j = 0; j < coords.size(); j++)
         {
             BoundingBoxCord box;
-            float src_bb_x, src_bb_y, bb_w, bb_h;
-            float dest_cx, dest_cy, src_cx, src_cy;
             float x1, y1, x2, y2, x3, y3, x4, y4, min_x, min_y;
-            float rotate[4];
-            float radian = RAD(_angle_val[i]);
-            rotate[0] = rotate[3] = cos(radian);
-            rotate[1] = sin(radian);
-            rotate[2] = -1 * rotate[1];
-            dest_cx = _dst_width / 2;
-            dest_cy = _dst_height / 2;
-            src_cx = _src_width_val[i]/2;
-            src_cy = _src_height_val[i]/2;
-            src_bb_x = (coords_buf[m++]);
-            src_bb_y = (coords_buf[m++]);
-            bb_w = (coords_buf[m++]);
-            bb_h = (coords_buf[m++]);
+            float src_bb_x = coords[j].l;
+            float src_bb_y = coords[j].t;
+            float bb_w = coords[j].r;
+            float bb_h = coords[j].b;
             x1 = (rotate[0] * (src_bb_x - src_cx)) + (rotate[1] * (src_bb_y - src_cy)) + dest_cx;
             y1 = (rotate[2] * (src_bb_x - src_cx)) + (rotate[3] * (src_bb_y - src_cy)) + dest_cy;
             x2 = (rotate[0] * ((src_bb_x + bb_w) - src_cx))+( rotate[1] * (src_bb_y - src_cy)) + dest_cx;
@@ -87,24 +71,24 @@ void RotateMetaNode::update_parameters(MetaDataBatch* input_meta_data)
             min_y = std::min(y1, std::min(y2, std::min(y3, y4)));
             box.l = std::max(min_x, 0.0f);
             box.t = std::max(min_y, 0.0f);
-            box.r = std::max(x1, std::max(x2, std::max(x3, x4))); ;
+            box.r = std::max(x1, std::max(x2, std::max(x3, x4)));
             box.b = std::max(y1, std::max(y2, std::max(y3, y4)));
             if (BBoxIntersectionOverUnion(box, dest_image) >= _iou_threshold)
             {
-                box.l = std::max(dest_image.l, box.l);
-                box.t = std::max(dest_image.t, box.t);
-                box.r = std::min(dest_image.r, box.r);
-                box.b = std::min(dest_image.b, box.b);
-                bb_coords.push_back(box);
-                bb_labels.push_back(labels_buf[j]);
+                coords[kept].l = std::max(dest_image.l, box.l);
+                coords[kept].t = std::max(dest_image.t, box.t);
+                coords[kept].r = std::min(dest_image.r, box.r);
+                coords[kept].b = std::min(dest_image.b, box.b);
+                labels[kept] = labels[j];
+                kept++;
             }
         }
-        if(bb_coords.size() == 0)
+        coords.resize(kept);
+        labels.resize(kept);
+        if(kept == 0)
         {
-            bb_coords.push_back(temp_box);
-            bb_labels.push_back(0);
+            coords.push_back({0, 0, 1, 1});
+            labels.push_back(0);
         }
-        input_meta_data->get_bb_cords_batch()[i] = bb_coords;
-        input_meta_data->get_bb_labels_batch()[i] = bb_labels;
     }
 }
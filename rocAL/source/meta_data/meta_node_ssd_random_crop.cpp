@@ -21,69 +21,55 @@ THE SOFTWARE.
 */
 
 #include "meta_node_ssd_random_crop.h"
-void SSDRandomCropMetaNode::initialize()
-{
-    _crop_width_val.resize(_batch_size);
-    _crop_height_val.resize(_batch_size);
-    _x1_val.resize(_batch_size);
-    _y1_val.resize(_batch_size);
-}
 void SSDRandomCropMetaNode::update_parameters(MetaDataBatch *input_meta_data)
 {
-    initialize();
     if(_batch_size != input_meta_data->size())
     {
         _batch_size = input_meta_data->size();
     }
-    std::vector<std::pair<float, float>> iou_range = _node->get_iou_range();
+    auto &iou_range = _node->get_iou_range();
     bool entire_iou = _node->is_entire_iou();
     _meta_crop_param = _node->get_crop_param();
     _dst_width = _node->get_dst_width();
     _dst_height = _node->get_dst_height();
-    _crop_width = _meta_crop_param->cropw_arr;
-    _crop_height = _meta_crop_param->croph_arr;
-    _x1 = _meta_crop_param->x1_arr;
-    _y1 = _meta_crop_param->y1_arr;
-    vxCopyArrayRange((vx_array)_crop_width, 0, _batch_size, sizeof(uint),_crop_width_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_crop_height, 0, _batch_size, sizeof(uint),_crop_height_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_x1, 0, _batch_size, sizeof(uint),_x1_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_y1, 0, _batch_size, sizeof(uint),_y1_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
+    // The node picks the crops of the batch on the host and keeps them, no need to read them back from the vx arrays
+    auto &crop_width = _node->get_crop_width_values();
+    auto &crop_height = _node->get_crop_height_values();
+    auto &x1 = _node->get_x1_values();
+    auto &y1 = _node->get_y1_values();
     for(int i = 0; i < _batch_size; i++)
     {
-        auto bb_count = input_meta_data->get_bb_labels_batch()[i].size();
-        int labels_buf[bb_count];
-        BoundingBoxCords box_coords_buf;
-        box_coords_buf.resize(bb_count);
-        memcpy(labels_buf, input_meta_data->get_bb_labels_batch()[i].data(),  sizeof(int)*bb_count);
-        memcpy((void *)box_coords_buf.data(), input_meta_data->get_bb_cords_batch()[i].data(), input_meta_data->get_bb_cords_batch()[i].size() * sizeof(BoundingBoxCord));
-        BoundingBoxCords bb_coords;
-        BoundingBoxLabels bb_labels;
+        auto &coords = input_meta_data->get_bb_cords_batch()[i];
+        auto &labels = input_meta_data->get_bb_labels_batch()[i];
         BoundingBoxCord crop_box;
-        crop_box.l = _x1_val[i];
-        crop_box.t = _y1_val[i];
-        crop_box.r = _x1_val[i] + _crop_width_val[i];
-        crop_box.b = _y1_val[i] + _crop_height_val[i];
-        for(uint j = 0; j < bb_count; j++)
+        crop_box.l = x1[i];
+        crop_box.t = y1[i];
+        crop_box.r = x1[i] + crop_width[i];
+        crop_box.b = y1[i] + crop_height[i];
+        const float crop_w = crop_box.r - crop_box.l, crop_h = crop_box.b - crop_box.t;
+        size_t kept = 0;
+        for(size_t j = 0; j < coords.size(); j++)
         {
-            auto x_c = 0.5f * (box_coords_buf[j].l + box_coords_buf[j].r);
-            auto y_c = 0.5f * (box_coords_buf[j].t + box_coords_buf[j].b);
+            const BoundingBoxCord &box = coords[j];
+            auto x_c = 0.5f * (box.l + box.r);
+            auto y_c = 0.5f * (box.t + box.b);
             bool is_center_in_crop = (x_c >= crop_box.l && x_c <= crop_box.r) && (y_c >= crop_box.t && y_c <= crop_box.b);
-            float bb_iou = BBoxIntersectionOverUnion(box_coords_buf[j], crop_box, entire_iou);
-            if (bb_iou >= iou_range[j].first && bb_iou <= iou_range[j].second && is_center_in_crop)
+            float bb_iou = BBoxIntersectionOverUnion(box, crop_box, entire_iou);
+            if (bb_iou >= iou_range[i].first && bb_iou <= iou_range[i].second && is_center_in_crop)
             {
-                float xA = std::max(crop_box.l, box_coords_buf[j].l);
-                float yA = std::max(crop_box.t, box_coords_buf[j].t);
-                float xB = std::min(crop_box.r, box_coords_buf[j].r);
-                float yB = std::min(crop_box.b, box_coords_buf[j].b);
-                box_coords_buf[j].l = (xA - crop_box.l) / (crop_box.r - crop_box.l);
-                box_coords_buf[j].t = (yA - crop_box.t) / (crop_box.b - crop_box.t);
-                box_coords_buf[j].r = (xB - crop_box.l) / (crop_box.r - crop_box.l);
-                box_coords_buf[j].b = (yB - crop_box.t) / (crop_box.b - crop_box.t);
-                bb_coords.push_back(box_coords_buf[j]);
-                bb_labels.push_back(labels_buf[j]);
+                float xA = std::max(crop_box.l, box.l);
+                float yA = std::max(crop_box.t, box.t);
+                float xB = std::min(crop_box.r, box.r);
+                float yB = std::min(crop_box.b, box.b);
+                coords[kept].l = (xA - crop_box.l) / crop_w;
+                coords[kept].t = (yA - crop_box.t) / crop_h;
+                coords[kept].r = (xB - crop_box.l) / crop_w;
+                coords[kept].b = (yB - crop_box.t) / crop_h;
+                labels[kept] = labels[j];
+                kept++;
             }
         }
-        input_meta_data->get_bb_cords_batch()[i] = bb_coords;
-        input_meta_data->get_bb_labels_batch()[i] = bb_labels;
+        coords.resize(kept);
+        labels.resize(kept);
     }
-}
\ No newline at end of file
+}
@@ -26,17 +26,12 @@ THE SOFTWARE.
 #include <memory.h>
 #include <stdint.h>
 #include "mxnet_meta_data_reader.h"
-#include <boost/filesystem.hpp>
-
-namespace filesys = boost::filesystem;
 using namespace std;
 
 void MXNetMetaDataReader::init(const MetaDataConfig &cfg)
 {
     _path = cfg.path();
     _output = new LabelBatch();
-    _src_dir = nullptr;
-    _entity = nullptr;
 }
 
 bool MXNetMetaDataReader::exists(const std::string& _image_name)
@@ -85,52 +80,8 @@ void MXNetMetaDataReader::print_map_contents()
 
 void MXNetMetaDataReader::read_all(const std::string &_path)
 {
-    std::string _rec_file, _idx_file;
-    if ((_src_dir = opendir (_path.c_str())) == nullptr)
-        THROW("MXNetMetaDataReader ERROR: Failed opening the directory at " + _path);
-
-    while((_entity = readdir (_src_dir)) != nullptr)
-    {
-        std::string file_name = _path + "/" + _entity->d_name;
-        filesys::path pathObj(file_name);
-        if(filesys::exists(pathObj) && filesys::is_regular_file(pathObj))
-        {
-            auto file_extension_idx = file_name.find_last_of(".");
-            if (file_extension_idx  != std::string::npos)
-            {
-                std::string file_extension = file_name.substr(file_extension_idx+1);
-                if (file_extension == "rec")
-                    _rec_file = file_name;
-                else if(file_extension == "idx")
-                    _idx_file = file_name;
-                else
-                    continue;
-            }
-        }
-    }
-    closedir(_src_dir);
-    uint rec_size;
-    _file_contents.open(_rec_file);
-    if (!_file_contents)
-        THROW("MXNetMetaDataReader ERROR: Failed opening the file " + _rec_file);
-    _file_contents.seekg(0, ifstream::end);
-    rec_size = _file_contents.tellg();
-    _file_contents.seekg(0, ifstream::beg);
-
-    ifstream index_file(_idx_file);
-    if(!index_file)
-        THROW("MXNetMetaDataReader ERROR: Could not open RecordIO index file. Provided path: " + _idx_file);
-
-    std::vector<size_t> _index_list;
-    size_t _index, _offset;
-    while (index_file >> _index >> _offset)
-        _index_list.push_back(_offset);
-    if(_index_list.empty())
-        THROW("MXNetMetaDataReader ERROR: RecordIO index file doesn't contain any indices. Provided path: " + _idx_file);
-    _index_list.push_back(rec_size);
-    std::sort(_index_list.begin(), _index_list.end());
-    for (size_t i = 0; i < _index_list.size() - 1; ++i)
-        _indices.emplace_back(_index_list[i], _index_list[i + 1] - _index_list[i]);
+    // Same index as the MXNetRecordIOReader, only the record headers are read
+    _index = load_mxnet_recordio_index(_path);
     read_images();
 }
 
@@ -150,36 +101,15 @@ void MXNetMetaDataReader::release() {
 
 void MXNetMetaDataReader::read_images()
 {
-    for(int current_index = 0; current_index < (int)_indices.size(); current_index++ )
+    // Multi-label records carry their labels after the header, a label batch holds one class per image: the first one
+    size_t multi_label_count = 0;
+    for(auto &record : _index->records)
     {
-        uint32_t _magic, _length_flag;
-        int64_t _seek_pos, _data_size_to_read;
-        std::tie(_seek_pos, _data_size_to_read) = _indices[current_index];
-        _file_contents.seekg(_seek_pos, ifstream::beg);
-        uint8_t* _data = new uint8_t[_data_size_to_read];
-        uint8_t* _data_ptr = _data;
-        auto ret = _file_contents.read((char *)_data_ptr, _data_size_to_read).gcount();
-        if(ret == -1 || ret != _data_size_to_read)
-            THROW("MXNetMetaDataReader ERROR:  Unable to read the data from the file ");
-        _magic = *((uint32_t *) _data_ptr);
-        _data_ptr += sizeof(_magic);
-        if(_magic != _kMagic)
-            THROW("MXNetMetaDataReader ERROR: Invalid RecordIO: wrong magic number");
-        _length_flag = *((uint32_t *) _data_ptr);
-        _data_ptr += sizeof(_length_flag);
-        _hdr = *((ImageRecordIOHeader *) _data_ptr);
-
-        if (_hdr.flag == 0)
-        {
-            add((to_string(_hdr.image_id[0])), _hdr.label);
-        }
-        else
-        {
-            WRN("\nMultiple record reading has not supported");
-            continue;
-        }
-        delete[] _data;
+        add(record.key, record.labels[0]);
+        multi_label_count += record.labels.size() > 1;
     }
+    if(multi_label_count)
+        WRN("MXNetMetaDataReader: " + TOSTR(multi_label_count) + " records carry several labels, only their first label is used as the class")
 }
 
 MXNetMetaDataReader::MXNetMetaDataReader()
@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "service_meta_data_reader.h"
+#include "exception.h"
+
+ServiceMetaDataReader::ServiceMetaDataReader()
+{
+}
+
+void ServiceMetaDataReader::init(const MetaDataConfig &cfg)
+{
+    _type = cfg.type();
+    delete _output;
+    if(_type == MetaDataType::BoundingBox)
+        _output = new BoundingBoxBatch();
+    else
+        _output = new LabelBatch();
+}
+
+void ServiceMetaDataReader::read_all(const std::string &path)
+{
+    _batch_ring = ShmBatchRing::attach(path, ATTACH_TIMEOUT_MS);
+    const auto &layout = _batch_ring->layout();
+    if(!layout.has_meta_data || static_cast<MetaDataType>(layout.meta_data_type) != _type)
+        THROW("The rocAL service does not publish the requested meta data type")
+}
+
+void ServiceMetaDataReader::lookup(const std::vector<std::string> &image_names)
+{
+    if(image_names.empty())
+    {
+        WRN("No image names passed")
+        return;
+    }
+    if(!_batch_ring)
+        THROW("ServiceMetaDataReader ERROR: not attached to the service ring")
+    _batch_ring->read_meta_data(_slot_names, _output);
+    if(_slot_names != image_names)
+        THROW("ServiceMetaDataReader ERROR: the names looked up are not the ones of the batch loaded from the service")
+}
+
+void ServiceMetaDataReader::release()
+{
+    _map_content.clear();
+}
@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "synthetic_meta_data_reader.h"
+
+SyntheticMetaDataReader::SyntheticMetaDataReader()
+{
+}
+
+void SyntheticMetaDataReader::init(const MetaDataConfig &cfg)
+{
+    _type = cfg.type();
+    _config = cfg.synthetic_data_config();
+    delete _output;
+    if(_type == MetaDataType::BoundingBox)
+        _output = new BoundingBoxBatch();
+    else
+        _output = new LabelBatch();
+}
+
+bool SyntheticMetaDataReader::exists(const std::string& image_name)
+{
+    return _map_content.find(image_name) != _map_content.end();
+}
+
+void SyntheticMetaDataReader::read_all(const std::string &path)
+{
+    release();
+    for(size_t index = 0; index < _config.sample_count; index++)
+    {
+        auto name = synthetic_sample_name(index);
+        if(_type == MetaDataType::BoundingBox)
+        {
+            auto desc = synthetic_image_desc(_config, index);
+            BoundingBoxCords boxes;
+            BoundingBoxLabels labels;
+            synthetic_boxes(desc, boxes, labels);
+            ImgSize img_size = {(int)desc.width, (int)desc.height};
+            _map_content.emplace_hint(_map_content.end(), name, std::make_shared<BoundingBox>(boxes, labels, img_size));
+        }
+        else
+        {
+            _map_content.emplace_hint(_map_content.end(), name, std::make_shared<Label>(synthetic_label(_config, index)));
+        }
+    }
+}
+
+void SyntheticMetaDataReader::lookup(const std::vector<std::string> &image_names)
+{
+    if(image_names.empty())
+    {
+        WRN("No image names passed")
+        return;
+    }
+    if(image_names.size() != (unsigned)_output->size())
+        _output->resize(image_names.size());
+
+    for(unsigned i = 0; i < image_names.size(); i++)
+    {
+        auto it = _map_content.find(image_names[i]);
+        if(_map_content.end() == it)
+            THROW("SyntheticMetaDataReader ERROR: Given name not present in the map" + image_names[i])
+        if(_type == MetaDataType::BoundingBox)
+        {
+            _output->get_bb_cords_batch()[i] = it->second->get_bb_cords();
+            _output->get_bb_labels_batch()[i] = it->second->get_bb_labels();
+            _output->get_img_sizes_batch()[i] = it->second->get_img_size();
+        }
+        else
+        {
+            _output->get_label_batch()[i] = it->second->get_label();
+        }
+    }
+}
+
+void SyntheticMetaDataReader::release()
+{
+    _map_content.clear();
+}
@@ -0,0 +1,198 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include "tar_shard_meta_data_reader.h"
+#include "lookahead_parser.h"
+
+TarShardMetaDataReader::TarShardMetaDataReader()
+{
+}
+
+void TarShardMetaDataReader::init(const MetaDataConfig &cfg)
+{
+    _type = cfg.type();
+    delete _output;
+    if(_type == MetaDataType::BoundingBox)
+        _output = new BoundingBoxBatch();
+    else
+        _output = new LabelBatch();
+}
+
+bool TarShardMetaDataReader::exists(const std::string& image_name)
+{
+    return _map_content.find(image_name) != _map_content.end();
+}
+
+void TarShardMetaDataReader::add_boxes(const std::string &key, std::string &json)
+{
+    BoundingBoxCords bb_coords;
+    BoundingBoxLabels bb_labels;
+    ImgSize img_size = {};
+    std::vector<std::array<float, 4>> boxes;
+    LookaheadParser parser(&json[0]);
+    if(parser.PeekType() != kObjectType)
+        THROW("TarShardMetaDataReader: the .json member of " + key + " is not a JSON object")
+    parser.EnterObject();
+    while(const char *json_key = parser.NextObjectKey())
+    {
+        if(0 == std::strcmp(json_key, "width"))
+        {
+            img_size.w = parser.GetInt();
+        }
+        else if(0 == std::strcmp(json_key, "height"))
+        {
+            img_size.h = parser.GetInt();
+        }
+        else if(0 == std::strcmp(json_key, "boxes"))
+        {
+            RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
+            parser.EnterArray();
+            while(parser.NextArrayValue())
+            {
+                std::array<float, 4> bbox = {};
+                RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
+                parser.EnterArray();
+                int i = 0;
+                while(parser.NextArrayValue())
+                {
+                    if(i < 4)
+                        bbox[i++] = parser.GetDouble();
+                    else
+                        parser.SkipValue();
+                }
+                boxes.push_back(bbox);
+            }
+        }
+        else if(0 == std::strcmp(json_key, "labels"))
+        {
+            RAPIDJSON_ASSERT(parser.PeekType() == kArrayType);
+            parser.EnterArray();
+            while(parser.NextArrayValue())
+                bb_labels.push_back(parser.GetInt());
+        }
+        else
+        {
+            parser.SkipValue();
+        }
+    }
+    if(!parser.IsValid())
+        THROW("TarShardMetaDataReader: invalid .json member of " + key)
+    if(img_size.w <= 0 || img_size.h <= 0)
+        THROW("TarShardMetaDataReader: the .json member of " + key + " needs the width and height of the image")
+    if(boxes.size() != bb_labels.size())
+        THROW("TarShardMetaDataReader: the .json member of " + key + " has " + TOSTR(boxes.size()) + " boxes and " + TOSTR(bb_labels.size()) + " labels")
+    for(auto &bbox : boxes)
+    {
+        // Normalizing the co-ordinates & convert to "ltrb" format
+        BoundingBoxCord box;
+        box.l = bbox[0] / img_size.w;
+        box.t = bbox[1] / img_size.h;
+        box.r = (bbox[0] + bbox[2]) / img_size.w;
+        box.b = (bbox[1] + bbox[3]) / img_size.h;
+        bb_coords.push_back(box);
+    }
+    _map_content.insert(std::make_pair(key, std::make_shared<BoundingBox>(bb_coords, bb_labels, img_size)));
+}
+
+void TarShardMetaDataReader::read_all(const std::string &path)
+{
+    release();
+    _index = load_tar_shard_index(path);
+    std::string text;
+    for(auto &file : _index->files)
+    {
+        int fd = ::open(file.path.c_str(), O_RDONLY);
+        if(fd < 0)
+            THROW("TarShardMetaDataReader: failed opening " + file.path)
+        for(auto &sample : file.samples)
+        {
+            const TarMember &member = (_type == MetaDataType::BoundingBox) ? sample.boxes : sample.label;
+            if(!member.valid())
+            {
+                ::close(fd);
+                THROW("TarShardMetaDataReader: no " + STR(_type == MetaDataType::BoundingBox ? ".json" : ".cls") + " member for " + sample.key + " in " + file.path)
+            }
+            if(exists(sample.key))
+            {
+                WRN("TarShardMetaDataReader: " + sample.key + " is in more than one tar file, the first one's meta data is used")
+                continue;
+            }
+            text.assign(member.size, '\0');
+            if(pread(fd, &text[0], member.size, member.offset) != (ssize_t)member.size)
+            {
+                ::close(fd);
+                THROW("TarShardMetaDataReader: failed reading the meta data of " + sample.key + " in " + file.path)
+            }
+            try
+            {
+                if(_type == MetaDataType::BoundingBox)
+                    add_boxes(sample.key, text);
+                else
+                    _map_content.insert(std::make_pair(sample.key, std::make_shared<Label>(std::stoi(text))));
+            }
+            catch(const std::exception &e)
+            {
+                ::close(fd);
+                THROW("TarShardMetaDataReader: " + sample.key + " in " + file.path + ": " + e.what())
+            }
+        }
+        ::close(fd);
+    }
+}
+
+void TarShardMetaDataReader::lookup(const std::vector<std::string> &image_names)
+{
+    if(image_names.empty())
+    {
+        WRN("No image names passed")
+        return;
+    }
+    if(image_names.size() != (unsigned)_output->size())
+        _output->resize(image_names.size());
+
+    for(unsigned i = 0; i < image_names.size(); i++)
+    {
+        auto it = _map_content.find(image_names[i]);
+        if(_map_content.end() == it)
+            THROW("TarShardMetaDataReader ERROR: Given name not present in the map" + image_names[i])
+        if(_type == MetaDataType::BoundingBox)
+        {
+            _output->get_bb_cords_batch()[i] = it->second->get_bb_cords();
+            _output->get_bb_labels_batch()[i] = it->second->get_bb_labels();
+            _output->get_img_sizes_batch()[i] = it->second->get_img_size();
+        }
+        else
+        {
+            _output->get_label_batch()[i] = it->second->get_label();
+        }
+    }
+}
+
+void TarShardMetaDataReader::release()
+{
+    _map_content.clear();
+    _index.reset();
+}
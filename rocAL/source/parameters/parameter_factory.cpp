@@ -22,8 +22,11 @@ THE SOFTWARE.
 
 #include <cstdlib>
 #include <ctime>
+#include <map>
+#include <algorithm>
 #include "parameter_factory.h"
 #include "parameter_simple.h"
+#include "commons.h"
 ParameterFactory* ParameterFactory::_instance = nullptr;
 std::mutex ParameterFactory::_mutex;
 
@@ -108,6 +111,40 @@ void ParameterFactory::renew_parameters()
                 rand_obj);
 }
 
+std::vector<std::pair<unsigned, uint64_t>>
+ParameterFactory::draw_positions()
+{
+    std::vector<std::pair<unsigned, uint64_t>> positions;
+    for(auto&& rand_obj : _parameters)
+        std::visit(
+                [&positions](auto&& arg)
+                {
+                    if(arg->stream())
+                        positions.emplace_back(arg->stream(), arg->draw_position());
+                },
+                rand_obj);
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+void ParameterFactory::set_draw_positions(const std::vector<std::pair<unsigned, uint64_t>> &positions)
+{
+    std::map<unsigned, uint64_t> stream_positions(positions.begin(), positions.end());
+    for(auto&& rand_obj : _parameters)
+        std::visit(
+                [&stream_positions](auto&& arg)
+                {
+                    auto it = stream_positions.find(arg->stream());
+                    if(it == stream_positions.end())
+                        return;
+                    arg->set_draw_position(it->second);
+                    stream_positions.erase(it);
+                },
+                rand_obj);
+    if(!stream_positions.empty())
+        THROW("The pipeline does not have the random parameter of stream " + TOSTR(stream_positions.begin()->first) + " of the state, it has to be created the same way")
+}
+
 unsigned
 ParameterFactory::get_seed()
 {
@@ -125,11 +162,13 @@ void
 ParameterFactory::set_seed(unsigned seed)
 {
     _seed = seed;
+    // Parameters created after this get the same streams on every run with this seed
+    _stream_count = 0;
 }
 
 IntParam* ParameterFactory::create_uniform_int_rand_param(int start, int end)
 {
-    auto gen = new UniformRand<int>(start, end, _seed);
+    auto gen = new UniformRand<int>(start, end, _seed, next_stream());
     auto ret = new IntParam(gen, RocalParameterType::RANDOM_UNIFORM);
     _parameters.insert(gen);
     return ret;
@@ -137,7 +176,7 @@ IntParam* ParameterFactory::create_uniform_int_rand_param(int start, int end)
 
 FloatParam* ParameterFactory::create_uniform_float_rand_param(float start, float end)
 {
-    auto gen = new UniformRand<float>(start, end, _seed);
+    auto gen = new UniformRand<float>(start, end, _seed, next_stream());
     auto ret = new FloatParam(gen, RocalParameterType::RANDOM_UNIFORM);
     _parameters.insert(gen);
     return ret;
@@ -146,7 +185,7 @@ FloatParam* ParameterFactory::create_uniform_float_rand_param(float start, float
 
 IntParam* ParameterFactory::create_custom_int_rand_param(const int *value, const double *frequencies, size_t size)
 {
-    auto gen = new CustomRand<int>(value, frequencies, size, _seed);
+    auto gen = new CustomRand<int>(value, frequencies, size, _seed, next_stream());
     auto ret = new IntParam(gen, RocalParameterType::RANDOM_CUSTOM);
     _parameters.insert(gen);
     return ret;
@@ -154,7 +193,7 @@ IntParam* ParameterFactory::create_custom_int_rand_param(const int *value, const
 
 FloatParam* ParameterFactory::create_custom_float_rand_param(const float *value, const double *frequencies, size_t size)
 {
-    auto gen = new CustomRand<float>(value, frequencies, size, _seed);
+    auto gen = new CustomRand<float>(value, frequencies, size, _seed, next_stream());
     auto ret = new FloatParam(gen, RocalParameterType::RANDOM_CUSTOM);
     _parameters.insert(gen);
     return ret;
@@ -24,9 +24,6 @@ THE SOFTWARE.
 #include "parameter_random_crop_decoder.h"
 #include <cassert>
 
-// Initializing the random generator so all objects of the class can share it.
-thread_local std::mt19937 RocalRandomCropDecParam::_rand_gen(time(0));
-
 RocalRandomCropDecParam::RocalRandomCropDecParam(
     AspectRatioRange aspect_ratio_range,
     AreaRange area_range,
@@ -39,11 +36,11 @@ RocalRandomCropDecParam::RocalRandomCropDecParam(
     , _seed(seed)
     , _num_attempts(num_attempts)
     , _batch_size(batch_size) {
-    _seeds.resize(_batch_size);
+    _stream = ParameterFactory::instance()->next_stream();
 }
 
 
-CropWindow RocalRandomCropDecParam::generate_crop_window_implementation(const Shape& shape) {
+CropWindow RocalRandomCropDecParam::generate_crop_window_implementation(const Shape& shape, PhiloxEngine& rand_gen) {
     assert(shape.size() == 2);
     CropWindow crop;
     int H = shape[0], W = shape[1];
@@ -64,10 +61,10 @@ CropWindow RocalRandomCropDecParam::generate_crop_window_implementation(const Sh
     } else { // it can still fail for very small images when size granularity matters
       int attempts_left = _num_attempts;
       for (; attempts_left > 0; attempts_left--) {
-        float scale = _area_dis(_rand_gen);
+        float scale = _area_dis(rand_gen);
         size_t original_area = H * W;
         float target_area = scale * original_area;
-        float ratio = std::exp(_aspect_ratio_log_dis(_rand_gen));
+        float ratio = std::exp(_aspect_ratio_log_dis(rand_gen));
         auto w = static_cast<int>(
             std::roundf(sqrtf(target_area * ratio)));
         auto h = static_cast<int>(
@@ -94,19 +91,17 @@ CropWindow RocalRandomCropDecParam::generate_crop_window_implementation(const Sh
         crop.H = std::max<int>(1, crop.H * std::sqrt(scale));
       }
     }
-    crop.x = std::uniform_int_distribution<int>(0, W - crop.W)(_rand_gen);
-    crop.y = std::uniform_int_distribution<int>(0, H - crop.H)(_rand_gen);
+    crop.x = std::uniform_int_distribution<int>(0, W - crop.W)(rand_gen);
+    crop.y = std::uniform_int_distribution<int>(0, H - crop.H)(rand_gen);
     return crop;
     }
 
-// seed the rng for the instance and return the random crop window.
+// Every sample draws from its own counter-based engine, so the decoder threads can generate the windows in any order.
 CropWindow RocalRandomCropDecParam::generate_crop_window(const Shape& shape, const int instance) {
-    _rand_gen.seed(_seeds[instance]);
-    return generate_crop_window_implementation(shape);
+    PhiloxEngine rand_gen(_seed, _stream, _batch_idx * _batch_size + instance);
+    return generate_crop_window_implementation(shape, rand_gen);
 }
 
 void RocalRandomCropDecParam::generate_random_seeds() {
-    ParameterFactory::instance()->generate_seed(); // Renew and regenerate
-    std::seed_seq seq{ParameterFactory::instance()->get_seed()};
-    seq.generate(_seeds.begin(), _seeds.end());
+    _batch_idx++;
 }
@@ -0,0 +1,112 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#if ENABLE_SIMD
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+#include "philox.h"
+
+namespace
+{
+#if ENABLE_SIMD
+//! 32x32 bit products of the 8 lanes of a by m, low and high halves
+inline void mulhilo(__m256i a, __m256i m, __m256i &lo, __m256i &hi)
+{
+    const __m256i even = _mm256_mul_epu32(a, m);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+//! 8 consecutive blocks of the stream starting at sample, written as 32 consecutive words
+void fill_8_blocks(uint64_t seed, uint32_t stream, uint64_t sample, uint32_t *out)
+{
+    const __m256i m0 = _mm256_set1_epi32(philox::M0), m1 = _mm256_set1_epi32(philox::M1);
+    __m256i c0 = _mm256_setzero_si256();
+    __m256i c1 = _mm256_set1_epi32(stream);
+    alignas(32) uint32_t sample_lo[8], sample_hi[8];
+    for(unsigned lane = 0; lane < 8; lane++)
+    {
+        sample_lo[lane] = uint32_t(sample + lane);
+        sample_hi[lane] = uint32_t((sample + lane) >> 32);
+    }
+    __m256i c2 = _mm256_load_si256(reinterpret_cast<const __m256i *>(sample_lo));
+    __m256i c3 = _mm256_load_si256(reinterpret_cast<const __m256i *>(sample_hi));
+    uint32_t key[2] = {uint32_t(seed), uint32_t(seed >> 32)};
+    for(unsigned r = 0; r < 10; r++)
+    {
+        if(r)
+        {
+            key[0] += philox::W0;
+            key[1] += philox::W1;
+        }
+        __m256i lo0, hi0, lo1, hi1;
+        mulhilo(c0, m0, lo0, hi0);
+        mulhilo(c2, m1, lo1, hi1);
+        c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(key[0]));
+        c1 = lo1;
+        c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(key[1]));
+        c3 = lo0;
+    }
+    // 4x8 transpose, from one register per counter word to the words of each block next to each other
+    const __m256i t0 = _mm256_unpacklo_epi32(c0, c1), t1 = _mm256_unpackhi_epi32(c0, c1);
+    const __m256i t2 = _mm256_unpacklo_epi32(c2, c3), t3 = _mm256_unpackhi_epi32(c2, c3);
+    const __m256i b0 = _mm256_unpacklo_epi64(t0, t2), b1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i b2 = _mm256_unpacklo_epi64(t1, t3), b3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i *dst = reinterpret_cast<__m256i *>(out);
+    _mm256_storeu_si256(dst + 0, _mm256_permute2x128_si256(b0, b1, 0x20));
+    _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(b2, b3, 0x20));
+    _mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(b0, b1, 0x31));
+    _mm256_storeu_si256(dst + 3, _mm256_permute2x128_si256(b2, b3, 0x31));
+}
+#endif
+}
+
+void philox::fill(uint64_t seed, uint32_t stream, uint64_t first, uint32_t *out, size_t count)
+{
+    size_t i = 0;
+    // Leading words of a partially used block
+    if(first % 4 && count)
+    {
+        uint32_t ctr[4] = {0, stream, uint32_t(first / 4), uint32_t((first / 4) >> 32)};
+        block(ctr, seed);
+        for(unsigned w = first % 4; w < 4 && i < count; w++)
+            out[i++] = ctr[w];
+    }
+    uint64_t sample = (first + i) / 4;
+#if ENABLE_SIMD
+    for(; i + 32 <= count; i += 32, sample += 8)
+        fill_8_blocks(seed, stream, sample, out + i);
+#endif
+    for(; i < count; sample++)
+    {
+        uint32_t ctr[4] = {0, stream, uint32_t(sample), uint32_t(sample >> 32)};
+        block(ctr, seed);
+        for(unsigned w = 0; w < 4 && i < count; w++)
+            out[i++] = ctr[w];
+    }
+}
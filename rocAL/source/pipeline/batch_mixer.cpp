@@ -0,0 +1,186 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "batch_mixer.h"
+#include "philox.h"
+#include "commons.h"
+#include "exception.h"
+#if ENABLE_SIMD
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+namespace
+{
+// a = a * w + b * (256 - w), b = b * w + a * (256 - w), in 8.8 fixed point
+void blend_pair(unsigned char *a, unsigned char *b, size_t size, unsigned w)
+{
+    size_t i = 0;
+#if ENABLE_SIMD
+    const __m256i pW = _mm256_set1_epi16(w), pWc = _mm256_set1_epi16(256 - w), pRound = _mm256_set1_epi16(128);
+    for(; i + 16 <= size; i += 16)
+    {
+        __m256i pA = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(a + i)));
+        __m256i pB = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b + i)));
+        __m256i pRa = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(pA, pW), _mm256_mullo_epi16(pB, pWc)), pRound), 8);
+        __m256i pRb = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(pB, pW), _mm256_mullo_epi16(pA, pWc)), pRound), 8);
+        // packus works per 128-bit lane: {a 0-7, b 0-7, a 8-15, b 8-15}, put back in order as {a 0-15, b 0-15}
+        __m256i pPacked = _mm256_permute4x64_epi64(_mm256_packus_epi16(pRa, pRb), 0xD8);
+        _mm_storeu_si128((__m128i *)(a + i), _mm256_castsi256_si128(pPacked));
+        _mm_storeu_si128((__m128i *)(b + i), _mm256_extracti128_si256(pPacked, 1));
+    }
+#endif
+    for(; i < size; i++)
+    {
+        unsigned va = a[i], vb = b[i];
+        a[i] = (va * w + vb * (256 - w) + 128) >> 8;
+        b[i] = (vb * w + va * (256 - w) + 128) >> 8;
+    }
+}
+
+// Gamma(alpha, 1) by Marsaglia and Tsang, the normal draws by Box-Muller, all from the Philox words so every platform mixes the same way
+float gamma_sample(PhiloxEngine &rng, float alpha)
+{
+    // Gamma(alpha) = Gamma(alpha + 1) x U^(1 / alpha) below 1
+    if(alpha < 1.0f)
+    {
+        float u = 1.0f - rng.uniform();
+        return gamma_sample(rng, alpha + 1.0f) * std::pow(u, 1.0f / alpha);
+    }
+    const float d = alpha - 1.0f / 3.0f, c = 1.0f / std::sqrt(9.0f * d);
+    while(true)
+    {
+        float x = std::sqrt(-2.0f * std::log(1.0f - rng.uniform())) * std::cos(6.2831853f * rng.uniform());
+        float v = 1.0f + c * x;
+        if(v <= 0)
+            continue;
+        v = v * v * v;
+        float u = 1.0f - rng.uniform();
+        if(u < 1.0f - 0.0331f * x * x * x * x || std::log(u) < 0.5f * x * x + d * (1.0f - v + std::log(v)))
+            return d * v;
+    }
+}
+}
+
+BatchMixer::BatchMixer(BatchMixMode mode, unsigned num_classes, float alpha, float probability, float label_smoothing, uint64_t seed, uint32_t stream):
+        _mode(mode), _num_classes(num_classes), _alpha(alpha), _probability(probability), _label_smoothing(label_smoothing), _seed(seed), _stream(stream)
+{
+    if(_num_classes == 0)
+        THROW("Batch mixing needs the number of classes")
+    if(_mode != BatchMixMode::NONE && _alpha <= 0)
+        THROW("MixUp and CutMix need a positive alpha, given " + TOSTR(_alpha))
+    if(_probability < 0 || _probability > 1 || _label_smoothing < 0 || _label_smoothing >= 1)
+        THROW("Batch mixing probability should be in [0, 1] and label smoothing in [0, 1)")
+}
+
+BatchMixer::PairMix BatchMixer::draw(uint64_t batch, size_t pair, size_t width, size_t height) const
+{
+    PairMix mix;
+    PhiloxEngine rng(_seed, _stream, (batch << 32) | pair);
+    if(_mode == BatchMixMode::NONE || rng.uniform() >= _probability)
+        return mix;
+    // Beta(alpha, alpha) as X / (X + Y), X and Y of Gamma(alpha, 1)
+    float x = gamma_sample(rng, _alpha), y = gamma_sample(rng, _alpha);
+    mix.lambda = (x + y > 0) ? x / (x + y) : 0.5f;
+    // The labels get the ratio the images are blended with
+    if(_mode == BatchMixMode::MIXUP)
+        mix.lambda = std::lround(mix.lambda * 256) / 256.0f;
+    if(_mode == BatchMixMode::CUTMIX)
+    {
+        float cut_ratio = std::sqrt(1.0f - mix.lambda);
+        float cut_w = width * cut_ratio, cut_h = height * cut_ratio;
+        float cx = rng.uniform() * width, cy = rng.uniform() * height;
+        mix.x0 = std::clamp<long>(std::lround(cx - cut_w / 2), 0, width);
+        mix.x1 = std::clamp<long>(std::lround(cx + cut_w / 2), 0, width);
+        mix.y0 = std::clamp<long>(std::lround(cy - cut_h / 2), 0, height);
+        mix.y1 = std::clamp<long>(std::lround(cy + cut_h / 2), 0, height);
+        mix.lambda = 1.0f - float((mix.x1 - mix.x0) * (mix.y1 - mix.y0)) / float(width * height);
+    }
+    return mix;
+}
+
+void BatchMixer::one_hot(int label, float weight, float *soft_label) const
+{
+    int class_idx = (label > 0 && label <= (int)_num_classes) ? label - 1 : (label == 0 ? (int)_num_classes - 1 : -1);
+    // An unknown label gets an empty row, the smoothing is only spread over the classes of a known one
+    if(class_idx < 0 || weight == 0)
+        return;
+    const float spread = weight * _label_smoothing / _num_classes;
+    if(spread > 0)
+        for(unsigned c = 0; c < _num_classes; c++)
+            soft_label[c] += spread;
+    soft_label[class_idx] += weight * (1.0f - _label_smoothing);
+}
+
+void BatchMixer::process(const std::vector<void *> &images, size_t image_count, size_t width, size_t height, size_t depth, bool planar,
+                         const std::vector<int> &labels, float *soft_labels)
+{
+    if(labels.size() != image_count)
+        THROW("Batch mixing needs one label per image, got " + TOSTR(labels.size()) + " labels for " + TOSTR(image_count) + " images")
+    const uint64_t batch = _batch_count++;
+    const size_t image_size = width * height * depth;
+    const size_t planes = planar ? depth : 1, pixel_size = planar ? 1 : depth, plane_size = width * height * pixel_size;
+    const size_t pair_count = (image_count + 1) / 2;
+    memset(soft_labels, 0, image_count * _num_classes * sizeof(float));
+    #pragma omp parallel for num_threads(_num_threads)
+    for(int pair = 0; pair < (int)pair_count; pair++)
+    {
+        const size_t i = pair, j = image_count - 1 - pair;
+        const PairMix mix = draw(batch, pair, width, height);
+        if(i != j && mix.lambda < 1.0f)
+        {
+            for(auto buffer: images)
+            {
+                unsigned char *a = static_cast<unsigned char *>(buffer) + i * image_size;
+                unsigned char *b = static_cast<unsigned char *>(buffer) + j * image_size;
+                if(_mode == BatchMixMode::MIXUP)
+                {
+                    blend_pair(a, b, image_size, std::lround(mix.lambda * 256));
+                    continue;
+                }
+                const size_t row_bytes = (mix.x1 - mix.x0) * pixel_size;
+                for(size_t plane = 0; plane < planes; plane++)
+                    for(size_t y = mix.y0; y < mix.y1; y++)
+                    {
+                        size_t offset = plane * plane_size + (y * width + mix.x0) * pixel_size;
+                        std::swap_ranges(a + offset, a + offset + row_bytes, b + offset);
+                    }
+            }
+        }
+        // A sample mixed with itself (middle of an odd batch) keeps its label
+        const float lambda = (i != j) ? mix.lambda : 1.0f;
+        one_hot(labels[i], lambda, soft_labels + i * _num_classes);
+        one_hot(labels[j], 1.0f - lambda, soft_labels + i * _num_classes);
+        if(i != j)
+        {
+            one_hot(labels[j], lambda, soft_labels + j * _num_classes);
+            one_hot(labels[i], 1.0f - lambda, soft_labels + j * _num_classes);
+        }
+    }
+}
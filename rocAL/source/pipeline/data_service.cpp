@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <climits>
+#include <algorithm>
+#include "data_service.h"
+#include "master_graph.h"
+#include "log.h"
+
+DataService::DataService(MasterGraph *master_graph, size_t batch_size, const std::string &service_name, unsigned rank_count, unsigned ring_depth):
+_master_graph(master_graph),
+_batch_size(batch_size),
+_service_name(service_name),
+_rank_count(rank_count),
+_ring_depth(ring_depth)
+{
+    if(_rank_count == 0)
+        THROW("The rocAL service needs at least one rank to serve")
+    if(_master_graph->augmentation_branch_count() != 1)
+        THROW("The rocAL service only publishes pipelines with a single output")
+    if(_master_graph->sequence_batch_size())
+        THROW("The rocAL service does not publish the output of sequence readers")
+}
+
+void
+DataService::create_rings(size_t epoch_batch_count)
+{
+    ShmBatchRingLayout layout;
+    layout.batch_size = _batch_size;
+    layout.width = _master_graph->output_width();
+    layout.height = _master_graph->output_height() / _batch_size;
+    layout.planes = _master_graph->output_depth();
+    layout.color_format = static_cast<int32_t>(_master_graph->output_color_format());
+    layout.depth = _ring_depth;
+    layout.image_bytes = _master_graph->output_byte_size();
+    layout.epoch_batch_count = epoch_batch_count;
+    // The meta data published is the one of the pipeline output, labels or boxes
+    auto meta_data = _master_graph->meta_data().second;
+    if(meta_data)
+    {
+        layout.has_meta_data = 1;
+        layout.meta_data_type = static_cast<int32_t>(std::dynamic_pointer_cast<BoundingBoxBatch>(meta_data) ? MetaDataType::BoundingBox : MetaDataType::Label);
+    }
+    // The names of the batches are the ones the reader holds the meta data of, the augmentations only drop boxes and the box encoder
+    // gives every sample one per anchor. Without a reader the names are only bounded by the path length
+    size_t max_name_length = 0, max_box_count = _master_graph->box_encoder_anchor_count();
+    for(auto &name: _master_graph->meta_data().first)
+        max_name_length = std::max(max_name_length, name.size());
+    auto reader = _master_graph->meta_data_reader();
+    if(reader)
+    {
+        for(auto &sample: reader->get_map_content())
+        {
+            max_name_length = std::max(max_name_length, sample.first.size());
+            max_box_count = std::max(max_box_count, sample.second->get_bb_cords().size());
+        }
+    }
+    else
+    {
+        max_name_length = std::max<size_t>(max_name_length, PATH_MAX);
+    }
+    layout.meta_data_bytes = ShmBatchRing::meta_data_bytes(layout.batch_size, layout.has_meta_data, static_cast<MetaDataType>(layout.meta_data_type),
+                                                           max_name_length, max_box_count);
+    for(unsigned rank = 0; rank < _rank_count; rank++)
+        _rings.push_back(ShmBatchRing::create(ShmBatchRing::segment_name(_service_name, rank), layout));
+    LOG("rocAL service " + _service_name + " serving " + TOSTR(_rank_count) + " ranks, " + TOSTR(epoch_batch_count) + " batches each per epoch")
+}
+
+void
+DataService::publish(size_t rank)
+{
+    auto &ring = _rings[rank];
+    if(!ring->wait_until_writable())
+        THROW("The ring of rank " + TOSTR(rank) + " was closed")
+    if(_master_graph->copy_output(ring->write_images(), ring->layout().image_bytes) != MasterGraph::Status::OK)
+        THROW("The output batch does not match the layout of the service rings")
+    auto &meta_data = _master_graph->meta_data();
+    ring->write_meta_data(meta_data.first, meta_data.second.get());
+    ring->commit_write();
+}
+
+void
+DataService::serve(unsigned epoch_count)
+{
+    size_t epoch_batch_count = 0;
+    for(unsigned epoch = 0; epoch_count == 0 || epoch < epoch_count; epoch++)
+    {
+        if(epoch > 0)
+            _master_graph->reset();
+        // The batches are handed out in rounds over the ranks, the ranks stay in step through the whole epoch
+        const size_t round_count = _master_graph->remaining_count() / _batch_size / _rank_count;
+        if(epoch == 0)
+        {
+            if(round_count == 0)
+                THROW("The dataset holds fewer batches than ranks to serve")
+            epoch_batch_count = round_count;
+        }
+        else if(round_count < epoch_batch_count)
+        {
+            WRN("The epoch holds fewer batches than the first one, the rocAL service stops")
+            break;
+        }
+        for(size_t batch = 0; batch < epoch_batch_count * _rank_count; batch++)
+        {
+            if(_master_graph->run() != MasterGraph::Status::OK)
+                THROW("The pipeline ran out of data in the middle of an epoch")
+            if(_rings.empty())
+                create_rings(epoch_batch_count);
+            publish(batch % _rank_count);
+        }
+    }
+    for(auto &ring: _rings)
+        ring->close();
+}
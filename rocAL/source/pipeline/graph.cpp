@@ -111,6 +111,20 @@ Graph::process()
     return  Status::OK;
 }
 
+Graph::Status
+Graph::set_cpu_num_threads(size_t cpu_num_threads)
+{
+    vx_status status;
+    vx_uint32 num_threads = cpu_num_threads;
+    if((status = vxSetGraphAttribute(   _graph,
+                                        VX_GRAPH_ATTRIBUTE_AMD_CPU_NUM_THREADS,
+                                        &num_threads,
+                                        sizeof(num_threads))) != VX_SUCCESS)
+        THROW("vxSetGraphAttribute failed " + TOSTR(status))
+
+    return verify();
+}
+
 Graph::Status
 Graph::release()
 {
@@ -205,7 +205,16 @@ void Image::update_image_original_dims(const std::vector<uint32_t> &original_wid
 
 Image::~Image()
 {
-    vxReleaseImage(&vx_handle);
+    if(vx_handle)
+        vxReleaseImage(&vx_handle);
+}
+
+void Image::release()
+{
+    if(vx_handle)
+        vxReleaseImage(&vx_handle);
+    vx_handle = nullptr;
+    _mem_handle = nullptr;
 }
 
 //! Converts the Rocal color format type to OpenVX
@@ -25,7 +25,14 @@ THE SOFTWARE.
 #include <vx_ext_amd.h>
 #include <VX/vx_types.h>
 #include <cstring>
+#include <chrono>
+#include <algorithm>
 #include <sched.h>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <cerrno>
+#endif
 #include <half/half.hpp>
 #include "master_graph.h"
 #include "parameter_factory.h"
@@ -109,6 +116,10 @@ std::vector<std::vector<float>>& operator+=(std::vector<std::vector<float>>& des
 MasterGraph::~MasterGraph()
 {
     release();
+#if defined(__linux__)
+    if(_output_ready_fd >= 0)
+        close(_output_ready_fd);
+#endif
 }
 
 MasterGraph::MasterGraph(size_t batch_size, RocalAffinity affinity, size_t cpu_thread_count, int gpu_id, size_t prefetch_queue_depth, RocalTensorDataType output_tensor_data_type):
@@ -121,6 +132,7 @@ MasterGraph::MasterGraph(size_t batch_size, RocalAffinity affinity, size_t cpu_t
         _convert_time("Conversion Time", DBG_TIMING),
         _process_time("Process Time", DBG_TIMING),
         _bencode_time("BoxEncoder Time", DBG_TIMING),
+        _meta_data_time("MetaData Process Time", DBG_TIMING),
         _user_batch_size(batch_size),
 #if ENABLE_HIP
         _mem_type ((_affinity == RocalAffinity::GPU) ? RocalMemType::HIP : RocalMemType::HOST),
@@ -227,6 +239,7 @@ MasterGraph::run()
     _ring_buffer.block_if_empty();// wait here if the user thread (caller of this function) is faster in consuming the processed images compare to th output routine in producing them
     _rb_block_if_empty_time.end();
 
+    const bool pop = !_first_run;
     if(_first_run)
     {
         // calling run pops the processed images that have been used by user, when user calls run() for the first time
@@ -235,6 +248,8 @@ MasterGraph::run()
     } else {
         _ring_buffer.pop(); // Pop previously used output images and metadata from the ring buffer
     }
+    if(_track_state)
+        hand_out_batch_state(pop);
 
     // If the last batch of processed imaged has been just popped from the ring_buffer it means user has previously consumed all the processed images.
     // User should check using the IsEmpty() API and not call run() or copy() API when there is no more data. run() will return MasterGraph::Status::NO_MORE_DATA flag to notify it.
@@ -243,10 +258,80 @@ MasterGraph::run()
     }
 
     decrease_image_count();
+    update_output_ready();
 
     return MasterGraph::Status::OK;
 }
 
+MasterGraph::Status
+MasterGraph::try_run(bool &ran)
+{
+    ran = false;
+    if(!next_output_ready())
+    {
+        // clears a spurious readiness so that the pollers of output_ready_fd() don't spin
+        update_output_ready();
+        return MasterGraph::Status::OK;
+    }
+    ran = true;
+    return run();
+}
+
+bool MasterGraph::next_output_ready()
+{
+    // run() returns right away when not processing or at the end of data
+    if(!_processing || _output_routine_finished_processing)
+        return true;
+    // the batch of the last run() stays in the ring buffer till the next run() pops it
+    return _ring_buffer.readable_count() > (_first_run ? 0 : 1);
+}
+
+int MasterGraph::output_ready_fd()
+{
+#if defined(__linux__)
+    std::unique_lock<std::mutex> lock(_output_ready_fd_lock);
+    if(_output_ready_fd < 0)
+    {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(fd < 0)
+            THROW("Creating the output ready eventfd failed: " + TOSTR(errno))
+        _output_ready_fd = fd;
+        lock.unlock();
+        update_output_ready();
+    }
+    return _output_ready_fd;
+#else
+    return -1;
+#endif
+}
+
+void MasterGraph::signal_output_ready()
+{
+#if defined(__linux__)
+    int fd = _output_ready_fd.load();
+    if(fd < 0)
+        return;
+    uint64_t one = 1;
+    if(write(fd, &one, sizeof(one)) < 0)
+        WRN("Signaling the output ready eventfd failed")
+#endif
+}
+
+void MasterGraph::update_output_ready()
+{
+#if defined(__linux__)
+    int fd = _output_ready_fd.load();
+    if(fd < 0)
+        return;
+    // drain the count and signal again if a batch is still waiting, a batch pushed in between only causes a spurious wake up
+    uint64_t count;
+    if(read(fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        WRN("Reading the output ready eventfd failed")
+    if(next_output_ready())
+        signal_output_ready();
+#endif
+}
+
 void
 MasterGraph::decrease_image_count()
 {
@@ -303,6 +388,8 @@ MasterGraph::build()
     for(auto&& output_image : _output_images)
         if(!(output_image->info() == _output_image_info))
             THROW("Dimension of the output images do not match")
+    _output_width = _output_image_info.width();
+    _output_height = _output_image_info.height_single();
 
     allocate_output_tensor();
 #if ENABLE_HIP || ENABLE_OPENCL
@@ -311,7 +398,12 @@ MasterGraph::build()
     _ring_buffer.init(_mem_type, nullptr, output_byte_size(), _output_images.size());
 #endif
     if (_is_box_encoder) _ring_buffer.initBoxEncoderMetaData(_mem_type, _user_batch_size*_num_anchors*4*sizeof(float), _user_batch_size*_num_anchors*sizeof(int));
+    if (_batch_mixer) _ring_buffer.initSoftLabelMetaData(_user_batch_size*_batch_mixer->num_classes()*sizeof(float));
+    if (_is_keypoint_heatmap) _ring_buffer.initKeyPointHeatmapMetaData(_user_batch_size*NUMBER_OF_JOINTS*_heatmap_width*_heatmap_height*sizeof(float), _user_batch_size*NUMBER_OF_JOINTS*sizeof(float));
     create_single_graph();
+    apply_output_size();
+    start_autotune();
+    start_state_tracking();
     start_processing();
     return Status::OK;
 }
@@ -350,6 +442,8 @@ MasterGraph::create_image(const ImageInfo &info, bool is_output)
 void
 MasterGraph::set_output(Image* output_image)
 {
+    if(std::find(_consumed_images.begin(), _consumed_images.end(), output_image) != _consumed_images.end())
+        THROW("Output image is consumed by the sequence rearrangement folded into its loader, use the output of the rearrangement instead")
     if(output_image->is_handle_set() == false)
     {
         if (output_image->create_from_handle(_context) != 0)
@@ -385,8 +479,18 @@ void MasterGraph::release()
         delete image;// It will call the vxReleaseImage internally in the destructor
     for(auto& image: _output_images)
         delete image;// It will call the vxReleaseImage internally in the destructor
+    for(auto& image: _consumed_images)
+        delete image;
     deallocate_output_tensor();
-
+    if(_output_compact_buffer)
+    {
+#if ENABLE_OPENCL
+        clReleaseMemObject((cl_mem)_output_compact_buffer);
+#elif ENABLE_HIP
+        hipFree(_output_compact_buffer);
+#endif
+        _output_compact_buffer = nullptr;
+    }
 
     if(_graph != nullptr)
         _graph->release();
@@ -426,13 +530,13 @@ MasterGraph::output_color_format()
 size_t
 MasterGraph::output_width()
 {
-    return _output_image_info.width();
+    return _output_width;
 }
 
 size_t
 MasterGraph::output_height()
 {
-    return _output_image_info.height_batch() * (_is_sequence_reader_output ? _sequence_length : 1);
+    return _output_height * _output_image_info.batch_size() * (_is_sequence_reader_output ? _sequence_length : 1);
 }
 
 void
@@ -503,35 +607,469 @@ MasterGraph::deallocate_output_tensor()
 MasterGraph::Status
 MasterGraph::reset()
 {
+    {
+        std::unique_lock<std::mutex> lock(_epoch_lock);
+        if (_output_routine_parked)
+        {
+            // The internal processing thread is waiting at the end of data and does not touch the ring buffer or the loaders,
+            // move them to the next epoch and let it carry on with the batches already loaded for it
+            apply_output_size();
+            _ring_buffer.reset();
+            reset_loaders();
+            if(_track_state)
+                start_state_tracking();
+            _first_run = true;
+            _output_routine_finished_processing = false;
+            _output_routine_parked = false;
+            lock.unlock();
+            _epoch_cv.notify_all();
+            update_output_ready();
+            return Status::OK;
+        }
+    }
     // stop the internal processing thread so that the
-    _processing = false;
+    set_processing(false);
     _ring_buffer.unblock_writer();
     if(_output_thread.joinable())
         _output_thread.join();
+    apply_output_size();
     _ring_buffer.reset();
-    // clearing meta ring buffer
+    reset_loaders();
+    if(_track_state)
+        start_state_tracking();
+
+    // restart processing of the images
+    _first_run = true;
+    _output_routine_finished_processing = false;
+    start_processing();
+    update_output_ready();
+    return Status::OK;
+}
+
+PipelineState
+MasterGraph::current_state()
+{
+    PipelineState state;
+    state.seed = ParameterFactory::instance()->get_seed();
+    state.batch_count = _processed_batch_count;
+    _loader_module->get_position(state.loader);
+    state.parameter_draws = ParameterFactory::instance()->draw_positions();
+    return state;
+}
+
+void
+MasterGraph::start_state_tracking()
+{
+    // Called by build(), and by reset() when the epoch the batches are processed from changes
+    if(!_track_state)
+    {
+        // Without it the output routine does not keep the state after every batch
+        if(!_state_tracking_enabled)
+            return;
+        LoaderPosition position;
+        _track_state = !_is_video_loader && _loader_module && _loader_module->get_position(position);
+        if(!_track_state)
+        {
+            if(_start_state)
+                THROW("The loader of the pipeline cannot be resumed from a position, the state cannot be loaded")
+            WRN("The loader of the pipeline cannot be resumed from a position, its state is not tracked")
+            return;
+        }
+        if(_start_state)
+        {
+            ParameterFactory::instance()->set_draw_positions(_start_state->parameter_draws);
+            _processed_batch_count = _start_state->batch_count;
+            if(_batch_mixer)
+                _batch_mixer->set_batch_count(_processed_batch_count);
+        }
+    }
+    // The batches left in the ring buffer are dropped, the ones processed from now on continue from the live state
+    std::unique_lock<std::mutex> lock(_state_lock);
+    _batch_states.clear();
+    _resume_state = current_state();
+}
+
+void
+MasterGraph::hand_out_batch_state(bool pop)
+{
+    std::unique_lock<std::mutex> lock(_state_lock);
+    if(pop && !_batch_states.empty())
+        _batch_states.pop_front();
+    if(!_batch_states.empty())
+        _resume_state = _batch_states.front();
+}
+
+void
+MasterGraph::set_state_tracking(bool enable)
+{
+    if(_processing)
+        THROW("State tracking should be set before the pipeline is built")
+    _state_tracking_enabled = enable;
+}
+
+PipelineState
+MasterGraph::save_state()
+{
+    if(!_track_state)
+        THROW("State tracking has to be enabled before the pipeline is built, with a loader that can be resumed from a position, to save its state")
+    std::unique_lock<std::mutex> lock(_state_lock);
+    return _resume_state;
+}
+
+void
+MasterGraph::load_state(const PipelineState &state)
+{
+    if(_loader_module || _is_video_loader)
+        THROW("The state should be loaded before the loader is created")
+    // The random parameters created from now on get the streams of the saved run, the readers shuffle with the same seed
+    ParameterFactory::instance()->set_seed(state.seed);
+    _start_state = std::make_unique<PipelineState>(state);
+    _state_tracking_enabled = true;
+    LOG("Resuming from epoch " + TOSTR(state.loader.epoch) + " sample " + TOSTR(state.epoch_sample_offset(_user_batch_size)))
+}
+
+void
+MasterGraph::reset_loaders()
+{
 #ifdef ROCAL_VIDEO
     if(_is_video_loader)
     {
         _video_loader_module->reset();
         _sequence_start_framenum_vec.clear();
         _sequence_frame_timestamps_vec.clear();
+        _remaining_count = _video_loader_module->remaining_count();
     }
     else
 #endif
     {
-        // if random_bbox meta reader is used: read again to get different crops
-        if (_randombboxcrop_meta_data_reader != nullptr)
-            _randombboxcrop_meta_data_reader->release();
-        // resetting loader module to start from the beginning of the media and clear it's internal state/buffers
+        // moving the loader module to the next epoch, the loader restarts from the beginning of the media (reshuffled, and
+        // with new random bbox crops if used) in the background
         _loader_module->reset();
+        _remaining_count = _loader_module->remaining_count();
     }
+}
 
-    // restart processing of the images
-    _first_run = true;
-    _output_routine_finished_processing = false;
-    start_processing();
-    return Status::OK;
+void
+MasterGraph::set_shard_scheduling(ShardScheduling scheduling, bool share_decode_threads)
+{
+    if(_loader_module)
+        THROW("Shard scheduling should be set before the loader is created")
+    _shard_scheduling = scheduling;
+    _share_decode_threads = share_decode_threads;
+}
+
+void
+MasterGraph::set_ssd_random_crop_sampler(std::shared_ptr<SSDRandomCropNode> node)
+{
+    if(node->get_bbox_crop_sampler())
+        node->get_bbox_crop_sampler()->set_num_threads(_cpu_num_threads);
+    // Needs the boxes of the samples, looked up by the loader threads in the (read only) meta data reader
+    if(_loader_sampled_ssd_node || !_loader_module || !_meta_data_reader || !node->get_bbox_crop_sampler())
+        return;
+    node->get_bbox_crop_sampler()->set_meta_data_reader(_meta_data_reader);
+    _loader_module->set_bbox_crop_sampler(node->get_bbox_crop_sampler());
+    _loader_sampled_ssd_node = node;
+}
+
+Image *
+MasterGraph::fold_sequence_rearrange(Image *input, const ImageInfo &info, const std::vector<unsigned> &new_order)
+{
+    auto loader = _image_map.find(input);
+    if(loader == _image_map.end() || std::find(_output_images.begin(), _output_images.end(), input) != _output_images.end())
+        return nullptr;
+    // The loader can only write the rearranged sequences in place of the read ones if nothing else reads them
+    for(auto &node: _nodes)
+    {
+        auto node_inputs = node->input();
+        if(std::find(node_inputs.begin(), node_inputs.end(), input) != node_inputs.end())
+            return nullptr;
+    }
+    auto node = loader->second;
+#ifdef ROCAL_VIDEO
+    auto video_loader = std::dynamic_pointer_cast<VideoLoaderNode>(node);
+#endif
+    auto image_loader = std::dynamic_pointer_cast<ImageLoaderNode>(node);
+    if(!image_loader || !_is_sequence_reader_output)
+        image_loader = nullptr;
+#ifdef ROCAL_VIDEO
+    if(!video_loader && !image_loader)
+#else
+    if(!image_loader)
+#endif
+        return nullptr;
+
+    auto output = create_loader_output_image(info);
+#ifdef ROCAL_VIDEO
+    if(video_loader)
+        video_loader->set_sequence_rearrange(output, new_order);
+#endif
+    if(image_loader)
+    {
+        image_loader->set_sequence_rearrange(output, new_order);
+        set_sequence_batch_size(new_order.size());
+    }
+    _image_map.erase(loader);
+    _image_map.insert(std::make_pair(output, node));
+    // The loader does not write the read sequences anymore, the image is released but kept so that using it later throws
+    _internal_images.remove(input);
+    input->release();
+    _consumed_images.push_back(input);
+    LOG("Sequence rearrangement folded into the loader, " + TOSTR(new_order.size()) + " frames per sequence")
+    return output;
+}
+
+void
+MasterGraph::set_output_size(unsigned width, unsigned height)
+{
+    if(width == 0 || height == 0)
+        THROW("Output size should be non zero, given " + TOSTR(width) + "x" + TOSTR(height))
+    if(_is_sequence_reader_output)
+        THROW("Output size cannot be changed for the sequence reader outputs")
+    if(!_output_images.empty() && (width > _output_images.front()->info().width() || height > _output_images.front()->info().height_single()))
+        THROW("Output size " + TOSTR(width) + "x" + TOSTR(height) + " is larger than the output images " +
+              TOSTR(_output_images.front()->info().width()) + "x" + TOSTR(_output_images.front()->info().height_single()))
+    _pending_output_width = width;
+    _pending_output_height = height;
+    _output_size_pending = true;
+}
+
+void
+MasterGraph::apply_output_size()
+{
+    // Only called from build() and reset(), while the output routine is not running a batch through the graph
+    if(!_output_size_pending)
+        return;
+    _output_size_pending = false;
+    if(_pending_output_width == _output_width && _pending_output_height == _output_height)
+        return;
+    // Resolves the node writing each output image, the sizes set on them are picked up on the next update_node()
+    std::vector<std::shared_ptr<Node>> producers;
+    for(auto output_image: _output_images)
+    {
+        auto producer = std::find_if(_nodes.begin(), _nodes.end(), [output_image](const std::shared_ptr<Node> &node)
+        {
+            auto node_outputs = node->output();
+            return std::find(node_outputs.begin(), node_outputs.end(), output_image) != node_outputs.end();
+        });
+        if(producer == _nodes.end())
+            THROW("The output images are written by the loader, add a resize or a fixed crop as the last augmentation to change their size")
+        if(!(*producer)->output_size_adjustable())
+            THROW("The augmentation producing an output cannot change the size of the images it writes, use a resize or a fixed crop as the last augmentation")
+        if(std::find(producers.begin(), producers.end(), *producer) == producers.end())
+            producers.push_back(*producer);
+    }
+    for(auto &producer: producers)
+        producer->set_output_size(_pending_output_width, _pending_output_height);
+    _output_width = _pending_output_width;
+    _output_height = _pending_output_height;
+    LOG("Output size set to " + TOSTR(_output_width) + "x" + TOSTR(_output_height))
+}
+
+void
+MasterGraph::compact_output_images(const std::vector<void*> &buffers)
+{
+    // The graph writes the top left corner of the output images allocated at their full size,
+    // it is packed here so that each batch holds contiguous images of the current output size
+    const size_t full_width = _output_image_info.width();
+    const size_t full_height = _output_image_info.height_single();
+    if(_output_width == full_width && _output_height == full_height)
+        return;
+    const size_t pixel_size = output_depth() * SAMPLE_SIZE;
+    const size_t src_stride = full_width * pixel_size, dst_stride = _output_width * pixel_size;
+    const size_t image_count = _output_image_info.batch_size();
+    const size_t src_image_size = src_stride * full_height, dst_image_size = dst_stride * _output_height;
+#if ENABLE_HIP
+    if(processing_on_device_hip())
+    {
+        // allocated once for the full size of the output images, set_output_size() can grow the output back up to it
+        if(!_output_compact_buffer)
+        {
+            hipError_t err = hipMalloc(&_output_compact_buffer, src_image_size * image_count);
+            if(err != hipSuccess)
+                THROW("hipMalloc of the output compaction buffer failed " + TOSTR(err))
+        }
+        for(auto buffer: buffers)
+        {
+            for(size_t i = 0; i < image_count; i++)
+            {
+                hipError_t err = hipMemcpy2D((unsigned char *)_output_compact_buffer + i * dst_image_size, dst_stride,
+                                             (unsigned char *)buffer + i * src_image_size, src_stride,
+                                             dst_stride, _output_height, hipMemcpyDeviceToDevice);
+                if(err != hipSuccess)
+                    THROW("hipMemcpy2D failed while compacting the output images " + TOSTR(err))
+            }
+            hipError_t err = hipMemcpy(buffer, _output_compact_buffer, dst_image_size * image_count, hipMemcpyDeviceToDevice);
+            if(err != hipSuccess)
+                THROW("hipMemcpy failed while compacting the output images " + TOSTR(err))
+        }
+        return;
+    }
+#elif ENABLE_OPENCL
+    if(processing_on_device_ocl())
+    {
+        auto queue = _device.resources()->cmd_queue;
+        cl_int err = CL_SUCCESS;
+        // allocated once for the full size of the output images, set_output_size() can grow the output back up to it
+        if(!_output_compact_buffer)
+        {
+            _output_compact_buffer = clCreateBuffer(_device.resources()->context, CL_MEM_READ_WRITE, src_image_size * image_count, nullptr, &err);
+            if(!_output_compact_buffer || err != CL_SUCCESS)
+                THROW("clCreateBuffer of the output compaction buffer failed " + TOSTR(err))
+        }
+        for(auto buffer: buffers)
+        {
+            for(size_t i = 0; i < image_count; i++)
+            {
+                size_t src_origin[3] = {0, i * full_height, 0};
+                size_t dst_origin[3] = {0, i * _output_height, 0};
+                size_t region[3] = {dst_stride, _output_height, 1};
+                if((err = clEnqueueCopyBufferRect(queue, (cl_mem)buffer, (cl_mem)_output_compact_buffer, src_origin, dst_origin, region,
+                                                  src_stride, 0, dst_stride, 0, 0, nullptr, nullptr)) != CL_SUCCESS)
+                    THROW("clEnqueueCopyBufferRect failed while compacting the output images " + TOSTR(err))
+            }
+            if((err = clEnqueueCopyBuffer(queue, (cl_mem)_output_compact_buffer, (cl_mem)buffer, 0, 0, dst_image_size * image_count, 0, nullptr, nullptr)) != CL_SUCCESS)
+                THROW("clEnqueueCopyBuffer failed while compacting the output images " + TOSTR(err))
+        }
+        clFinish(queue);
+        return;
+    }
+#endif
+    // On the host the destination never runs ahead of the source, the rows can be moved in place front to back
+    for(auto buffer: buffers)
+    {
+        auto base = (unsigned char *)buffer;
+        for(size_t i = 0; i < image_count; i++)
+            for(size_t row = 0; row < _output_height; row++)
+                memmove(base + i * dst_image_size + row * dst_stride, base + i * src_image_size + row * src_stride, dst_stride);
+    }
+}
+
+void
+MasterGraph::set_numa_placement(bool enable, int output_numa_node, const std::vector<int> &shard_numa_nodes)
+{
+    if(_loader_module)
+        THROW("NUMA placement should be set before the loader is created")
+    _numa_shard_cpus.clear();
+    _numa_output_cpus.clear();
+    if(!enable)
+        return;
+    NumaTopology topology;
+    // By default the output thread stays on the node of the training process (the thread setting up the pipeline)
+    if(output_numa_node < 0)
+        output_numa_node = topology.current_node();
+    _numa_output_cpus = topology.cpus(output_numa_node);
+    // By default the shards are spread over all the nodes, starting with the output node so a single shard stays local
+    std::vector<int> shard_nodes = shard_numa_nodes;
+    if(shard_nodes.empty())
+    {
+        shard_nodes.push_back(output_numa_node);
+        for(auto node: topology.nodes())
+            if(node != output_numa_node)
+                shard_nodes.push_back(node);
+    }
+    for(auto node: shard_nodes)
+        _numa_shard_cpus.push_back(topology.cpus(node));
+    INFO("NUMA placement: output thread on node " + TOSTR(output_numa_node) + ", loader shards over " + TOSTR(shard_nodes.size()) + " node(s)")
+}
+
+void
+MasterGraph::place_output_thread()
+{
+    if(_numa_output_cpus.empty())
+        return;
+    // The ring buffer slots are placed on the node of the output thread (the training process node) by touching them first from it
+    if(NumaTopology::bind_current_thread(_numa_output_cpus) && !_output_buffers_placed)
+    {
+        _ring_buffer.first_touch();
+        _output_buffers_placed = true;
+    }
+}
+
+void
+MasterGraph::set_autotune(bool enable, size_t tuning_batch_count, size_t memory_budget)
+{
+    if(_loader_module)
+        THROW("Autotuning should be set before the loader is created")
+    if(enable && tuning_batch_count == 0)
+        THROW("Autotuning needs at least one batch to tune on")
+    _autotune_batch_count = enable ? tuning_batch_count : 0;
+    _autotune_memory_budget = memory_budget;
+}
+
+size_t
+MasterGraph::loader_prefetch_queue_depth(Image *loader_output)
+{
+    if(!_autotune_batch_count)
+        return _prefetch_queue_depth;
+    // The buffers of the deepest prefetch the autotuner may pick are allocated up front, it only changes how many of them are in use.
+    // Every internal shard allocates its own buffers, the loader splits the memory budget between them once it knows their number
+    size_t depth = MAX_AUTOTUNE_PREFETCH_DEPTH;
+    if(_autotune_memory_budget)
+    {
+        depth = std::min<size_t>(depth, _autotune_memory_budget / loader_output->info().data_size());
+        _loader_module->set_prefetch_memory_budget(_autotune_memory_budget, _prefetch_queue_depth);
+        _autotune_loader_buffer_size = loader_output->info().data_size();
+    }
+    _autotune_prefetch_depth = std::max(depth, _prefetch_queue_depth);
+    return _autotune_prefetch_depth;
+}
+
+void
+MasterGraph::start_autotune()
+{
+    if(!_autotune_batch_count || !_loader_module)
+        return;
+    const size_t thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    // The decode threads and the prefetch depth are applied to every internal shard
+    const size_t shard_count = std::max<size_t>(_loader_module->internal_shard_count(), 1);
+    if(_autotune_memory_budget && _autotune_loader_buffer_size)
+        _autotune_prefetch_depth = std::max(_prefetch_queue_depth, std::min(_autotune_prefetch_depth, _autotune_memory_budget / (_autotune_loader_buffer_size * shard_count)));
+    AutotuneConfig initial, max;
+    initial.decode_threads = initial.graph_threads = std::max<size_t>(_cpu_num_threads, 1);
+    initial.prefetch_depth = _prefetch_queue_depth;
+    max.decode_threads = std::max(initial.decode_threads, thread_count / shard_count);
+    // The graph threads only matter to the nodes running on the CPU, the loader buffers are only deeper for the image loaders
+    max.graph_threads = (_affinity == RocalAffinity::CPU) ? std::max(initial.graph_threads, thread_count) : initial.graph_threads;
+    max.prefetch_depth = std::max(_autotune_prefetch_depth, initial.prefetch_depth);
+    _autotuner = std::make_unique<PipelineAutotuner>(initial, max, _autotune_batch_count);
+    _autotune_applied = initial;
+    _loader_module->set_prefetch_limit(initial.prefetch_depth);
+    INFO("Autotuning on the first " + TOSTR(_autotune_batch_count) + " batches, starting from " + initial.to_string())
+}
+
+void
+MasterGraph::apply_autotune_config(const AutotuneConfig &config)
+{
+    if(config.decode_threads != _autotune_applied.decode_threads)
+        _loader_module->set_decode_thread_count(config.decode_threads);
+    if(config.prefetch_depth != _autotune_applied.prefetch_depth)
+        _loader_module->set_prefetch_limit(config.prefetch_depth);
+    if(config.graph_threads != _autotune_applied.graph_threads)
+        _graph->set_cpu_num_threads(config.graph_threads);
+    _autotune_applied = config;
+}
+
+void
+MasterGraph::autotune(double output_wait, double load_wait, double process)
+{
+    std::unique_lock<std::mutex> lock(_autotune_lock);
+    if(!_autotuner || _autotuner->done())
+        return;
+    if(_autotuner->add_batch(output_wait, load_wait, process))
+        apply_autotune_config(_autotuner->config());
+    if(_autotuner->done())
+        LOG("Autotuning done: " + _autotuner->best().to_string() + ", " + TOSTR(_autotuner->best_rate()) + " batches/s")
+}
+
+bool
+MasterGraph::autotune_result(AutotuneConfig &config, double &batches_per_second)
+{
+    std::unique_lock<std::mutex> lock(_autotune_lock);
+    if(!_autotuner)
+        THROW("Autotuning is not enabled, or the pipeline is not built yet")
+    config = _autotuner->best();
+    batches_per_second = _autotuner->best_rate();
+    return _autotuner->done();
 }
 
 size_t
@@ -564,6 +1102,7 @@ MasterGraph::timing()
     }
     t.copy_to_output += _convert_time.get_timing();
     t.bb_process_time += _bencode_time.get_timing();
+    t.meta_data_process_time += _meta_data_time.get_timing();
     return t;
 }
 
@@ -584,7 +1123,7 @@ MasterGraph::to_tensor(void *out_ptr, RocalTensorFormat format, float multiplier
     // Copies to the output context given by the user
     unsigned int n = _user_batch_size;
     const size_t c = output_depth();
-    const size_t h = _output_image_info.height_single();
+    const size_t h = _output_height;
     const size_t w = output_width();
     const size_t single_output_image_size = output_byte_size();
 
@@ -991,6 +1530,7 @@ MasterGraph::copy_output(unsigned char *out_ptr, size_t out_size_in_bytes)
 void MasterGraph::output_routine()
 {
     INFO("Output routine started with "+TOSTR(_remaining_count) + " to load");
+    place_output_thread();
     try {
         while (_processing)
         {
@@ -1002,22 +1542,27 @@ void MasterGraph::output_routine()
                 // If the internal process routine ,output_routine(), has finished processing all the images, and last
                 // processed images stored in the _ring_buffer will be consumed by the user when it calls the run() func
                 notify_user_thread();
-                // the following call is required in case the ring buffer is waiting for more data to be loaded and there is no more data to process.
-                _ring_buffer.release_if_empty();
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                // Waits for reset() (next epoch) or stop_processing() instead of polling the loader
+                wait_for_next_epoch();
                 continue;
             }
+            auto cycle_start = std::chrono::steady_clock::now();
             _rb_block_if_full_time.start();
             // _ring_buffer.get_write_buffers() is blocking and blocks here until user uses processed image by calling run() and frees space in the ring_buffer
             auto write_buffers = _ring_buffer.get_write_buffers();
             _rb_block_if_full_time.end();
+            auto output_wait_end = std::chrono::steady_clock::now();
 
             _process_time.start();
 
             // Swap handles on the input image, so that new image is loaded to be processed
             auto load_ret = _loader_module->load_next();
+            // The loader ran out of data for this epoch earlier than its count, handled as the end of data at the top of the loop
+            if (load_ret == LoaderModuleStatus::NO_MORE_DATA_TO_READ)
+                continue;
             if (load_ret != LoaderModuleStatus::OK)
                 THROW("Loader module failed to load next batch of images, status " + TOSTR(load_ret))
+            auto load_end = std::chrono::steady_clock::now();
 
             if (!_processing)
                 break;
@@ -1051,6 +1596,9 @@ void MasterGraph::output_routine()
                 if(node->_is_ssd)
                 {
                     node->set_meta_data(_augmented_meta_data);
+                    if(auto ssd_node = std::dynamic_pointer_cast<SSDRandomCropNode>(node))
+                        ssd_node->set_batch_crop_windows(this_cycle_names, decode_image_info._epoch,
+                                                         ssd_node == _loader_sampled_ssd_node ? crop_image_info._bbox_crop_windows : std::vector<BBoxCropWindow>());
                 }
             }
 
@@ -1059,11 +1607,13 @@ void MasterGraph::output_routine()
             {
                 if (_meta_data_graph)
                 {
+                    _meta_data_time.start();
                     if(_is_random_bbox_crop)
                     {
                         _meta_data_graph->update_random_bbox_meta_data(_augmented_meta_data, decode_image_info, crop_image_info);
                     }
                     _meta_data_graph->process(_augmented_meta_data);
+                    _meta_data_time.end();
                 }
                 if (full_batch_meta_data)
                     full_batch_meta_data->concatenate(_augmented_meta_data);
@@ -1071,6 +1621,14 @@ void MasterGraph::output_routine()
                     full_batch_meta_data = _augmented_meta_data->clone();
             }
             _graph->process();
+            compact_output_images(write_buffers);
+            if(_batch_mixer)
+            {
+                // In place, in the ring buffer slot the batch is handed out from
+                _batch_mixer->process(write_buffers, _output_image_info.batch_size(), _output_width, _output_height, output_depth(),
+                                      _output_image_info.color_format() == RocalColorFormat::RGB_PLANAR, full_batch_meta_data->get_label_batch(),
+                                      (float *)_ring_buffer.get_soft_label_write_buffer());
+            }
             _bencode_time.start();
             if(_is_box_encoder )
             {
@@ -1084,9 +1642,31 @@ void MasterGraph::output_routine()
 #endif
                     _meta_data_graph->update_box_encoder_meta_data(&_anchors, full_batch_meta_data, _criteria, _offset, _scale, _means, _stds);
             }
+            if(_is_keypoint_heatmap)
+            {
+                auto heatmap_write_buffers = _ring_buffer.get_heatmap_write_buffers();
+                _meta_data_graph->update_keypoint_heatmaps(full_batch_meta_data, (float *)heatmap_write_buffers.first, (float *)heatmap_write_buffers.second,
+                                                           _pose_output_width, _pose_output_height, _heatmap_width, _heatmap_height, _pose_sigma, _cpu_num_threads);
+            }
             _bencode_time.end();
             _ring_buffer.set_meta_data(full_batch_image_names, full_batch_meta_data);
+            _processed_batch_count++;
+            if (_track_state)
+            {
+                auto state = current_state();
+                std::unique_lock<std::mutex> lock(_state_lock);
+                _batch_states.push_back(std::move(state));
+            }
             _ring_buffer.push(); // Image data and metadata is now stored in output the ring_buffer, increases it's level by 1
+            // the batch pushed might only be the one the user holds after the first run(), or stay behind leased ones
+            if(next_output_ready())
+                signal_output_ready();
+            if (_autotuner)
+            {
+                std::chrono::duration<double> output_wait = output_wait_end - cycle_start, load_wait = load_end - output_wait_end,
+                                              process = std::chrono::steady_clock::now() - load_end;
+                autotune(output_wait.count(), load_wait.count(), process.count());
+            }
         }
         _process_time.end();
 
@@ -1096,6 +1676,7 @@ void MasterGraph::output_routine()
         ERR("Exception thrown in the process routine: " + STR(e.what()) + STR("\n"));
         _processing = false;
         _ring_buffer.release_all_blocked_calls();
+        signal_output_ready();
     }
 }
 
@@ -1104,6 +1685,7 @@ void MasterGraph::output_routine_video()
 {
     _process_time.start();
     INFO("Output routine of video pipeline started with "+TOSTR(_remaining_count) + " to load");
+    place_output_thread();
     try {
         while (_processing)
         {
@@ -1115,9 +1697,8 @@ void MasterGraph::output_routine_video()
                 // If the internal process routine ,output_routine_video(), has finished processing all the images, and last
                 // processed images stored in the _ring_buffer will be consumed by the user when it calls the run() func
                 notify_user_thread();
-                // the following call is required in case the ring buffer is waiting for more data to be loaded and there is no more data to process.
-                _ring_buffer.release_if_empty();
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                // Waits for reset() (next epoch) or stop_processing() instead of polling the loader
+                wait_for_next_epoch();
                 continue;
             }
 
@@ -1172,7 +1753,9 @@ void MasterGraph::output_routine_video()
             {
                 if (_meta_data_graph)
                 {
+                    _meta_data_time.start();
                     _meta_data_graph->process(_augmented_meta_data);
+                    _meta_data_time.end();
                 }
                 if (full_batch_meta_data)
                     full_batch_meta_data->concatenate(_augmented_meta_data);
@@ -1186,6 +1769,9 @@ void MasterGraph::output_routine_video()
             }
             _ring_buffer.set_meta_data(full_batch_image_names, full_batch_meta_data);
             _ring_buffer.push(); // Image data and metadata is now stored in output the ring_buffer, increases it's level by 1
+            // the batch pushed might only be the one the user holds after the first run(), or stay behind leased ones
+            if(next_output_ready())
+                signal_output_ready();
         }
     }
     catch (const std::exception &e)
@@ -1193,14 +1779,32 @@ void MasterGraph::output_routine_video()
         ERR("Exception thrown in the process routine: " + STR(e.what()) + STR("\n"));
         _processing = false;
         _ring_buffer.release_all_blocked_calls();
+        signal_output_ready();
     }
     _process_time.end();
 }
 #endif
 
+void MasterGraph::set_processing(bool processing)
+{
+    {
+        std::unique_lock<std::mutex> lock(_epoch_lock);
+        _processing = processing;
+    }
+    _epoch_cv.notify_all();
+}
+
+void MasterGraph::wait_for_next_epoch()
+{
+    std::unique_lock<std::mutex> lock(_epoch_lock);
+    _output_routine_parked = true;
+    _epoch_cv.wait(lock, [this]() { return !_processing || !_output_routine_parked; });
+    _output_routine_parked = false;
+}
+
 void MasterGraph::start_processing()
 {
-    _processing = true;
+    set_processing(true);
 #ifdef ROCAL_VIDEO
     if(_is_video_loader)
     {
@@ -1230,7 +1834,7 @@ void MasterGraph::start_processing()
 
 void MasterGraph::stop_processing()
 {
-    _processing = false;
+    set_processing(false);
     _ring_buffer.unblock_reader();
     _ring_buffer.unblock_writer();
     if(_output_thread.joinable())
@@ -1244,6 +1848,9 @@ MetaDataBatch * MasterGraph::create_coco_meta_data_reader(const char *source_pat
     MetaDataConfig config(label_type, reader_type, source_path, std::map<std::string, std::string>(), std::string());
     config.set_out_img_width(pose_output_width);
     config.set_out_img_height(pose_output_height);
+    _pose_sigma = sigma;
+    _pose_output_width = pose_output_width;
+    _pose_output_height = pose_output_height;
     _meta_data_graph = create_meta_data_graph(config);
     _meta_data_reader = create_meta_data_reader(config);
     _meta_data_reader->init(config);
@@ -1327,12 +1934,68 @@ MetaDataBatch * MasterGraph::create_mxnet_label_reader(const char *source_path,
     return _meta_data_reader->get_output();
 }
 
+MetaDataBatch * MasterGraph::create_synthetic_meta_data_reader(const SyntheticDataConfig &synthetic_config, MetaDataType label_type, bool is_output)
+{
+    if( _meta_data_reader)
+        THROW("A metadata reader has already been created")
+    MetaDataConfig config(label_type, MetaDataReaderType::SYNTHETIC_META_DATA_READER, "");
+    config.set_synthetic_data_config(synthetic_config);
+    _meta_data_graph = create_meta_data_graph(config);
+    _meta_data_reader = create_meta_data_reader(config);
+    _meta_data_reader->init(config);
+    _meta_data_reader->read_all("");
+    if(is_output)
+    {
+        if (_augmented_meta_data)
+            THROW("Metadata output already defined, there can only be a single output for metadata augmentation")
+        else
+            _augmented_meta_data = _meta_data_reader->get_output();
+    }
+    return _meta_data_reader->get_output();
+}
+
+MetaDataBatch * MasterGraph::create_tar_shard_meta_data_reader(const char *source_path, MetaDataType label_type, bool is_output)
+{
+    if( _meta_data_reader)
+        THROW("A metadata reader has already been created")
+    MetaDataConfig config(label_type, MetaDataReaderType::TAR_SHARD_META_DATA_READER, source_path);
+    _meta_data_graph = create_meta_data_graph(config);
+    _meta_data_reader = create_meta_data_reader(config);
+    _meta_data_reader->init(config);
+    _meta_data_reader->read_all(source_path);
+    if(is_output)
+    {
+        if (_augmented_meta_data)
+            THROW("Metadata output already defined, there can only be a single output for metadata augmentation")
+        else
+            _augmented_meta_data = _meta_data_reader->get_output();
+    }
+    return _meta_data_reader->get_output();
+}
+
+MetaDataBatch * MasterGraph::create_service_meta_data_reader(const std::string &segment, MetaDataType label_type)
+{
+    if( _meta_data_reader)
+        THROW("A metadata reader has already been created")
+    MetaDataConfig config(label_type, MetaDataReaderType::SERVICE_META_DATA_READER, segment);
+    _meta_data_graph = create_meta_data_graph(config);
+    _meta_data_reader = create_meta_data_reader(config);
+    _meta_data_reader->init(config);
+    _meta_data_reader->read_all(segment);
+    if (_augmented_meta_data)
+        THROW("Metadata output already defined, there can only be a single output for metadata augmentation")
+    else
+        _augmented_meta_data = _meta_data_reader->get_output();
+    return _meta_data_reader->get_output();
+}
+
 void MasterGraph::create_randombboxcrop_reader(RandomBBoxCrop_MetaDataReaderType reader_type, RandomBBoxCrop_MetaDataType label_type, bool all_boxes_overlap, bool no_crop, FloatParam* aspect_ratio, bool has_shape, int crop_width, int crop_height, int num_attempts, FloatParam* scaling, int total_num_attempts, int64_t seed)
 {
     if( _randombboxcrop_meta_data_reader)
         THROW("A metadata reader has already been created")
     _is_random_bbox_crop = true;
-    RandomBBoxCrop_MetaDataConfig config(label_type, reader_type, all_boxes_overlap, no_crop, aspect_ratio, has_shape, crop_width, crop_height, num_attempts, scaling, total_num_attempts, seed);
+    RandomBBoxCrop_MetaDataConfig config(label_type, reader_type, all_boxes_overlap, no_crop, aspect_ratio, has_shape, crop_width, crop_height, num_attempts, scaling,
+                                         total_num_attempts, seed, _cpu_num_threads);
     _randombboxcrop_meta_data_reader = create_meta_data_reader(config);
     _randombboxcrop_meta_data_reader->set_meta_data(_meta_data_reader);
     if (_random_bbox_crop_cords_data)
@@ -1361,6 +2024,30 @@ void MasterGraph::box_encoder(std::vector<float> &anchors, float criteria, const
     _stds = stds;
 }
 
+void MasterGraph::keypoint_heatmaps(unsigned heatmap_width, unsigned heatmap_height)
+{
+    if(!_meta_data_reader || _meta_data_reader->get_output() == nullptr || !_meta_data_graph || _pose_output_width == 0 || _pose_output_height == 0)
+        THROW("Key point heatmaps need the COCO key points reader to be created first, with the pose output size")
+    if(_pose_sigma <= 0 || heatmap_width == 0 || heatmap_height == 0)
+        THROW("Key point heatmaps need a positive sigma and heatmap size")
+    _is_keypoint_heatmap = true;
+    _heatmap_width = heatmap_width;
+    _heatmap_height = heatmap_height;
+}
+
+void MasterGraph::batch_mix(BatchMixMode mode, unsigned num_classes, float alpha, float probability, float label_smoothing)
+{
+    if(!_meta_data_reader || _meta_data_reader->get_output() == nullptr)
+        THROW("Batch mixing needs a label reader to be created first")
+    if(_is_video_loader)
+        THROW("Batch mixing is not supported for the video loader")
+    if(mode != BatchMixMode::NONE && _affinity == RocalAffinity::GPU)
+        THROW("MixUp and CutMix are only supported when the augmentations run on the CPU")
+    _batch_mixer = std::make_unique<BatchMixer>(mode, num_classes, alpha, probability, label_smoothing,
+                                                ParameterFactory::instance()->get_seed(), ParameterFactory::instance()->next_stream());
+    _batch_mixer->set_num_threads(_cpu_num_threads);
+}
+
 MetaDataBatch * MasterGraph::create_caffe2_lmdb_record_meta_data_reader(const char *source_path, MetaDataReaderType reader_type , MetaDataType label_type)
 {
     if( _meta_data_reader)
@@ -1416,6 +2103,48 @@ const std::pair<ImageNameBatch,pMetaDataBatch>& MasterGraph::meta_data()
     return _ring_buffer.get_meta_data();
 }
 
+uint64_t MasterGraph::acquire_output_batch()
+{
+    if(!_processing || _first_run)
+        THROW("Output batch can only be acquired after a successful call to run()")
+    if(no_more_processed_data())
+        THROW("No output batch left to acquire")
+    _ring_buffer.block_if_empty();
+    return _ring_buffer.acquire_read_slot();
+}
+
+void MasterGraph::release_output_batch(uint64_t lease)
+{
+    _ring_buffer.release_read_slot(lease);
+}
+
+std::vector<void*> MasterGraph::output_batch_buffers(uint64_t lease)
+{
+    return _ring_buffer.get_leased_buffers(lease);
+}
+
+const std::pair<ImageNameBatch,pMetaDataBatch>& MasterGraph::output_batch_meta_data(uint64_t lease)
+{
+    return _ring_buffer.get_leased_meta_data(lease);
+}
+
+std::pair<void*, void*> MasterGraph::output_batch_heatmaps(uint64_t lease)
+{
+    return _ring_buffer.get_leased_heatmap_buffers(lease);
+}
+
+void* MasterGraph::output_batch_soft_labels(uint64_t lease)
+{
+    return _ring_buffer.get_leased_soft_label_buffer(lease);
+}
+
+std::pair<void*, void*> MasterGraph::output_batch_encoded_boxes(uint64_t lease)
+{
+    if(!_is_box_encoder)
+        return std::make_pair(nullptr, nullptr);
+    return _ring_buffer.get_leased_box_encode_buffers(lease);
+}
+
 size_t MasterGraph::bounding_box_batch_count(int *buf, pMetaDataBatch meta_data_batch)
 {
     size_t size = 0;
@@ -1448,6 +2177,10 @@ void MasterGraph::notify_user_thread()
         return;
     LOG("Output routine finished processing all images, no more image to be processed")
     _output_routine_finished_processing = true;
+    // the user thread might be waiting for more data to be processed and there is no more data to process,
+    // the ring buffer does not block anymore till it is reset for the next epoch
+    _ring_buffer.release_all_blocked_calls();
+    signal_output_ready();
 }
 
 bool MasterGraph::no_more_processed_data()
@@ -1465,7 +2198,7 @@ MasterGraph::copy_out_tensor_planar(void *out_ptr, RocalTensorFormat format, flo
     _convert_time.start();
     // Copies to the output context given by the user, each image is copied separate for planar
     const size_t w = output_width();
-    const size_t h = _output_image_info.height_single();
+    const size_t h = _output_height;
     const size_t c = output_depth();
     const size_t n = _output_image_info.batch_size();
 
@@ -1626,3 +2359,23 @@ MasterGraph::get_bbox_encoded_buffers(float **boxes_buf_ptr, int **labels_buf_pt
     }
     return Status::OK;
 }
+
+MasterGraph::Status
+MasterGraph::get_keypoint_heatmap_buffers(float **heatmaps_buf_ptr, float **target_weights_buf_ptr)
+{
+    if (!_is_keypoint_heatmap)
+        THROW("Key point heatmaps are not generated, rocalKeyPointHeatmaps() should be called before building the pipeline")
+    auto heatmaps_and_weights = _ring_buffer.get_heatmap_read_buffers();
+    *heatmaps_buf_ptr = (float *) heatmaps_and_weights.first;
+    *target_weights_buf_ptr = (float *) heatmaps_and_weights.second;
+    return Status::OK;
+}
+
+MasterGraph::Status
+MasterGraph::get_soft_label_buffer(float **soft_labels_buf_ptr)
+{
+    if (!_batch_mixer)
+        THROW("Soft labels are not generated, rocalBatchMix() should be called before building the pipeline")
+    *soft_labels_buf_ptr = (float *) _ring_buffer.get_soft_label_read_buffer();
+    return Status::OK;
+}
@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <thread>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <dirent.h>
+#include <sched.h>
+#include "numa_topology.h"
+#include "commons.h"
+
+NumaTopology::NumaTopology()
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
+#else
+    const std::string node_path = "/sys/devices/system/node/";
+    DIR *node_dir = opendir(node_path.c_str());
+    if (node_dir)
+    {
+        struct dirent *entity;
+        while ((entity = readdir(node_dir)) != nullptr)
+        {
+            std::string name = entity->d_name;
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 || name.find_first_not_of("0123456789", 4) != std::string::npos)
+                continue;
+            std::ifstream cpu_list_file(node_path + name + "/cpulist");
+            std::string cpu_list;
+            if (!std::getline(cpu_list_file, cpu_list))
+                continue;
+            auto cpus = parse_cpu_list(cpu_list);
+            // Memory only nodes have no CPUs to run the threads on
+            if (!cpus.empty())
+                _node_cpus[std::stoi(name.substr(4))] = cpus;
+        }
+        closedir(node_dir);
+    }
+#endif
+    if (_node_cpus.empty())
+    {
+        std::vector<unsigned> cpus(std::max(std::thread::hardware_concurrency(), 1u));
+        for (unsigned cpu = 0; cpu < cpus.size(); cpu++)
+            cpus[cpu] = cpu;
+        _node_cpus[0] = cpus;
+    }
+    LOG("NUMA topology: " + TOSTR(_node_cpus.size()) + " node(s)")
+}
+
+std::vector<int> NumaTopology::nodes() const
+{
+    std::vector<int> nodes;
+    for (auto &node_cpus : _node_cpus)
+        nodes.push_back(node_cpus.first);
+    return nodes;
+}
+
+const std::vector<unsigned> &NumaTopology::cpus(int node) const
+{
+    auto it = _node_cpus.find(node);
+    if (it == _node_cpus.end())
+        THROW("NUMA node " + TOSTR(node) + " does not exist on this host")
+    return it->second;
+}
+
+int NumaTopology::current_node() const
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
+    return _node_cpus.begin()->first;
+#else
+    int cpu = sched_getcpu();
+    for (auto &node_cpus : _node_cpus)
+        for (auto node_cpu : node_cpus.second)
+            if ((int)node_cpu == cpu)
+                return node_cpus.first;
+    return _node_cpus.begin()->first;
+#endif
+}
+
+bool NumaTopology::bind_current_thread(const std::vector<unsigned> &cpus)
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
+    return false;
+#else
+    cpu_set_t cpu_mask;
+    CPU_ZERO(&cpu_mask);
+    for (auto cpu : cpus)
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &cpu_mask);
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_mask);
+    if (ret != 0)
+        WRN("Error calling pthread_setaffinity_np: " + TOSTR(ret))
+    return ret == 0;
+#endif
+}
+
+std::vector<unsigned> NumaTopology::parse_cpu_list(const std::string &cpu_list)
+{
+    std::vector<unsigned> cpus;
+    std::stringstream ranges(cpu_list);
+    std::string range;
+    while (std::getline(ranges, range, ','))
+    {
+        if (range.find_first_of("0123456789") == std::string::npos)
+            continue;
+        auto dash = range.find('-');
+        unsigned first = std::stoul(range.substr(0, dash));
+        unsigned last = (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+        for (unsigned cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <iterator>
+#include "pipeline_autotuner.h"
+#include "commons.h"
+
+std::string AutotuneConfig::to_string() const
+{
+    return "decode threads " + TOSTR(decode_threads) + ", graph threads " + TOSTR(graph_threads) + ", prefetch depth " + TOSTR(prefetch_depth);
+}
+
+PipelineAutotuner::PipelineAutotuner(const AutotuneConfig &initial, const AutotuneConfig &max, size_t tuning_batch_count):
+_config(initial),
+_best(initial),
+_max(max),
+_tuning_batch_count(tuning_batch_count)
+{
+}
+
+size_t &
+PipelineAutotuner::knob_value(AutotuneConfig &config, Knob knob)
+{
+    switch(knob)
+    {
+        case Knob::DECODE_THREADS: return config.decode_threads;
+        case Knob::PREFETCH_DEPTH: return config.prefetch_depth;
+        default: return config.graph_threads;
+    }
+}
+
+bool
+PipelineAutotuner::add_batch(double output_wait, double load_wait, double process)
+{
+    if(_done)
+        return false;
+    _batch_count++;
+    if(_settle_count)
+    {
+        _settle_count--;
+        return false;
+    }
+    _window_output_wait += output_wait;
+    _window_load_wait += load_wait;
+    _window_process += process;
+    if(++_window_batch_count < WINDOW_BATCH_COUNT)
+        return false;
+    return end_window();
+}
+
+bool
+PipelineAutotuner::raise(Knob knob)
+{
+    auto idx = static_cast<size_t>(knob);
+    size_t &value = knob_value(_config, knob);
+    const size_t max_value = knob_value(_max, knob);
+    if(_exhausted[idx] || value >= max_value)
+    {
+        _exhausted[idx] = true;
+        return false;
+    }
+    // Threads are raised by a quarter so that large machines are covered within the tuning batches, prefetch depth one batch at a time
+    const size_t step = (knob == Knob::PREFETCH_DEPTH) ? 1 : std::max<size_t>(1, value / 4);
+    value = std::min(value + step, max_value);
+    _trial = true;
+    _trial_knob = knob;
+    return true;
+}
+
+bool
+PipelineAutotuner::end_window()
+{
+    const double total = _window_output_wait + _window_load_wait + _window_process;
+    const double rate = total > 0 ? _window_batch_count / total : 0;
+    const double output_share = total > 0 ? _window_output_wait / total : 0;
+    const double load_share = total > 0 ? _window_load_wait / total : 0;
+    const double process_share = total > 0 ? _window_process / total : 0;
+    _window_batch_count = 0;
+    _window_output_wait = _window_load_wait = _window_process = 0;
+
+    const AutotuneConfig previous = _config;
+    if(!_trial || rate > _best_rate * (1 + MIN_GAIN))
+    {
+        // The bottleneck may have moved, the knobs that did not help before get another try
+        if(_trial)
+            std::fill(std::begin(_exhausted), std::end(_exhausted), false);
+        _best = _config;
+        _best_rate = rate;
+        _best_output_share = output_share;
+        _best_load_share = load_share;
+        _best_process_share = process_share;
+    }
+    else
+    {
+        _config = _best;
+        _exhausted[static_cast<size_t>(_trial_knob)] = true;
+    }
+    _trial = false;
+
+    if(_batch_count >= _tuning_batch_count || _best_output_share > CONSUMER_BOUND_SHARE)
+    {
+        _done = true;
+    }
+    else
+    {
+        const bool loader_bound = _best_load_share >= _best_process_share;
+        const Knob order[KNOB_COUNT] = { loader_bound ? Knob::DECODE_THREADS : Knob::GRAPH_THREADS,
+                                         loader_bound ? Knob::PREFETCH_DEPTH : Knob::DECODE_THREADS,
+                                         loader_bound ? Knob::GRAPH_THREADS : Knob::PREFETCH_DEPTH };
+        bool raised = false;
+        for(auto knob: order)
+            if((raised = raise(knob)))
+                break;
+        _done = !raised;
+    }
+    if(_config == previous)
+        return false;
+    _settle_count = SETTLE_BATCH_COUNT;
+    return true;
+}
@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <numeric>
+#include "pipeline_state.h"
+#include "commons.h"
+
+namespace
+{
+constexpr uint32_t STATE_MAGIC = 0x534C4352;//!< "RCLS"
+constexpr uint32_t STATE_VERSION = 1;
+
+class StateWriter
+{
+public:
+    template<typename T> void put(T value)
+    {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(&value);
+        _data.insert(_data.end(), bytes, bytes + sizeof(T));
+    }
+    std::vector<unsigned char> &data() { return _data; }
+private:
+    std::vector<unsigned char> _data;
+};
+
+class StateReader
+{
+public:
+    StateReader(const unsigned char *data, size_t size): _data(data), _size(size) {}
+    template<typename T> T get()
+    {
+        if(_offset + sizeof(T) > _size)
+            THROW("Truncated pipeline state, " + TOSTR(_size) + " bytes")
+        T value;
+        memcpy(&value, _data + _offset, sizeof(T));
+        _offset += sizeof(T);
+        return value;
+    }
+    //! Element counts are checked against the bytes left, so that a corrupted count does not allocate
+    uint64_t get_count(size_t element_size)
+    {
+        auto count = get<uint64_t>();
+        if(count > (_size - _offset) / element_size)
+            THROW("Corrupted pipeline state, " + TOSTR(count) + " elements")
+        return count;
+    }
+    bool done() const { return _offset == _size; }
+private:
+    const unsigned char *_data;
+    size_t _size;
+    size_t _offset = 0;
+};
+}
+
+size_t PipelineState::epoch_sample_offset(size_t batch_size) const
+{
+    return std::accumulate(loader.shard_batch_counts.begin(), loader.shard_batch_counts.end(), (size_t)0) * batch_size;
+}
+
+std::vector<unsigned char> PipelineState::serialize() const
+{
+    StateWriter writer;
+    writer.put<uint32_t>(STATE_MAGIC);
+    writer.put<uint32_t>(STATE_VERSION);
+    writer.put<uint64_t>(seed);
+    writer.put<uint64_t>(batch_count);
+    writer.put<uint64_t>(loader.epoch);
+    writer.put<uint64_t>(loader.shard_idx);
+    writer.put<uint64_t>(loader.shard_batch_counts.size());
+    for(size_t i = 0; i < loader.shard_batch_counts.size(); i++)
+    {
+        writer.put<uint64_t>(loader.shard_batch_counts[i]);
+        writer.put<uint64_t>(loader.shard_total_batch_counts[i]);
+    }
+    writer.put<uint64_t>(parameter_draws.size());
+    for(auto &draws: parameter_draws)
+    {
+        writer.put<uint32_t>(draws.first);
+        writer.put<uint64_t>(draws.second);
+    }
+    return std::move(writer.data());
+}
+
+PipelineState PipelineState::deserialize(const unsigned char *data, size_t size)
+{
+    if(!data)
+        THROW("Null pipeline state")
+    StateReader reader(data, size);
+    if(reader.get<uint32_t>() != STATE_MAGIC)
+        THROW("Not a rocAL pipeline state")
+    auto version = reader.get<uint32_t>();
+    if(version != STATE_VERSION)
+        THROW("Unsupported pipeline state version " + TOSTR(version))
+    PipelineState state;
+    state.seed = reader.get<uint64_t>();
+    state.batch_count = reader.get<uint64_t>();
+    state.loader.epoch = reader.get<uint64_t>();
+    state.loader.shard_idx = reader.get<uint64_t>();
+    auto shard_count = reader.get_count(2 * sizeof(uint64_t));
+    for(uint64_t i = 0; i < shard_count; i++)
+    {
+        state.loader.shard_batch_counts.push_back(reader.get<uint64_t>());
+        state.loader.shard_total_batch_counts.push_back(reader.get<uint64_t>());
+    }
+    auto parameter_count = reader.get_count(sizeof(uint32_t) + sizeof(uint64_t));
+    for(uint64_t i = 0; i < parameter_count; i++)
+    {
+        auto stream = reader.get<uint32_t>();
+        state.parameter_draws.emplace_back(stream, reader.get<uint64_t>());
+    }
+    if(!reader.done())
+        THROW("Unexpected data at the end of the pipeline state")
+    return state;
+}
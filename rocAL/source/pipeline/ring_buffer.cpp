@@ -20,46 +20,62 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
+#include <cstring>
+#include <algorithm>
 #include <device_manager.h>
 #include "ring_buffer.h"
 
 RingBuffer::RingBuffer(unsigned buffer_depth):
+        _meta_ring_buffer(buffer_depth),
         BUFF_DEPTH(buffer_depth),
+        _slots(buffer_depth),
         _dev_sub_buffer(buffer_depth),
         _host_master_buffers(buffer_depth),
         _dev_bbox_buffer(buffer_depth),
-        _dev_labels_buffer(buffer_depth)
+        _dev_labels_buffer(buffer_depth),
+        _slot_leases(buffer_depth)
 {
     reset();
 }
 void RingBuffer::block_if_empty()
 {
-    std::unique_lock<std::mutex> lock(_lock);
-    if(empty())
-    { // if the current read buffer is being written wait on it
-        if(_dont_block)
-            return;
-        _wait_for_load.wait(lock);
+    if(_lease_count.load(std::memory_order_acquire) == 0)
+    {
+        _slots.wait_until_readable();
+        return;
     }
+    size_t position;
+    {
+        std::unique_lock<std::mutex> lock(_lease_lock);
+        // the producer can't write to the slots popped by the user while they are leased
+        if(_popped_leased >= BUFF_DEPTH - 1)
+            THROW("All the output batches are held by exported views, release them or increase the prefetch queue depth")
+        position = _slots.read_position() + _popped_leased;
+    }
+    // if the current read buffer is being written wait on it, returns right away after release_all_blocked_calls()
+    _slots.wait_until_readable(position);
+}
+
+size_t RingBuffer::read_slot()
+{
+    if(_lease_count.load(std::memory_order_acquire) == 0)
+        return _slots.read_index();
+    std::unique_lock<std::mutex> lock(_lease_lock);
+    return (_slots.read_position() + _popped_leased) % BUFF_DEPTH;
 }
 
 void RingBuffer:: block_if_full()
 {
-    std::unique_lock<std::mutex> lock(_lock);
     // Write the whole buffer except for the last spot which is being read by the reader thread
-    if(full())
-    {
-        if(_dont_block)
-            return;
-        _wait_for_unload.wait(lock);
-    }
+    _slots.wait_until_writable();
 }
 std::vector<void*> RingBuffer::get_read_buffers()
 {
     block_if_empty();
+    auto slot = read_slot();
     if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
-        return _dev_sub_buffer[_read_ptr];
-    return _host_sub_buffers[_read_ptr];
+        return _dev_sub_buffer[slot];
+    return _host_sub_buffers[slot];
 }
 
 void *RingBuffer::get_host_master_read_buffer() {
@@ -67,45 +83,77 @@ void *RingBuffer::get_host_master_read_buffer() {
     if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
         return nullptr;
 
-    return _host_master_buffers[_read_ptr];
+    return _host_master_buffers[read_slot()];
 }
 
 
 std::pair<void*, void*> RingBuffer::get_box_encode_read_buffers()
 {
     block_if_empty();
+    auto slot = read_slot();
     if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
-        return std::make_pair(_dev_bbox_buffer[_read_ptr], _dev_labels_buffer[_read_ptr]);
+        return std::make_pair(_dev_bbox_buffer[slot], _dev_labels_buffer[slot]);
     return std::make_pair(nullptr, nullptr);   // todo:: implement the same scheme for host as well
 }
 
+std::pair<void*, void*> RingBuffer::get_heatmap_read_buffers()
+{
+    block_if_empty();
+    if(_host_heatmap_buffer.empty())
+        return std::make_pair(nullptr, nullptr);
+    auto slot = read_slot();
+    return std::make_pair(_host_heatmap_buffer[slot], _host_target_weight_buffer[slot]);
+}
+
+void* RingBuffer::get_soft_label_read_buffer()
+{
+    block_if_empty();
+    if(_host_soft_label_buffer.empty())
+        return nullptr;
+    return _host_soft_label_buffer[read_slot()];
+}
+
 std::vector<void*> RingBuffer::get_write_buffers()
 {
     block_if_full();
     if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
-        return _dev_sub_buffer[_write_ptr];
+        return _dev_sub_buffer[_slots.write_index()];
 
-    return _host_sub_buffers[_write_ptr];
+    return _host_sub_buffers[_slots.write_index()];
 }
 
 std::pair<void*, void*> RingBuffer::get_box_encode_write_buffers()
 {
     block_if_full();
     if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
-        return std::make_pair(_dev_bbox_buffer[_write_ptr], _dev_labels_buffer[_write_ptr]);
+        return std::make_pair(_dev_bbox_buffer[_slots.write_index()], _dev_labels_buffer[_slots.write_index()]);
     return std::make_pair(nullptr, nullptr); 
 }
+std::pair<void*, void*> RingBuffer::get_heatmap_write_buffers()
+{
+    block_if_full();
+    if(_host_heatmap_buffer.empty())
+        return std::make_pair(nullptr, nullptr);
+    return std::make_pair(_host_heatmap_buffer[_slots.write_index()], _host_target_weight_buffer[_slots.write_index()]);
+}
+
+void* RingBuffer::get_soft_label_write_buffer()
+{
+    block_if_full();
+    if(_host_soft_label_buffer.empty())
+        return nullptr;
+    return _host_soft_label_buffer[_slots.write_index()];
+}
+
 void RingBuffer::unblock_reader()
 {
     // Wake up the reader thread in case it's waiting for a load
-    _wait_for_load.notify_all();
+    _slots.interrupt_reader();
 }
 
 void RingBuffer::release_all_blocked_calls()
 {
-    _dont_block = true;
-    unblock_reader();
-    unblock_writer();
+    _slots.release_all_waits();
 }
 
 void RingBuffer::release_if_empty()
@@ -116,7 +164,7 @@ void RingBuffer::release_if_empty()
 void RingBuffer::unblock_writer()
 {
     // Wake up the writer thread in case it's waiting for an unload
-    _wait_for_unload.notify_all();
+    _slots.interrupt_writer();
 }
 
 void RingBuffer::init(RocalMemType mem_type, void *devres, unsigned sub_buffer_size, unsigned sub_buffer_count)
@@ -205,6 +253,14 @@ void RingBuffer::init(RocalMemType mem_type, void *devres, unsigned sub_buffer_s
 #endif    
 }
 
+void RingBuffer::first_touch()
+{
+    if(_mem_type != RocalMemType::HOST)
+        return;
+    for(size_t buffIdx = 0; buffIdx < BUFF_DEPTH; buffIdx++)
+        memset(_host_master_buffers[buffIdx], 0, _sub_buffer_size * _sub_buffer_count);
+}
+
 void RingBuffer::initBoxEncoderMetaData(RocalMemType mem_type, size_t encoded_bbox_size, size_t encoded_labels_size)
 {
 #if ENABLE_HIP
@@ -261,32 +317,173 @@ void RingBuffer::initBoxEncoderMetaData(RocalMemType mem_type, size_t encoded_bb
 #endif
 }
 
+void RingBuffer::initKeyPointHeatmapMetaData(size_t heatmaps_size, size_t target_weights_size)
+{
+    // Generated on the CPU by the output routine, the user copies them to the device together with the images if needed
+    _host_heatmap_buffer.resize(BUFF_DEPTH);
+    _host_target_weight_buffer.resize(BUFF_DEPTH);
+    for(size_t buffIdx = 0; buffIdx < BUFF_DEPTH; buffIdx++)
+    {
+        _host_heatmap_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (heatmaps_size / MEM_ALIGNMENT + 1));
+        _host_target_weight_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (target_weights_size / MEM_ALIGNMENT + 1));
+        if(!_host_heatmap_buffer[buffIdx] || !_host_target_weight_buffer[buffIdx])
+            THROW("Allocating the key point heatmap buffers of size " + TOSTR(heatmaps_size) + " failed")
+    }
+}
+
+void RingBuffer::initSoftLabelMetaData(size_t soft_labels_size)
+{
+    _host_soft_label_buffer.resize(BUFF_DEPTH);
+    for(size_t buffIdx = 0; buffIdx < BUFF_DEPTH; buffIdx++)
+    {
+        _host_soft_label_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (soft_labels_size / MEM_ALIGNMENT + 1));
+        if(!_host_soft_label_buffer[buffIdx])
+            THROW("Allocating the soft label buffers of size " + TOSTR(soft_labels_size) + " failed")
+    }
+}
+
 void RingBuffer::push()
 {
-    // pushing and popping to and from image and metadata buffer should be atomic so that their level stays the same at all times
-    std::unique_lock<std::mutex> lock(_names_buff_lock);
-    _meta_ring_buffer.push(_last_image_meta_data);
-    increment_write_ptr();
+    // The metadata is stored in the same slot as the images by set_meta_data(), publishing the slot makes both visible to the reader
+    _slots.commit_write();
 }
 
 void RingBuffer::pop()
 {
-    if(empty())
+    if(_lease_count.load(std::memory_order_acquire) == 0)
+    {
+        if(_slots.empty())
+            return;
+        // Release the metadata of the slot so the batch does not outlive its use by the user
+        _meta_ring_buffer[_slots.read_index()] = MetaDataNamePair();
+        _slots.commit_read();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(_lease_lock);
+    if(_slots.level() <= _popped_leased)
+        return;
+    _popped_leased++;
+    release_popped_slots();
+}
+
+void RingBuffer::release_popped_slots()
+{
+    // Slots are handed back to the producer in order, a leased slot holds back the ones popped after it
+    while(_popped_leased > 0 && _slot_leases[_slots.read_index()].empty())
+    {
+        // Release the metadata of the slot so the batch does not outlive its use by the user
+        _meta_ring_buffer[_slots.read_index()] = MetaDataNamePair();
+        _slots.commit_read();
+        _popped_leased--;
+    }
+}
+
+uint64_t RingBuffer::acquire_read_slot()
+{
+    std::unique_lock<std::mutex> lock(_lease_lock);
+    if(_slots.level() <= _popped_leased)
+        THROW("No output batch available to acquire, run() should be called first")
+    auto slot = (_slots.read_position() + _popped_leased) % BUFF_DEPTH;
+    auto generation = ++_lease_generation;
+    _slot_leases[slot].push_back(generation);
+    _lease_count.fetch_add(1, std::memory_order_acq_rel);
+    return (static_cast<uint64_t>(generation) << 32) | slot;
+}
+
+// Returns the position of the lease in the list of its slot, or the size of the list when the lease was released already
+static size_t find_lease(const std::vector<uint32_t>& slot_leases, uint64_t lease)
+{
+    auto generation = static_cast<uint32_t>(lease >> 32);
+    size_t idx = 0;
+    while(idx < slot_leases.size() && slot_leases[idx] != generation)
+        idx++;
+    return idx;
+}
+
+void RingBuffer::release_read_slot(uint64_t lease)
+{
+    std::unique_lock<std::mutex> lock(_lease_lock);
+    auto slot = static_cast<size_t>(lease & 0xFFFFFFFF);
+    if(slot >= BUFF_DEPTH)
+        return;
+    auto& slot_leases = _slot_leases[slot];
+    auto idx = find_lease(slot_leases, lease);
+    // Released twice, or the slot has been handed back and written again since
+    if(idx == slot_leases.size())
         return;
-    // pushing and popping to and from image and metadata buffer should be atomic so that their level stays the same at all times
-    std::unique_lock<std::mutex> lock(_names_buff_lock);
-    increment_read_ptr();
-    _meta_ring_buffer.pop();
+    slot_leases.erase(slot_leases.begin() + idx);
+    release_popped_slots();
+    // Last, so that the consumer seeing no lease left also sees the popped slots handed back
+    _lease_count.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+size_t RingBuffer::leased_slot(uint64_t lease)
+{
+    std::unique_lock<std::mutex> lock(_lease_lock);
+    auto slot = static_cast<size_t>(lease & 0xFFFFFFFF);
+    if(slot >= BUFF_DEPTH || find_lease(_slot_leases[slot], lease) == _slot_leases[slot].size())
+        THROW("Output batch lease is not valid anymore, it has been released")
+    return slot;
+}
+
+std::vector<void*> RingBuffer::get_leased_buffers(uint64_t lease)
+{
+    auto slot = leased_slot(lease);
+    if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
+        return _dev_sub_buffer[slot];
+    return _host_sub_buffers[slot];
+}
+
+std::pair<void*, void*> RingBuffer::get_leased_box_encode_buffers(uint64_t lease)
+{
+    auto slot = leased_slot(lease);
+    if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
+        return std::make_pair(_dev_bbox_buffer[slot], _dev_labels_buffer[slot]);
+    return std::make_pair(nullptr, nullptr);
+}
+
+std::pair<void*, void*> RingBuffer::get_leased_heatmap_buffers(uint64_t lease)
+{
+    auto slot = leased_slot(lease);
+    if(_host_heatmap_buffer.empty())
+        return std::make_pair(nullptr, nullptr);
+    return std::make_pair(_host_heatmap_buffer[slot], _host_target_weight_buffer[slot]);
+}
+
+void* RingBuffer::get_leased_soft_label_buffer(uint64_t lease)
+{
+    auto slot = leased_slot(lease);
+    if(_host_soft_label_buffer.empty())
+        return nullptr;
+    return _host_soft_label_buffer[slot];
+}
+
+MetaDataNamePair& RingBuffer::get_leased_meta_data(uint64_t lease)
+{
+    return _meta_ring_buffer[leased_slot(lease)];
 }
 
 void RingBuffer::reset()
 {
-    _write_ptr = 0;
-    _read_ptr = 0;
-    _level = 0;
-    _dont_block = false;
-    while(!_meta_ring_buffer.empty())
-        _meta_ring_buffer.pop();
+    std::unique_lock<std::mutex> lock(_lease_lock);
+    if(_lease_count.load(std::memory_order_acquire) == 0)
+    {
+        _slots.reset();
+        for(auto& meta_data: _meta_ring_buffer)
+            meta_data = MetaDataNamePair();
+        return;
+    }
+    // Views exported by the user still point to the leased slots, they are kept from the producer till released:
+    // all the batches left are dropped as if popped, the leased ones and the ones behind them stay in the ring meanwhile
+    for(size_t i = _popped_leased; i < _slots.level(); i++)
+    {
+        auto slot = (_slots.read_position() + i) % BUFF_DEPTH;
+        if(_slot_leases[slot].empty())
+            _meta_ring_buffer[slot] = MetaDataNamePair();
+    }
+    _popped_leased = _slots.level();
+    release_popped_slots();
+    _slots.resume_waits();
 }
 
 void RingBuffer::release_gpu_res()
@@ -327,54 +524,47 @@ RingBuffer::~RingBuffer()
         _host_master_buffers.clear();
         _host_sub_buffers.clear();
     }
+    for (auto buffer: _host_heatmap_buffer)
+        free(buffer);
+    for (auto buffer: _host_target_weight_buffer)
+        free(buffer);
+    for (auto buffer: _host_soft_label_buffer)
+        free(buffer);
 }
 
 bool RingBuffer::empty()
 {
-    return (_level <= 0);
+    return level() == 0;
 }
 
 bool RingBuffer::full()
 {
-    return (_level >= BUFF_DEPTH - 1);
+    return _slots.full();
 }
 
 size_t RingBuffer::level()
 {
-    return _level;
-}
-void RingBuffer::increment_read_ptr()
-{
-    std::unique_lock<std::mutex> lock(_lock);
-    _read_ptr = (_read_ptr+1)%BUFF_DEPTH;
-    _level--;
-    lock.unlock();
-    // Wake up the writer thread (in case waiting) since there is an empty spot to write to,
-    _wait_for_unload.notify_all();
-
+    return readable_count();
 }
 
-void RingBuffer::increment_write_ptr()
+size_t RingBuffer::readable_count()
 {
-    std::unique_lock<std::mutex> lock(_lock);
-    _write_ptr = (_write_ptr+1)%BUFF_DEPTH;
-    _level++;
-    lock.unlock();
-    // Wake up the reader thread (in case waiting) since there is a new load to be read
-    _wait_for_load.notify_all();
+    if(_lease_count.load(std::memory_order_acquire) == 0)
+        return _slots.level();
+    // the slots popped by the user but still leased are in the ring, they are not readable anymore
+    std::unique_lock<std::mutex> lock(_lease_lock);
+    return _slots.level() - _popped_leased;
 }
 
 void RingBuffer::set_meta_data( ImageNameBatch names, pMetaDataBatch meta_data)
 {
-    _last_image_meta_data = std::move(std::make_pair(std::move(names), meta_data));
+    // The write slot is owned by the producer till push() is called
+    _meta_ring_buffer[_slots.write_index()] = std::make_pair(std::move(names), meta_data);
 }
 
 MetaDataNamePair& RingBuffer::get_meta_data()
 {
     block_if_empty();
-    std::unique_lock<std::mutex> lock(_names_buff_lock);
-    if(_level != _meta_ring_buffer.size())
-        THROW("ring buffer internals error, image and metadata sizes not the same "+TOSTR(_level) + " != "+TOSTR(_meta_ring_buffer.size()))
-    return  _meta_ring_buffer.front();
+    return  _meta_ring_buffer[read_slot()];
 }
 
@@ -0,0 +1,333 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <new>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "shm_batch_ring.h"
+#include "commons.h"
+#include "exception.h"
+
+struct ShmSegmentHeader
+{
+    uint64_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> ready;//!< Set by the service once the segment is initialized
+    std::atomic<uint32_t> closed;
+    int32_t owner_pid;//!< Service process, the clients check it is still alive while they wait for a batch
+    ShmBatchRingLayout layout;
+};
+
+namespace
+{
+const uint64_t SEGMENT_MAGIC = 0x6D68736C61636F72ULL;
+const uint32_t SEGMENT_VERSION = 2;
+const size_t PAGE_ALIGNMENT = 4096;
+const unsigned LIVENESS_CHECK_MS = 1000;
+
+size_t align_up(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+// Segment: header | SlotRing | slot 0 ... slot depth - 1, a slot is the names and meta data region followed by the images
+size_t ring_offset() { return align_up(sizeof(ShmSegmentHeader), 64); }
+size_t slots_offset() { return align_up(ring_offset() + sizeof(SlotRing), PAGE_ALIGNMENT); }
+size_t meta_data_region(const ShmBatchRingLayout &layout) { return align_up(layout.meta_data_bytes, PAGE_ALIGNMENT); }
+size_t slot_stride(const ShmBatchRingLayout &layout) { return meta_data_region(layout) + align_up(layout.image_bytes, PAGE_ALIGNMENT); }
+
+class SlotWriter
+{
+public:
+    SlotWriter(unsigned char *begin, size_t size): _ptr(begin), _end(begin + size) {}
+    template <typename T> void put(const T &value) { put_bytes(&value, sizeof(T)); }
+    void put_bytes(const void *data, size_t size)
+    {
+        if(size > (size_t)(_end - _ptr))
+            THROW("The names and meta data of the batch do not fit in the slots of the service ring")
+        memcpy(_ptr, data, size);
+        _ptr += size;
+    }
+private:
+    unsigned char *_ptr, *_end;
+};
+
+class SlotReader
+{
+public:
+    SlotReader(const unsigned char *begin, size_t size): _ptr(begin), _end(begin + size) {}
+    template <typename T> T get() { T value; get_bytes(&value, sizeof(T)); return value; }
+    void get_bytes(void *data, size_t size)
+    {
+        if(size > (size_t)(_end - _ptr))
+            THROW("Corrupted names and meta data in a slot of the service ring")
+        memcpy(data, _ptr, size);
+        _ptr += size;
+    }
+private:
+    const unsigned char *_ptr, *_end;
+};
+}
+
+std::string
+ShmBatchRing::segment_name(const std::string &service_name, unsigned rank)
+{
+    return "/rocal_" + service_name + "_" + TOSTR(rank);
+}
+
+size_t
+ShmBatchRing::meta_data_bytes(size_t batch_size, bool has_meta_data, MetaDataType meta_data_type, size_t max_name_length, size_t max_box_count)
+{
+    // Same fields as write_meta_data(): the name count, then the length and bytes of each name and the label or the image size and boxes
+    size_t sample_bytes = sizeof(uint32_t) + max_name_length;
+    if(has_meta_data)
+        sample_bytes += (meta_data_type == MetaDataType::BoundingBox) ? sizeof(ImgSize) + sizeof(uint32_t) + max_box_count * (4 * sizeof(float) + sizeof(int32_t))
+                                                                      : sizeof(int32_t);
+    return sizeof(uint32_t) + batch_size * sample_bytes;
+}
+
+std::shared_ptr<ShmBatchRing>
+ShmBatchRing::create(const std::string &segment, const ShmBatchRingLayout &layout)
+{
+    if(layout.depth < 2)
+        THROW("The service ring needs at least 2 slots")
+    std::shared_ptr<ShmBatchRing> ring(new ShmBatchRing());
+    ring->_segment = segment;
+    ring->_slot_stride = slot_stride(layout);
+    ring->_size = slots_offset() + layout.depth * ring->_slot_stride;
+    // A segment left over by a service that did not exit cleanly is replaced, its clients keep their own mapping of it
+    shm_unlink(segment.c_str());
+    int fd = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0)
+        THROW("Creating the shared memory segment " + segment + " failed: " + STR(strerror(errno)))
+    if(ftruncate(fd, ring->_size) != 0)
+    {
+        int err = errno;
+        ::close(fd);
+        shm_unlink(segment.c_str());
+        THROW("Sizing the shared memory segment " + segment + " to " + TOSTR(ring->_size) + " bytes failed: " + STR(strerror(err)))
+    }
+    ring->_base = mmap(nullptr, ring->_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(ring->_base == MAP_FAILED)
+    {
+        ring->_base = nullptr;
+        shm_unlink(segment.c_str());
+        THROW("Mapping the shared memory segment " + segment + " failed: " + STR(strerror(errno)))
+    }
+    ring->_owner = true;
+    auto base = static_cast<unsigned char *>(ring->_base);
+    ring->_header = new(base) ShmSegmentHeader();
+    ring->_header->magic = SEGMENT_MAGIC;
+    ring->_header->version = SEGMENT_VERSION;
+    ring->_header->closed.store(0);
+    ring->_header->owner_pid = getpid();
+    ring->_header->layout = layout;
+    ring->_ring = new(base + ring_offset()) SlotRing(layout.depth, true);
+    ring->_slots = base + slots_offset();
+    ring->_header->ready.store(1, std::memory_order_release);
+    return ring;
+}
+
+std::shared_ptr<ShmBatchRing>
+ShmBatchRing::attach(const std::string &segment, unsigned timeout_ms)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    auto wait = [&](const std::string &what)
+    {
+        if(std::chrono::steady_clock::now() > deadline)
+            THROW("Timed out waiting for " + what + " of the service segment " + segment + ", is the rocAL service running?")
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    };
+    int fd;
+    while((fd = shm_open(segment.c_str(), O_RDWR, 0)) < 0)
+    {
+        if(errno != ENOENT)
+            THROW("Opening the shared memory segment " + segment + " failed: " + STR(strerror(errno)))
+        wait("the creation");
+    }
+    // The service sizes the segment once, right after creating it
+    struct stat st = {};
+    while(fstat(fd, &st) == 0 && st.st_size == 0)
+        wait("the sizing");
+    std::shared_ptr<ShmBatchRing> ring(new ShmBatchRing());
+    ring->_segment = segment;
+    ring->_size = st.st_size;
+    ring->_base = (ring->_size > slots_offset()) ? mmap(nullptr, ring->_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if(ring->_base == MAP_FAILED)
+    {
+        ring->_base = nullptr;
+        THROW("Mapping the shared memory segment " + segment + " failed")
+    }
+    auto base = static_cast<unsigned char *>(ring->_base);
+    ring->_header = reinterpret_cast<ShmSegmentHeader *>(base);
+    while(ring->_header->ready.load(std::memory_order_acquire) == 0)
+        wait("the initialization");
+    if(ring->_header->magic != SEGMENT_MAGIC || ring->_header->version != SEGMENT_VERSION)
+        THROW("The shared memory segment " + segment + " is not a rocAL service ring of this version")
+    ring->_slot_stride = slot_stride(ring->_header->layout);
+    if(ring->_size < slots_offset() + ring->_header->layout.depth * ring->_slot_stride)
+        THROW("The shared memory segment " + segment + " is smaller than its layout")
+    ring->_ring = reinterpret_cast<SlotRing *>(base + ring_offset());
+    ring->_slots = base + slots_offset();
+    return ring;
+}
+
+ShmBatchRing::~ShmBatchRing()
+{
+    if(_base)
+        munmap(_base, _size);
+    if(_owner)
+        shm_unlink(_segment.c_str());
+}
+
+const ShmBatchRingLayout &
+ShmBatchRing::layout() const
+{
+    return _header->layout;
+}
+
+bool
+ShmBatchRing::wait_until_writable()
+{
+    if(_header->closed.load())
+        return false;
+    return _ring->wait_until_writable();
+}
+
+unsigned char *
+ShmBatchRing::write_images()
+{
+    return slot(_ring->write_index()) + meta_data_region(_header->layout);
+}
+
+void
+ShmBatchRing::write_meta_data(const ImageNameBatch &names, MetaDataBatch *meta_data)
+{
+    const auto &layout = _header->layout;
+    if(layout.has_meta_data && !meta_data)
+        THROW("The service ring carries meta data but the batch has none")
+    SlotWriter writer(slot(_ring->write_index()), layout.meta_data_bytes);
+    writer.put<uint32_t>(names.size());
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        writer.put<uint32_t>(names[i].size());
+        writer.put_bytes(names[i].data(), names[i].size());
+        if(!layout.has_meta_data)
+            continue;
+        if(static_cast<MetaDataType>(layout.meta_data_type) == MetaDataType::BoundingBox)
+        {
+            auto &boxes = meta_data->get_bb_cords_batch()[i];
+            auto &labels = meta_data->get_bb_labels_batch()[i];
+            auto &img_sizes = meta_data->get_img_sizes_batch();
+            ImgSize img_size = (i < img_sizes.size()) ? img_sizes[i] : ImgSize{0, 0};
+            writer.put(img_size);
+            writer.put<uint32_t>(boxes.size());
+            for(size_t box = 0; box < boxes.size(); box++)
+            {
+                writer.put(boxes[box].l); writer.put(boxes[box].t); writer.put(boxes[box].r); writer.put(boxes[box].b);
+                writer.put<int32_t>(box < labels.size() ? labels[box] : 0);
+            }
+        }
+        else
+        {
+            writer.put<int32_t>(meta_data->get_label_batch()[i]);
+        }
+    }
+}
+
+void
+ShmBatchRing::close()
+{
+    _header->closed.store(1);
+    _ring->release_all_waits();
+}
+
+bool
+ShmBatchRing::wait_until_readable()
+{
+    // The wait is done in slices, a client does not wait forever on a service that died without closing the ring
+    while(!_ring->wait_until_readable_for(LIVENESS_CHECK_MS))
+    {
+        if(_header->closed.load())
+            return !_ring->empty();
+        if(kill(_header->owner_pid, 0) != 0 && errno == ESRCH)
+            THROW("The rocAL service of the segment " + _segment + " (process " + TOSTR(_header->owner_pid) + ") exited without closing its ring")
+    }
+    return true;
+}
+
+unsigned char *
+ShmBatchRing::read_images()
+{
+    return slot(_ring->read_index()) + meta_data_region(_header->layout);
+}
+
+void
+ShmBatchRing::read_meta_data(ImageNameBatch &names, MetaDataBatch *meta_data)
+{
+    const auto &layout = _header->layout;
+    SlotReader reader(slot(_ring->read_index()), layout.meta_data_bytes);
+    const size_t count = reader.get<uint32_t>();
+    names.resize(count);
+    const bool read_meta_data = meta_data && layout.has_meta_data;
+    const bool boxes = static_cast<MetaDataType>(layout.meta_data_type) == MetaDataType::BoundingBox;
+    if(read_meta_data)
+        meta_data->resize(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        names[i].resize(reader.get<uint32_t>());
+        reader.get_bytes(&names[i][0], names[i].size());
+        if(!layout.has_meta_data)
+            continue;
+        if(boxes)
+        {
+            auto img_size = reader.get<ImgSize>();
+            const size_t box_count = reader.get<uint32_t>();
+            BoundingBoxCords cords(box_count);
+            BoundingBoxLabels labels(box_count);
+            for(size_t box = 0; box < box_count; box++)
+            {
+                cords[box].l = reader.get<float>(); cords[box].t = reader.get<float>();
+                cords[box].r = reader.get<float>(); cords[box].b = reader.get<float>();
+                labels[box] = reader.get<int32_t>();
+            }
+            if(read_meta_data)
+            {
+                meta_data->get_bb_cords_batch()[i] = std::move(cords);
+                meta_data->get_bb_labels_batch()[i] = std::move(labels);
+                meta_data->get_img_sizes_batch()[i] = img_size;
+            }
+        }
+        else
+        {
+            int label = reader.get<int32_t>();
+            if(read_meta_data)
+                meta_data->get_label_batch()[i] = label;
+        }
+    }
+}
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include <cassert>
 #include <commons.h>
 #include "caffe2_lmdb_record_reader.h"
+#include "parameter_factory.h"
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 #include <iostream>
@@ -63,6 +64,8 @@ Reader::Status Caffe2LMDBRecordReader::initialize(ReaderConfig desc)
     _folder_path = desc.path();
     _path = desc.path();
     _shard_id = desc.get_shard_id();
+    std::seed_seq seed{ParameterFactory::instance()->get_seed(), (unsigned)_shard_id};
+    _rng.seed(seed);
     _shard_count = desc.get_shard_count();
     _batch_count = desc.get_batch_size();
     _loop = desc.loop();
@@ -79,7 +82,7 @@ Reader::Status Caffe2LMDBRecordReader::initialize(ReaderConfig desc)
     }
     //shuffle dataset if set
     if( ret==Reader::Status::OK && _shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
 
     return ret;
 
@@ -131,7 +134,7 @@ Caffe2LMDBRecordReader::release()
 void Caffe2LMDBRecordReader::reset()
 {
     if(_shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
     _read_counter = 0;
     _curr_file_idx = 0;
 }
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <fstream>
 #include <stdint.h>
 #include "caffe_lmdb_record_reader.h"
+#include "parameter_factory.h"
 
 using namespace std;
 using caffe_protos::Datum;
@@ -65,6 +66,8 @@ Reader::Status CaffeLMDBRecordReader::initialize(ReaderConfig desc)
     _folder_path = desc.path();
     _path = desc.path();
     _shard_id = desc.get_shard_id();
+    std::seed_seq seed{ParameterFactory::instance()->get_seed(), (unsigned)_shard_id};
+    _rng.seed(seed);
     _shard_count = desc.get_shard_count();
     _batch_count = desc.get_batch_size();
     _loop = desc.loop();
@@ -82,7 +85,7 @@ Reader::Status CaffeLMDBRecordReader::initialize(ReaderConfig desc)
     }
     //shuffle dataset if set
     if( ret==Reader::Status::OK && _shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
 
     return ret;
 
@@ -140,7 +143,7 @@ int CaffeLMDBRecordReader::release()
 void CaffeLMDBRecordReader::reset()
 {
     if (_shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
     _read_counter = 0;
     _curr_file_idx = 0;
 }
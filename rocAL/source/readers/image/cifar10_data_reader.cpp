@@ -21,6 +21,7 @@ THE SOFTWARE.
 */
 
 #include <cassert>
+#include <cstring>
 #include <commons.h>
 #include "cifar10_data_reader.h"
 #include <boost/filesystem.hpp>
@@ -34,20 +35,17 @@ CIFAR10DataReader::CIFAR10DataReader()
     _sub_dir = nullptr;
     _entity = nullptr;
     _curr_file_idx = 0;
-    _current_file_size = 0;
-    _current_fPtr = nullptr;
     _loop = false;
     _file_id = 0;
-    _total_file_size = 0;
     _last_file_idx = 0;
 }
 
 unsigned CIFAR10DataReader::count_items()
 {
     if(_loop)
-        return _file_names.size();
+        return _file_offsets.size();
 
-    int ret = ((int)_file_names.size() -_read_counter);
+    int ret = ((int)_file_offsets.size() -_read_counter);
     return ((ret < 0) ? 0 : ret);
 }
 
@@ -64,67 +62,61 @@ Reader::Status CIFAR10DataReader::initialize(ReaderConfig desc)
 void CIFAR10DataReader::incremenet_read_ptr()
 {
     _read_counter++;
-    _curr_file_idx = (_curr_file_idx + 1) % _file_names.size();
+    _curr_file_idx = (_curr_file_idx + 1) % _file_offsets.size();
 }
 
 size_t CIFAR10DataReader::open()
 {
-    auto file_path = _file_names[_curr_file_idx];// Get next file name
+    auto mapping_idx = _file_mapping_idx[_curr_file_idx];
     auto file_offset = _file_offsets[_curr_file_idx];
     _last_file_idx = _file_idx[_curr_file_idx];
     incremenet_read_ptr();
-    // update _last_id for the next record
-    _last_id= file_path;
-    auto last_slash_idx = _last_id.find_last_of("\\/");
-    if (std::string::npos != last_slash_idx)
-    {
-        _last_id.erase(0, last_slash_idx + 1);
-    }
     // add file_idx to last_id so the loader knows the index within the same master file
+    _last_id = _mapped_file_ids[mapping_idx];
     _last_id.append("_");
     _last_id.append(std::to_string(_last_file_idx));
-    // compare the file_name with the last one opened
-    if ( file_path.compare(_last_file_name) != 0) {
-        if (_current_fPtr) {
-            fclose(_current_fPtr);
-            _current_fPtr = nullptr;
-        }
-        _current_fPtr = fopen(file_path.c_str(), "rb");// Open the file,
-        _last_file_name = file_path;
-        fseek(_current_fPtr, 0, SEEK_END);// Take the file read pointer to the end
-        _total_file_size = ftell(_current_fPtr);
-        fseek(_current_fPtr, 0, SEEK_SET);// Take the file read pointer to the beginning
-    }
 
-    if(!_current_fPtr) // Check if it is ready for reading
-        return 0;
-
-    fseek(_current_fPtr, file_offset, SEEK_END);// Take the file read pointer to the end
-
-    _current_file_size = ftell(_current_fPtr);// Check how many bytes are there between and the current read pointer position (end of the file)
-
-    if(_current_file_size < _raw_file_size)     // not enough data in the file to read
-    { // If file is empty continue
-        fclose(_current_fPtr);
-        _current_fPtr = nullptr;
+    auto &mapped_file = _mapped_files[mapping_idx];
+    if(file_offset + _raw_file_size > mapped_file->size())     // not enough data in the file to read
+    {
+        _current_data = nullptr;
         return 0;
     }
+    // skip the extra byte for label
+    _current_data = mapped_file->data() + file_offset + 1;
+    return (_raw_file_size-1);
+}
 
-    fseek(_current_fPtr, file_offset+1 , SEEK_SET);// Take the file pointer back to the fileoffset + 1 extra byte for label
+bool CIFAR10DataReader::view(ReaderItemView &item_view)
+{
+    if(!_current_data)
+        return false;
+    item_view.data = _current_data;
+    item_view.shape.width = 32;
+    item_view.shape.height = 32;
+    item_view.shape.channels = 3;
+    return true;
+}
 
-    return (_raw_file_size-1);
+bool CIFAR10DataReader::skip(size_t count)
+{
+    if(_file_offsets.empty())
+        return count == 0;
+    _read_counter += count;
+    _curr_file_idx = (_curr_file_idx + count) % _file_offsets.size();
+    return true;
 }
 
 size_t CIFAR10DataReader::read_data(unsigned char* buf, size_t read_size)
 {
-    if(!_current_fPtr)
+    if(!_current_data)
         return 0;
 
     // Requested read size bigger than the raw file size? just read as many bytes as the raw file size
     read_size = (read_size > (_raw_file_size-1)) ? _raw_file_size-1 : read_size;
 
-    size_t actual_read_size = fread(buf, sizeof(unsigned char), read_size, _current_fPtr);
-    return actual_read_size;
+    memcpy(buf, _current_data, read_size);
+    return read_size;
 }
 
 int CIFAR10DataReader::close()
@@ -134,16 +126,15 @@ int CIFAR10DataReader::close()
 
 CIFAR10DataReader::~CIFAR10DataReader()
 {
-    if(_current_fPtr) {
-        fclose(_current_fPtr);
-        _current_fPtr = nullptr;
-    }
+    _current_data = nullptr;
+    _mapped_files.clear();
 }
 
 int
 CIFAR10DataReader::release()
 {
-    // do not need to close file here since data is read from the same file continuously
+    // do not need to close file here since the batch files stay mapped for the whole run
+    _current_data = nullptr;
     return 0;
 }
 
@@ -185,8 +176,8 @@ Reader::Status CIFAR10DataReader::subfolder_reading()
                 WRN("CIFAR10DataReader: File reader cannot access the storage at " + _folder_path);
         }
     }
-    if(!_file_names.empty())
-        LOG("CIFAR10DataReader  Total of " + TOSTR(_file_names.size()) + " images loaded from " + _full_path )
+    if(!_file_offsets.empty())
+        LOG("CIFAR10DataReader  Total of " + TOSTR(_file_offsets.size()) + " images loaded from " + _full_path )
 
     closedir(_sub_dir);
     return ret;
@@ -218,22 +209,28 @@ Reader::Status CIFAR10DataReader::open_folder()
         if  (data_file_name.find(_file_name_prefix) != std::string::npos) {
             file_path.append("/");
             file_path.append(_entity->d_name);
-            FILE* fp = fopen(file_path.c_str(), "rb");// Open the file,
-            fseek(fp, 0, SEEK_END);// Take the file read pointer to the end
-            size_t total_file_size = ftell(fp);
-            size_t num_of_raw_files = _raw_file_size? total_file_size / _raw_file_size: 0;
+            // The batch file is read in once and its records are handed out from memory from then on
+            auto mapped_file = MappedFile::open(file_path);
+            if(!mapped_file)
+            {
+                WRN("CIFAR10DataReader: Could not read " + file_path)
+                continue;
+            }
+            size_t num_of_raw_files = _raw_file_size? mapped_file->size() / _raw_file_size: 0;
+            unsigned mapping_idx = _mapped_files.size();
+            _mapped_files.push_back(mapped_file);
+            _mapped_file_ids.push_back(data_file_name);
             unsigned file_offset = 0;
             for (unsigned i = 0; i < num_of_raw_files; i++) {
-                _file_names.push_back(file_path);
+                _file_mapping_idx.push_back(mapping_idx);
                 _file_offsets.push_back(file_offset);
                 _file_idx.push_back(i);
                 file_offset += _raw_file_size;
                 incremenet_file_id();
             }
-            fclose (fp);
         }
     }
-    if(_file_names.empty())
+    if(_file_offsets.empty())
         WRN("CIFAR10DataReader:: Did not load any file from " + _folder_path)
 
     closedir(_src_dir);
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <boost/filesystem.hpp>
 #include "meta_data_reader_factory.h"
 #include "meta_data_graph_factory.h"
+#include "parameter_factory.h"
 
 namespace filesys = boost::filesystem;
 #define USE_STDIO_FILE 0
@@ -55,6 +56,15 @@ unsigned COCOFileSourceReader::count_items()
     return ((ret < 0) ? 0 : ret);
 }
 
+bool COCOFileSourceReader::skip(size_t count)
+{
+    if(_file_names.empty())
+        return true;
+    _read_counter += count;
+    _curr_file_idx = (_curr_file_idx + count) % _file_names.size();
+    return true;
+}
+
 Reader::Status COCOFileSourceReader::initialize(ReaderConfig desc)
 {
     auto ret = Reader::Status::OK;
@@ -67,6 +77,8 @@ Reader::Status COCOFileSourceReader::initialize(ReaderConfig desc)
     _loop = desc.loop();
     _shuffle = desc.shuffle();
     _meta_data_reader = desc.meta_data_reader();
+    std::seed_seq seed{ParameterFactory::instance()->get_seed(), (unsigned)_shard_id};
+    _rng.seed(seed);
 
     if(_json_path == "")
     {
@@ -88,7 +100,7 @@ Reader::Status COCOFileSourceReader::initialize(ReaderConfig desc)
     }
     //shuffle dataset if set
     if (ret == Reader::Status::OK && _shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
     return ret;
 }
 
@@ -185,7 +197,7 @@ int COCOFileSourceReader::release()
 void COCOFileSourceReader::reset()
 {
     if (_shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
     _read_counter = 0;
     _curr_file_idx = 0;
 }
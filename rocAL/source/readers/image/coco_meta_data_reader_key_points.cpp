@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #include "lookahead_parser.h"
 #include "coco_meta_data_reader_key_points.h"
+#include "coco_annotation_cache.h"
 #include <iostream>
 #include <utility>
 #include <algorithm>
@@ -39,9 +40,20 @@ void COCOMetaDataReaderKeyPoints::init(const MetaDataConfig &cfg)
 
 bool COCOMetaDataReaderKeyPoints::exists(const std::string &image_name)
 {
+    if (_annotation_cache)
+        return _annotation_cache->contains(image_name);
     return _map_content.find(image_name) != _map_content.end();
 }
 
+const std::map<std::string, std::shared_ptr<MetaData>> & COCOMetaDataReaderKeyPoints::get_map_content()
+{
+    std::lock_guard<std::mutex> lock(_map_fill_lock);
+    if (_annotation_cache && !_map_filled)
+        _annotation_cache->fill(_map_content);
+    _map_filled = true;
+    return _map_content;
+}
+
 void COCOMetaDataReaderKeyPoints::lookup(const std::vector<std::string> &image_names)
 {
     if (image_names.empty())
@@ -56,11 +68,22 @@ void COCOMetaDataReaderKeyPoints::lookup(const std::vector<std::string> &image_n
     for (unsigned i = 0; i < image_names.size(); i++)
     {
         auto image_name = image_names[i];
-        auto it = _map_content.find(image_name);
-        if (_map_content.end() == it)
-            THROW("ERROR: Given name not present in the map" + image_name);
         const JointsData *joints_data;
-        joints_data = &(it->second->get_joints_data());
+        JointsData cached_joints_data;
+        if (_annotation_cache)
+        {
+            ImgSize image_size;
+            if (!_annotation_cache->find_key_points(image_name, cached_joints_data, image_size))
+                THROW("ERROR: Given name not present in the map" + image_name);
+            joints_data = &cached_joints_data;
+        }
+        else
+        {
+            auto it = _map_content.find(image_name);
+            if (_map_content.end() == it)
+                THROW("ERROR: Given name not present in the map" + image_name);
+            joints_data = &(it->second->get_joints_data());
+        }
         joints_data_batch.image_id_batch.push_back(joints_data->image_id);
         joints_data_batch.annotation_id_batch.push_back(joints_data->annotation_id);
         joints_data_batch.image_path_batch.push_back(joints_data->image_path);
@@ -83,7 +106,7 @@ void COCOMetaDataReaderKeyPoints::add(std::string image_id, ImgSize image_size,
 void COCOMetaDataReaderKeyPoints::print_map_contents()
 {
     JointsData joints_data;
-    for (auto &elem : _map_content)
+    for (auto &elem : get_map_content())
     {
         std::cout << "\nName :\t " << elem.first<<std::endl;
         joints_data = elem.second->get_joints_data();
@@ -104,6 +127,15 @@ void COCOMetaDataReaderKeyPoints::print_map_contents()
 void COCOMetaDataReaderKeyPoints::read_all(const std::string &path)
 {
     _coco_metadata_read_time.start(); // Debug timing
+    // the center and scale of the boxes depend on the output aspect ratio
+    auto annotation_cache = std::make_unique<CocoAnnotationCache>(path, CocoAnnotationCache::Kind::KEY_POINTS, std::vector<uint32_t>{_out_img_width, _out_img_height});
+    if (annotation_cache->open(_label_info))
+    {
+        // Kept open, the images are looked up in the cache
+        _annotation_cache = std::move(annotation_cache);
+        _coco_metadata_read_time.end();
+        return;
+    }
     std::ifstream f;
     f.open(path, std::ifstream::in | std::ios::binary);
     if (f.fail())
@@ -368,6 +400,7 @@ void COCOMetaDataReaderKeyPoints::read_all(const std::string &path)
             parser.SkipValue();
         }
     }
+    annotation_cache->store(_map_content, _label_info);
     _coco_metadata_read_time.end(); // Debug timing
     // print_map_contents();
     // std::cout << "coco read time in sec: " << _coco_metadata_read_time.get_timing() / 1000 << std::endl;
@@ -387,6 +420,8 @@ void COCOMetaDataReaderKeyPoints::release()
 {
     _map_content.clear();
     _map_img_sizes.clear();
+    _annotation_cache.reset();
+    _map_filled = false;
 }
 
 COCOMetaDataReaderKeyPoints::COCOMetaDataReaderKeyPoints() : _coco_metadata_read_time("coco meta read time", DBG_TIMING)
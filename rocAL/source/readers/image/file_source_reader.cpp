@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <algorithm>
 #include <commons.h>
 #include "file_source_reader.h"
+#include "parameter_factory.h"
 #include <boost/filesystem.hpp>
 
 namespace filesys = boost::filesystem;
@@ -51,16 +52,29 @@ unsigned FileSourceReader::count_items()
     return ((ret < 0) ? 0 : ret);
 }
 
+bool FileSourceReader::skip(size_t count)
+{
+    if(_file_names.empty())
+        return true;
+    _read_counter += count;
+    _curr_file_idx = (_curr_file_idx + count) % _file_names.size();
+    return true;
+}
+
 Reader::Status FileSourceReader::initialize(ReaderConfig desc)
 {
     auto ret = Reader::Status::OK;
     _file_id = 0;
     _folder_path = desc.path();
+    _root_path = desc.path();
     _shard_id = desc.get_shard_id();
     _shard_count = desc.get_shard_count();
     _batch_count = desc.get_batch_size();
     _shuffle = desc.shuffle();
     _loop = desc.loop();
+    _quarantine = SampleQuarantine::open(desc.path());
+    std::seed_seq seed{ParameterFactory::instance()->get_seed(), (unsigned)_shard_id};
+    _rng.seed(seed);
     ret = subfolder_reading();
     // the following code is required to make every shard the same size:: required for multi-gpu training
     if (_shard_count > 1 && _batch_count > 1) {
@@ -73,7 +87,7 @@ Reader::Status FileSourceReader::initialize(ReaderConfig desc)
     }
     //shuffle dataset if set
     if( ret==Reader::Status::OK && _shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
 
     return ret;
 }
@@ -87,6 +101,7 @@ size_t FileSourceReader::open()
 {
     auto file_path = _file_names[_curr_file_idx];// Get next file name
     incremenet_read_ptr();
+    _last_sample_path = relative_path(file_path);
     _last_id= file_path;
     auto last_slash_idx = _last_id.find_last_of("\\/");
     if (std::string::npos != last_slash_idx)
@@ -149,7 +164,7 @@ FileSourceReader::release()
 
 void FileSourceReader::reset()
 {
-    if (_shuffle) std::random_shuffle(_file_names.begin(), _file_names.end());
+    if (_shuffle) std::shuffle(_file_names.begin(), _file_names.end(), _rng);
     _read_counter = 0;
     _curr_file_idx = 0;
 }
@@ -196,6 +211,7 @@ Reader::Status FileSourceReader::subfolder_reading()
                 WRN("FileReader ShardID ["+ TOSTR(_shard_id)+ "] File reader cannot access the storage at " + _folder_path);
         }
     }
+    replace_quarantined_files();
     if(_in_batch_read_count > 0 && _in_batch_read_count < _batch_count)
     {
         replicate_last_image_to_fill_last_shard();
@@ -203,8 +219,37 @@ Reader::Status FileSourceReader::subfolder_reading()
     }
     if(!_file_names.empty())
         LOG("FileReader ShardID ["+ TOSTR(_shard_id)+ "] Total of " + TOSTR(_file_names.size()) + " images loaded from " + _full_path )
+    if(_quarantined_count > 0)
+        LOG("FileReader ShardID ["+ TOSTR(_shard_id)+ "] Replaced " + TOSTR(_quarantined_count) + " quarantined images")
     return ret;
 }
+
+void FileSourceReader::replace_quarantined_files()
+{
+    // Each quarantined file takes the place of the next healthy file of the shard, the shard keeps its size and padding
+    // whatever the quarantine holds, so the batch counts of the ranks and the positions of a saved state stay the same
+    if(_quarantined_files.empty())
+        return;
+    auto healthy = std::find_if(_file_names.begin(), _file_names.end(), [this](const std::string &file_name) { return !_quarantined_files.count(file_name); });
+    if(healthy == _file_names.end())
+    {
+        WRN("FileReader ShardID ["+ TOSTR(_shard_id)+ "] All the images of the shard are quarantined, reading them anyway")
+        return;
+    }
+    for(size_t i = _file_names.size(); i-- > 0;)
+    {
+        if(_quarantined_files.count(_file_names[i]))
+        {
+            _file_names[i] = *healthy;
+            _quarantined_count++;
+        }
+        else
+        {
+            healthy = _file_names.begin() + i;
+        }
+    }
+    _last_file_name = _file_names.back();
+}
 void FileSourceReader::replicate_last_image_to_fill_last_shard()
 {
     for(size_t i = _in_batch_read_count; i < _batch_count; i++)
@@ -251,6 +296,9 @@ Reader::Status FileSourceReader::open_folder()
         std::string file_path = _folder_path;
         file_path.append("/");
         file_path.append(_entity->d_name);
+        // The quarantine grows while the ranks run, it is only looked at once the files are dealt so every shard keeps its files
+        if(_quarantine && _quarantine->contains(relative_path(file_path)))
+            _quarantined_files.insert(file_path);
         _file_names.push_back(file_path);
         _file_count_all_shards++;
         incremenet_file_id();
@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <map>
+#include <cstdlib>
+#include <mutex>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mapped_file.h"
+#include "commons.h"
+
+namespace
+{
+std::mutex mapped_files_lock;
+std::map<std::string, std::weak_ptr<const MappedFile>> mapped_files;
+}
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mapped_files_lock);
+    if(auto file = mapped_files[path].lock())
+        return file;
+    std::shared_ptr<MappedFile> file(new MappedFile(path));
+    if(!file->load())
+        return nullptr;
+    mapped_files[path] = file;
+    return file;
+}
+
+bool MappedFile::load()
+{
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        WRN("MappedFile: failed opening " + _path)
+        return false;
+    }
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    _size = file_stat.st_size;
+    // The whole file is used every epoch, its pages are read in once here rather than faulted in sample by sample
+    if(!std::getenv("ROCAL_DISABLE_MMAP"))
+    {
+        _address = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        if(_address != MAP_FAILED)
+        {
+            _data = static_cast<const unsigned char *>(_address);
+            ::close(fd);
+            return true;
+        }
+        WRN("MappedFile: failed mapping " + _path + " " + STR(strerror(errno)) + ", reading it to memory")
+    }
+    _address = nullptr;
+    _buffer.resize(_size);
+    size_t read_size = 0;
+    while(read_size < _size)
+    {
+        ssize_t n = ::read(fd, _buffer.data() + read_size, _size - read_size);
+        if(n <= 0)
+            break;
+        read_size += n;
+    }
+    ::close(fd);
+    if(read_size != _size)
+    {
+        WRN("MappedFile: failed reading " + _path)
+        return false;
+    }
+    _data = _buffer.data();
+    return true;
+}
+
+MappedFile::~MappedFile()
+{
+    if(_address)
+        munmap(_address, _size);
+}
@@ -0,0 +1,263 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mxnet_recordio_index.h"
+#include "image_reader.h"
+#include "commons.h"
+
+namespace
+{
+const uint32_t RECORDIO_MAGIC = 0xced7230a;
+//! Records are indexed in chunks of this many .idx entries, each chunk by one thread
+const size_t INDEX_CHUNK_SIZE = 1024;
+
+uint32_t decode_flag(uint32_t length_flag) { return (length_flag >> 29U) & 7U; }
+uint32_t decode_length(uint32_t length_flag) { return length_flag & ((1U << 29U) - 1U); }
+
+bool has_extension(const std::string &name, const std::string &extension)
+{
+    return name.size() > extension.size() && name.compare(name.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+size_t payload_size(const MXNetRecord &record)
+{
+    size_t size = (record.pieces.size() - 1) * sizeof(RECORDIO_MAGIC);
+    for(auto &piece : record.pieces)
+        size += piece.size;
+    return size;
+}
+
+//! Walks the part headers of the record starting at offset and reads its image record header and labels, the image itself is not read
+void index_record(int fd, size_t file_size, size_t offset, MXNetRecord &record, const std::string &rec_file)
+{
+    uint32_t part_flag = 0;
+    do
+    {
+        uint32_t part_header[2];
+        if(offset + sizeof(part_header) > file_size || pread(fd, part_header, sizeof(part_header), offset) != (ssize_t)sizeof(part_header))
+            THROW("MXNetRecordIOIndex: " + rec_file + " is truncated, failed reading the record at offset " + TOSTR(offset))
+        if(part_header[0] != RECORDIO_MAGIC)
+            THROW("MXNetRecordIOIndex: invalid RecordIO " + rec_file + ", wrong magic number at offset " + TOSTR(offset))
+        const uint32_t flag = decode_flag(part_header[1]);
+        // 0: whole record, 1: first part, 2: middle part, 3: last part
+        if((record.pieces.empty() && flag != 0 && flag != 1) || (!record.pieces.empty() && flag != 2 && flag != 3))
+            THROW("MXNetRecordIOIndex: invalid RecordIO " + rec_file + ", unexpected part flag " + TOSTR(flag) + " at offset " + TOSTR(offset))
+        part_flag = flag;
+        MXNetRecordPiece piece;
+        piece.offset = offset + sizeof(part_header);
+        piece.size = decode_length(part_header[1]);
+        if(piece.offset + piece.size > file_size)
+            THROW("MXNetRecordIOIndex: " + rec_file + " is truncated, record at offset " + TOSTR(offset) + " goes past the end of the file")
+        record.pieces.push_back(piece);
+        offset = piece.offset + ((piece.size + 3U) & ~size_t(3U));// parts are padded to 4 bytes
+    } while(part_flag == 1 || part_flag == 2);
+
+    const size_t size = payload_size(record);
+    ImageRecordIOHeader header;
+    if(size < sizeof(header) || !read_mxnet_record_payload(fd, record, 0, sizeof(header), reinterpret_cast<unsigned char *>(&header)))
+        THROW("MXNetRecordIOIndex: invalid RecordIO " + rec_file + ", record at offset " + TOSTR(record.pieces[0].offset) + " is too small for an image record")
+    record.id = header.image_id[0];
+    record.key = std::to_string(record.id);
+    record.image_offset = sizeof(header) + header.flag * sizeof(float);
+    if(record.image_offset > size)
+        THROW("MXNetRecordIOIndex: invalid RecordIO " + rec_file + ", labels of record " + record.key + " go past its end")
+    record.image_size = size - record.image_offset;
+    if(header.flag == 0)
+    {
+        record.labels.assign(1, header.label);
+    }
+    else
+    {
+        record.labels.resize(header.flag);
+        if(!read_mxnet_record_payload(fd, record, sizeof(header), header.flag * sizeof(float), reinterpret_cast<unsigned char *>(record.labels.data())))
+            THROW("MXNetRecordIOIndex: failed reading the labels of record " + record.key + " from " + rec_file)
+    }
+}
+
+//! Offsets of the records listed in the .idx file ("index\toffset" lines), sorted
+std::vector<size_t> read_index_file(const std::string &idx_file)
+{
+    std::ifstream index_file(idx_file);
+    if(!index_file)
+        THROW("MXNetRecordIOIndex: could not open RecordIO index file " + idx_file)
+    std::vector<size_t> offsets;
+    size_t index, offset;
+    while(index_file >> index >> offset)
+        offsets.push_back(offset);
+    if(offsets.empty())
+        THROW("MXNetRecordIOIndex: RecordIO index file doesn't contain any indices " + idx_file)
+    std::sort(offsets.begin(), offsets.end());
+    return offsets;
+}
+
+void index_rec_file(const std::string &rec_file, const std::string &idx_file, unsigned file_idx, std::vector<MXNetRecord> &records)
+{
+    auto offsets = read_index_file(idx_file);
+    int fd = ::open(rec_file.c_str(), O_RDONLY);
+    if(fd < 0)
+        THROW("MXNetRecordIOIndex: failed opening " + rec_file)
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0)
+    {
+        ::close(fd);
+        THROW("MXNetRecordIOIndex: failed reading the size of " + rec_file)
+    }
+    const size_t file_size = file_stat.st_size;
+    const size_t first = records.size();
+    records.resize(first + offsets.size());
+    const int chunk_count = (offsets.size() + INDEX_CHUNK_SIZE - 1) / INDEX_CHUNK_SIZE;
+    std::vector<std::string> errors(chunk_count);
+    // Reading the headers is mostly waiting on the storage, the chunks are read concurrently (pread has no shared file position)
+    #pragma omp parallel for schedule(dynamic)
+    for(int chunk = 0; chunk < chunk_count; chunk++)
+    {
+        const size_t end = std::min(offsets.size(), (chunk + 1) * INDEX_CHUNK_SIZE);
+        try
+        {
+            for(size_t i = chunk * INDEX_CHUNK_SIZE; i < end; i++)
+            {
+                records[first + i].file = file_idx;
+                index_record(fd, file_size, offsets[i], records[first + i], rec_file);
+            }
+        }
+        catch(const std::exception &e)
+        {
+            errors[chunk] = e.what();
+        }
+    }
+    ::close(fd);
+    for(auto &error : errors)
+        if(!error.empty())
+            THROW(error)
+}
+
+std::shared_ptr<const MXNetRecordIOIndex> build_mxnet_recordio_index(const std::string &path)
+{
+    auto index = std::make_shared<MXNetRecordIOIndex>();
+    DIR *dir = opendir(path.c_str());
+    if(!dir)
+        THROW("MXNetRecordIOIndex: failed opening the directory at " + path)
+    std::vector<std::string> idx_files;
+    while(auto entity = readdir(dir))
+    {
+        std::string name(entity->d_name);
+        if(name[0] == '.')
+            continue;
+        std::string file_name = path + "/" + name;
+        struct stat file_stat;
+        if(stat(file_name.c_str(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+            continue;
+        if(has_extension(name, ".rec"))
+            index->rec_files.push_back(file_name);
+        else if(has_extension(name, ".idx"))
+            idx_files.push_back(file_name);
+    }
+    closedir(dir);
+    if(index->rec_files.empty())
+        THROW("MXNetRecordIOIndex: did not find any .rec file at " + path)
+    std::sort(index->rec_files.begin(), index->rec_files.end());
+    for(unsigned file_idx = 0; file_idx < index->rec_files.size(); file_idx++)
+    {
+        // Every part.rec comes with its part.idx, a single .rec may have an index of another name
+        auto &rec_file = index->rec_files[file_idx];
+        std::string idx_file = rec_file.substr(0, rec_file.size() - 4) + ".idx";
+        if(std::find(idx_files.begin(), idx_files.end(), idx_file) == idx_files.end())
+        {
+            if(index->rec_files.size() != 1 || idx_files.size() != 1)
+                THROW("MXNetRecordIOIndex: could not find the RecordIO index file " + idx_file)
+            idx_file = idx_files[0];
+        }
+        index_rec_file(rec_file, idx_file, file_idx, index->records);
+    }
+    // The readers look the records up by id, a record of the same id as another one would silently replace it
+    std::vector<size_t> order(index->records.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return index->records[a].id < index->records[b].id; });
+    for(size_t i = 1; i < order.size(); i++)
+    {
+        auto &first = index->records[order[i - 1]], &second = index->records[order[i]];
+        if(first.id == second.id)
+            THROW("MXNetRecordIOIndex: image id " + first.key + " is used by the records at offset " + TOSTR(first.pieces[0].offset) + " of " +
+                  index->rec_files[first.file] + " and at offset " + TOSTR(second.pieces[0].offset) + " of " + index->rec_files[second.file] +
+                  ", the image ids have to be unique across the .rec files")
+    }
+    LOG("MXNetRecordIOIndex: " + TOSTR(index->records.size()) + " records in " + TOSTR(index->rec_files.size()) + " .rec files at " + path)
+    return index;
+}
+}
+
+bool read_mxnet_record_payload(int fd, const MXNetRecord &record, size_t begin, size_t size, unsigned char *dst)
+{
+    // Position of the current piece and of the magic number following it within the payload
+    size_t position = 0;
+    for(size_t i = 0; i < record.pieces.size() && size > 0; i++)
+    {
+        auto &piece = record.pieces[i];
+        if(begin < position + piece.size)
+        {
+            const size_t piece_begin = begin - position;
+            const size_t count = std::min(size, piece.size - piece_begin);
+            if(pread(fd, dst, count, piece.offset + piece_begin) != (ssize_t)count)
+                return false;
+            dst += count;
+            begin += count;
+            size -= count;
+        }
+        position += piece.size;
+        if(i + 1 == record.pieces.size())
+            break;
+        if(size > 0 && begin < position + sizeof(RECORDIO_MAGIC))
+        {
+            const size_t magic_begin = begin - position;
+            const size_t count = std::min(size, sizeof(RECORDIO_MAGIC) - magic_begin);
+            memcpy(dst, reinterpret_cast<const unsigned char *>(&RECORDIO_MAGIC) + magic_begin, count);
+            dst += count;
+            begin += count;
+            size -= count;
+        }
+        position += sizeof(RECORDIO_MAGIC);
+    }
+    return size == 0;
+}
+
+std::shared_ptr<const MXNetRecordIOIndex> load_mxnet_recordio_index(const std::string &path)
+{
+    // The shards of a loader and the meta data reader all need the index, the first one to get here builds it and the others reuse it
+    static std::mutex index_lock;
+    static std::map<std::string, std::weak_ptr<const MXNetRecordIOIndex>> indices;
+    std::unique_lock<std::mutex> lock(index_lock);
+    if(auto index = indices[path].lock())
+        return index;
+    auto index = build_mxnet_recordio_index(path);
+    indices[path] = index;
+    return index;
+}
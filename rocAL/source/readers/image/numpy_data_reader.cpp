@@ -0,0 +1,370 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "numpy_data_reader.h"
+#include "parameter_factory.h"
+#include "commons.h"
+
+namespace
+{
+const char NUMPY_MAGIC[] = "\x93NUMPY";
+const size_t NUMPY_MAGIC_SIZE = 6;
+
+//! Size of the magic string, version and header length fields preceding the header dictionary, 0 if not a supported .npy file
+size_t numpy_preamble_size(const unsigned char *buffer, size_t size)
+{
+    if(size < 10 || memcmp(buffer, NUMPY_MAGIC, NUMPY_MAGIC_SIZE) != 0)
+        return 0;
+    switch(buffer[6])
+    {
+        case 1: return 10;
+        case 2:
+        case 3: return 12;
+        default: THROW("Unsupported .npy format version " + TOSTR((unsigned)buffer[6]) + "." + TOSTR((unsigned)buffer[7]))
+    }
+}
+
+size_t numpy_header_length(const unsigned char *buffer, size_t preamble_size)
+{
+    if(preamble_size == 10)
+        return buffer[8] | (buffer[9] << 8);
+    return buffer[8] | (buffer[9] << 8) | (buffer[10] << 16) | ((size_t)buffer[11] << 24);
+}
+
+//! Returns the text following "'key':" in the header dictionary, with the leading spaces removed
+std::string numpy_header_value(const std::string &header, const std::string &key)
+{
+    auto pos = header.find("'" + key + "'");
+    if(pos == std::string::npos)
+        THROW("The .npy header has no '" + key + "' entry: " + header)
+    pos = header.find(':', pos);
+    if(pos == std::string::npos)
+        THROW("Invalid .npy header: " + header)
+    pos = header.find_first_not_of(" ", pos + 1);
+    return pos == std::string::npos ? std::string() : header.substr(pos);
+}
+
+bool is_npy_file(const std::string &name)
+{
+    if(name.size() < 4)
+        return false;
+    std::string extension = name.substr(name.size() - 4);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension == ".npy";
+}
+}
+
+bool parse_numpy_header(const unsigned char *buffer, size_t size, bool has_sample_axis, NumpyFileInfo &info)
+{
+    const size_t preamble_size = numpy_preamble_size(buffer, size);
+    if(preamble_size == 0)
+        return false;
+    if(size < preamble_size)
+        THROW("Truncated .npy header")
+    const size_t header_length = numpy_header_length(buffer, preamble_size);
+    if(preamble_size + header_length > size)
+        THROW("Truncated .npy header")
+    const std::string header(reinterpret_cast<const char *>(buffer) + preamble_size, header_length);
+
+    std::string descr = numpy_header_value(header, "descr");
+    if(descr.empty() || (descr[0] != '\'' && descr[0] != '"') || descr.find(descr[0], 1) == std::string::npos)
+        THROW("Invalid .npy dtype description: " + header)
+    descr = descr.substr(1, descr.find(descr[0], 1) - 1);
+    if(descr != "|u1" && descr != "<u1" && descr != ">u1" && descr != "u1")
+        THROW("Only uint8 .npy arrays can be loaded into images, the array's dtype is " + descr)
+    if(numpy_header_value(header, "fortran_order").compare(0, 5, "False") != 0)
+        THROW("Fortran ordered .npy arrays are not supported")
+
+    std::string shape_text = numpy_header_value(header, "shape");
+    if(shape_text.empty() || shape_text[0] != '(' || shape_text.find(')') == std::string::npos)
+        THROW("Invalid .npy shape: " + header)
+    shape_text = shape_text.substr(1, shape_text.find(')') - 1);
+    std::vector<size_t> shape;
+    size_t pos = 0;
+    while(pos < shape_text.size())
+    {
+        size_t end = shape_text.find(',', pos);
+        if(end == std::string::npos)
+            end = shape_text.size();
+        auto dim = shape_text.substr(pos, end - pos);
+        if(dim.find_first_not_of(" ") != std::string::npos)
+            shape.push_back(std::stoull(dim));
+        pos = end + 1;
+    }
+
+    // Sample count, height, width, channels
+    size_t dims[4] = {1, 0, 0, 1};
+    if(shape.size() == 4)
+        std::copy(shape.begin(), shape.end(), dims);
+    else if(has_sample_axis && shape.size() == 3)
+        std::copy(shape.begin(), shape.end(), dims);
+    else if(!has_sample_axis && (shape.size() == 2 || shape.size() == 3))
+        std::copy(shape.begin(), shape.end(), dims + 1);
+    else
+        THROW("Unsupported .npy array of " + TOSTR(shape.size()) + " dimensions, the samples need to be (H, W) or (H, W, C) arrays" +
+              (has_sample_axis ? " along the first axis" : ""))
+    if(dims[3] != 1 && dims[3] != 3)
+        THROW("The samples of the .npy arrays need 1 or 3 channels, got " + TOSTR(dims[3]))
+    if(dims[1] == 0 || dims[2] == 0)
+        THROW("Invalid .npy sample size " + TOSTR(dims[2]) + " x " + TOSTR(dims[1]))
+    info.sample_count = dims[0];
+    info.shape.height = dims[1];
+    info.shape.width = dims[2];
+    info.shape.channels = dims[3];
+    info.data_offset = preamble_size + header_length;
+    return true;
+}
+
+unsigned NumpyDataReader::count_items()
+{
+    if(_loop)
+        return _samples.size();
+    int ret = ((int)_samples.size() - (int)_read_counter);
+    return ((ret < 0) ? 0 : ret);
+}
+
+void NumpyDataReader::add_file(const std::string &path, bool has_sample_axis)
+{
+    NumpyFileInfo info;
+    info.path = path;
+    auto last_slash_idx = path.find_last_of("\\/");
+    info.name = (last_slash_idx == std::string::npos) ? path : path.substr(last_slash_idx + 1);
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        THROW("NumpyDataReader ShardID [" + TOSTR(_shard_id) + "] ERROR: Failed opening " + path)
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0)
+    {
+        ::close(fd);
+        THROW("NumpyDataReader ShardID [" + TOSTR(_shard_id) + "] ERROR: Failed reading the size of " + path)
+    }
+    info.file_size = file_stat.st_size;
+    if(is_npy_file(info.name))
+    {
+        // Only the header is read here, the data is mapped when the samples are opened
+        std::vector<unsigned char> header(std::min<size_t>(info.file_size, 12));
+        ssize_t read_size = pread(fd, header.data(), header.size(), 0);
+        size_t preamble_size = (read_size == (ssize_t)header.size()) ? numpy_preamble_size(header.data(), header.size()) : 0;
+        if(preamble_size == 0 || preamble_size > header.size())
+        {
+            ::close(fd);
+            THROW("NumpyDataReader: " + path + " is not a .npy file")
+        }
+        header.resize(std::min(info.file_size, preamble_size + numpy_header_length(header.data(), preamble_size)));
+        read_size = pread(fd, header.data(), header.size(), 0);
+        ::close(fd);
+        try
+        {
+            parse_numpy_header(header.data(), read_size < 0 ? 0 : read_size, has_sample_axis, info);
+        }
+        catch(const std::exception &e)
+        {
+            THROW("NumpyDataReader: " + path + ": " + e.what())
+        }
+        if(info.data_offset + info.sample_count * info.shape.size() > info.file_size)
+            THROW("NumpyDataReader: " + path + " is smaller than the array described by its header")
+    }
+    else
+    {
+        ::close(fd);
+        if(_raw_shape.size() == 0)
+            THROW("NumpyDataReader: the shape of the samples needs to be given to read the raw tensor file " + path)
+        info.shape = _raw_shape;
+        info.sample_count = info.file_size / _raw_shape.size();
+        if(info.file_size % _raw_shape.size())
+            WRN("NumpyDataReader: size of " + path + " is not a multiple of the sample size, the last " + TOSTR(info.file_size % _raw_shape.size()) + " bytes are ignored")
+    }
+    if(info.sample_count == 0)
+    {
+        WRN("NumpyDataReader: no sample in " + path)
+        return;
+    }
+    _files.push_back(info);
+}
+
+Reader::Status NumpyDataReader::initialize(ReaderConfig desc)
+{
+    _shard_id = desc.get_shard_id();
+    _shard_count = desc.get_shard_count();
+    _batch_count = std::max<size_t>(desc.get_batch_size(), 1);
+    _shuffle = desc.shuffle();
+    _loop = desc.loop();
+    _raw_shape = desc.raw_sample_shape();
+    std::seed_seq seed{ParameterFactory::instance()->get_seed(), (unsigned)_shard_id};
+    _rng.seed(seed);
+    const std::string path = desc.path();
+    struct stat path_stat;
+    if(stat(path.c_str(), &path_stat) != 0)
+        THROW("NumpyDataReader ShardID [" + TOSTR(_shard_id) + "] ERROR: Failed accessing " + path)
+    if(S_ISDIR(path_stat.st_mode))
+    {
+        DIR *dir = opendir(path.c_str());
+        if(!dir)
+            THROW("NumpyDataReader ShardID [" + TOSTR(_shard_id) + "] ERROR: Failed opening the directory at " + path)
+        std::vector<std::string> file_names;
+        while(auto entity = readdir(dir))
+        {
+            std::string name(entity->d_name);
+            if(entity->d_type != DT_REG || name[0] == '.')
+                continue;
+            if(!is_npy_file(name) && _raw_shape.size() == 0)
+                continue;
+            file_names.push_back(name);
+        }
+        closedir(dir);
+        std::sort(file_names.begin(), file_names.end());
+        for(auto &name : file_names)
+            add_file(path + "/" + name, false);
+    }
+    else
+    {
+        add_file(path, true);
+    }
+    if(_files.empty())
+        THROW("NumpyDataReader ShardID [" + TOSTR(_shard_id) + "] ERROR: Did not find any sample at " + path)
+    _mappings.resize(_files.size());
+
+    // Samples are dealt round robin to the shards, and every shard is padded with its first samples to the same count, a multiple of the batch size
+    size_t sample_count = 0;
+    for(unsigned file_idx = 0; file_idx < _files.size(); file_idx++)
+        for(size_t sample = 0; sample < _files[file_idx].sample_count; sample++, sample_count++)
+            if(sample_count % _shard_count == _shard_id)
+                _samples.emplace_back(file_idx, sample);
+    if(_samples.empty())
+        _samples.emplace_back(0, 0);
+    size_t shard_size = (sample_count + _shard_count - 1) / _shard_count;
+    shard_size = ((shard_size + _batch_count - 1) / _batch_count) * _batch_count;
+    for(size_t i = 0; _samples.size() < shard_size; i++)
+        _samples.push_back(_samples[i]);
+    LOG("NumpyDataReader ShardID [" + TOSTR(_shard_id) + "] Total of " + TOSTR(_samples.size()) + " samples in " + TOSTR(_files.size()) + " files loaded from " + path)
+    if(_shuffle)
+        shuffle();
+    return Reader::Status::OK;
+}
+
+void NumpyDataReader::shuffle()
+{
+    std::shuffle(_samples.begin(), _samples.end(), _rng);
+}
+
+const unsigned char *NumpyDataReader::map_file(size_t file_idx)
+{
+    auto &mapping = _mappings[file_idx];
+    if(mapping.address)
+        return static_cast<const unsigned char *>(mapping.address);
+    auto &file = _files[file_idx];
+    int fd = ::open(file.path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        WRN("NumpyDataReader: failed opening " + file.path)
+        return nullptr;
+    }
+    // Single sample files are used right away and entirely, their pages are read ahead by the mapping
+    const bool single_sample = file.sample_count == 1;
+    void *address = mmap(nullptr, file.file_size, PROT_READ, MAP_PRIVATE | (single_sample ? MAP_POPULATE : 0), fd, 0);
+    ::close(fd);
+    if(address == MAP_FAILED)
+    {
+        WRN("NumpyDataReader: failed mapping " + file.path + " " + STR(strerror(errno)))
+        return nullptr;
+    }
+    if(!single_sample && _shuffle)
+        madvise(address, file.file_size, MADV_RANDOM);
+    mapping.address = address;
+    mapping.size = file.file_size;
+    return static_cast<const unsigned char *>(address);
+}
+
+void NumpyDataReader::unmap_file(size_t file_idx)
+{
+    auto &mapping = _mappings[file_idx];
+    if(!mapping.address)
+        return;
+    munmap(mapping.address, mapping.size);
+    mapping = Mapping();
+}
+
+size_t NumpyDataReader::open()
+{
+    const auto [file_idx, sample] = _samples[_curr_sample_idx];
+    _read_counter++;
+    _curr_sample_idx = (_curr_sample_idx + 1) % _samples.size();
+    auto &file = _files[file_idx];
+    _last_id = (file.sample_count > 1) ? file.name + ":" + TOSTR(sample) : file.name;
+    auto base = map_file(file_idx);
+    if(!base)
+    {
+        _current_data = nullptr;
+        return 0;
+    }
+    _current_file = file_idx;
+    _current_shape = file.shape;
+    _current_data = base + file.data_offset + sample * file.shape.size();
+    return file.shape.size();
+}
+
+bool NumpyDataReader::view(ReaderItemView &item_view)
+{
+    if(!_current_data)
+        return false;
+    item_view.data = _current_data;
+    item_view.shape = _current_shape;
+    return true;
+}
+
+size_t NumpyDataReader::read_data(unsigned char* buf, size_t read_size)
+{
+    if(!_current_data)
+        return 0;
+    read_size = std::min(read_size, _current_shape.size());
+    memcpy(buf, _current_data, read_size);
+    return read_size;
+}
+
+int NumpyDataReader::close()
+{
+    if(_current_data && _files[_current_file].sample_count == 1)
+        unmap_file(_current_file);
+    _current_data = nullptr;
+    return 0;
+}
+
+void NumpyDataReader::reset()
+{
+    if(_shuffle)
+        shuffle();
+    _read_counter = 0;
+    _curr_sample_idx = 0;
+}
+
+NumpyDataReader::~NumpyDataReader()
+{
+    for(size_t file_idx = 0; file_idx < _mappings.size(); file_idx++)
+        unmap_file(file_idx);
+}
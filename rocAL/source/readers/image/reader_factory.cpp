@@ -31,6 +31,9 @@ THE SOFTWARE.
 #include "caffe_lmdb_record_reader.h"
 #include "caffe2_lmdb_record_reader.h"
 #include "mxnet_recordio_reader.h"
+#include "synthetic_data_reader.h"
+#include "numpy_data_reader.h"
+#include "tar_shard_reader.h"
 
 std::shared_ptr<Reader> create_reader(ReaderConfig config) {
     switch(config.type()) {
@@ -98,6 +101,30 @@ std::shared_ptr<Reader> create_reader(ReaderConfig config) {
             return ret;
         }
         break;
+        case StorageType::SYNTHETIC:
+        {
+            auto ret = std::make_shared<SyntheticDataReader>();
+            if(ret->initialize(config) != Reader::Status::OK)
+                throw std::runtime_error("SyntheticDataReader cannot be initialized");
+            return ret;
+        }
+        break;
+        case StorageType::NUMPY_DATA:
+        {
+            auto ret = std::make_shared<NumpyDataReader>();
+            if(ret->initialize(config) != Reader::Status::OK)
+                throw std::runtime_error("NumpyDataReader cannot access the storage");
+            return ret;
+        }
+        break;
+        case StorageType::TAR_SHARDS:
+        {
+            auto ret = std::make_shared<TarShardReader>();
+            if(ret->initialize(config) != Reader::Status::OK)
+                throw std::runtime_error("TarShardReader cannot access the storage");
+            return ret;
+        }
+        break;
         default:
             throw std::runtime_error ("Reader type is unsupported");
     }
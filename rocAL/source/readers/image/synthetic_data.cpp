@@ -0,0 +1,180 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include "synthetic_data.h"
+
+namespace
+{
+const char SYNTHETIC_MAGIC[8] = {'R', 'O', 'C', 'A', 'L', 'S', 'Y', 'N'};
+const char SYNTHETIC_NAME_PREFIX[] = "synthetic_";
+
+// splitmix64 finalizer, every generated value is a hash of the seed and of what it is generated for
+inline uint64_t mix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t hash(uint64_t seed, uint64_t item, uint64_t field)
+{
+    return mix(seed ^ mix(item * 0x100000001B3ull + field));
+}
+
+inline float unit(uint64_t h)
+{
+    return (h >> 40) * (1.0f / (1 << 24));
+}
+
+inline unsigned in_range(uint64_t h, unsigned min, unsigned max)
+{
+    return (max > min) ? min + (unsigned)(h % (max - min + 1)) : min;
+}
+
+enum Field : uint64_t { WIDTH = 1, HEIGHT, LABEL, BOX_COUNT, COLORS, NOISE, BOX = 64 };
+
+struct Rgb { int c[3]; };
+
+Rgb color(uint64_t h)
+{
+    return Rgb{{(int)(h & 0xFF), (int)((h >> 8) & 0xFF), (int)((h >> 16) & 0xFF)}};
+}
+}
+
+std::string synthetic_sample_name(size_t index)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "%s%08zu", SYNTHETIC_NAME_PREFIX, index);
+    return name;
+}
+
+bool synthetic_sample_index(const std::string &name, size_t &index)
+{
+    const size_t prefix_size = sizeof(SYNTHETIC_NAME_PREFIX) - 1;
+    if(name.compare(0, prefix_size, SYNTHETIC_NAME_PREFIX) != 0 || name.size() == prefix_size)
+        return false;
+    char *end = nullptr;
+    index = strtoull(name.c_str() + prefix_size, &end, 10);
+    return *end == '\0';
+}
+
+SyntheticImageDesc synthetic_image_desc(const SyntheticDataConfig &config, size_t index)
+{
+    SyntheticImageDesc desc = {};
+    memcpy(desc.magic, SYNTHETIC_MAGIC, sizeof(desc.magic));
+    desc.seed = config.seed;
+    desc.variant = index % std::max(config.distinct_images, 1u);
+    desc.width = in_range(hash(config.seed, desc.variant, WIDTH), config.min_width, config.max_width);
+    desc.height = in_range(hash(config.seed, desc.variant, HEIGHT), config.min_height, config.max_height);
+    desc.max_boxes = config.max_boxes;
+    desc.num_classes = std::max(config.num_classes, 1u);
+    return desc;
+}
+
+bool synthetic_parse_image_desc(const unsigned char *buffer, size_t size, SyntheticImageDesc &desc)
+{
+    if(size < sizeof(SyntheticImageDesc) || memcmp(buffer, SYNTHETIC_MAGIC, sizeof(SYNTHETIC_MAGIC)) != 0)
+        return false;
+    memcpy(&desc, buffer, sizeof(SyntheticImageDesc));
+    return desc.width > 0 && desc.height > 0;
+}
+
+int synthetic_label(const SyntheticDataConfig &config, size_t index)
+{
+    return (int)(hash(config.seed, index, LABEL) % std::max(config.num_classes, 1u));
+}
+
+void synthetic_boxes(const SyntheticImageDesc &desc, BoundingBoxCords &boxes, BoundingBoxLabels &labels)
+{
+    boxes.clear();
+    labels.clear();
+    if(desc.max_boxes == 0)
+        return;
+    const unsigned count = 1 + hash(desc.seed, desc.variant, BOX_COUNT) % desc.max_boxes;
+    for(unsigned i = 0; i < count; i++)
+    {
+        const uint64_t field = BOX + 8 * i;
+        const float w = 0.05f + 0.45f * unit(hash(desc.seed, desc.variant, field));
+        const float h = 0.05f + 0.45f * unit(hash(desc.seed, desc.variant, field + 1));
+        const float l = (1.0f - w) * unit(hash(desc.seed, desc.variant, field + 2));
+        const float t = (1.0f - h) * unit(hash(desc.seed, desc.variant, field + 3));
+        boxes.emplace_back(l, t, l + w, t + h);
+        labels.push_back(1 + (int)(hash(desc.seed, desc.variant, field + 4) % desc.num_classes));
+    }
+}
+
+void synthetic_render(const SyntheticImageDesc &desc, unsigned char *output, unsigned width, unsigned height, size_t stride, unsigned planes, bool bgr)
+{
+    // A gradient background with the boxes filled on top, plus some noise so that JPEG encoding and the augmentations see texture
+    const Rgb base = color(hash(desc.seed, desc.variant, COLORS));
+    const Rgb grad_x = color(hash(desc.seed, desc.variant, COLORS + 1));
+    const Rgb grad_y = color(hash(desc.seed, desc.variant, COLORS + 2));
+    BoundingBoxCords boxes;
+    BoundingBoxLabels labels;
+    synthetic_boxes(desc, boxes, labels);
+    std::vector<Rgb> box_colors(boxes.size());
+    for(size_t i = 0; i < boxes.size(); i++)
+        box_colors[i] = color(hash(desc.seed, desc.variant, BOX + 8 * i + 5));
+    const int order[3] = {bgr ? 2 : 0, 1, bgr ? 0 : 2};
+    auto store = [&](unsigned char *pixel, const int (&value)[3], uint64_t noise)
+    {
+        int v[3];
+        for(int c = 0; c < 3; c++)
+            v[c] = std::min(255, std::max(0, value[order[c]] + (int)((noise >> (8 * c)) & 0x1F) - 16));
+        if(planes == 1)
+        {
+            pixel[0] = (unsigned char)((v[0] + v[1] + v[2]) / 3);
+            return;
+        }
+        for(int c = 0; c < 3; c++)
+            pixel[c] = (unsigned char)v[c];
+    };
+    for(unsigned y = 0; y < height; y++)
+    {
+        unsigned char *row = output + y * stride;
+        uint64_t noise_state = hash(desc.seed, desc.variant, NOISE + y);
+        for(unsigned x = 0; x < width; x++)
+        {
+            // xorshift, one draw per pixel
+            noise_state ^= noise_state << 13;
+            noise_state ^= noise_state >> 7;
+            noise_state ^= noise_state << 17;
+            int value[3];
+            for(int c = 0; c < 3; c++)
+                value[c] = (base.c[c] >> 1) + (int)((grad_x.c[c] >> 1) * x / width) + (int)((grad_y.c[c] >> 1) * y / height);
+            store(row + x * planes, value, noise_state);
+        }
+        for(size_t i = 0; i < boxes.size(); i++)
+        {
+            if(y < (unsigned)(boxes[i].t * height) || y >= (unsigned)(boxes[i].b * height))
+                continue;
+            const unsigned x_end = std::min(width, (unsigned)(boxes[i].r * width));
+            for(unsigned x = (unsigned)(boxes[i].l * width); x < x_end; x++)
+                store(row + x * planes, box_colors[i].c, noise_state >> (x & 31));
+        }
+    }
+}
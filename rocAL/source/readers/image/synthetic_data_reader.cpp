@@ -0,0 +1,151 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <random>
+#include <turbojpeg.h>
+#include "synthetic_data_reader.h"
+#include "commons.h"
+
+namespace
+{
+using JpegImages = std::vector<std::vector<unsigned char>>;
+
+std::shared_ptr<const JpegImages> encode_jpeg_images(const SyntheticDataConfig &config)
+{
+    // The shards of a loader all use the same images, the first one to get here encodes them and the others reuse them
+    static std::mutex pool_lock;
+    static std::map<std::string, std::weak_ptr<const JpegImages>> pools;
+    const std::string key = TOSTR(config.seed) + "_" + TOSTR(config.distinct_images) + "_" + TOSTR(config.min_width) + "_" + TOSTR(config.max_width) + "_" +
+                            TOSTR(config.min_height) + "_" + TOSTR(config.max_height) + "_" + TOSTR(config.max_boxes) + "_" +
+                            TOSTR(config.num_classes) + "_" + TOSTR(config.jpeg_quality) + "_" + TOSTR(config.sample_count);
+    std::unique_lock<std::mutex> lock(pool_lock);
+    if(auto images = pools[key].lock())
+        return images;
+    auto images = std::make_shared<JpegImages>(std::min<size_t>(std::max(config.distinct_images, 1u), config.sample_count));
+    tjhandle compressor = tjInitCompress();
+    if(!compressor)
+        THROW("SyntheticDataReader: cannot create the JPEG compressor " + STR(tjGetErrorStr2(compressor)))
+    std::vector<unsigned char> pixels;
+    for(size_t variant = 0; variant < images->size(); variant++)
+    {
+        auto desc = synthetic_image_desc(config, variant);
+        pixels.resize((size_t)desc.width * desc.height * 3);
+        synthetic_render(desc, pixels.data(), desc.width, desc.height, desc.width * 3, 3, false);
+        unsigned char *jpeg = nullptr;
+        unsigned long jpeg_size = 0;
+        if(tjCompress2(compressor, pixels.data(), desc.width, 0, desc.height, TJPF_RGB, &jpeg, &jpeg_size, TJSAMP_420, config.jpeg_quality, TJFLAG_FASTDCT) != 0)
+        {
+            tjDestroy(compressor);
+            THROW("SyntheticDataReader: JPEG encoding failed " + STR(tjGetErrorStr2(compressor)))
+        }
+        (*images)[variant].assign(jpeg, jpeg + jpeg_size);
+        tjFree(jpeg);
+    }
+    tjDestroy(compressor);
+    pools[key] = images;
+    return images;
+}
+}
+
+unsigned SyntheticDataReader::count_items()
+{
+    if(_loop)
+        return _sample_indices.size();
+    int ret = ((int)_sample_indices.size() - (int)_read_counter);
+    return ((ret < 0) ? 0 : ret);
+}
+
+Reader::Status SyntheticDataReader::initialize(ReaderConfig desc)
+{
+    _config = desc.synthetic_data_config();
+    _shard_id = desc.get_shard_id();
+    _shard_count = desc.get_shard_count();
+    _batch_count = std::max<size_t>(desc.get_batch_size(), 1);
+    _shuffle = desc.shuffle();
+    _loop = desc.loop();
+    if(_config.sample_count == 0)
+        THROW("SyntheticDataReader: the sample count cannot be 0")
+    if(_config.min_width == 0 || _config.min_height == 0 || _config.min_width > _config.max_width || _config.min_height > _config.max_height)
+        THROW("SyntheticDataReader: invalid image size range " + TOSTR(_config.min_width) + "-" + TOSTR(_config.max_width) + " x " +
+              TOSTR(_config.min_height) + "-" + TOSTR(_config.max_height))
+    // Samples are dealt round robin to the shards, like the files of the FileSourceReader, and every shard is padded
+    // with its first samples to the same count, a multiple of the batch size
+    for(size_t index = _shard_id; index < _config.sample_count; index += _shard_count)
+        _sample_indices.push_back(index);
+    size_t shard_size = (_config.sample_count + _shard_count - 1) / _shard_count;
+    shard_size = ((shard_size + _batch_count - 1) / _batch_count) * _batch_count;
+    for(size_t i = 0; _sample_indices.size() < shard_size; i++)
+        _sample_indices.push_back(_sample_indices.empty() ? i % _config.sample_count : _sample_indices[i]);
+    if(_config.jpeg_encoded)
+        _jpeg_images = encode_jpeg_images(_config);
+    if(_shuffle)
+        shuffle();
+    return Reader::Status::OK;
+}
+
+void SyntheticDataReader::shuffle()
+{
+    // Seeded with the epoch so that the order is the same from one run to the next
+    std::mt19937_64 rng(_config.seed ^ ((uint64_t)_shard_id << 32) ^ _epoch);
+    std::shuffle(_sample_indices.begin(), _sample_indices.end(), rng);
+}
+
+size_t SyntheticDataReader::open()
+{
+    const size_t index = _sample_indices[_curr_sample_idx];
+    _read_counter++;
+    _curr_sample_idx = (_curr_sample_idx + 1) % _sample_indices.size();
+    _last_id = synthetic_sample_name(index);
+    _current_desc = synthetic_image_desc(_config, index);
+    if(_jpeg_images)
+    {
+        auto &jpeg = (*_jpeg_images)[_current_desc.variant % _jpeg_images->size()];
+        _current_data = jpeg.data();
+        _current_size = jpeg.size();
+    }
+    else
+    {
+        _current_data = reinterpret_cast<const unsigned char *>(&_current_desc);
+        _current_size = sizeof(_current_desc);
+    }
+    return _current_size;
+}
+
+size_t SyntheticDataReader::read_data(unsigned char* buf, size_t read_size)
+{
+    read_size = std::min(read_size, _current_size);
+    memcpy(buf, _current_data, read_size);
+    return read_size;
+}
+
+void SyntheticDataReader::reset()
+{
+    _epoch++;
+    if(_shuffle)
+        shuffle();
+    _read_counter = 0;
+    _curr_sample_idx = 0;
+}
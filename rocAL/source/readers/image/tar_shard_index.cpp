@@ -0,0 +1,274 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "tar_shard_index.h"
+#include "commons.h"
+
+namespace
+{
+const size_t TAR_BLOCK_SIZE = 512;
+
+size_t round_to_block(size_t size)
+{
+    return ((size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE) * TAR_BLOCK_SIZE;
+}
+
+std::string header_string(const char *field, size_t length)
+{
+    return std::string(field, strnlen(field, length));
+}
+
+//! Numeric header fields are octal text, or base-256 when the top bit of the first byte is set (GNU extension for the large sizes)
+size_t header_number(const char *field, size_t length)
+{
+    size_t value = 0;
+    if(static_cast<unsigned char>(field[0]) & 0x80)
+    {
+        value = static_cast<unsigned char>(field[0]) & 0x7f;
+        for(size_t i = 1; i < length; i++)
+            value = (value << 8) | static_cast<unsigned char>(field[i]);
+        return value;
+    }
+    for(size_t i = 0; i < length && field[i]; i++)
+    {
+        if(field[i] == ' ')
+            continue;
+        if(field[i] < '0' || field[i] > '7')
+            break;
+        value = (value << 3) | (field[i] - '0');
+    }
+    return value;
+}
+
+bool valid_header_checksum(const char *header)
+{
+    size_t sum = 0;
+    for(size_t i = 0; i < TAR_BLOCK_SIZE; i++)
+        sum += (i >= 148 && i < 156) ? ' ' : static_cast<unsigned char>(header[i]);
+    return sum == header_number(header + 148, 8);
+}
+
+//! Value of the "key=value" record of a pax extended header, empty if not present
+std::string pax_value(const std::string &records, const std::string &key)
+{
+    size_t pos = 0;
+    while(pos < records.size())
+    {
+        size_t space = records.find(' ', pos);
+        if(space == std::string::npos)
+            break;
+        size_t length = std::stoull(records.substr(pos, space - pos));
+        if(length == 0 || pos + length > records.size())
+            break;
+        std::string record = records.substr(space + 1, pos + length - space - 2);// without the trailing new line
+        if(record.compare(0, key.size() + 1, key + "=") == 0)
+            return record.substr(key.size() + 1);
+        pos += length;
+    }
+    return std::string();
+}
+
+bool read_exactly(int fd, void *buffer, size_t size, size_t offset)
+{
+    return pread(fd, buffer, size, offset) == (ssize_t)size;
+}
+
+void index_tar_file(const std::string &path, TarShardFile &file)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        THROW("TarShardIndex: failed opening " + path)
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0)
+    {
+        ::close(fd);
+        THROW("TarShardIndex: failed reading the size of " + path)
+    }
+    const size_t file_size = file_stat.st_size;
+    file.path = path;
+    std::unordered_map<std::string, size_t> sample_of_key;
+    char header[TAR_BLOCK_SIZE];
+    std::string long_name, pax_path;
+    size_t pax_size = 0;
+    bool has_pax_size = false;
+    size_t offset = 0;
+    while(offset + TAR_BLOCK_SIZE <= file_size)
+    {
+        if(!read_exactly(fd, header, TAR_BLOCK_SIZE, offset))
+            break;
+        if(header[0] == '\0' && std::all_of(header, header + TAR_BLOCK_SIZE, [](char c) { return c == '\0'; }))
+            break;// end of archive
+        if(!valid_header_checksum(header))
+        {
+            ::close(fd);
+            THROW("TarShardIndex: " + path + " is not a tar file or is corrupted, invalid header at offset " + TOSTR(offset))
+        }
+        const char type = header[156];
+        size_t size = has_pax_size ? pax_size : header_number(header + 124, 12);
+        const size_t data_offset = offset + TAR_BLOCK_SIZE;
+        offset = data_offset + round_to_block(size);
+        if(data_offset + size > file_size)
+        {
+            ::close(fd);
+            THROW("TarShardIndex: " + path + " is truncated")
+        }
+        if(type == 'L' || type == 'x')
+        {
+            // GNU long name and pax extended header, both apply to the next member
+            std::string data(size, '\0');
+            if(!read_exactly(fd, &data[0], size, data_offset))
+                break;
+            if(type == 'L')
+            {
+                long_name = header_string(data.c_str(), data.size());
+            }
+            else
+            {
+                pax_path = pax_value(data, "path");
+                auto pax_size_text = pax_value(data, "size");
+                has_pax_size = !pax_size_text.empty();
+                pax_size = has_pax_size ? std::stoull(pax_size_text) : 0;
+            }
+            continue;
+        }
+        std::string name;
+        if(!pax_path.empty())
+            name = pax_path;
+        else if(!long_name.empty())
+            name = long_name;
+        else
+        {
+            name = header_string(header, 100);
+            auto prefix = header_string(header + 345, 155);
+            if(memcmp(header + 257, "ustar", 5) == 0 && !prefix.empty())
+                name = prefix + "/" + name;
+        }
+        long_name.clear();
+        pax_path.clear();
+        has_pax_size = false;
+        if(type != '0' && type != '\0' && type != '7')
+            continue;// directories, links and global headers
+        auto slash = name.find_last_of('/');
+        auto base_start = (slash == std::string::npos) ? 0 : slash + 1;
+        auto dot = name.find('.', base_start);
+        if(dot == std::string::npos || dot == base_start)
+            continue;// no extension, or a hidden file
+        std::string extension = name.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        TarMember member;
+        member.offset = data_offset;
+        member.size = size;
+        const std::string key = name.substr(0, dot);
+        auto it = sample_of_key.find(key);
+        if(it == sample_of_key.end())
+        {
+            it = sample_of_key.emplace(key, file.samples.size()).first;
+            file.samples.emplace_back();
+            file.samples.back().key = key;
+        }
+        auto &sample = file.samples[it->second];
+        if(extension == "jpg" || extension == "jpeg" || extension == "png")
+            sample.image = member;
+        else if(extension == "cls")
+            sample.label = member;
+        else if(extension == "json")
+            sample.boxes = member;
+    }
+    ::close(fd);
+    file.samples.erase(std::remove_if(file.samples.begin(), file.samples.end(), [](const TarShardSample &sample) { return !sample.image.valid(); }),
+                       file.samples.end());
+    std::sort(file.samples.begin(), file.samples.end(), [](const TarShardSample &a, const TarShardSample &b) { return a.image.offset < b.image.offset; });
+}
+
+bool is_tar_file(const std::string &name)
+{
+    return name.size() > 4 && name.compare(name.size() - 4, 4, ".tar") == 0;
+}
+
+std::shared_ptr<const TarShardIndex> build_tar_shard_index(const std::string &path)
+{
+    auto index = std::make_shared<TarShardIndex>();
+    struct stat path_stat;
+    if(stat(path.c_str(), &path_stat) != 0)
+        THROW("TarShardIndex: failed accessing " + path)
+    std::vector<std::string> paths;
+    if(S_ISDIR(path_stat.st_mode))
+    {
+        DIR *dir = opendir(path.c_str());
+        if(!dir)
+            THROW("TarShardIndex: failed opening the directory at " + path)
+        while(auto entity = readdir(dir))
+        {
+            std::string name(entity->d_name);
+            if(entity->d_type == DT_REG && name[0] != '.' && is_tar_file(name))
+                paths.push_back(path + "/" + name);
+        }
+        closedir(dir);
+        std::sort(paths.begin(), paths.end());
+    }
+    else
+    {
+        paths.push_back(path);
+    }
+    index->files.resize(paths.size());
+    for(size_t file_idx = 0; file_idx < paths.size(); file_idx++)
+    {
+        index_tar_file(paths[file_idx], index->files[file_idx]);
+        if(index->files[file_idx].samples.empty())
+            WRN("TarShardIndex: no image in " + paths[file_idx])
+    }
+    if(index->sample_count() == 0)
+        THROW("TarShardIndex: did not find any image in the tar shards at " + path)
+    LOG("TarShardIndex: " + TOSTR(index->sample_count()) + " samples in " + TOSTR(index->files.size()) + " tar files at " + path)
+    return index;
+}
+}
+
+size_t TarShardIndex::sample_count() const
+{
+    size_t count = 0;
+    for(auto &file : files)
+        count += file.samples.size();
+    return count;
+}
+
+std::shared_ptr<const TarShardIndex> load_tar_shard_index(const std::string &path)
+{
+    // The shards of a loader and the meta data reader all need the index, the first one to get here builds it and the others reuse it
+    static std::mutex index_lock;
+    static std::map<std::string, std::weak_ptr<const TarShardIndex>> indices;
+    std::unique_lock<std::mutex> lock(index_lock);
+    if(auto index = indices[path].lock())
+        return index;
+    auto index = build_tar_shard_index(path);
+    indices[path] = index;
+    return index;
+}
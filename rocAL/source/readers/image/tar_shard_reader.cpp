@@ -0,0 +1,228 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "tar_shard_reader.h"
+#include "parameter_factory.h"
+#include "commons.h"
+
+namespace
+{
+//! The tar files are read in chunks of at least this size
+const size_t STREAM_CHUNK_SIZE = 8 << 20;
+}
+
+unsigned TarShardReader::count_items()
+{
+    if(_loop)
+        return _shard_size;
+    int ret = ((int)_shard_size - (int)_read_counter);
+    return ((ret < 0) ? 0 : ret);
+}
+
+Reader::Status TarShardReader::initialize(ReaderConfig desc)
+{
+    _shard_id = desc.get_shard_id();
+    _shard_count = desc.get_shard_count();
+    _batch_count = std::max<size_t>(desc.get_batch_size(), 1);
+    _shuffle = desc.shuffle();
+    _loop = desc.loop();
+    _shuffle_buffer_capacity = _shuffle ? desc.shuffle_buffer_size() : 0;
+    std::seed_seq seed{ParameterFactory::instance()->get_seed(), (unsigned)_shard_id};
+    _rng.seed(seed);
+    _index = load_tar_shard_index(desc.path());
+    if(_index->files.size() < _shard_count)
+        THROW("TarShardReader ShardID [" + TOSTR(_shard_id) + "] ERROR: " + TOSTR(_index->files.size()) + " tar files at " + desc.path() +
+              " cannot be split into " + TOSTR(_shard_count) + " shards, the tar files are the unit of sharding")
+
+    // Whole tar files are dealt round robin to the shards, the shards are padded with their first samples to the size of the largest one, a multiple of the batch size
+    std::vector<size_t> shard_sample_counts(_shard_count, 0);
+    for(unsigned file_idx = 0; file_idx < _index->files.size(); file_idx++)
+    {
+        shard_sample_counts[file_idx % _shard_count] += _index->files[file_idx].samples.size();
+        if(file_idx % _shard_count == _shard_id)
+            _files.push_back(file_idx);
+    }
+    if(shard_sample_counts[_shard_id] == 0)
+        THROW("TarShardReader ShardID [" + TOSTR(_shard_id) + "] ERROR: no image in the tar files of the shard")
+    _shard_size = *std::max_element(shard_sample_counts.begin(), shard_sample_counts.end());
+    _shard_size = ((_shard_size + _batch_count - 1) / _batch_count) * _batch_count;
+    _shuffle_buffer.reserve(_shuffle_buffer_capacity);
+    LOG("TarShardReader ShardID [" + TOSTR(_shard_id) + "] Total of " + TOSTR(_shard_size) + " samples in " + TOSTR(_files.size()) + " tar files loaded from " + desc.path())
+    start_epoch();
+    return Reader::Status::OK;
+}
+
+void TarShardReader::start_epoch()
+{
+    if(_shuffle)
+        std::shuffle(_files.begin(), _files.end(), _rng);
+    _file_pos = 0;
+    _sample_pos = 0;
+    _streamed_count = 0;
+    _shuffle_buffer.clear();
+    close_stream();
+}
+
+void TarShardReader::close_stream()
+{
+    if(_fd >= 0)
+        ::close(_fd);
+    _fd = -1;
+    _stream_buffer_size = 0;
+}
+
+const unsigned char *TarShardReader::fetch(unsigned file_idx, const TarMember &member)
+{
+    if(_fd < 0 || _stream_file != file_idx)
+    {
+        close_stream();
+        auto &path = _index->files[file_idx].path;
+        _fd = ::open(path.c_str(), O_RDONLY);
+        if(_fd < 0)
+        {
+            WRN("TarShardReader ShardID [" + TOSTR(_shard_id) + "] failed opening " + path)
+            return nullptr;
+        }
+        struct stat file_stat;
+        _stream_file_size = (fstat(_fd, &file_stat) == 0) ? file_stat.st_size : 0;
+        posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        _stream_file = file_idx;
+    }
+    if(member.offset >= _stream_buffer_offset && member.offset + member.size <= _stream_buffer_offset + _stream_buffer_size)
+        return _stream_buffer.data() + (member.offset - _stream_buffer_offset);
+
+    // The samples are read in file order, so the next chunk starts at the member and the skipped bytes are never needed again
+    if(member.offset + member.size > _stream_file_size)
+        return nullptr;
+    const size_t chunk_size = std::min(std::max(STREAM_CHUNK_SIZE, member.size), _stream_file_size - member.offset);
+    if(_stream_buffer.size() < chunk_size)
+        _stream_buffer.resize(chunk_size);
+    _stream_buffer_offset = member.offset;
+    _stream_buffer_size = 0;
+    while(_stream_buffer_size < chunk_size)
+    {
+        ssize_t read_size = pread(_fd, _stream_buffer.data() + _stream_buffer_size, chunk_size - _stream_buffer_size, _stream_buffer_offset + _stream_buffer_size);
+        if(read_size <= 0)
+            break;
+        _stream_buffer_size += read_size;
+    }
+    if(_stream_buffer_size < member.size)
+    {
+        WRN("TarShardReader ShardID [" + TOSTR(_shard_id) + "] failed reading " + _index->files[file_idx].path + " at offset " + TOSTR(member.offset))
+        return nullptr;
+    }
+    return _stream_buffer.data();
+}
+
+bool TarShardReader::stream_next(const TarShardSample *&sample, const unsigned char *&data)
+{
+    if(_streamed_count >= _shard_size)
+        return false;
+    // Past the last file of the shard the epoch is padded from its first file again
+    while(_sample_pos >= _index->files[_files[_file_pos]].samples.size())
+    {
+        _file_pos = (_file_pos + 1) % _files.size();
+        _sample_pos = 0;
+    }
+    const unsigned file_idx = _files[_file_pos];
+    sample = &_index->files[file_idx].samples[_sample_pos++];
+    _streamed_count++;
+    data = fetch(file_idx, sample->image);
+    return true;
+}
+
+size_t TarShardReader::open()
+{
+    if(_streamed_count >= _shard_size && _shuffle_buffer.empty())
+        start_epoch();
+    _read_counter++;
+    const TarShardSample *sample = nullptr;
+    const unsigned char *data = nullptr;
+    if(_shuffle_buffer_capacity <= 1)
+    {
+        stream_next(sample, data);
+        _last_id = sample->key;
+        _current_data = data;
+        _current_size = data ? sample->image.size : 0;
+        return _current_size;
+    }
+
+    while(_shuffle_buffer.size() < _shuffle_buffer_capacity && stream_next(sample, data))
+    {
+        _shuffle_buffer.emplace_back();
+        _shuffle_buffer.back().key = sample->key;
+        if(data)
+            _shuffle_buffer.back().data.assign(data, data + sample->image.size);
+    }
+    // The picked sample is replaced by the next streamed one, the buffers are swapped around so that their allocations are reused
+    const size_t picked = std::uniform_int_distribution<size_t>(0, _shuffle_buffer.size() - 1)(_rng);
+    std::swap(_current_sample, _shuffle_buffer[picked]);
+    if(stream_next(sample, data))
+    {
+        _shuffle_buffer[picked].key = sample->key;
+        if(data)
+            _shuffle_buffer[picked].data.assign(data, data + sample->image.size);
+        else
+            _shuffle_buffer[picked].data.clear();
+    }
+    else
+    {
+        std::swap(_shuffle_buffer[picked], _shuffle_buffer.back());
+        _shuffle_buffer.pop_back();
+    }
+    _last_id = _current_sample.key;
+    _current_data = _current_sample.data.data();
+    _current_size = _current_sample.data.size();
+    return _current_size;
+}
+
+size_t TarShardReader::read_data(unsigned char* buf, size_t read_size)
+{
+    if(!_current_data)
+        return 0;
+    read_size = std::min(read_size, _current_size);
+    memcpy(buf, _current_data, read_size);
+    return read_size;
+}
+
+int TarShardReader::close()
+{
+    _current_data = nullptr;
+    _current_size = 0;
+    return 0;
+}
+
+void TarShardReader::reset()
+{
+    start_epoch();
+    _read_counter = 0;
+}
+
+TarShardReader::~TarShardReader()
+{
+    close_stream();
+}
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include <cassert>
 #include <commons.h>
 #include "tf_record_reader.h"
+#include "parameter_factory.h"
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 #include <iostream>
@@ -66,6 +67,8 @@ Reader::Status TFRecordReader::initialize(ReaderConfig desc)
     _path = desc.path();
     _feature_key_map = desc.feature_key_map();
     _shard_id = desc.get_shard_id();
+    std::seed_seq seed{ParameterFactory::instance()->get_seed(), (unsigned)_shard_id};
+    _rng.seed(seed);
     _shard_count = desc.get_shard_count();
     _batch_count = desc.get_batch_size();
     _loop = desc.loop();
@@ -84,7 +87,7 @@ Reader::Status TFRecordReader::initialize(ReaderConfig desc)
     }
     //shuffle dataset if set
     if (ret == Reader::Status::OK && _shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
     return ret;
 }
 
@@ -133,7 +136,7 @@ int TFRecordReader::release()
 void TFRecordReader::reset()
 {
     if (_shuffle)
-        std::random_shuffle(_file_names.begin(), _file_names.end());
+        std::shuffle(_file_names.begin(), _file_names.end(), _rng);
     _read_counter = 0;
     _curr_file_idx = 0;
 }
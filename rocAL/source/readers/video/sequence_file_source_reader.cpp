@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <algorithm>
 #include <commons.h>
 #include "sequence_file_source_reader.h"
+#include "parameter_factory.h"
 #include <boost/filesystem.hpp>
 
 namespace filesys = boost::filesystem;
@@ -56,6 +57,8 @@ Reader::Status SequenceFileSourceReader::initialize(ReaderConfig desc)
     _sequence_id = 0;
     _folder_path = desc.path();
     _shard_id = desc.get_shard_id();
+    std::seed_seq seed{ParameterFactory::instance()->get_seed(), (unsigned)_shard_id};
+    _rng.seed(seed);
     _shard_count = desc.get_shard_count();
     _user_batch_count = desc.get_batch_size();
     _shuffle = desc.shuffle();
@@ -63,7 +66,11 @@ Reader::Status SequenceFileSourceReader::initialize(ReaderConfig desc)
     _sequence_length = desc.get_sequence_length();
     _step = desc.get_frame_step();
     _stride = desc.get_frame_stride();
-    _batch_count = _user_batch_count / _sequence_length;
+    _new_order = desc.get_sequence_rearrange();
+    for (auto position : _new_order)
+        if (position >= _sequence_length)
+            THROW("SequenceReader ShardID [" + TOSTR(_shard_id) + "] Rearranged frame position " + TOSTR(position) + " is out of the sequence of length " + TOSTR(_sequence_length))
+    _batch_count = _user_batch_count / (_new_order.empty() ? _sequence_length : _new_order.size());
     ret = subfolder_reading();
     if (ret != Reader::Status::OK)
         return ret;
@@ -83,7 +90,7 @@ Reader::Status SequenceFileSourceReader::initialize(ReaderConfig desc)
 
     //shuffle dataset if set
     if (ret == Reader::Status::OK && _shuffle)
-        std::random_shuffle(_sequence_frame_names.begin(), _sequence_frame_names.end());
+        std::shuffle(_sequence_frame_names.begin(), _sequence_frame_names.end(), _rng);
 
     for(auto && seq : _sequence_frame_names)
     {
@@ -157,7 +164,7 @@ int SequenceFileSourceReader::release()
 void SequenceFileSourceReader::reset()
 {
     if (_shuffle)
-        std::random_shuffle(_sequence_frame_names.begin(), _sequence_frame_names.end());
+        std::shuffle(_sequence_frame_names.begin(), _sequence_frame_names.end(), _rng);
 
     _read_counter = 0;
     _curr_file_idx = 0;
@@ -187,9 +194,18 @@ Reader::Status SequenceFileSourceReader::get_sequences()
             _in_batch_read_count++;
             _in_batch_read_count = (_in_batch_read_count % _batch_count == 0) ? 0 : _in_batch_read_count;
             std::vector<std::string> temp_sequence;
-            for (unsigned frame_count = 0, frame_idx = file_idx; (frame_count < _sequence_length); frame_count++, frame_idx += _stride)
+            if (_new_order.empty())
             {
-                temp_sequence.push_back(_folder_file_names[folder_idx][frame_idx]);
+                for (unsigned frame_count = 0, frame_idx = file_idx; (frame_count < _sequence_length); frame_count++, frame_idx += _stride)
+                {
+                    temp_sequence.push_back(_folder_file_names[folder_idx][frame_idx]);
+                }
+            }
+            else
+            {
+                // Only the frames referenced by the new order are listed, already in their output order
+                for (auto position : _new_order)
+                    temp_sequence.push_back(_folder_file_names[folder_idx][file_idx + position * _stride]);
             }
             _last_sequence = temp_sequence;
             _sequence_frame_names.push_back(temp_sequence);
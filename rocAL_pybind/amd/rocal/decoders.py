@@ -94,6 +94,21 @@ def image(*inputs, user_feature_key_map=None, path='', file_root='', annotations
             "dec_type" : decoder_type}
         decoded_image = b.Caffe_ImageDecoderShard(Pipeline._current_pipeline._handle, *(kwargs_pybind.values()))
 
+    elif reader == "TarShardReader" or reader == "TarShardReaderDetection":
+        kwargs_pybind = {
+            "source_path": path,
+            "color_format": output_type,
+            "num_shards": num_shards,
+            'is_output': False,
+            "shuffle": random_shuffle,
+            "loop": False,
+            "decode_size_policy": decode_size_policy,
+            "max_width": max_decoded_width,
+            "max_height": max_decoded_height,
+            "dec_type" : types.DECODER_TJPEG,
+            "shuffle_buffer_size": Pipeline._current_pipeline._reader_initial_fill}
+        decoded_image = b.TarShard_ImageDecoder(Pipeline._current_pipeline._handle, *(kwargs_pybind.values()))
+
     else:
         kwargs_pybind = {
             "source_path": file_root,
@@ -24,6 +24,8 @@ import numpy as np
 import cupy as cp
 import ctypes
 import functools
+import asyncio
+from concurrent.futures import ThreadPoolExecutor
 import inspect
 
 
@@ -114,7 +116,8 @@ class Pipeline(object):
         self._check_crop_ops = ["Resize"]
         self._check_ops_decoder = ["ImageDecoder", "ImageDecoderSlice" , "ImageDecoderRandomCrop", "ImageDecoderRaw"]
         self._check_ops_reader = ["labelReader", "TFRecordReaderClassification", "TFRecordReaderDetection",
-            "COCOReader", "Caffe2Reader", "Caffe2ReaderDetection", "CaffeReader", "CaffeReaderDetection"]
+            "COCOReader", "Caffe2Reader", "Caffe2ReaderDetection", "CaffeReader", "CaffeReaderDetection",
+            "TarShardReader", "TarShardReaderDetection"]
         self._batch_size = batch_size
         self._num_threads = num_threads
         self._device_id = device_id
@@ -123,6 +126,7 @@ class Pipeline(object):
         self._exec_pipelined = exec_pipelined
         self._prefetch_queue_depth = prefetch_queue_depth
         self._exec_async = exec_async
+        self._run_executor = None
         self._bytes_per_sample = bytes_per_sample
         self._rocal_cpu = rocal_cpu
         self._max_streams = max_streams
@@ -144,6 +148,7 @@ class Pipeline(object):
         self._castLabels = False
         self._current_pipeline = None
         self._reader = None
+        self._reader_initial_fill = 512
         self._define_graph_set = False
         self.set_seed(self._seed)
 
@@ -164,6 +169,42 @@ class Pipeline(object):
             print("Rocal Run failed")
         return status
 
+    def try_run(self):
+        """ Runs the pipeline like run() if the next batch is ready, otherwise returns None right away
+        """
+        status, ran = b.rocalTryRun(self._handle)
+        if not ran:
+            return None
+        if(status != types.OK):
+            print("Rocal Run failed")
+        return status
+
+    def run_async(self):
+        """ Runs the pipeline on a background thread and returns a concurrent.futures.Future of the run() status,
+        the GIL is released while waiting so the other Python threads keep running
+        """
+        if self._run_executor is None:
+            self._run_executor = ThreadPoolExecutor(max_workers=1)
+        return self._run_executor.submit(self.run)
+
+    async def run_awaitable(self):
+        """ Awaits the next batch on the running asyncio event loop, using the output ready file descriptor
+        """
+        fd = b.rocalGetOutputReadyFd(self._handle)
+        if fd < 0:
+            return await asyncio.get_running_loop().run_in_executor(None, self.run)
+        loop = asyncio.get_running_loop()
+        while True:
+            status = self.try_run()
+            if status is not None:
+                return status
+            ready = loop.create_future()
+            loop.add_reader(fd, lambda: ready.done() or ready.set_result(None))
+            try:
+                await ready
+            finally:
+                loop.remove_reader(fd)
+
     def define_graph(self):
         """This function is defined by the user to construct the
         graph of operations for their pipeline.
@@ -299,6 +340,11 @@ class Pipeline(object):
     def getEncodedBoxesAndLables(self, batch_size, num_anchors):
         return b.rocalGetEncodedBoxesAndLables(self._handle, batch_size, num_anchors)
 
+    def getOutputBatch(self):
+        """Zero-copy access to the batch of the last run(), the views it gives support __dlpack__ and the buffer protocol (host memory).
+        The batch is kept out of the pipeline's reuse till the returned object and all its views are gone, and should not outlive the pipeline."""
+        return b.OutputBatch(self._handle, self._batch_size, max(self._device_id, 0))
+
     def GetImgSizes(self, array):
         return b.getImgSizes(self._handle, array)
 
@@ -323,6 +369,22 @@ class Pipeline(object):
     def getRemainingImages(self):
         return b.getRemainingImages(self._handle)
 
+    def set_output_size(self, width, height):
+        # Applied on build() if called before it, otherwise on the next rocalResetLoaders()
+        return b.rocalSetOutputSize(self._handle, width, height)
+
+    def set_state_tracking(self, enable=True):
+        # Needed by save_state(), called before build()
+        return b.rocalSetStateTracking(self._handle, enable)
+
+    def save_state(self):
+        # State after the last batch returned by run(), as bytes to store with the training checkpoint
+        return b.rocalSaveState(self._handle)
+
+    def load_state(self, state):
+        # Resumes from a saved state, called before the graph is defined (the loader created)
+        b.rocalLoadState(self._handle, state)
+
     def rocalResetLoaders(self):
         return b.rocalResetLoaders(self._handle)
 
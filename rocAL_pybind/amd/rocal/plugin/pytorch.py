@@ -214,6 +214,16 @@ class ROCALGenericIterator(object):
 
     def reset(self):
         b.rocalResetLoaders(self.loader._handle)
+        # The output size set with Pipeline.set_output_size() takes effect on reset, the output tensor follows it
+        w = b.getOutputWidth(self.loader._handle)
+        h = b.getOutputHeight(self.loader._handle)
+        if w != self.w or h != self.h:
+            self.w, self.h = w, h
+            if self.tensor_format == types.NCHW:
+                shape = (self.bs*self.n, self.p, int(self.h/self.bs), self.w)
+            else:
+                shape = (self.bs*self.n, int(self.h/self.bs), self.w, self.p)
+            self.out = torch.empty(shape, dtype=self.out.dtype, device=self.out.device)
 
     def __iter__(self):
         return self
@@ -37,6 +37,50 @@ def coco(*inputs, file_root, annotations_file='', bytes_per_sample_hint=0, dump_
     meta_data = b.COCOReader(Pipeline._current_pipeline._handle ,*(kwargs_pybind.values()))
     return (meta_data, labels, bboxes)
 
+def synthetic(*inputs, num_samples=1024, min_width=640, max_width=640, min_height=480, max_height=480,
+              meta_data=types.SYNTHETIC_LABELS, num_classes=1000, max_boxes=8, jpeg_encoded=False, seed=0,
+              output_type=types.RGB, num_shards=1, random_shuffle=False, device=None):
+
+    Pipeline._current_pipeline._reader = "SyntheticReader"
+    #Output
+    kwargs_pybind = {
+        "color_format": output_type,
+        "num_shards": num_shards,
+        "is_output": False,
+        "num_samples": num_samples,
+        "min_width": min_width,
+        "max_width": max_width,
+        "min_height": min_height,
+        "max_height": max_height,
+        "meta_data": meta_data,
+        "num_classes": num_classes,
+        "max_boxes": max_boxes,
+        "jpeg_encoded": jpeg_encoded,
+        "seed": seed,
+        "shuffle": random_shuffle,
+        "loop": False}
+    images = b.SyntheticSource(Pipeline._current_pipeline._handle, *(kwargs_pybind.values()))
+    return images
+
+def numpy(*inputs, file_root, max_width, max_height, raw_width=0, raw_height=0, output_type=types.RGB,
+          num_shards=1, random_shuffle=False, device=None):
+
+    Pipeline._current_pipeline._reader = "NumpyReader"
+    #Output
+    kwargs_pybind = {
+        "source_path": file_root,
+        "color_format": output_type,
+        "num_shards": num_shards,
+        "is_output": False,
+        "max_width": max_width,
+        "max_height": max_height,
+        "shuffle": random_shuffle,
+        "loop": False,
+        "raw_width": raw_width,
+        "raw_height": raw_height}
+    images = b.NumpyFileSource(Pipeline._current_pipeline._handle, *(kwargs_pybind.values()))
+    return images
+
 def file(*inputs, file_root, bytes_per_sample_hint=0, file_list='', initial_fill='', lazy_init='',
          num_shards=1, pad_last_batch=False, prefetch_queue_depth=1, preserve=False, random_shuffle=False,
          read_ahead=False, seed=-1, shard_id=0, shuffle_after_epoch=False, skip_cached_images=False,
@@ -176,4 +220,21 @@ def sequence_reader(*inputs, file_root, sequence_length, bytes_per_sample_hint=0
     #Output
     kwargs_pybind = {"source_path": file_root,"color_format":image_type, "shard_count":num_shards, "sequence_length":sequence_length, "is_output":False, "shuffle":random_shuffle, "loop":False, "frame_step":step,"frame_stride":stride}
     frames = b.SequenceReader(Pipeline._current_pipeline._handle ,*(kwargs_pybind.values()))
-    return (frames)
\ No newline at end of file
+    return (frames)
+
+def tar(*inputs, path, bbox=False, initial_fill=512, num_shards=1, random_shuffle=False, device=None):
+
+    #Output
+    bboxes = []
+    labels = []
+    Pipeline._current_pipeline._reader_initial_fill = initial_fill
+    if (bbox == True):
+        Pipeline._current_pipeline._reader = "TarShardReaderDetection"
+        kwargs_pybind = {"source_path": path, "is_output":True}
+        tar_meta_data = b.TarShardReaderDetection(Pipeline._current_pipeline._handle ,*(kwargs_pybind.values()))
+        return (tar_meta_data, bboxes, labels)
+    else:
+        Pipeline._current_pipeline._reader = "TarShardReader"
+        kwargs_pybind = {"source_path": path}
+        tar_meta_data = b.TarShardReader(Pipeline._current_pipeline._handle ,*(kwargs_pybind.values()))
+        return (tar_meta_data, labels)
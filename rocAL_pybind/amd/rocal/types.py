@@ -69,6 +69,11 @@ from rocal_pybind.types import DECODER_HW_JEPG
 from rocal_pybind.types import DECODER_VIDEO_FFMPEG_SW
 from rocal_pybind.types import DECODER_VIDEO_FFMPEG_HW
 
+#     RocalSyntheticMetaData
+from rocal_pybind.types import SYNTHETIC_NO_META_DATA
+from rocal_pybind.types import SYNTHETIC_LABELS
+from rocal_pybind.types import SYNTHETIC_BOXES
+
 #     RocalResizeScalingMode
 from rocal_pybind.types import SCALING_MODE_DEFAULT
 from rocal_pybind.types import SCALING_MODE_STRETCH
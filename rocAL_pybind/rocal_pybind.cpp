@@ -24,6 +24,8 @@ THE SOFTWARE.
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <pybind11/embed.h>
 #include <pybind11/eval.h>
 #include "rocal_api_types.h"
@@ -54,7 +56,270 @@ namespace pybind11
         };
     }
 }  // namespace pybind11::detail
+
+// Subset of the DLPack (https://github.com/dmlc/dlpack) ABI needed to export the output batches, layouts have to match dlpack.h
+namespace dlpack
+{
+    enum DeviceType : int32_t { kDLCPU = 1, kDLOpenCL = 4, kDLROCM = 10 };
+    enum DataTypeCode : uint8_t { kDLInt = 0, kDLUInt = 1, kDLFloat = 2 };
+    struct DLDevice { int32_t device_type; int32_t device_id; };
+    struct DLDataType { uint8_t code; uint8_t bits; uint16_t lanes; };
+    struct DLTensor
+    {
+        void *data;
+        DLDevice device;
+        int32_t ndim;
+        DLDataType dtype;
+        int64_t *shape;
+        int64_t *strides;
+        uint64_t byte_offset;
+    };
+    struct DLManagedTensor
+    {
+        DLTensor dl_tensor;
+        void *manager_ctx;
+        void (*deleter)(DLManagedTensor *self);
+    };
+}
+
 namespace rocal{
+    constexpr int NUM_KEY_POINTS = 17;//!< Joints of a COCO person, NUMBER_OF_JOINTS of the library
+
+    //! Runs a call into the library without holding the GIL, so that the other Python threads keep running while it blocks or converts
+    template <typename Call>
+    auto without_gil(Call &&call)
+    {
+        py::gil_scoped_release release;
+        return call();
+    }
+
+    //! Output batches held on each context, a context released while some are left is released after the last one
+    struct ContextLeases
+    {
+        size_t count = 0;
+        bool release_pending = false;
+    };
+    std::mutex context_leases_lock;
+    std::map<RocalContext, ContextLeases> context_leases;
+
+    //! rocalRelease() deferred while views of the context's output batches are alive, their memory is the context's
+    RocalStatus release_context(RocalContext context)
+    {
+        {
+            std::lock_guard<std::mutex> lock(context_leases_lock);
+            auto it = context_leases.find(context);
+            if(it != context_leases.end())
+            {
+                it->second.release_pending = true;
+                return ROCAL_OK;
+            }
+        }
+        return rocalRelease(context);
+    }
+
+    //! Keeps an output batch acquired with rocalAcquireOutputBatch() till the last view of it is gone, and its context alive meanwhile
+    struct OutputBatchLease
+    {
+        OutputBatchLease(RocalContext context): context(context)
+        {
+            if(rocalAcquireOutputBatch(context, &lease) != ROCAL_OK)
+                throw std::runtime_error(rocalGetErrorMessage(context));
+            std::lock_guard<std::mutex> lock(context_leases_lock);
+            context_leases[context].count++;
+        }
+        ~OutputBatchLease()
+        {
+            rocalReleaseOutputBatch(context, lease);
+            bool release_pending = false;
+            {
+                std::lock_guard<std::mutex> lock(context_leases_lock);
+                auto it = context_leases.find(context);
+                if(--it->second.count == 0)
+                {
+                    release_pending = it->second.release_pending;
+                    context_leases.erase(it);
+                }
+            }
+            if(release_pending)
+                rocalRelease(context);
+        }
+        RocalContext context;
+        unsigned long long lease = 0;
+    };
+
+    //! Zero-copy view of one buffer of an acquired output batch, exported through DLPack and the buffer protocol (host memory only)
+    struct OutputBatchTensor
+    {
+        std::shared_ptr<OutputBatchLease> owner;
+        void *data = nullptr;
+        std::vector<int64_t> shape;
+        dlpack::DLDataType dtype;
+        std::string format;//!< buffer protocol format of an element
+        dlpack::DLDevice device;
+        size_t item_size() const { return dtype.bits / 8; }
+        std::vector<int64_t> strides() const
+        {
+            // contiguous strides in elements, as DLPack expects them
+            std::vector<int64_t> strides(shape.size(), 1);
+            for(int i = (int)shape.size() - 2; i >= 0; i--)
+                strides[i] = strides[i + 1] * shape[i + 1];
+            return strides;
+        }
+    };
+
+    //! Context of an exported DLManagedTensor, owns the shape/strides arrays and a reference to the lease
+    struct DLPackExport
+    {
+        std::shared_ptr<OutputBatchLease> owner;
+        std::vector<int64_t> shape, strides;
+        dlpack::DLManagedTensor managed;
+    };
+
+    template <typename T> dlpack::DLDataType dlpack_type();
+    template <> dlpack::DLDataType dlpack_type<unsigned char>() { return {dlpack::kDLUInt, 8, 1}; }
+    template <> dlpack::DLDataType dlpack_type<int>() { return {dlpack::kDLInt, 32, 1}; }
+    template <> dlpack::DLDataType dlpack_type<float>() { return {dlpack::kDLFloat, 32, 1}; }
+
+    template <typename T>
+    OutputBatchTensor make_output_batch_tensor(const std::shared_ptr<OutputBatchLease> &owner, void *data, std::vector<int64_t> shape, dlpack::DLDevice device)
+    {
+        OutputBatchTensor tensor;
+        tensor.owner = owner;
+        tensor.data = data;
+        tensor.shape = std::move(shape);
+        tensor.dtype = dlpack_type<T>();
+        tensor.format = py::format_descriptor<T>::format();
+        tensor.device = device;
+        return tensor;
+    }
+
+    py::capsule wrapper_to_dlpack(const OutputBatchTensor &tensor)
+    {
+        auto context = new DLPackExport;
+        context->owner = tensor.owner;
+        context->shape = tensor.shape;
+        context->strides = tensor.strides();
+        auto &dl_tensor = context->managed.dl_tensor;
+        dl_tensor.data = tensor.data;
+        dl_tensor.device = tensor.device;
+        dl_tensor.ndim = context->shape.size();
+        dl_tensor.dtype = tensor.dtype;
+        dl_tensor.shape = context->shape.data();
+        dl_tensor.strides = context->strides.data();
+        dl_tensor.byte_offset = 0;
+        context->managed.manager_ctx = context;
+        context->managed.deleter = [](dlpack::DLManagedTensor *self) { delete static_cast<DLPackExport *>(self->manager_ctx); };
+        // A consumer renames the capsule to "used_dltensor" and calls the deleter itself once done with the memory
+        return py::capsule(&context->managed, "dltensor", [](PyObject *capsule) {
+            if(PyCapsule_IsValid(capsule, "dltensor"))
+            {
+                auto managed = static_cast<dlpack::DLManagedTensor *>(PyCapsule_GetPointer(capsule, "dltensor"));
+                managed->deleter(managed);
+            }
+        });
+    }
+
+    //! Batch returned by the last rocalRun() call, held in the pipeline's output queue till this object and all the views taken from it are gone
+    class OutputBatch
+    {
+    public:
+        OutputBatch(RocalContext context, unsigned batch_size, int device_id): _lease(std::make_shared<OutputBatchLease>(context)), _batch_size(batch_size)
+        {
+            _images.resize(rocalGetAugmentationBranchCount(context));
+            RocalOutputMemType mem_type;
+            if(rocalGetOutputBatchImages(context, _lease->lease, _images.data(), _images.size(), &mem_type) != ROCAL_OK)
+                throw std::runtime_error(rocalGetErrorMessage(context));
+#if ENABLE_OPENCL
+            dlpack::DeviceType gpu_device_type = dlpack::kDLOpenCL;
+#else
+            dlpack::DeviceType gpu_device_type = dlpack::kDLROCM;
+#endif
+            _device = (mem_type == ROCAL_MEMCPY_HOST) ? dlpack::DLDevice{dlpack::kDLCPU, 0} : dlpack::DLDevice{gpu_device_type, device_id};
+        }
+        std::vector<OutputBatchTensor> images()
+        {
+            check_lease();
+            auto context = _lease->context;
+            int64_t height = rocalGetOutputHeight(context) / _batch_size;
+            int64_t width = rocalGetOutputWidth(context);
+            auto color_format = rocalGetOutputColorFormat(context);
+            int64_t channels = (color_format == ROCAL_COLOR_U8) ? 1 : 3;
+            std::vector<int64_t> shape = (color_format == ROCAL_COLOR_RGB_PLANAR) ? std::vector<int64_t>{(int64_t)_batch_size, channels, height, width}
+                                                                                  : std::vector<int64_t>{(int64_t)_batch_size, height, width, channels};
+            std::vector<OutputBatchTensor> views;
+            for(auto image: _images)
+                views.push_back(make_output_batch_tensor<unsigned char>(_lease, image, shape, _device));
+            return views;
+        }
+        OutputBatchTensor labels()
+        {
+            check_lease();
+            int *labels;
+            if(rocalGetOutputBatchLabels(_lease->context, _lease->lease, &labels) != ROCAL_OK)
+                throw std::runtime_error(rocalGetErrorMessage(_lease->context));
+            if(!labels)
+                throw std::runtime_error("No label has been loaded for the output batch");
+            return make_output_batch_tensor<int>(_lease, labels, {(int64_t)_batch_size}, {dlpack::kDLCPU, 0});
+        }
+        std::vector<std::pair<OutputBatchTensor, OutputBatchTensor>> bounding_boxes()
+        {
+            check_lease();
+            std::vector<float *> boxes(_batch_size);
+            std::vector<int *> box_labels(_batch_size);
+            std::vector<int> box_counts(_batch_size);
+            if(rocalGetOutputBatchBoundingBoxes(_lease->context, _lease->lease, boxes.data(), box_labels.data(), box_counts.data()) != ROCAL_OK)
+                throw std::runtime_error(rocalGetErrorMessage(_lease->context));
+            std::vector<std::pair<OutputBatchTensor, OutputBatchTensor>> views;
+            for(unsigned i = 0; i < _batch_size; i++)
+                views.emplace_back(make_output_batch_tensor<float>(_lease, boxes[i], {box_counts[i], 4}, {dlpack::kDLCPU, 0}),
+                                   make_output_batch_tensor<int>(_lease, box_labels[i], {box_counts[i]}, {dlpack::kDLCPU, 0}));
+            return views;
+        }
+        std::pair<OutputBatchTensor, OutputBatchTensor> encoded_boxes(int num_anchors)
+        {
+            check_lease();
+            float *boxes; int *labels;
+            if(rocalGetOutputBatchEncodedBoxes(_lease->context, _lease->lease, &boxes, &labels) != ROCAL_OK)
+                throw std::runtime_error(rocalGetErrorMessage(_lease->context));
+            if(!boxes)
+                throw std::runtime_error("No encoded box is available for the output batch");
+            return std::make_pair(make_output_batch_tensor<float>(_lease, boxes, {(int64_t)_batch_size, num_anchors, 4}, _device),
+                                  make_output_batch_tensor<int>(_lease, labels, {(int64_t)_batch_size, num_anchors}, _device));
+        }
+        std::pair<OutputBatchTensor, OutputBatchTensor> heatmaps(int heatmap_width, int heatmap_height)
+        {
+            check_lease();
+            float *heatmaps, *target_weights;
+            if(rocalGetOutputBatchHeatmaps(_lease->context, _lease->lease, &heatmaps, &target_weights) != ROCAL_OK)
+                throw std::runtime_error(rocalGetErrorMessage(_lease->context));
+            if(!heatmaps)
+                throw std::runtime_error("No key point heatmap is available for the output batch");
+            return std::make_pair(make_output_batch_tensor<float>(_lease, heatmaps, {(int64_t)_batch_size, NUM_KEY_POINTS, heatmap_height, heatmap_width}, {dlpack::kDLCPU, 0}),
+                                  make_output_batch_tensor<float>(_lease, target_weights, {(int64_t)_batch_size, NUM_KEY_POINTS}, {dlpack::kDLCPU, 0}));
+        }
+        OutputBatchTensor soft_labels(int num_classes)
+        {
+            check_lease();
+            float *soft_labels;
+            if(rocalGetOutputBatchSoftLabels(_lease->context, _lease->lease, &soft_labels) != ROCAL_OK)
+                throw std::runtime_error(rocalGetErrorMessage(_lease->context));
+            if(!soft_labels)
+                throw std::runtime_error("No soft label is available for the output batch");
+            return make_output_batch_tensor<float>(_lease, soft_labels, {(int64_t)_batch_size, num_classes}, {dlpack::kDLCPU, 0});
+        }
+        //! Drops the reference of this object, the batch goes back to the pipeline once the views taken from it are gone as well
+        void release() { _lease.reset(); }
+    private:
+        void check_lease()
+        {
+            if(!_lease)
+                throw std::runtime_error("Output batch has been released");
+        }
+        std::shared_ptr<OutputBatchLease> _lease;
+        unsigned _batch_size;
+        std::vector<void *> _images;
+        dlpack::DLDevice _device;
+    };
     using namespace pybind11::literals; // NOLINT
     // PYBIND11_MODULE(rocal_backend_impl, m) {
     static void *ctypes_void_ptr(const py::object &object)
@@ -73,7 +338,7 @@ namespace rocal{
         auto buf = array.request();
         unsigned char* ptr = (unsigned char*) buf.ptr;
         // call pure C++ function
-        int status = rocalCopyToOutput(context, ptr, buf.size);
+        int status = without_gil([&]() { return rocalCopyToOutput(context, ptr, buf.size); });
         return py::cast<py::none>(Py_None);
     }
 
@@ -82,7 +347,7 @@ namespace rocal{
         auto buf = array.request();
         int* ptr = (int*) buf.ptr;
         // call pure C++ function
-        int length =rocalGetImageNameLen(context,ptr);
+        int length =without_gil([&]() { return rocalGetImageNameLen(context,ptr); });
         return py::cast(length);
     }
 
@@ -93,7 +358,7 @@ namespace rocal{
         char* ptr = (char*) buf.ptr;
         ptr = (char *)calloc(array_len, sizeof(char));
         // call pure C++ function
-        rocalGetImageName(context,ptr);
+        without_gil([&]() { rocalGetImageName(context,ptr); });
         std::string s(ptr);
         free(ptr);
         return py::bytes(s);
@@ -107,10 +372,9 @@ namespace rocal{
     {
         auto ptr = ctypes_void_ptr(p);
         // call pure C++ function
-
-        int status = rocalToTensor(context, ptr, tensor_format, tensor_output_type, multiplier0,
+        int status = without_gil([&]() { return rocalToTensor(context, ptr, tensor_format, tensor_output_type, multiplier0,
                                               multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
+                                              offset1, offset2, reverse_channels, output_mem_type); });
         // std::cerr<<"\n Copy failed with status :: "<<status;
         return py::cast<py::none>(Py_None);
     }
@@ -124,9 +388,9 @@ namespace rocal{
         auto buf = array.request();
         float* ptr = (float*) buf.ptr;
         // call pure C++ function
-        int status = rocalToTensor32(context, ptr, tensor_format, multiplier0,
+        int status = without_gil([&]() { return rocalToTensor32(context, ptr, tensor_format, multiplier0,
                                               multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
+                                              offset1, offset2, reverse_channels, output_mem_type); });
         // std::cerr<<"\n Copy failed with status :: "<<status;
         return py::cast<py::none>(Py_None);
     }
@@ -140,9 +404,9 @@ namespace rocal{
         auto buf = array.request();
         float16* ptr = (float16*) buf.ptr;
         // call pure C++ function
-        int status = rocalToTensor16(context, ptr, tensor_format, multiplier0,
+        int status = without_gil([&]() { return rocalToTensor16(context, ptr, tensor_format, multiplier0,
                                               multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
+                                              offset1, offset2, reverse_channels, output_mem_type); });
         // std::cerr<<"\n Copy failed with status :: "<<status;
         return py::cast<py::none>(Py_None);
     }
@@ -155,9 +419,9 @@ namespace rocal{
     {
         float * ptr = (float*)array_ptr;
         // call pure C++ function
-        int status = rocalToTensor32(context, ptr, tensor_format, multiplier0,
+        int status = without_gil([&]() { return rocalToTensor32(context, ptr, tensor_format, multiplier0,
                                               multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
+                                              offset1, offset2, reverse_channels, output_mem_type); });
         // std::cerr<<"\n Copy failed with status :: "<<status;
         return py::cast<py::none>(Py_None);
     }
@@ -170,9 +434,9 @@ namespace rocal{
     {
         float16 * ptr = (float16*)array_ptr;
         // call pure C++ function
-        int status = rocalToTensor16(context, ptr, tensor_format, multiplier0,
+        int status = without_gil([&]() { return rocalToTensor16(context, ptr, tensor_format, multiplier0,
                                               multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
+                                              offset1, offset2, reverse_channels, output_mem_type); });
         // std::cerr<<"\n Copy failed with status :: "<<status;
         return py::cast<py::none>(Py_None);
     }
@@ -181,7 +445,7 @@ namespace rocal{
     {
         auto ptr = ctypes_void_ptr(p);
         // call pure C++ function
-        rocalGetImageLabels(context,ptr, output_mem_type);
+        without_gil([&]() { rocalGetImageLabels(context,ptr, output_mem_type); });
         return py::cast<py::none>(Py_None);
     }
 
@@ -189,7 +453,7 @@ namespace rocal{
     {
         void * ptr = (void*)array_ptr;
         // call pure C++ function
-        rocalGetImageLabels(context,ptr, output_mem_type);
+        without_gil([&]() { rocalGetImageLabels(context,ptr, output_mem_type); });
         return py::cast<py::none>(Py_None);
     }
 
@@ -198,7 +462,7 @@ namespace rocal{
         auto buf = array.request();
         int* ptr = (int*) buf.ptr;
         // call pure C++ function
-        rocalGetImageId(context,ptr);
+        without_gil([&]() { rocalGetImageId(context,ptr); });
         return py::cast<py::none>(Py_None);
     }
     py::object wrapper_labels_BB_count_copy(RocalContext context, py::array_t<int> array)
@@ -207,7 +471,7 @@ namespace rocal{
         auto buf = array.request();
         int* ptr = (int*) buf.ptr;
         // call pure C++ function
-        int count =rocalGetBoundingBoxCount(context,ptr);
+        int count =without_gil([&]() { return rocalGetBoundingBoxCount(context,ptr); });
         return py::cast(count);
     }
 
@@ -217,7 +481,7 @@ namespace rocal{
         auto buf = array.request();
         int* ptr = (int*) buf.ptr;
         // call pure C++ function
-        rocalGetBoundingBoxLabel(context,ptr);
+        without_gil([&]() { rocalGetBoundingBoxLabel(context,ptr); });
         return py::cast<py::none>(Py_None);
     }
 
@@ -228,15 +492,41 @@ namespace rocal{
         auto labels_buf = labels_array.request();
         int* labels_ptr = (int*) labels_buf.ptr;
         // call pure C++ function
-        rocalCopyEncodedBoxesAndLables(context, bboxes_ptr , labels_ptr);
+        without_gil([&]() { rocalCopyEncodedBoxesAndLables(context, bboxes_ptr , labels_ptr); });
         return py::cast<py::none>(Py_None);
     }
 
+    std::pair<py::array_t<float>, py::array_t<float>> wrapper_get_keypoint_heatmaps(RocalContext context, int batch_size, int heatmap_width, int heatmap_height)
+    {
+        float* heatmaps_buf_ptr; float* target_weights_buf_ptr;
+        without_gil([&]() { rocalGetKeyPointHeatmaps(context, &heatmaps_buf_ptr, &target_weights_buf_ptr); });
+        // no need to free the memory as this is freed by c++ lib
+        py::array_t<float> heatmaps_array = py::array_t<float>(
+                                                          {batch_size, NUM_KEY_POINTS, heatmap_height, heatmap_width},
+                                                          {NUM_KEY_POINTS*heatmap_height*heatmap_width*sizeof(float), heatmap_height*heatmap_width*sizeof(float), heatmap_width*sizeof(float), sizeof(float)},
+                                                          heatmaps_buf_ptr,
+                                                          py::cast<py::none>(Py_None));
+        py::array_t<float> target_weights_array = py::array_t<float>(
+                                                          {batch_size, NUM_KEY_POINTS},
+                                                          {NUM_KEY_POINTS*sizeof(float), sizeof(float)},
+                                                          target_weights_buf_ptr,
+                                                          py::cast<py::none>(Py_None));
+        return std::make_pair(heatmaps_array, target_weights_array);
+    }
+
+    py::array_t<float> wrapper_get_soft_labels(RocalContext context, int batch_size, int num_classes)
+    {
+        float* soft_labels_buf_ptr;
+        without_gil([&]() { rocalGetSoftLabels(context, &soft_labels_buf_ptr); });
+        // no need to free the memory as this is freed by c++ lib
+        return py::array_t<float>({batch_size, num_classes}, {num_classes*sizeof(float), sizeof(float)}, soft_labels_buf_ptr, py::cast<py::none>(Py_None));
+    }
+
     std::pair<py::array_t<float>, py::array_t<int>>  wrapper_get_encoded_bbox_label(RocalContext context, int batch_size, int num_anchors)
     {
         float* bboxes_buf_ptr; int* labels_buf_ptr;
         // call pure C++ function
-        rocalGetEncodedBoxesAndLables(context, &bboxes_buf_ptr, &labels_buf_ptr, num_anchors*batch_size);
+        without_gil([&]() { rocalGetEncodedBoxesAndLables(context, &bboxes_buf_ptr, &labels_buf_ptr, num_anchors*batch_size); });
         // create numpy arrays for boxes and labels tensor from the returned ptr
         // no need to free the memory as this is freed by c++ lib
         py::array_t<float> bboxes_array = py::array_t<float>(
@@ -259,7 +549,7 @@ namespace rocal{
         auto buf = array.request();
         float* ptr = (float*) buf.ptr;
         // call pure C++ function
-        rocalGetBoundingBoxCords(context,ptr);
+        without_gil([&]() { rocalGetBoundingBoxCords(context,ptr); });
         return py::cast<py::none>(Py_None);
     }
 
@@ -268,7 +558,7 @@ namespace rocal{
         auto buf = array.request();
         int* ptr = (int*) buf.ptr;
         // call pure C++ function
-        rocalGetImageSizes(context,ptr);
+        without_gil([&]() { rocalGetImageSizes(context,ptr); });
         return py::cast<py::none>(Py_None);
     }
 
@@ -276,7 +566,7 @@ namespace rocal{
     {
         auto ptr = ctypes_void_ptr(p);
         // call pure C++ function
-        rocalGetOneHotImageLabels(context, ptr, numOfClasses, dest);
+        without_gil([&]() { rocalGetOneHotImageLabels(context, ptr, numOfClasses, dest); });
         return py::cast<py::none>(Py_None);
     }
 
@@ -284,7 +574,7 @@ namespace rocal{
     {
         void * ptr = (void*) array_ptr;
         // call pure C++ function
-        rocalGetOneHotImageLabels(context, ptr, numOfClasses, dest);
+        without_gil([&]() { rocalGetOneHotImageLabels(context, ptr, numOfClasses, dest); });
         return py::cast<py::none>(Py_None);
     }
 
@@ -307,15 +597,99 @@ namespace rocal{
                 py::arg("cpu_thread_count") = 1,
                 py::arg("prefetch_queue_depth") = 3,
                 py::arg("output_data_type") = 0);
-        m.def("rocalVerify",&rocalVerify);
-        m.def("rocalRun",&rocalRun);
-        m.def("rocalRelease",&rocalRelease);
+        m.def("rocalSetShardScheduling",&rocalSetShardScheduling,"Defines how the batches of the internal shards are handed out, call before creating the loader",
+                py::arg("context"),
+                py::arg("scheduling"),
+                py::arg("share_decode_threads") = false);
+        m.def("rocalSetNumaPlacement",[](RocalContext context, bool enable, int output_numa_node, std::vector<int> shard_numa_nodes){
+                return rocalSetNumaPlacement(context, enable, output_numa_node, shard_numa_nodes.empty() ? nullptr : shard_numa_nodes.data(), shard_numa_nodes.size());
+            },"Pins the loader and output threads and their buffers to NUMA nodes, call before creating the loader",
+                py::arg("context"),
+                py::arg("enable"),
+                py::arg("output_numa_node") = -1,
+                py::arg("shard_numa_nodes") = std::vector<int>());
+        m.def("rocalSetAutotune",&rocalSetAutotune,"Tunes the decode threads, graph threads and prefetch depth on the first batches, call before creating the loader",
+                py::arg("context"),
+                py::arg("enable"),
+                py::arg("tuning_batch_count") = 200,
+                py::arg("memory_budget") = 0);
+        m.def("rocalGetAutotuneResult",[](RocalContext context){
+                RocalAutotuneResult result;
+                if(rocalGetAutotuneResult(context, &result) != ROCAL_OK)
+                    throw std::runtime_error(rocalGetErrorMessage(context));
+                return result;
+            },"Returns the configuration picked by the autotuner",
+                py::arg("context"));
+        m.def("rocalSetOutputSize",&rocalSetOutputSize,"Changes the size of the output images, applied at the next epoch boundary",
+                py::arg("context"),
+                py::arg("width"),
+                py::arg("height"));
+        py::class_<OutputBatchTensor>(m, "OutputBatchTensor", py::buffer_protocol(),
+                "Zero-copy view of an output batch buffer, it keeps the batch out of the pipeline's reuse till it is garbage collected")
+            .def_buffer([](OutputBatchTensor &tensor) -> py::buffer_info {
+                if(tensor.device.device_type != dlpack::kDLCPU)
+                    throw std::runtime_error("Buffer protocol is only available for host memory, use __dlpack__ for device memory");
+                std::vector<py::ssize_t> shape(tensor.shape.begin(), tensor.shape.end());
+                std::vector<py::ssize_t> strides;
+                for(auto stride: tensor.strides())
+                    strides.push_back(stride * tensor.item_size());
+                return py::buffer_info(tensor.data, tensor.item_size(), tensor.format, shape.size(), shape, strides);
+            })
+            .def_property_readonly("shape", [](const OutputBatchTensor &tensor) { return tensor.shape; })
+            .def("__dlpack__", [](const OutputBatchTensor &tensor, py::object stream) { return wrapper_to_dlpack(tensor); }, py::arg("stream") = py::none())
+            .def("__dlpack_device__", [](const OutputBatchTensor &tensor) { return std::make_pair(tensor.device.device_type, tensor.device.device_id); });
+        py::class_<OutputBatch>(m, "OutputBatch", "Output batch of the last rocalRun() call, accessed in place")
+            .def(py::init<RocalContext, unsigned, int>(), py::arg("context"), py::arg("batch_size"), py::arg("device_id") = 0)
+            .def("images", &OutputBatch::images, "One uint8 view per output image, NHWC or NCHW for planar outputs")
+            .def("labels", &OutputBatch::labels)
+            .def("bounding_boxes", &OutputBatch::bounding_boxes, "Per sample (boxes, labels) views")
+            .def("encoded_boxes", &OutputBatch::encoded_boxes, py::arg("num_anchors"))
+            .def("heatmaps", &OutputBatch::heatmaps, py::arg("heatmap_width"), py::arg("heatmap_height"), "(heatmaps, target weights) views")
+            .def("soft_labels", &OutputBatch::soft_labels, py::arg("num_classes"))
+            .def("release", &OutputBatch::release)
+            .def("__enter__", [](py::object self) { return self; })
+            .def("__exit__", [](OutputBatch &batch, py::args) { batch.release(); });
+        m.def("rocalVerify",&rocalVerify, py::call_guard<py::gil_scoped_release>());
+        m.def("rocalRun",&rocalRun, py::call_guard<py::gil_scoped_release>());
+        m.def("rocalTryRun",[](RocalContext context){
+                bool ran = false;
+                RocalStatus status = without_gil([&]() { return rocalTryRun(context, &ran); });
+                return std::make_pair(status, ran);
+            },"Runs like rocalRun if the next batch is ready, returns (status, ran) without blocking");
+        m.def("rocalServe",&rocalServe,"Runs the pipeline as a rocAL service publishing its batches to rank_count client pipelines of the node",
+            py::call_guard<py::gil_scoped_release>(),
+            py::arg("context"), py::arg("service_name"), py::arg("rank_count"), py::arg("epoch_count") = 0, py::arg("ring_depth") = 3);
+        m.def("rocalSetStateTracking",&rocalSetStateTracking,"Keeps the state of the pipeline after every batch for rocalSaveState, call before rocalVerify",
+                py::arg("context"),
+                py::arg("enable"));
+        m.def("rocalSaveState",[](RocalContext context){
+                size_t size = 0;
+                if(rocalSaveState(context, nullptr, &size) != ROCAL_OK)
+                    throw std::runtime_error(rocalGetErrorMessage(context));
+                std::string state(size, '\0');
+                if(rocalSaveState(context, state.data(), &size) != ROCAL_OK)
+                    throw std::runtime_error(rocalGetErrorMessage(context));
+                return py::bytes(state.data(), size);
+            },"Returns the state of the pipeline after the last batch returned by rocalRun, as bytes");
+        m.def("rocalLoadState",[](RocalContext context, py::bytes state){
+                std::string buffer = state;
+                if(rocalLoadState(context, buffer.data(), buffer.size()) != ROCAL_OK)
+                    throw std::runtime_error(rocalGetErrorMessage(context));
+            },"Resumes from a state returned by rocalSaveState, call before creating the loader");
+        m.def("rocalGetOutputReadyFd",&rocalGetOutputReadyFd,"File descriptor polling readable when the next batch may be ready, to await it from an event loop");
+        m.def("rocalRelease",&release_context,"Releases the context, once the views of its output batches still alive are gone", py::call_guard<py::gil_scoped_release>());
         // rocal_api_types.h
         py::class_<TimingInfo>(m, "TimingInfo")
             .def_readwrite("load_time",&TimingInfo::load_time)
             .def_readwrite("decode_time",&TimingInfo::decode_time)
             .def_readwrite("process_time",&TimingInfo::process_time)
             .def_readwrite("transfer_time",&TimingInfo::transfer_time);
+        py::class_<RocalAutotuneResult>(m, "AutotuneResult")
+            .def_readwrite("decode_threads",&RocalAutotuneResult::decode_threads)
+            .def_readwrite("graph_threads",&RocalAutotuneResult::graph_threads)
+            .def_readwrite("prefetch_depth",&RocalAutotuneResult::prefetch_depth)
+            .def_readwrite("batches_per_second",&RocalAutotuneResult::batches_per_second)
+            .def_readwrite("done",&RocalAutotuneResult::done);
         py::module types_m = m.def_submodule("types");
         types_m.doc() = "Datatypes and options used by ROCAL";
         py::enum_<RocalStatus>(types_m, "RocalStatus", "Status info")
@@ -339,6 +713,15 @@ namespace rocal{
             .value("GPU_MEMORY", ROCAL_MEMCPY_GPU)
             .value("PINNED_MEMORY", ROCAL_MEMCPY_PINNED)
             .export_values();
+        py::enum_<RocalShardScheduling>(types_m,"RocalShardScheduling","Shard scheduling")
+            .value("SHARD_ROUND_ROBIN",ROCAL_SHARD_ROUND_ROBIN)
+            .value("SHARD_ANY_READY",ROCAL_SHARD_ANY_READY)
+            .export_values();
+        py::enum_<RocalSyntheticMetaData>(types_m,"RocalSyntheticMetaData","Meta data of the synthetic source")
+            .value("SYNTHETIC_NO_META_DATA",ROCAL_SYNTHETIC_NO_META_DATA)
+            .value("SYNTHETIC_LABELS",ROCAL_SYNTHETIC_LABELS)
+            .value("SYNTHETIC_BOXES",ROCAL_SYNTHETIC_BOXES)
+            .export_values();
         py::enum_<RocalResizeScalingMode>(types_m,"RocalResizeScalingMode","Decode size policies")
             .value("SCALING_MODE_DEFAULT",ROCAL_SCALING_MODE_DEFAULT)
             .value("SCALING_MODE_STRETCH",ROCAL_SCALING_MODE_STRETCH)
@@ -353,6 +736,11 @@ namespace rocal{
             .value("GAUSSIAN_INTERPOLATION",ROCAL_GAUSSIAN_INTERPOLATION)
             .value("TRIANGULAR_INTERPOLATION",ROCAL_TRIANGULAR_INTERPOLATION)
             .export_values();
+        py::enum_<RocalBatchMixMode>(types_m,"RocalBatchMixMode","Batch mixing modes")
+            .value("BATCH_MIX_NONE",ROCAL_BATCH_MIX_NONE)
+            .value("MIXUP",ROCAL_BATCH_MIX_MIXUP)
+            .value("CUTMIX",ROCAL_BATCH_MIX_CUTMIX)
+            .export_values();
         py::enum_<RocalImageSizeEvaluationPolicy>(types_m,"RocalImageSizeEvaluationPolicy","Decode size policies")
             .value("MAX_SIZE",ROCAL_USE_MAX_SIZE)
             .value("USER_GIVEN_SIZE",ROCAL_USE_USER_GIVEN_SIZE)
@@ -402,6 +790,8 @@ namespace rocal{
         m.def("Caffe2Reader",&rocalCreateCaffe2LMDBLabelReader);
         m.def("CaffeReaderDetection",&rocalCreateCaffeLMDBReaderDetection);
         m.def("Caffe2ReaderDetection",&rocalCreateCaffe2LMDBReaderDetection);
+        m.def("TarShardReader",&rocalCreateTarShardLabelReader);
+        m.def("TarShardReaderDetection",&rocalCreateTarShardReaderDetection);
         m.def("Cifar10LabelReader",&rocalCreateTextCifar10LabelReader);
         m.def("RandomBBoxCrop",&wrapper_random_bbox_crop);
         m.def("COCOReader",&rocalCreateCOCOReader);
@@ -412,12 +802,16 @@ namespace rocal{
         m.def("getBBCords",&wrapper_BB_cord_copy);
         m.def("rocalCopyEncodedBoxesAndLables",&wrapper_encoded_bbox_label);
         m.def("rocalGetEncodedBoxesAndLables",&wrapper_get_encoded_bbox_label);
+        m.def("rocalGetKeyPointHeatmaps",&wrapper_get_keypoint_heatmaps);
+        m.def("rocalGetSoftLabels",&wrapper_get_soft_labels);
         m.def("getImgSizes",&wrapper_img_sizes_copy);
         m.def("getBoundingBoxCount",&wrapper_labels_BB_count_copy);
         m.def("getOneHotEncodedLabels",&wrapper_one_hot_label_copy);
         m.def("getCupyOneHotEncodedLabels",&wrapper_cupy_one_hot_label_copy);
         m.def("isEmpty",&rocalIsEmpty);
         m.def("BoxEncoder",&rocalBoxEncoder);
+        m.def("KeyPointHeatmaps",&rocalKeyPointHeatmaps);
+        m.def("BatchMix",&rocalBatchMix);
         m.def("getTimingInfo",rocalGetTimingInfo);
         // rocal_api_parameter.h
         m.def("setSeed",&rocalSetSeed);
@@ -448,6 +842,15 @@ namespace rocal{
             py::return_value_policy::reference);
          m.def("COCO_ImageDecoderSliceShard",&rocalJpegCOCOFileSourcePartialSingleShard,"Reads file from the source given and decodes it according to the policy",
             py::return_value_policy::reference);
+        m.def("SyntheticSource",&rocalSyntheticSource,"Generates deterministic images, and optionally labels or boxes, in memory",
+            py::return_value_policy::reference);
+        m.def("NumpyFileSource",&rocalNumpyFileSource,"Reads pre-decoded uint8 samples from memory mapped .npy arrays or raw tensor files",
+            py::return_value_policy::reference);
+        m.def("ServiceSource",&rocalServiceSource,"Gets the batches a rocAL service of the node publishes for the given rank",
+            py::return_value_policy::reference, py::call_guard<py::gil_scoped_release>(),
+            py::arg("context"), py::arg("service_name"), py::arg("rank"), py::arg("is_output"), py::arg("timeout_ms") = 60000);
+        m.def("TarShard_ImageDecoder",&rocalTarShardSource,"Streams the images of WebDataset style tar shards and decodes them according to the policy",
+            py::return_value_policy::reference);
         m.def("ImageDecoder",&rocalJpegFileSource,"Reads file from the source given and decodes it according to the policy",
             py::return_value_policy::reference);
         m.def("ImageDecoderShard",&rocalJpegFileSourceSingleShard,"Reads file from the source given and decodes it according to the shard id and number of shards",
@@ -492,7 +895,7 @@ namespace rocal{
             py::arg("loop") = false,
             py::arg("frame_step"),
             py::arg("frame_stride"));
-        m.def("rocalResetLoaders",&rocalResetLoaders);
+        m.def("rocalResetLoaders",&rocalResetLoaders, py::call_guard<py::gil_scoped_release>());
         // rocal_api_augmentation.h
         m.def("SSDRandomCrop",&rocalSSDRandomCrop,
             py::return_value_policy::reference,
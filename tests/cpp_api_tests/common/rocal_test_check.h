@@ -0,0 +1,61 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <iostream>
+#include <string>
+
+// Checks of the rocAL tests built straight from the source tree: a failed check is printed and counted,
+// the test carries on and report() fails it at the end
+namespace rocal_test {
+
+inline int &failure_count()
+{
+    static int count = 0;
+    return count;
+}
+
+inline void check(bool condition, const std::string &what)
+{
+    if(!condition)
+    {
+        std::cout << "FAILED: " << what << std::endl;
+        failure_count()++;
+    }
+}
+
+//! Prints the outcome of the test
+/// \return the exit code of the test application
+inline int report(const std::string &passed_message)
+{
+    if(failure_count())
+    {
+        std::cout << failure_count() << " checks failed" << std::endl;
+        return -1;
+    }
+    std::cout << passed_message << std::endl;
+    return 0;
+}
+
+}
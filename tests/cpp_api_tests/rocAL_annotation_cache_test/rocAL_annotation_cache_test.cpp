@@ -0,0 +1,294 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "coco_annotation_cache.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+using AnnotationMap = std::map<std::string, std::shared_ptr<MetaData>>;
+
+static std::string g_folder;
+
+static void write_file(const std::string &path, const std::string &content)
+{
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+static void set_mtime(const std::string &path, time_t seconds)
+{
+    struct timespec times[2] = {{seconds, 0}, {seconds, 0}};
+    if(utimensat(AT_FDCWD, path.c_str(), times, 0) != 0)
+        check(false, "cannot set the modification time of " + path);
+}
+
+static bool file_exists(const std::string &path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+static AnnotationMap box_annotations()
+{
+    AnnotationMap annotations;
+    annotations["000000000139.jpg"] = std::make_shared<BoundingBox>(BoundingBoxCords{{0.1f, 0.2f, 0.5f, 0.6f}, {0.0f, 0.0f, 1.0f, 1.0f}},
+                                                                    BoundingBoxLabels{3, 7}, ImgSize{640, 426});
+    annotations["000000000285.jpg"] = std::make_shared<BoundingBox>(BoundingBoxCords{{0.25f, 0.25f, 0.75f, 0.75f}}, BoundingBoxLabels{1}, ImgSize{586, 640});
+    annotations["000000000632.jpg"] = std::make_shared<BoundingBox>(BoundingBoxCords{}, BoundingBoxLabels{}, ImgSize{640, 483});
+    return annotations;
+}
+
+static bool same_boxes(AnnotationMap &a, AnnotationMap &b)
+{
+    if(a.size() != b.size())
+        return false;
+    for(auto ita = a.begin(), itb = b.begin(); ita != a.end(); ++ita, ++itb)
+    {
+        if(ita->first != itb->first || ita->second->get_img_size().w != itb->second->get_img_size().w ||
+           ita->second->get_img_size().h != itb->second->get_img_size().h || ita->second->get_bb_labels() != itb->second->get_bb_labels())
+            return false;
+        auto &boxes_a = ita->second->get_bb_cords(), &boxes_b = itb->second->get_bb_cords();
+        if(boxes_a.size() != boxes_b.size())
+            return false;
+        for(size_t i = 0; i < boxes_a.size(); i++)
+            if(boxes_a[i].l != boxes_b[i].l || boxes_a[i].t != boxes_b[i].t || boxes_a[i].r != boxes_b[i].r || boxes_a[i].b != boxes_b[i].b)
+                return false;
+    }
+    return true;
+}
+
+static bool load(const std::string &json_path, CocoAnnotationCache::Kind kind, std::vector<uint32_t> params, AnnotationMap &annotations, std::map<int, int> &labels)
+{
+    CocoAnnotationCache cache(json_path, kind, params);
+    return cache.load(annotations, labels);
+}
+
+static void store(const std::string &json_path, CocoAnnotationCache::Kind kind, std::vector<uint32_t> params, const AnnotationMap &annotations, const std::map<int, int> &labels)
+{
+    CocoAnnotationCache cache(json_path, kind, params);
+    cache.store(annotations, labels);
+}
+
+// The boxes, labels, image sizes and category map come back from the cache as they were stored
+void test_round_trip()
+{
+    const std::string json_path = g_folder + "/round_trip.json";
+    write_file(json_path, "{\"images\": [], \"annotations\": [], \"categories\": []}");
+    AnnotationMap annotations = box_annotations(), loaded;
+    std::map<int, int> labels = {{1, 1}, {3, 2}, {90, 80}}, loaded_labels;
+    check(!load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, loaded, loaded_labels), "round trip: cache loaded before being stored");
+    store(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, annotations, labels);
+    check(file_exists(json_path + ".rocalcache"), "round trip: no cache next to the annotations file");
+    check(load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, loaded, loaded_labels), "round trip: cache not loaded");
+    check(same_boxes(annotations, loaded), "round trip: boxes differ");
+    check(labels == loaded_labels, "round trip: category map differs");
+
+    JointsData joints_data = {};
+    joints_data.image_id = 139;
+    joints_data.annotation_id = 42;
+    joints_data.image_path = "000000000139.jpg";
+    joints_data.center[0] = 10.5f;
+    joints_data.scale[1] = 2.0f;
+    joints_data.joints.assign(NUMBER_OF_JOINTS, {1.0f, 2.0f});
+    joints_data.joints_visibility.assign(NUMBER_OF_JOINTS, {1.0f, 0.0f});
+    joints_data.score = 0.5f;
+    joints_data.rotation = 30.0f;
+    AnnotationMap key_points = {{"000000000139.jpg", std::make_shared<KeyPoint>(ImgSize{640, 426}, &joints_data)}}, loaded_key_points;
+    const std::string key_points_path = g_folder + "/key_points.json";
+    write_file(key_points_path, "{\"annotations\": []}");
+    store(key_points_path, CocoAnnotationCache::Kind::KEY_POINTS, {192, 256}, key_points, {});
+    check(load(key_points_path, CocoAnnotationCache::Kind::KEY_POINTS, {192, 256}, loaded_key_points, loaded_labels), "key points: cache not loaded");
+    if(loaded_key_points.size() == 1)
+    {
+        auto &joints = loaded_key_points.begin()->second->get_joints_data();
+        check(joints.image_id == 139 && joints.annotation_id == 42 && joints.center[0] == 10.5f && joints.scale[1] == 2.0f &&
+              joints.joints.size() == NUMBER_OF_JOINTS && joints.joints[16][1] == 2.0f && joints.score == 0.5f && joints.rotation == 30.0f,
+              "key points differ");
+    }
+    else
+    {
+        check(false, "key points: " + std::to_string(loaded_key_points.size()) + " images loaded");
+    }
+}
+
+// A cache is only used for the annotations file and the parameters it was built from
+void test_invalidation()
+{
+    const std::string json_path = g_folder + "/instances.json";
+    const std::string content = "{\"images\": [{\"id\": 139}], \"annotations\": [], \"categories\": []}";
+    AnnotationMap annotations = box_annotations(), loaded;
+    std::map<int, int> labels = {{1, 1}}, loaded_labels;
+    auto stored = [&]() {
+        write_file(json_path, content);
+        store(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 2}, annotations, labels);
+        return load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 2}, loaded, loaded_labels);
+    };
+    check(stored(), "invalidation: cache not loaded");
+
+    // An edit in place keeps the size, the file gets another modification time and its content hash then differs
+    std::string edited = content;
+    edited[edited.find("139")] = '2';
+    write_file(json_path, edited);
+    set_mtime(json_path, 1000000000);
+    check(!load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 2}, loaded, loaded_labels), "cache used for an annotations file edited in place");
+
+    // A file touched or copied keeps its content, the hash matches and the new time is recorded. The size and time are
+    // then trusted without hashing, even for a content edited behind them
+    check(stored(), "invalidation: cache not rebuilt");
+    set_mtime(json_path, 1100000000);
+    check(load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 2}, loaded, loaded_labels), "cache not used for a touched annotations file");
+    write_file(json_path, edited);
+    set_mtime(json_path, 1100000000);
+    check(load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 2}, loaded, loaded_labels), "annotations file of the recorded size and time hashed");
+
+    check(stored(), "invalidation: cache not rebuilt");
+    write_file(json_path, content + " ");
+    check(!load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 2}, loaded, loaded_labels), "cache used for a longer annotations file");
+
+    check(stored(), "invalidation: cache not rebuilt");
+    check(!load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 3}, loaded, loaded_labels), "cache used with other parameters");
+    check(!load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1}, loaded, loaded_labels), "cache used with fewer parameters");
+    check(!load(json_path, CocoAnnotationCache::Kind::KEY_POINTS, {1, 2}, loaded, loaded_labels), "box cache used for the key points");
+
+    // A cache cut short, by a writer that died or a full disk, is ignored
+    check(stored(), "invalidation: cache not rebuilt");
+    const std::string cache_path = json_path + ".rocalcache";
+    struct stat st;
+    stat(cache_path.c_str(), &st);
+    if(truncate(cache_path.c_str(), st.st_size - 8) != 0)
+        check(false, "cannot truncate " + cache_path);
+    check(!load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 2}, loaded, loaded_labels), "truncated cache used");
+    write_file(cache_path, "not a cache");
+    check(!load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {1, 2}, loaded, loaded_labels), "file without the cache header used");
+}
+
+// An open cache is read in place, the images are found by name without filling a map
+void test_lookups()
+{
+    const std::string json_path = g_folder + "/lookups.json";
+    write_file(json_path, "{\"images\": [], \"annotations\": []}");
+    AnnotationMap annotations = box_annotations(), filled;
+    std::map<int, int> labels = {{1, 1}, {3, 2}}, loaded_labels;
+    store(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, annotations, labels);
+    CocoAnnotationCache cache(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX);
+    check(cache.open(loaded_labels) && loaded_labels == labels, "lookups: cache not opened");
+    for(auto &annotation: annotations)
+    {
+        BoundingBoxCords boxes = {{9, 9, 9, 9}};
+        BoundingBoxLabels box_labels;
+        ImgSize image_size = {};
+        check(cache.contains(annotation.first), "lookups: " + annotation.first + " not in the cache");
+        AnnotationMap found = {{annotation.first, nullptr}}, expected = {annotation};
+        if(cache.find_boxes(annotation.first, boxes, box_labels, image_size))
+            found[annotation.first] = std::make_shared<BoundingBox>(boxes, box_labels, image_size);
+        check(found[annotation.first] && same_boxes(expected, found), "lookups: boxes of " + annotation.first + " differ");
+    }
+    // Names before, between and after the ones of the cache
+    for(auto name: {"000000000000.jpg", "000000000200.jpg", "000000000139.jp", "000000000139.jpgx", "zzz.jpg", ""})
+    {
+        BoundingBoxCords boxes;
+        BoundingBoxLabels box_labels;
+        ImgSize image_size;
+        check(!cache.contains(name) && !cache.find_boxes(name, boxes, box_labels, image_size), std::string("lookups: ") + name + " found in the cache");
+    }
+    cache.fill(filled);
+    check(same_boxes(annotations, filled), "lookups: map filled from the cache differs");
+    cache.close();
+    check(!cache.contains("000000000139.jpg"), "lookups: closed cache still used");
+
+    JointsData joints_data = {};
+    joints_data.image_id = 285;
+    joints_data.joints.assign(NUMBER_OF_JOINTS, {3.0f, 4.0f});
+    joints_data.joints_visibility.assign(NUMBER_OF_JOINTS, {1.0f, 1.0f});
+    AnnotationMap key_points = {{"000000000285.jpg", std::make_shared<KeyPoint>(ImgSize{586, 640}, &joints_data)}};
+    const std::string key_points_path = g_folder + "/lookups_key_points.json";
+    write_file(key_points_path, "{\"annotations\": []}");
+    store(key_points_path, CocoAnnotationCache::Kind::KEY_POINTS, {}, key_points, {});
+    CocoAnnotationCache key_points_cache(key_points_path, CocoAnnotationCache::Kind::KEY_POINTS);
+    JointsData found_joints;
+    ImgSize image_size = {};
+    check(key_points_cache.open(loaded_labels) && key_points_cache.find_key_points("000000000285.jpg", found_joints, image_size) &&
+          found_joints.image_id == 285 && found_joints.image_path == "000000000285.jpg" && found_joints.joints[3][1] == 4.0f && image_size.h == 640,
+          "lookups: key points not found in the cache");
+    check(!key_points_cache.find_key_points("000000000139.jpg", found_joints, image_size), "lookups: key points of another image found");
+}
+
+// The cache goes to ROCAL_CACHE_DIR when it cannot be written next to the annotations file, and is not used at all once disabled
+void test_locations()
+{
+    const std::string json_path = g_folder + "/fallback.json";
+    write_file(json_path, "{\"images\": []}");
+    // A directory in the way of the cache file, a read-only folder would not stop the tests run as root
+    mkdir((json_path + ".rocalcache").c_str(), 0755);
+    const std::string cache_dir = g_folder + "/cache_dir";
+    mkdir(cache_dir.c_str(), 0755);
+    setenv("ROCAL_CACHE_DIR", cache_dir.c_str(), 1);
+    AnnotationMap annotations = box_annotations(), loaded;
+    std::map<int, int> labels = {{1, 1}}, loaded_labels;
+    store(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, annotations, labels);
+    check(load(json_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, loaded, loaded_labels) && same_boxes(annotations, loaded), "cache in ROCAL_CACHE_DIR not loaded");
+    unsetenv("ROCAL_CACHE_DIR");
+
+    const std::string disabled_path = g_folder + "/disabled.json";
+    write_file(disabled_path, "{\"images\": []}");
+    setenv("ROCAL_DISABLE_ANNOTATION_CACHE", "1", 1);
+    store(disabled_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, annotations, labels);
+    check(!file_exists(disabled_path + ".rocalcache"), "cache written while disabled");
+    unsetenv("ROCAL_DISABLE_ANNOTATION_CACHE");
+    store(disabled_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, annotations, labels);
+    setenv("ROCAL_DISABLE_ANNOTATION_CACHE", "1", 1);
+    check(!load(disabled_path, CocoAnnotationCache::Kind::BOUNDING_BOX, {}, loaded, loaded_labels), "cache loaded while disabled");
+    unsetenv("ROCAL_DISABLE_ANNOTATION_CACHE");
+}
+
+int main(int argc, const char **argv)
+{
+    char folder[] = "/tmp/rocal_annotation_cache_test_XXXXXX";
+    if(!mkdtemp(folder))
+    {
+        std::cout << "Cannot create a temporary folder" << std::endl;
+        return -1;
+    }
+    g_folder = folder;
+    unsetenv("ROCAL_DISABLE_ANNOTATION_CACHE");
+    unsetenv("ROCAL_CACHE_DIR");
+    test_round_trip();
+    test_invalidation();
+    test_lookups();
+    test_locations();
+    std::string remove = "rm -rf " + g_folder;
+    if(system(remove.c_str()) != 0)
+        std::cout << "Could not remove " << g_folder << std::endl;
+    return rocal_test::report("Annotation cache checks passed");
+}
@@ -0,0 +1,163 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "batch_mixer.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+static const unsigned NUM_CLASSES = 10;
+static const size_t WIDTH = 32, HEIGHT = 24, DEPTH = 3;
+
+// Images filled with their index + 1, labels 0 (the last class) to NUM_CLASSES, so the two samples of a pair of up to 10 images have other classes
+static void fill_batch(std::vector<unsigned char> &images, std::vector<int> &labels, size_t image_count)
+{
+    images.resize(image_count * WIDTH * HEIGHT * DEPTH);
+    labels.resize(image_count);
+    for(size_t i = 0; i < image_count; i++)
+    {
+        memset(images.data() + i * WIDTH * HEIGHT * DEPTH, int(i + 1), WIDTH * HEIGHT * DEPTH);
+        labels[i] = i % (NUM_CLASSES + 1);
+    }
+}
+
+static size_t class_of(int label)
+{
+    return label == 0 ? NUM_CLASSES - 1 : label - 1;
+}
+
+static void test_label_sums()
+{
+    // Whatever the mode, the smoothing and the batch size, every soft label is a distribution
+    for(auto mode : {BatchMixMode::NONE, BatchMixMode::MIXUP, BatchMixMode::CUTMIX})
+        for(float label_smoothing : {0.0f, 0.1f})
+            for(size_t image_count : {1, 7, 8})
+            {
+                BatchMixer mixer(mode, NUM_CLASSES, 0.4f, 0.8f, label_smoothing, 42, 1);
+                std::vector<unsigned char> images;
+                std::vector<int> labels;
+                std::vector<float> soft_labels(image_count * NUM_CLASSES);
+                for(int batch = 0; batch < 20; batch++)
+                {
+                    fill_batch(images, labels, image_count);
+                    mixer.process({images.data()}, image_count, WIDTH, HEIGHT, DEPTH, false, labels, soft_labels.data());
+                    for(size_t i = 0; i < image_count; i++)
+                    {
+                        float sum = 0, smallest = 1;
+                        for(unsigned c = 0; c < NUM_CLASSES; c++)
+                        {
+                            sum += soft_labels[i * NUM_CLASSES + c];
+                            smallest = std::min(smallest, soft_labels[i * NUM_CLASSES + c]);
+                        }
+                        std::string what = "mode " + std::to_string(int(mode)) + ", smoothing " + std::to_string(label_smoothing) + ", " +
+                                           std::to_string(image_count) + " images, batch " + std::to_string(batch) + ", sample " + std::to_string(i);
+                        check(std::fabs(sum - 1.0f) < 1e-5f, "soft label sum of " + what);
+                        check(smallest >= (label_smoothing / NUM_CLASSES) - 1e-6f, "smallest soft label of " + what);
+                    }
+                }
+            }
+}
+
+static void test_mix_ratios()
+{
+    // The label weights match the pixels each sample got from its pair, and lambda follows Beta(alpha, alpha)
+    const float alpha = 0.4f;
+    const size_t image_count = 8, pixels = WIDTH * HEIGHT * DEPTH;
+    for(auto mode : {BatchMixMode::MIXUP, BatchMixMode::CUTMIX})
+    {
+        BatchMixer mixer(mode, NUM_CLASSES, alpha, 1.0f, 0.0f, 7, 2);
+        std::vector<unsigned char> images;
+        std::vector<int> labels;
+        std::vector<float> soft_labels(image_count * NUM_CLASSES);
+        double sum = 0, sum_squares = 0;
+        size_t count = 0;
+        for(int batch = 0; batch < 2000; batch++)
+        {
+            fill_batch(images, labels, image_count);
+            mixer.process({images.data()}, image_count, WIDTH, HEIGHT, DEPTH, false, labels, soft_labels.data());
+            for(size_t i = 0; i < image_count / 2; i++)
+            {
+                const size_t j = image_count - 1 - i;
+                const float lambda = soft_labels[i * NUM_CLASSES + class_of(labels[i])];
+                check(soft_labels[j * NUM_CLASSES + class_of(labels[j])] == lambda, "pair " + std::to_string(i) + " of batch " + std::to_string(batch) + " has the same lambda");
+                if(mode == BatchMixMode::CUTMIX)
+                {
+                    size_t kept = 0;
+                    for(size_t p = 0; p < pixels; p++)
+                        kept += images[i * pixels + p] == i + 1;
+                    check(std::fabs(float(kept) / pixels - lambda) < 1e-5f, "CutMix box of pair " + std::to_string(i) + " of batch " + std::to_string(batch));
+                }
+                else
+                {
+                    unsigned expected = ((i + 1) * std::lround(lambda * 256) + (j + 1) * (256 - std::lround(lambda * 256)) + 128) >> 8;
+                    check(images[i * pixels] == expected, "MixUp blend of pair " + std::to_string(i) + " of batch " + std::to_string(batch));
+                }
+                sum += lambda;
+                sum_squares += lambda * lambda;
+                count++;
+            }
+        }
+        // Beta(alpha, alpha) has a mean of 1/2 and a variance of 1 / (4 (2 alpha + 1)), the CutMix lambda is the one of the box clipped to the image
+        if(mode == BatchMixMode::CUTMIX)
+            continue;
+        const double mean = sum / count, variance = sum_squares / count - mean * mean;
+        check(std::fabs(mean - 0.5) < 0.02, "mean MixUp lambda " + std::to_string(mean));
+        check(std::fabs(variance - 1.0 / (4 * (2 * alpha + 1))) < 0.015, "MixUp lambda variance " + std::to_string(variance));
+    }
+}
+
+static void test_thread_count()
+{
+    // A batch is mixed the same way on any number of threads, and the same again after restoring the batch count
+    const size_t image_count = 16;
+    std::vector<unsigned char> reference_images, images;
+    std::vector<int> labels;
+    std::vector<float> reference_labels(image_count * NUM_CLASSES), soft_labels(image_count * NUM_CLASSES);
+    BatchMixer mixer(BatchMixMode::CUTMIX, NUM_CLASSES, 1.0f, 0.5f, 0.1f, 3, 4);
+    fill_batch(reference_images, labels, image_count);
+    mixer.process({reference_images.data()}, image_count, WIDTH, HEIGHT, DEPTH, true, labels, reference_labels.data());
+    for(size_t num_threads : {2, 4, 8})
+    {
+        mixer.set_batch_count(0);
+        mixer.set_num_threads(num_threads);
+        fill_batch(images, labels, image_count);
+        mixer.process({images.data()}, image_count, WIDTH, HEIGHT, DEPTH, true, labels, soft_labels.data());
+        check(images == reference_images, "images mixed on " + std::to_string(num_threads) + " threads");
+        check(soft_labels == reference_labels, "soft labels on " + std::to_string(num_threads) + " threads");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    test_label_sums();
+    test_mix_ratios();
+    test_thread_count();
+    return rocal_test::report("rocal_batch_mixer_test");
+}
@@ -0,0 +1,124 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bbox_crop_sampler.h"
+#include "philox.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+static bool same_window(const BBoxCropWindow &a, const BBoxCropWindow &b)
+{
+    return !std::memcmp(&a.window, &b.window, sizeof(a.window)) && a.min_iou == b.min_iou && a.max_iou == b.max_iou;
+}
+
+static BBoxCropSampler ssd_sampler(uint64_t seed, uint32_t stream)
+{
+    std::vector<BBoxCropOption> options = {{0.0f, 1.0f, true}, {0.1f, 1.0f, false}, {0.3f, 1.0f, false}, {0.5f, 1.0f, false},
+                                           {0.7f, 1.0f, false}, {0.9f, 1.0f, false}, {0.0f, 1.0f, false}};
+    return BBoxCropSampler(options, true, true, 1, 50, seed, stream);
+}
+
+static void test_philox_mapping()
+{
+    // uniform() and bounded() map the next word of the stream, the values are fixed by the words alone
+    PhiloxEngine words(42, 7, 1234), rng(42, 7, 1234);
+    for(int i = 0; i < 1000; i++)
+    {
+        uint32_t word = words();
+        float u = rng.uniform();
+        check(u == (word >> 8) * 0x1p-24f && u >= 0.0f && u < 1.0f, "uniform() of word " + std::to_string(i));
+        word = words();
+        uint32_t n = 1 + i % 13;
+        uint32_t v = rng.bounded(n);
+        check(v == uint32_t((uint64_t(word) * n) >> 32) && v < n, "bounded(" + std::to_string(n) + ") of word " + std::to_string(i));
+    }
+}
+
+static void test_sample_determinism()
+{
+    BBoxCropSampler sampler = ssd_sampler(42, 3), same = ssd_sampler(42, 3), other_seed = ssd_sampler(43, 3);
+    BoundingBoxCords boxes = {BoundingBoxCord(0.1f, 0.1f, 0.4f, 0.5f), BoundingBoxCord(0.5f, 0.2f, 0.9f, 0.8f)};
+    unsigned differ = 0;
+    for(size_t s = 0; s < 200; s++)
+    {
+        uint64_t key = BBoxCropSampler::sample_key("image_" + std::to_string(s) + ".jpg", 2);
+        BBoxCropWindow window = sampler.sample(boxes, key);
+        check(same_window(window, sampler.sample(boxes, key)), "window of sample " + std::to_string(s) + " drawn twice");
+        check(same_window(window, same.sample(boxes, key)), "window of sample " + std::to_string(s) + " from a sampler of the same seed");
+        const BoundingBoxCord &w = window.window;
+        check(w.l >= 0.0f && w.t >= 0.0f && w.r <= 1.0f && w.b <= 1.0f && w.r > w.l && w.b > w.t,
+              "window of sample " + std::to_string(s) + " within the image");
+        differ += !same_window(window, other_seed.sample(boxes, key));
+    }
+    check(differ > 0, "another seed gives other windows");
+    check(BBoxCropSampler::sample_key("image_0.jpg", 0) != BBoxCropSampler::sample_key("image_0.jpg", 1), "the key changes with the epoch");
+}
+
+static void test_batch_thread_count()
+{
+    // The windows of a batch do not depend on the thread count or on which thread picks which sample
+    BBoxCropSampler sampler = ssd_sampler(7, 1);
+    std::vector<BoundingBoxCords> sample_boxes(64);
+    std::vector<const BoundingBoxCords *> boxes(sample_boxes.size());
+    std::vector<std::string> names(sample_boxes.size());
+    for(size_t i = 0; i < sample_boxes.size(); i++)
+    {
+        for(size_t j = 0; j < i % 11; j++)
+        {
+            float x = 0.05f * (j % 10), y = 0.07f * ((i + j) % 10);
+            sample_boxes[i].push_back(BoundingBoxCord(x, y, x + 0.2f + 0.01f * j, y + 0.25f));
+        }
+        boxes[i] = i % 9 ? &sample_boxes[i] : nullptr;
+        names[i] = "sample_" + std::to_string(i);
+    }
+    std::vector<BBoxCropWindow> reference;
+    sampler.sample_batch(boxes, names, 5, reference);
+    for(size_t num_threads : {1, 2, 4, 8})
+    {
+        sampler.set_num_threads(num_threads);
+        std::vector<BBoxCropWindow> windows;
+        sampler.sample_batch(boxes, names, 5, windows);
+        for(size_t i = 0; i < names.size(); i++)
+        {
+            check(same_window(windows[i], reference[i]), "window of sample " + std::to_string(i) + " on " + std::to_string(num_threads) + " threads");
+            const BoundingBoxCords no_boxes;
+            check(same_window(windows[i], sampler.sample(boxes[i] ? *boxes[i] : no_boxes, BBoxCropSampler::sample_key(names[i], 5))),
+                  "batch window of sample " + std::to_string(i) + " against sample()");
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    test_philox_mapping();
+    test_sample_determinism();
+    test_batch_thread_count();
+    return rocal_test::report("rocal_bbox_crop_sampler_test");
+}
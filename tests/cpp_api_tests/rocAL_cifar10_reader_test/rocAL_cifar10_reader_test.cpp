@@ -0,0 +1,134 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "cifar10_data_reader.h"
+#include "mapped_file.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+static const size_t RECORD_SIZE = 32 * 32 * 3 + 1;//!< label byte then three 32x32 planes
+
+static std::string g_folder;
+
+// A batch file of count records, the bytes depend on the file, the record and their position, followed by extra bytes of a cut record
+static void write_batch_file(const std::string &name, unsigned count, size_t extra_bytes)
+{
+    std::vector<unsigned char> bytes(count * RECORD_SIZE + extra_bytes);
+    for(size_t i = 0; i < bytes.size(); i++)
+        bytes[i] = (unsigned char)(i * 7 + i / RECORD_SIZE * 13 + name.size() * name.back());
+    std::ofstream(g_folder + "/" + name, std::ios::binary).write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+// The pixels of a record read with a seek and a read, the way the reader got them before the batch files were held in memory
+static std::vector<unsigned char> read_record(const std::string &id)
+{
+    auto separator = id.find_last_of('_');
+    std::vector<unsigned char> pixels(RECORD_SIZE - 1);
+    FILE *file = fopen((g_folder + "/" + id.substr(0, separator)).c_str(), "rb");
+    if(!file)
+        return {};
+    bool read = fseek(file, std::stoul(id.substr(separator + 1)) * RECORD_SIZE + 1, SEEK_SET) == 0 &&
+                fread(pixels.data(), 1, pixels.size(), file) == pixels.size();
+    fclose(file);
+    return read ? pixels : std::vector<unsigned char>();
+}
+
+struct Epoch
+{
+    std::vector<std::string> ids;
+    std::vector<std::vector<unsigned char>> pixels;
+};
+
+// Reads an epoch of the folder through view() and read_data(), checking both against the records read from the files
+static Epoch read_epoch(const std::string &mode, bool expect_mapped)
+{
+    ReaderConfig config(StorageType::FILE_SYSTEM, g_folder);
+    config.set_file_prefix("data_batch_");
+    CIFAR10DataReader reader;
+    reader.initialize(config);
+    Epoch epoch;
+    while(reader.count_items() > 0)
+    {
+        size_t size = reader.open();
+        const std::string what = reader.id() + " " + mode;
+        ReaderItemView item_view;
+        std::vector<unsigned char> pixels(size);
+        check(size == RECORD_SIZE - 1 && reader.view(item_view) && reader.read_data(pixels.data(), size) == size, "size of " + what);
+        check(item_view.data && item_view.shape.width == 32 && item_view.shape.height == 32 && item_view.shape.channels == 3, "view shape of " + what);
+        auto reference = read_record(reader.id());
+        check(!reference.empty() && pixels == reference, "read_data of " + what);
+        check(item_view.data && std::vector<unsigned char>(item_view.data, item_view.data + size) == reference, "view of " + what);
+        reader.close();
+        epoch.ids.push_back(reader.id());
+        epoch.pixels.push_back(pixels);
+    }
+    for(std::string name : {"data_batch_1.bin", "data_batch_2.bin"})
+    {
+        auto file = MappedFile::open(g_folder + "/" + name);
+        check(file && file->mapped() == expect_mapped, name + " " + mode);
+    }
+    // Skipping lands on the record opened at that position
+    reader.reset();
+    check(reader.skip(5) && reader.count_items() == epoch.ids.size() - 5, "count after skipping " + mode);
+    reader.open();
+    check(reader.id() == epoch.ids[5], "record after skipping " + mode);
+    reader.close();
+    return epoch;
+}
+
+int main(int argc, char **argv)
+{
+    char folder[] = "/tmp/rocal_cifar10_reader_test_XXXXXX";
+    if(!mkdtemp(folder))
+    {
+        std::cout << "Cannot create a temporary folder" << std::endl;
+        return -1;
+    }
+    g_folder = folder;
+    // The cut record at the end of the second file is not handed out, the test batch is left out by the prefix
+    write_batch_file("data_batch_1.bin", 5, 0);
+    write_batch_file("data_batch_2.bin", 3, 100);
+    write_batch_file("test_batch.bin", 2, 0);
+    unsetenv("ROCAL_DISABLE_MMAP");
+    auto mapped = read_epoch("mapped", true);
+    check(mapped.ids.size() == 8, "records of the mapped batch files");
+    // The mappings are released with the reader, the files are read to memory by the next one
+    setenv("ROCAL_DISABLE_MMAP", "1", 1);
+    auto read = read_epoch("read to memory", false);
+    unsetenv("ROCAL_DISABLE_MMAP");
+    check(read.ids == mapped.ids && read.pixels == mapped.pixels, "records of the mapped and the read batch files differ");
+    std::string remove = "rm -rf " + g_folder;
+    if(system(remove.c_str()) != 0)
+        std::cout << "Could not remove " << g_folder << std::endl;
+    return rocal_test::report("rocal_cifar10_reader_test");
+}
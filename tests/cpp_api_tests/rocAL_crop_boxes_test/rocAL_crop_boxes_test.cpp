@@ -0,0 +1,155 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "meta_data_graph.h"
+#include "meta_node.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+// Exposes the batch transform shared by the crop meta nodes
+class CropBoxesNode: public MetaNode
+{
+public:
+    void update_parameters(MetaDataBatch *input_meta_data) override {}
+    using MetaNode::crop_boxes;
+};
+
+// The per box loop the crop meta nodes ran before crop_boxes(), one sample at a time
+static void reference_crop_boxes(BoundingBoxCords &boxes, BoundingBoxLabels &labels, const BoundingBoxCord &window, bool mirrored, float iou_threshold, bool fill_empty)
+{
+    BoundingBoxCords kept_boxes;
+    BoundingBoxLabels kept_labels;
+    const float window_w = window.r - window.l, window_h = window.b - window.t;
+    for(size_t j = 0; j < boxes.size(); j++)
+    {
+        const BoundingBoxCord &box = boxes[j];
+        float xA = std::max(window.l, box.l);
+        float yA = std::max(window.t, box.t);
+        float xB = std::min(window.r, box.r);
+        float yB = std::min(window.b, box.b);
+        float intersection_area = std::max(0.0f, xB - xA) * std::max(0.0f, yB - yA);
+        float box_area = (box.b - box.t) * (box.r - box.l);
+        if((intersection_area / box_area) < iou_threshold)
+            continue;
+        BoundingBoxCord cropped = {(xA - window.l) / window_w, (yA - window.t) / window_h, (xB - window.l) / window_w, (yB - window.t) / window_h};
+        if(mirrored)
+        {
+            float l = 1 - cropped.r;
+            cropped.r = 1 - cropped.l;
+            cropped.l = l;
+        }
+        kept_boxes.push_back(cropped);
+        kept_labels.push_back(labels[j]);
+    }
+    if(kept_boxes.empty() && fill_empty)
+    {
+        kept_boxes.push_back({0, 0, 1, 1});
+        kept_labels.push_back(0);
+    }
+    boxes = kept_boxes;
+    labels = kept_labels;
+}
+
+static bool same_bits(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// One batch through crop_boxes() and through the reference, the boxes have to be the same bits
+void test_batch(CropBoxesNode &node, std::mt19937 &rng, const std::vector<size_t> &box_counts, bool mirror, bool fill_empty, const std::string &name)
+{
+    std::uniform_real_distribution<float> coord(0.0f, 1.0f);
+    BoundingBoxBatch batch;
+    batch.resize(box_counts.size());
+    std::vector<BoundingBoxCord> windows(box_counts.size());
+    std::vector<int> mirror_values(box_counts.size());
+    for(size_t i = 0; i < box_counts.size(); i++)
+    {
+        for(size_t j = 0; j < box_counts[i]; j++)
+        {
+            float x0 = coord(rng), x1 = coord(rng), y0 = coord(rng), y1 = coord(rng);
+            BoundingBoxCord box = {std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1)};
+            // Boxes on the edges of the image and of the window, where the max/min of equal values and of signed zeros matter
+            if(j % 5 == 1)
+                box.l = -0.0f;
+            if(j % 7 == 2)
+                box.t = 0.0f;
+            if(j % 11 == 3)
+                box.r = 1.0f;
+            batch.get_bb_cords_batch()[i].push_back(box);
+            batch.get_bb_labels_batch()[i].push_back(int(j) + 1);
+        }
+        float x0 = coord(rng), x1 = coord(rng), y0 = coord(rng), y1 = coord(rng);
+        windows[i] = {std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1)};
+        if(i % 3 == 0)
+            windows[i] = {0.0f, 0.0f, 1.0f, 1.0f};
+        mirror_values[i] = mirror ? int(i % 2) : 0;
+    }
+    BoundingBoxBatch expected = batch;
+    for(size_t i = 0; i < box_counts.size(); i++)
+        reference_crop_boxes(expected.get_bb_cords_batch()[i], expected.get_bb_labels_batch()[i], windows[i], mirror_values[i] != 0, node._iou_threshold, fill_empty);
+    node.crop_boxes(&batch, windows, mirror ? mirror_values.data() : nullptr, fill_empty);
+
+    for(size_t i = 0; i < box_counts.size(); i++)
+    {
+        auto &boxes = batch.get_bb_cords_batch()[i], &expected_boxes = expected.get_bb_cords_batch()[i];
+        const std::string sample = name + " sample " + std::to_string(i);
+        if(boxes.size() != expected_boxes.size())
+        {
+            check(false, sample + ": " + std::to_string(boxes.size()) + " boxes kept instead of " + std::to_string(expected_boxes.size()));
+            continue;
+        }
+        check(batch.get_bb_labels_batch()[i] == expected.get_bb_labels_batch()[i], sample + ": labels differ");
+        for(size_t j = 0; j < boxes.size(); j++)
+            if(!same_bits(boxes[j].l, expected_boxes[j].l) || !same_bits(boxes[j].t, expected_boxes[j].t) ||
+               !same_bits(boxes[j].r, expected_boxes[j].r) || !same_bits(boxes[j].b, expected_boxes[j].b))
+            {
+                check(false, sample + " box " + std::to_string(j) + " differs");
+                break;
+            }
+    }
+}
+
+int main(int argc, const char **argv)
+{
+    std::mt19937 rng(2023);
+    CropBoxesNode node;
+    // Sample sizes around the 8 boxes of the AVX2 loop, empty samples included, one node for all so its buffers are reused
+    const std::vector<size_t> box_counts = {0, 1, 7, 8, 9, 15, 16, 17, 33, 3, 0, 64};
+    for(unsigned iteration = 0; iteration < 20; iteration++)
+    {
+        node._iou_threshold = (iteration % 4) * 0.25f;
+        test_batch(node, rng, box_counts, false, true, "iteration " + std::to_string(iteration));
+        test_batch(node, rng, box_counts, true, true, "mirrored iteration " + std::to_string(iteration));
+        test_batch(node, rng, box_counts, iteration % 2, false, "no fill iteration " + std::to_string(iteration));
+    }
+    return rocal_test::report("crop_boxes() matches the per box reference bit for bit");
+}
@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "numpy_data_reader.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+// A .npy file of the given format version, its header dictionary padded with spaces and a new line the way numpy writes it
+static std::vector<unsigned char> make_npy(unsigned version, const std::string &dictionary)
+{
+    const size_t preamble_size = version == 1 ? 10 : 12;
+    std::string header = dictionary;
+    while((preamble_size + header.size() + 1) % 64)
+        header += ' ';
+    header += '\n';
+    std::string file = "\x93NUMPY";
+    file += char(version);
+    file += char(0);
+    for(size_t i = 0; i < preamble_size - 8; i++)
+        file += char(header.size() >> (8 * i));
+    file += header;
+    return std::vector<unsigned char>(file.begin(), file.end());
+}
+
+static std::string dictionary(const std::string &descr, const std::string &fortran_order, const std::string &shape)
+{
+    return "{'descr': " + descr + ", 'fortran_order': " + fortran_order + ", 'shape': " + shape + ", }";
+}
+
+static void expect_layout(const std::vector<unsigned char> &file, bool has_sample_axis, size_t samples, size_t height, size_t width, size_t channels, const std::string &name)
+{
+    NumpyFileInfo info;
+    try
+    {
+        check(parse_numpy_header(file.data(), file.size(), has_sample_axis, info), name + ": not recognized as a .npy file");
+    }
+    catch(const std::exception &e)
+    {
+        check(false, name + ": " + e.what());
+        return;
+    }
+    check(info.sample_count == samples && info.shape.height == height && info.shape.width == width && info.shape.channels == channels,
+          name + ": parsed as " + std::to_string(info.sample_count) + " x " + std::to_string(info.shape.height) + " x " + std::to_string(info.shape.width) + " x " + std::to_string(info.shape.channels));
+    check(info.data_offset % 64 == 0 && info.data_offset <= file.size(), name + ": data offset " + std::to_string(info.data_offset));
+}
+
+static void expect_error(const std::vector<unsigned char> &file, bool has_sample_axis, const std::string &name)
+{
+    NumpyFileInfo info;
+    bool thrown = false;
+    try
+    {
+        parse_numpy_header(file.data(), file.size(), has_sample_axis, info);
+    }
+    catch(const std::exception &e)
+    {
+        thrown = true;
+    }
+    check(thrown, name + ": accepted");
+}
+
+void test_layouts()
+{
+    expect_layout(make_npy(1, dictionary("'|u1'", "False", "(4, 6, 3)")), false, 1, 4, 6, 3, "single (H, W, C) sample");
+    expect_layout(make_npy(1, dictionary("'|u1'", "False", "(4, 6)")), false, 1, 4, 6, 1, "single (H, W) sample");
+    expect_layout(make_npy(1, dictionary("'<u1'", "False", "(5, 4, 6)")), true, 5, 4, 6, 1, "(N, H, W) samples");
+    expect_layout(make_npy(2, dictionary("'u1'", "False", "(5, 4, 6, 3)")), true, 5, 4, 6, 3, "(N, H, W, C) samples, version 2.0");
+    expect_layout(make_npy(3, dictionary("\">u1\"", "False", "(2, 4, 6, 1)")), false, 2, 4, 6, 1, "4 dimensional array in a folder, version 3.0");
+    // The keys in another order and without spaces, as other writers than numpy may produce them
+    expect_layout(make_npy(1, "{'shape':(7,8,3),'fortran_order':False,'descr':'|u1'}"), false, 1, 7, 8, 3, "compact dictionary");
+}
+
+void test_unsupported_arrays()
+{
+    expect_error(make_npy(1, dictionary("'|u1'", "True", "(4, 6, 3)")), false, "fortran order");
+    expect_error(make_npy(1, dictionary("'<f4'", "False", "(4, 6, 3)")), false, "float32 dtype");
+    expect_error(make_npy(1, dictionary("'<u2'", "False", "(4, 6, 3)")), false, "uint16 dtype");
+    expect_error(make_npy(1, dictionary("'|i1'", "False", "(4, 6, 3)")), false, "int8 dtype");
+    expect_error(make_npy(1, dictionary("'|u1'", "False", "(4, 6, 4)")), false, "4 channels");
+    expect_error(make_npy(1, dictionary("'|u1'", "False", "(24,)")), false, "1 dimension");
+    expect_error(make_npy(1, dictionary("'|u1'", "False", "(4, 6)")), true, "(H, W) without the sample axis");
+    expect_error(make_npy(1, dictionary("'|u1'", "False", "(2, 3, 4, 6, 3)")), true, "5 dimensions");
+    expect_error(make_npy(1, dictionary("'|u1'", "False", "(0, 6, 3)")), false, "empty height");
+}
+
+void test_malformed_headers()
+{
+    NumpyFileInfo info;
+    std::vector<unsigned char> not_npy = {'P', 'K', 3, 4, 0, 0, 0, 0, 0, 0, 0, 0};
+    check(!parse_numpy_header(not_npy.data(), not_npy.size(), false, info), "file without the .npy magic string recognized as .npy");
+    auto short_file = make_npy(1, dictionary("'|u1'", "False", "(4, 6, 3)"));
+    check(!parse_numpy_header(short_file.data(), 6, false, info), "file shorter than the preamble recognized as .npy");
+
+    auto truncated = make_npy(1, dictionary("'|u1'", "False", "(4, 6, 3)"));
+    truncated.resize(truncated.size() - 20);
+    expect_error(truncated, false, "truncated header");
+    auto truncated_v2 = make_npy(2, dictionary("'|u1'", "False", "(4, 6, 3)"));
+    truncated_v2.resize(11);
+    expect_error(truncated_v2, false, "version 2.0 preamble cut short");
+    auto unknown_version = make_npy(1, dictionary("'|u1'", "False", "(4, 6, 3)"));
+    unknown_version[6] = 4;
+    expect_error(unknown_version, false, "format version 4.0");
+    expect_error(make_npy(1, "{'fortran_order': False, 'shape': (4, 6, 3), }"), false, "no dtype");
+    expect_error(make_npy(1, "{'descr': '|u1', 'shape': (4, 6, 3), }"), false, "no fortran order");
+    expect_error(make_npy(1, "{'descr': '|u1', 'fortran_order': False, }"), false, "no shape");
+    expect_error(make_npy(1, dictionary("|u1", "False", "(4, 6, 3)")), false, "unquoted dtype");
+    expect_error(make_npy(1, dictionary("'|u1", "False", "(4, 6, 3)")), false, "unterminated dtype");
+    expect_error(make_npy(1, dictionary("'|u1'", "False", "[4, 6, 3]")), false, "shape as a list");
+    expect_error(make_npy(1, dictionary("'|u1'", "False", "(4, 6, 3")), false, "unterminated shape");
+    expect_error(make_npy(1, dictionary("'|u1'", "False", "(4, six, 3)")), false, "shape with a name");
+}
+
+int main(int argc, const char **argv)
+{
+    test_layouts();
+    test_unsupported_arrays();
+    test_malformed_headers();
+    return rocal_test::report(".npy header checks passed");
+}
@@ -0,0 +1,120 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+#include "philox.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+// Known answers of Philox4x32-10 from the Random123 distribution (kat_vectors), the key is {seed low, seed high}
+struct KnownAnswer
+{
+    uint32_t ctr[4];
+    uint32_t key[2];
+    uint32_t expected[4];
+};
+
+static const KnownAnswer known_answers[] = {
+    {{0x00000000, 0x00000000, 0x00000000, 0x00000000}, {0x00000000, 0x00000000}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+    {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+    {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}, {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+};
+
+void test_known_answers()
+{
+    for(const auto &known: known_answers)
+    {
+        uint32_t ctr[4] = {known.ctr[0], known.ctr[1], known.ctr[2], known.ctr[3]};
+        philox::block(ctr, uint64_t(known.key[1]) << 32 | known.key[0]);
+        for(unsigned w = 0; w < 4; w++)
+        {
+            char what[128];
+            snprintf(what, sizeof(what), "known answer word %u: 0x%08x instead of 0x%08x", w, ctr[w], known.expected[w]);
+            check(ctr[w] == known.expected[w], what);
+        }
+    }
+}
+
+// Word n of a stream is word n % 4 of the block {0, stream, n / 4}
+static uint32_t scalar_word(uint64_t seed, uint32_t stream, uint64_t n)
+{
+    uint32_t ctr[4] = {0, stream, uint32_t(n / 4), uint32_t((n / 4) >> 32)};
+    philox::block(ctr, seed);
+    return ctr[n % 4];
+}
+
+// fill() takes 32 words at a time through the AVX2 path when built with ENABLE_SIMD, the rest block by block,
+// the words have to be the same whatever the alignment of first and the number of words
+void test_fill()
+{
+    const uint64_t seeds[] = {0, 1, 0x0123456789abcdefULL};
+    // The last ones cross the 32 bit boundary of the sample within the 8 blocks of the AVX2 path
+    const uint64_t firsts[] = {0, 1, 3, 4, 31, 32, 100, (0xffffffffULL - 3) * 4, (0xffffffffULL - 3) * 4 + 2};
+    const size_t counts[] = {0, 1, 3, 4, 31, 32, 33, 64, 97, 300};
+    for(auto seed: seeds)
+        for(uint32_t stream: {0u, 7u, 0xffffffffu})
+            for(auto first: firsts)
+                for(auto count: counts)
+                {
+                    std::vector<uint32_t> out(count + 1, 0xdeadbeef);
+                    philox::fill(seed, stream, first, out.data(), count);
+                    for(size_t i = 0; i < count; i++)
+                        if(out[i] != scalar_word(seed, stream, first + i))
+                        {
+                            check(false, "fill() word " + std::to_string(i) + " of " + std::to_string(count) + " from " + std::to_string(first) +
+                                         " stream " + std::to_string(stream) + " seed " + std::to_string(seed));
+                            break;
+                        }
+                    check(out[count] == 0xdeadbeef, "fill() wrote past " + std::to_string(count) + " words");
+                }
+}
+
+// The engine uses the blocks {1, 2, ..., stream, sample}, after block 0 that fill() uses for the same stream and sample
+void test_engine()
+{
+    const uint64_t seed = 42, sample = 0x100000003ULL;
+    const uint32_t stream = 5;
+    PhiloxEngine engine(seed, stream, sample);
+    for(uint32_t block_idx = 1; block_idx <= 3; block_idx++)
+    {
+        uint32_t ctr[4] = {block_idx, stream, uint32_t(sample), uint32_t(sample >> 32)};
+        philox::block(ctr, seed);
+        for(unsigned w = 0; w < 4; w++)
+            check(engine() == ctr[w], "engine word " + std::to_string(w) + " of block " + std::to_string(block_idx));
+    }
+}
+
+int main(int argc, const char **argv)
+{
+    test_known_answers();
+    test_fill();
+    test_engine();
+    return rocal_test::report("Philox4x32-10 known answers, fill() and PhiloxEngine checks passed");
+}
@@ -0,0 +1,307 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <poll.h>
+
+#include "rocal_api.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+static std::string g_image_folder;
+static RocalProcessMode g_process_mode = RocalProcessMode::ROCAL_PROCESS_CPU;
+static const size_t BATCH_SIZE = 4;
+
+// A looping JPEG pipeline resized to width x height, nullptr if it could not be built
+static RocalContext create_pipeline(size_t prefetch_queue_depth, unsigned width, unsigned height)
+{
+    auto handle = rocalCreate(BATCH_SIZE, g_process_mode, 0, 1, prefetch_queue_depth);
+    if(rocalGetStatus(handle) != ROCAL_OK)
+    {
+        std::cout << "Could not create the rocAL context" << std::endl;
+        return nullptr;
+    }
+    auto input = rocalJpegFileSource(handle, g_image_folder.c_str(), RocalImageColor::ROCAL_COLOR_RGB24, 1, false, false, true,
+                                     ROCAL_USE_USER_GIVEN_SIZE, 256, 256);
+    rocalCreateLabelReader(handle, g_image_folder.c_str());
+    rocalResize(handle, input, width, height, true);
+    if(rocalGetStatus(handle) != ROCAL_OK || rocalVerify(handle) != ROCAL_OK)
+    {
+        std::cout << "Could not build the pipeline: " << rocalGetErrorMessage(handle) << std::endl;
+        rocalRelease(handle);
+        return nullptr;
+    }
+    return handle;
+}
+
+// Returns true if rocalTryRun() ran a batch before the timeout
+static bool try_run_within(RocalContext handle, std::chrono::milliseconds timeout)
+{
+    auto end = std::chrono::steady_clock::now() + timeout;
+    do
+    {
+        bool ran = false;
+        if(rocalTryRun(handle, &ran) != ROCAL_OK)
+            return false;
+        if(ran)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    } while(std::chrono::steady_clock::now() < end);
+    return false;
+}
+
+// While the user holds the batch of the previous run, the producer is one slot short: the next batch is not ready
+// till the lease is released, rocalTryRun() and the output ready descriptor have to say so instead of blocking
+void test_try_run_with_lease()
+{
+    // two batches ahead of the user at most, one of them is held by the lease
+    auto handle = create_pipeline(3, 64, 64);
+    if(!handle)
+    {
+        check(false, "try_run pipeline");
+        return;
+    }
+    int fd = rocalGetOutputReadyFd(handle);
+    check(rocalRun(handle) == ROCAL_OK, "first run");
+    unsigned long long lease = 0;
+    check(rocalAcquireOutputBatch(handle, &lease) == ROCAL_OK, "acquiring the output batch");
+    check(rocalRun(handle) == ROCAL_OK, "run with a leased batch");
+    // let the producer fill all the slots it can
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    check(!try_run_within(handle, std::chrono::milliseconds(200)), "try_run ready while the next slot is leased");
+    if(fd >= 0)
+    {
+        pollfd ready = {fd, POLLIN, 0};
+        check(poll(&ready, 1, 0) == 0, "output ready descriptor readable while the next slot is leased");
+    }
+    std::vector<unsigned char> output(BATCH_SIZE * 64 * 64 * 3);
+    check(rocalCopyToOutput(handle, output.data(), output.size()) == ROCAL_OK, "copy of the batch after the leased one");
+    check(rocalReleaseOutputBatch(handle, lease) == ROCAL_OK, "releasing the output batch");
+    if(fd >= 0)
+    {
+        pollfd ready = {fd, POLLIN, 0};
+        check(poll(&ready, 1, 5000) == 1, "output ready descriptor not readable once the lease is released");
+    }
+    check(try_run_within(handle, std::chrono::milliseconds(5000)), "try_run not ready once the lease is released");
+    rocalRelease(handle);
+}
+
+// Runs the first batch of the epoch and copies it, empty if it failed
+static std::vector<unsigned char> first_batch(RocalContext handle, unsigned width, unsigned height)
+{
+    std::vector<unsigned char> output(BATCH_SIZE * width * height * 3);
+    if(rocalGetOutputWidth(handle) != (int)width || rocalGetOutputHeight(handle) != (int)(height * BATCH_SIZE) ||
+       rocalRun(handle) != ROCAL_OK || rocalCopyToOutput(handle, output.data(), output.size()) != ROCAL_OK)
+        output.clear();
+    return output;
+}
+
+// The output images packed after rocalSetOutputSize() shrinks them and grows them back match the ones of pipelines built at these sizes
+void test_output_size_shrink_and_grow()
+{
+    auto handle = create_pipeline(3, 64, 64);
+    if(!handle)
+    {
+        check(false, "output size pipeline");
+        return;
+    }
+    const std::vector<std::pair<unsigned, unsigned>> sizes = {{32, 24}, {48, 40}, {64, 64}, {16, 16}};
+    check(!first_batch(handle, 64, 64).empty(), "first batch at the full size");
+    for(auto &size: sizes)
+    {
+        const std::string name = std::to_string(size.first) + "x" + std::to_string(size.second);
+        check(rocalSetOutputSize(handle, size.first, size.second) == ROCAL_OK, "setting the output size to " + name);
+        check(rocalResetLoaders(handle) == ROCAL_OK, "reset after setting the output size to " + name);
+        auto resized = first_batch(handle, size.first, size.second);
+        auto reference_handle = create_pipeline(3, size.first, size.second);
+        if(!reference_handle)
+        {
+            check(false, "reference pipeline of " + name);
+            continue;
+        }
+        auto reference = first_batch(reference_handle, size.first, size.second);
+        check(!resized.empty() && resized == reference, "output images resized to " + name + " differ from a pipeline built at that size");
+        rocalRelease(reference_handle);
+    }
+    rocalRelease(handle);
+}
+
+// Runs a batch and copies it at the output size of the pipeline, empty if it failed
+static std::vector<unsigned char> run_and_copy(RocalContext handle)
+{
+    std::vector<unsigned char> output((size_t)rocalGetOutputWidth(handle) * rocalGetOutputHeight(handle) * 3);
+    if(rocalRun(handle) != ROCAL_OK || rocalCopyToOutput(handle, output.data(), output.size()) != ROCAL_OK)
+        output.clear();
+    return output;
+}
+
+// Sequences of the image folder, taken as one stream of frames, rearranged and resized. With copy_first a copy of the
+// frames is rearranged instead of the output of the sequence reader, so that the rearrangement is not folded into the reader
+static RocalContext create_sequence_pipeline(std::vector<unsigned> &new_order, unsigned sequence_length, bool copy_first)
+{
+    auto handle = rocalCreate(BATCH_SIZE, g_process_mode, 0, 1);
+    if(rocalGetStatus(handle) != ROCAL_OK)
+        return nullptr;
+    auto frames = rocalSequenceReader(handle, g_image_folder.c_str(), RocalImageColor::ROCAL_COLOR_RGB24, 1, sequence_length, false, false, true);
+    if(copy_first)
+        frames = rocalCopy(handle, frames, false);
+    auto rearranged = rocalSequenceRearrange(handle, frames, new_order.data(), new_order.size(), sequence_length, false);
+    rocalResize(handle, rearranged, 64, 64, true);
+    if(rocalGetStatus(handle) != ROCAL_OK || rocalVerify(handle) != ROCAL_OK)
+    {
+        std::cout << "Could not build the sequence pipeline: " << rocalGetErrorMessage(handle) << std::endl;
+        rocalRelease(handle);
+        return nullptr;
+    }
+    return handle;
+}
+
+// The frames the sequence reader loads in the new order when the rearrangement is folded into it are the ones the rearrange node outputs,
+// and the output of the reader cannot be used anymore once the rearrangement consumed it
+void test_folded_sequence_rearrange()
+{
+    // frames dropped, repeated and moved
+    std::vector<unsigned> new_order = {3, 1, 1, 0, 4};
+    const unsigned sequence_length = 5;
+    auto folded = create_sequence_pipeline(new_order, sequence_length, false);
+    auto unfolded = create_sequence_pipeline(new_order, sequence_length, true);
+    if(!folded || !unfolded)
+    {
+        check(false, "sequence pipelines");
+        if(folded)
+            rocalRelease(folded);
+        if(unfolded)
+            rocalRelease(unfolded);
+        return;
+    }
+    check(rocalGetOutputHeight(folded) == rocalGetOutputHeight(unfolded), "folded and unfolded output sizes differ");
+    for(unsigned batch = 0; batch < 3; batch++)
+    {
+        auto folded_frames = run_and_copy(folded);
+        auto unfolded_frames = run_and_copy(unfolded);
+        check(!folded_frames.empty() && folded_frames == unfolded_frames, "folded rearrangement differs from the rearrange node in batch " + std::to_string(batch));
+    }
+    rocalRelease(folded);
+    rocalRelease(unfolded);
+
+    auto handle = rocalCreate(BATCH_SIZE, g_process_mode, 0, 1);
+    auto frames = rocalSequenceReader(handle, g_image_folder.c_str(), RocalImageColor::ROCAL_COLOR_RGB24, 1, sequence_length, false, false, true);
+    rocalSequenceRearrange(handle, frames, new_order.data(), new_order.size(), sequence_length, true);
+    check(rocalGetStatus(handle) == ROCAL_OK, "folding the rearrangement");
+    rocalBrightness(handle, frames, true);
+    check(rocalGetStatus(handle) != ROCAL_OK, "output of the sequence reader used after the rearrangement consumed it");
+    rocalRelease(handle);
+}
+
+// A shuffled pipeline of two internal shards with random brightness, either tracking its state or resumed from the given one
+static RocalContext create_state_pipeline(const std::vector<unsigned char> &state)
+{
+    auto handle = rocalCreate(BATCH_SIZE, g_process_mode, 0, 1);
+    if(rocalGetStatus(handle) != ROCAL_OK)
+        return nullptr;
+    auto status = state.empty() ? rocalSetStateTracking(handle, true) : rocalLoadState(handle, state.data(), state.size());
+    auto input = rocalJpegFileSource(handle, g_image_folder.c_str(), RocalImageColor::ROCAL_COLOR_RGB24, 2, false, true, true,
+                                     ROCAL_USE_USER_GIVEN_SIZE, 256, 256);
+    rocalCreateLabelReader(handle, g_image_folder.c_str());
+    auto resized = rocalResize(handle, input, 64, 64, false);
+    rocalBrightness(handle, resized, true);
+    if(status != ROCAL_OK || rocalGetStatus(handle) != ROCAL_OK || rocalVerify(handle) != ROCAL_OK)
+    {
+        std::cout << "Could not build the state pipeline: " << rocalGetErrorMessage(handle) << std::endl;
+        rocalRelease(handle);
+        return nullptr;
+    }
+    return handle;
+}
+
+// Runs a batch and copies its images followed by its labels, empty if it failed
+static std::vector<unsigned char> run_and_copy_with_labels(RocalContext handle)
+{
+    auto output = run_and_copy(handle);
+    if(output.empty())
+        return output;
+    std::vector<int> labels(BATCH_SIZE);
+    rocalGetImageLabels(handle, labels.data());
+    output.insert(output.end(), reinterpret_cast<unsigned char *>(labels.data()), reinterpret_cast<unsigned char *>(labels.data() + labels.size()));
+    return output;
+}
+
+// The batches after a state saved mid-epoch, with prefetched batches in flight, are the ones a pipeline resumed from it runs first:
+// same shuffled samples of the same shards, same random brightness, same labels
+void test_save_and_load_state()
+{
+    auto saved = create_state_pipeline({});
+    if(!saved)
+    {
+        check(false, "state pipeline");
+        return;
+    }
+    for(unsigned batch = 0; batch < 3; batch++)
+        check(!run_and_copy_with_labels(saved).empty(), "batch " + std::to_string(batch) + " before saving the state");
+    size_t size = 0;
+    check(rocalSaveState(saved, nullptr, &size) == ROCAL_OK && size > 0, "size of the state");
+    std::vector<unsigned char> state(size);
+    check(rocalSaveState(saved, state.data(), &size) == ROCAL_OK && size == state.size(), "saving the state");
+    std::vector<std::vector<unsigned char>> expected;
+    for(unsigned batch = 0; batch < 3; batch++)
+        expected.push_back(run_and_copy_with_labels(saved));
+    rocalRelease(saved);
+
+    auto resumed = create_state_pipeline(state);
+    if(!resumed)
+    {
+        check(false, "pipeline resumed from the state");
+        return;
+    }
+    for(unsigned batch = 0; batch < expected.size(); batch++)
+    {
+        auto output = run_and_copy_with_labels(resumed);
+        check(!output.empty() && output == expected[batch], "batch " + std::to_string(batch) + " after loading the state differs from the one after saving it");
+    }
+    rocalRelease(resumed);
+}
+
+int main(int argc, const char **argv)
+{
+    if(argc < 2)
+    {
+        std::cout << "Usage: rocal_pipeline_test <image_dataset_folder> <processing_device=1/cpu=0>" << std::endl;
+        return -1;
+    }
+    g_image_folder = argv[1];
+    if(argc > 2 && atoi(argv[2]))
+        g_process_mode = RocalProcessMode::ROCAL_PROCESS_GPU;
+    std::cout << ">>> Running on " << (g_process_mode == RocalProcessMode::ROCAL_PROCESS_GPU ? "GPU" : "CPU") << std::endl;
+    test_try_run_with_lease();
+    test_output_size_shrink_and_grow();
+    test_folded_sequence_rearrange();
+    test_save_and_load_state();
+    return rocal_test::report("Pipeline checks passed");
+}
@@ -0,0 +1,231 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "image_reader.h"
+#include "mxnet_recordio_index.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+static const uint32_t RECORDIO_MAGIC = 0xced7230a;
+
+static std::string g_folder;
+
+struct TestRecord
+{
+    uint64_t id;
+    std::vector<float> labels;//!< one label is stored in the header, more after it (flag labels)
+    std::vector<unsigned char> image;
+};
+
+static void put_word(std::vector<unsigned char> &bytes, uint32_t word)
+{
+    bytes.insert(bytes.end(), reinterpret_cast<unsigned char *>(&word), reinterpret_cast<unsigned char *>(&word) + 4);
+}
+
+// The image bytes hold the magic number at 4 byte aligned positions of the payload for the multi-part records
+static std::vector<unsigned char> image_bytes(uint64_t id, unsigned magic_count)
+{
+    std::vector<unsigned char> image;
+    for(unsigned i = 0; i < 40 + 4 * (id % 7); i++)
+        image.push_back((unsigned char)(id * 31 + i));
+    for(unsigned m = 0; m < magic_count; m++)
+    {
+        put_word(image, RECORDIO_MAGIC);
+        for(unsigned i = 0; i < 12; i++)
+            image.push_back((unsigned char)(m + i));
+    }
+    return image;
+}
+
+// Writes the records the way the dmlc RecordIO writer does: the payload is split around the magic numbers it holds, the parts are padded to 4 bytes
+static void write_rec_file(const std::string &name, const std::vector<TestRecord> &records)
+{
+    std::vector<unsigned char> rec;
+    std::ofstream idx(g_folder + "/" + name + ".idx");
+    for(size_t r = 0; r < records.size(); r++)
+    {
+        auto &record = records[r];
+        std::vector<unsigned char> payload(sizeof(ImageRecordIOHeader));
+        ImageRecordIOHeader header = {};
+        header.flag = record.labels.size() > 1 ? record.labels.size() : 0;
+        header.label = record.labels.size() == 1 ? record.labels[0] : 0;
+        header.image_id[0] = record.id;
+        memcpy(payload.data(), &header, sizeof(header));
+        if(header.flag)
+            payload.insert(payload.end(), reinterpret_cast<const unsigned char *>(record.labels.data()),
+                           reinterpret_cast<const unsigned char *>(record.labels.data() + record.labels.size()));
+        payload.insert(payload.end(), record.image.begin(), record.image.end());
+        std::vector<std::pair<size_t, size_t>> parts;
+        size_t begin = 0;
+        for(size_t i = 0; i + 4 <= payload.size(); i += 4)
+        {
+            uint32_t word;
+            memcpy(&word, payload.data() + i, 4);
+            if(word != RECORDIO_MAGIC)
+                continue;
+            parts.emplace_back(begin, i - begin);
+            begin = i + 4;
+        }
+        parts.emplace_back(begin, payload.size() - begin);
+        idx << r << "\t" << rec.size() << "\n";
+        for(size_t p = 0; p < parts.size(); p++)
+        {
+            const uint32_t flag = parts.size() == 1 ? 0 : (p == 0 ? 1 : (p + 1 == parts.size() ? 3 : 2));
+            put_word(rec, RECORDIO_MAGIC);
+            put_word(rec, (flag << 29U) | parts[p].second);
+            rec.insert(rec.end(), payload.begin() + parts[p].first, payload.begin() + parts[p].first + parts[p].second);
+            rec.resize((rec.size() + 3) & ~size_t(3), 0);
+        }
+    }
+    std::ofstream(g_folder + "/" + name + ".rec", std::ios::binary).write(reinterpret_cast<const char *>(rec.data()), rec.size());
+}
+
+static std::vector<TestRecord> test_records(uint64_t first_id, size_t count)
+{
+    std::vector<TestRecord> records;
+    for(uint64_t id = first_id; id < first_id + count; id++)
+    {
+        std::vector<float> labels = (id % 4 == 1) ? std::vector<float>{float(id % 10), 2.5f, 7.0f} : std::vector<float>{float(id % 10)};
+        records.push_back({id, labels, image_bytes(id, id % 3)});
+    }
+    return records;
+}
+
+static std::vector<unsigned char> read_payload(const MXNetRecordIOIndex &index, const MXNetRecord &record, size_t begin, size_t size)
+{
+    std::vector<unsigned char> bytes(size);
+    int fd = open(index.rec_files[record.file].c_str(), O_RDONLY);
+    bool read = fd >= 0 && read_mxnet_record_payload(fd, record, begin, size, bytes.data());
+    if(fd >= 0)
+        close(fd);
+    return read ? bytes : std::vector<unsigned char>();
+}
+
+static void test_multi_part_records()
+{
+    // Two .rec files, the records of the second one are listed in the index out of order, some are split in up to 3 parts
+    const std::string folder = g_folder;
+    auto part0 = test_records(0, 9), part1 = test_records(100, 9);
+    write_rec_file("part0", part0);
+    write_rec_file("part1", part1);
+    std::vector<std::string> lines;
+    {
+        std::ifstream idx(folder + "/part1.idx");
+        for(std::string line; std::getline(idx, line);)
+            lines.insert(lines.begin(), line);
+        std::ofstream reversed(folder + "/part1.idx");
+        for(auto &line: lines)
+            reversed << line << "\n";
+    }
+    std::shared_ptr<const MXNetRecordIOIndex> index;
+    try { index = load_mxnet_recordio_index(folder); } catch(const std::exception &e) { check(false, std::string("index: ") + e.what()); return; }
+    check(index->rec_files.size() == 2 && index->rec_files[0] == folder + "/part0.rec" && index->rec_files[1] == folder + "/part1.rec", "rec files of the index");
+    part0.insert(part0.end(), part1.begin(), part1.end());
+    if(index->records.size() != part0.size())
+    {
+        check(false, std::to_string(index->records.size()) + " records indexed");
+        return;
+    }
+    size_t multi_part_count = 0;
+    for(size_t i = 0; i < part0.size(); i++)
+    {
+        auto &expected = part0[i];
+        auto &record = index->records[i];
+        const std::string what = "record " + std::to_string(expected.id);
+        check(record.key == std::to_string(expected.id) && record.id == expected.id && record.file == (i < 9 ? 0U : 1U), "key and file of " + what);
+        check(record.labels == expected.labels, "labels of " + what);
+        check(record.pieces.size() == 1 + expected.id % 3, "parts of " + what);
+        check(record.image_size == expected.image.size() && read_payload(*index, record, record.image_offset, record.image_size) == expected.image,
+              "image of " + what);
+        multi_part_count += record.pieces.size() > 1;
+        // Reads starting and ending anywhere, in a part or in the magic number between two parts
+        bool same = true;
+        for(size_t begin = 0; begin < record.image_size && same; begin += 3)
+            for(size_t size = 1; begin + size <= record.image_size && same; size += 5)
+                same = read_payload(*index, record, record.image_offset + begin, size) ==
+                       std::vector<unsigned char>(expected.image.begin() + begin, expected.image.begin() + begin + size);
+        check(same, "partial reads of " + what);
+    }
+    check(multi_part_count > 0, "multi-part records indexed");
+}
+
+static void test_index_reuse()
+{
+    // The index of a path is shared while in use, and built again once released
+    auto index = load_mxnet_recordio_index(g_folder);
+    auto again = load_mxnet_recordio_index(g_folder);
+    check(index == again, "index of the same path shared");
+    std::weak_ptr<const MXNetRecordIOIndex> released = index;
+    index.reset();
+    again.reset();
+    check(released.expired(), "index released with its last user");
+    write_rec_file("part2", test_records(200, 3));
+    index = load_mxnet_recordio_index(g_folder);
+    check(index->rec_files.size() == 3 && index->records.size() == 21, "index built again once released");
+}
+
+static void test_duplicate_ids()
+{
+    // Records 201 and 202 of part3 have the ids of records of part2
+    write_rec_file("part3", test_records(201, 3));
+    bool thrown = false;
+    try
+    {
+        load_mxnet_recordio_index(g_folder);
+    }
+    catch(const std::exception &e)
+    {
+        thrown = std::string(e.what()).find("part2.rec") != std::string::npos && std::string(e.what()).find("part3.rec") != std::string::npos;
+    }
+    check(thrown, "duplicate image ids across .rec files rejected, naming both files");
+}
+
+int main(int argc, char **argv)
+{
+    char folder[] = "/tmp/rocal_recordio_index_test_XXXXXX";
+    if(!mkdtemp(folder))
+    {
+        std::cout << "Cannot create a temporary folder" << std::endl;
+        return -1;
+    }
+    g_folder = folder;
+    test_multi_part_records();
+    test_index_reuse();
+    test_duplicate_ids();
+    std::string remove = "rm -rf " + g_folder;
+    if(system(remove.c_str()) != 0)
+        std::cout << "Could not remove " << g_folder << std::endl;
+    return rocal_test::report("rocal_recordio_index_test");
+}
@@ -0,0 +1,181 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+#include "ring_buffer.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+#if ENABLE_HIP
+using TestDeviceResources = DeviceResourcesHip;
+#elif ENABLE_OPENCL
+using TestDeviceResources = DeviceResources;
+#else
+struct TestDeviceResources {};
+#endif
+
+static TestDeviceResources g_dev_resources;
+static const unsigned SLOT_SIZE = 16;
+
+// Writes a batch whose bytes are all its number and publishes it
+static void push_batch(RingBuffer &buffer, unsigned char batch)
+{
+    memset(buffer.get_write_buffers()[0], batch, SLOT_SIZE);
+    buffer.set_meta_data(ImageNameBatch(1, "image_" + std::to_string(batch) + ".jpg"), nullptr);
+    buffer.push();
+}
+
+static unsigned char read_batch(RingBuffer &buffer)
+{
+    return static_cast<unsigned char *>(buffer.get_read_buffers()[0])[0];
+}
+
+static unsigned char leased_batch(RingBuffer &buffer, uint64_t lease)
+{
+    return static_cast<unsigned char *>(buffer.get_leased_buffers(lease)[0])[0];
+}
+
+static bool lease_rejected(RingBuffer &buffer, uint64_t lease)
+{
+    try
+    {
+        buffer.get_leased_buffers(lease);
+    }
+    catch(const std::exception &e)
+    {
+        return true;
+    }
+    return false;
+}
+
+// A leased batch is skipped by pop() and handed back to the producer only once released, in order
+void test_lease_release()
+{
+    // the producer can run ahead by depth - 1 batches
+    RingBuffer buffer(4);
+    buffer.init(RocalMemType::HOST, &g_dev_resources, SLOT_SIZE, 1);
+    push_batch(buffer, 0);
+    check(read_batch(buffer) == 0, "first batch");
+    auto lease = buffer.acquire_read_slot();
+    buffer.pop();
+    push_batch(buffer, 1);
+    push_batch(buffer, 2);
+    check(buffer.level() == 2, "popped leased batch counted in the level");
+    check(buffer.full(), "producer not held back by the leased slot");
+    check(read_batch(buffer) == 1, "batch after the leased one");
+    check(leased_batch(buffer, lease) == 0, "leased batch overwritten");
+    check(buffer.get_leased_meta_data(lease).first[0] == "image_0.jpg", "leased meta data lost");
+    // the slot of batch 1 is popped but stays behind the leased one
+    buffer.pop();
+    check(buffer.full(), "slot popped after the leased one handed back to the producer");
+    buffer.release_read_slot(lease);
+    check(!buffer.full(), "released slots not handed back to the producer");
+    check(lease_rejected(buffer, lease), "released lease still valid");
+    check(buffer.level() == 1 && read_batch(buffer) == 2, "batches left after the release");
+    // a lease released twice is ignored
+    buffer.release_read_slot(lease);
+    check(buffer.level() == 1 && read_batch(buffer) == 2, "second release of a lease changed the ring");
+}
+
+// A stale lease id does not touch the lease of a newer batch written to the same slot
+void test_lease_generation()
+{
+    RingBuffer buffer(2);
+    buffer.init(RocalMemType::HOST, &g_dev_resources, SLOT_SIZE, 1);
+    push_batch(buffer, 10);
+    auto stale = buffer.acquire_read_slot();
+    buffer.release_read_slot(stale);
+    buffer.pop();
+    // two more batches take the slot of batch 10 again
+    push_batch(buffer, 11);
+    buffer.pop();
+    push_batch(buffer, 12);
+    check(read_batch(buffer) == 12, "batch in the reused slot");
+    auto lease = buffer.acquire_read_slot();
+    auto second = buffer.acquire_read_slot();
+    check((lease & 0xFFFFFFFF) == (stale & 0xFFFFFFFF), "test does not reuse the slot of the stale lease");
+    check(lease != stale && lease != second, "lease ids of the slot are not unique");
+    check(lease_rejected(buffer, stale), "stale lease accepted");
+    buffer.release_read_slot(stale);
+    buffer.pop();
+    check(!lease_rejected(buffer, lease) && leased_batch(buffer, lease) == 12, "stale lease released the newer one");
+    // the leases on the same batch are released one by one, releasing one of them twice does not release the other
+    buffer.release_read_slot(lease);
+    buffer.release_read_slot(lease);
+    check(buffer.full() && leased_batch(buffer, second) == 12, "slot handed back while a lease is left");
+    buffer.release_read_slot(second);
+    check(buffer.level() == 0 && !buffer.full(), "slot not handed back once all its leases are released");
+}
+
+// The popped batches still leased are not readable, the next run() of the pipeline would wait for the producer
+void test_readable_count()
+{
+    RingBuffer buffer(4);
+    buffer.init(RocalMemType::HOST, &g_dev_resources, SLOT_SIZE, 1);
+    push_batch(buffer, 30);
+    auto lease = buffer.acquire_read_slot();
+    buffer.pop();
+    check(buffer.readable_count() == 0 && buffer.empty(), "popped leased batch readable");
+    push_batch(buffer, 31);
+    check(buffer.readable_count() == 1, "batch pushed behind a leased one not readable");
+    buffer.pop();
+    push_batch(buffer, 32);
+    check(buffer.readable_count() == 1 && read_batch(buffer) == 32, "popped batch behind a leased one readable");
+    buffer.release_read_slot(lease);
+    check(buffer.readable_count() == 1 && read_batch(buffer) == 32, "release changed the readable batches");
+}
+
+// The batches held by the user stay valid across reset(), the others are dropped
+void test_lease_across_reset()
+{
+    RingBuffer buffer(4);
+    buffer.init(RocalMemType::HOST, &g_dev_resources, SLOT_SIZE, 1);
+    push_batch(buffer, 20);
+    auto lease = buffer.acquire_read_slot();
+    push_batch(buffer, 21);
+    buffer.reset();
+    check(buffer.level() == 0, "batches left after reset()");
+    check(leased_batch(buffer, lease) == 20, "leased batch lost by reset()");
+    push_batch(buffer, 22);
+    check(read_batch(buffer) == 22, "first batch after reset()");
+    check(leased_batch(buffer, lease) == 20, "leased batch overwritten after reset()");
+    buffer.release_read_slot(lease);
+    check(lease_rejected(buffer, lease), "lease valid after its release");
+    check(buffer.level() == 1 && read_batch(buffer) == 22, "batch after reset() lost by the release");
+}
+
+int main(int argc, const char **argv)
+{
+    test_lease_release();
+    test_lease_generation();
+    test_readable_count();
+    test_lease_across_reset();
+    return rocal_test::report("Output ring buffer lease checks passed");
+}
@@ -0,0 +1,151 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "file_source_reader.h"
+#include "sample_quarantine.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+static std::string g_folder;
+
+static void write_file(const std::string &path, const std::string &content)
+{
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+static std::vector<std::string> read_lines(const std::string &path)
+{
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    for(std::string line; std::getline(file, line);)
+        lines.push_back(line);
+    return lines;
+}
+
+// Dataset of two sub folders holding files of the same names, the content of a file is its path relative to the root
+static std::string make_dataset(const std::string &name)
+{
+    const std::string root = g_folder + "/" + name;
+    mkdir(root.c_str(), 0755);
+    for(std::string sub_folder : {"a", "b"})
+    {
+        mkdir((root + "/" + sub_folder).c_str(), 0755);
+        for(std::string file : {"0001.jpg", "0002.jpg", "0003.jpg"})
+            write_file(root + "/" + sub_folder + "/" + file, sub_folder + "/" + file);
+    }
+    return root;
+}
+
+// Relative path -> times read, for all the files one epoch of a file reader of the dataset reads
+static std::map<std::string, unsigned> read_epoch(const std::string &root, size_t &count)
+{
+    ReaderConfig config(StorageType::FILE_SYSTEM, root);
+    config.set_batch_count(2);
+    FileSourceReader reader;
+    reader.initialize(config);
+    std::map<std::string, unsigned> reads;
+    count = 0;
+    while(reader.count_items() > 0)
+    {
+        size_t size = reader.open();
+        std::string content(size, '\0');
+        reader.read_data(reinterpret_cast<unsigned char *>(&content[0]), size);
+        reader.close();
+        check(content == reader.sample_path(), "sample path " + reader.sample_path() + " of the file read");
+        check(reader.id() == reader.sample_path().substr(2), "id " + reader.id() + " of the file read");
+        reads[reader.sample_path()]++;
+        count++;
+    }
+    return reads;
+}
+
+static void test_persistence()
+{
+    // The samples are recorded as they come and read back by the next quarantine of the same source
+    const std::string root = make_dataset("persistence");
+    auto quarantine = SampleQuarantine::open(root);
+    check(quarantine && quarantine->size() == 0 && !quarantine->contains("a/0001.jpg"), "quarantine empty at first");
+    check(SampleQuarantine::open(root) == quarantine && SampleQuarantine::open(root + "/") != quarantine, "quarantine of a source shared");
+    quarantine->add("a/0001.jpg", "could not decode\tthe header\n");
+    quarantine->add("a/0001.jpg", "could not decode the image");
+    check(quarantine->size() == 1 && quarantine->contains("a/0001.jpg"), "sample quarantined once");
+    check(!quarantine->contains("b/0001.jpg") && !quarantine->contains("0001.jpg"), "files of the same name in other folders not quarantined");
+    auto lines = read_lines(root + "/.rocal_quarantine");
+    check(lines.size() == 1 && lines[0] == "a/0001.jpg\tcould not decode the header ", "sidecar line of the sample");
+    quarantine.reset();
+
+    quarantine = SampleQuarantine::open(root);
+    check(quarantine->size() == 1 && quarantine->contains("a/0001.jpg") && !quarantine->contains("b/0001.jpg"), "quarantine read back");
+    quarantine->add("b/0003.jpg", "empty or unreadable");
+    quarantine.reset();
+    check(read_lines(root + "/.rocal_quarantine").size() == 2, "sidecar appended to");
+
+    setenv("ROCAL_DISABLE_QUARANTINE", "1", 1);
+    check(!SampleQuarantine::open(root), "quarantine disabled");
+    unsetenv("ROCAL_DISABLE_QUARANTINE");
+}
+
+static void test_file_reader_skip()
+{
+    // The quarantined file is left out of the list of the reader and replaced by a healthy file, the file of the same name in the other folder is read
+    const std::string root = make_dataset("skip");
+    size_t count_before, count_after;
+    auto reads = read_epoch(root, count_before);
+    check(count_before == 6 && reads.size() == 6, "all the files read without quarantine");
+    auto quarantine = SampleQuarantine::open(root);
+    quarantine->add("a/0002.jpg", "could not decode the header");
+    quarantine.reset();
+    reads = read_epoch(root, count_after);
+    check(count_after == count_before, "shard size kept");
+    check(!reads.count("a/0002.jpg"), "quarantined file skipped");
+    check(reads["b/0002.jpg"] == 1, "file of the same name in the other folder read");
+    check(reads["a/0003.jpg"] == 2, "quarantined file replaced by the next healthy one");
+}
+
+int main(int argc, char **argv)
+{
+    char folder[] = "/tmp/rocal_sample_quarantine_test_XXXXXX";
+    if(!mkdtemp(folder))
+    {
+        std::cout << "Cannot create a temporary folder" << std::endl;
+        return -1;
+    }
+    g_folder = folder;
+    unsetenv("ROCAL_DISABLE_QUARANTINE");
+    test_persistence();
+    test_file_reader_skip();
+    std::string remove = "rm -rf " + g_folder;
+    if(system(remove.c_str()) != 0)
+        std::cout << "Could not remove " << g_folder << std::endl;
+    return rocal_test::report("rocal_sample_quarantine_test");
+}
@@ -0,0 +1,208 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "shm_batch_ring.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+static const unsigned BATCH_SIZE = 3, BATCH_COUNT = 20, MAX_BOX_COUNT = 5;
+
+static ShmBatchRingLayout box_layout()
+{
+    ShmBatchRingLayout layout;
+    layout.width = 8;
+    layout.height = 4;
+    layout.planes = 3;
+    layout.batch_size = BATCH_SIZE;
+    layout.has_meta_data = 1;
+    layout.meta_data_type = static_cast<int32_t>(MetaDataType::BoundingBox);
+    layout.depth = 3;
+    layout.image_bytes = layout.width * layout.height * layout.planes * BATCH_SIZE;
+    layout.meta_data_bytes = ShmBatchRing::meta_data_bytes(BATCH_SIZE, true, MetaDataType::BoundingBox, 16, MAX_BOX_COUNT);
+    layout.epoch_batch_count = BATCH_COUNT;
+    return layout;
+}
+
+// Sample i of batch b: name of up to 16 characters, (i + b) % (MAX_BOX_COUNT + 1) boxes, images filled with b + i
+static void make_batch(unsigned batch, ImageNameBatch &names, BoundingBoxBatch &meta_data)
+{
+    names.resize(BATCH_SIZE);
+    meta_data.resize(BATCH_SIZE);
+    for(unsigned i = 0; i < BATCH_SIZE; i++)
+    {
+        names[i] = "img_" + std::to_string(batch) + "_" + std::to_string(i) + (i % 2 ? "_longname" : "");
+        const unsigned box_count = (i + batch) % (MAX_BOX_COUNT + 1);
+        meta_data.get_bb_cords_batch()[i].assign(box_count, BoundingBoxCord(0.1f * i, 0.01f * batch, 0.5f, 0.9f));
+        meta_data.get_bb_labels_batch()[i].assign(box_count, int(batch * 10 + i));
+        meta_data.get_img_sizes_batch()[i] = ImgSize{int(100 + i), int(200 + batch)};
+    }
+}
+
+static void test_round_trip(const std::string &segment)
+{
+    // The service (producer) runs in a child process, the client reads every batch it publishes and sees the ring closed after the last one
+    pid_t child = fork();
+    if(child == 0)
+    {
+        int status = 0;
+        try
+        {
+            auto ring = ShmBatchRing::create(segment, box_layout());
+            for(unsigned batch = 0; batch < BATCH_COUNT; batch++)
+            {
+                ImageNameBatch names;
+                BoundingBoxBatch meta_data;
+                make_batch(batch, names, meta_data);
+                if(!ring->wait_until_writable())
+                    _exit(2);
+                memset(ring->write_images(), batch, ring->layout().image_bytes);
+                ring->write_meta_data(names, &meta_data);
+                ring->commit_write();
+            }
+            // The ring holds fewer slots than batches, the client is attached by now and keeps its mapping once the segment is unlinked
+            ring->close();
+        }
+        catch(const std::exception &e)
+        {
+            std::cerr << "Service: " << e.what() << std::endl;
+            status = 1;
+        }
+        _exit(status);
+    }
+    try
+    {
+        auto ring = ShmBatchRing::attach(segment, 5000);
+        check(ring->layout().meta_data_bytes == box_layout().meta_data_bytes && ring->layout().epoch_batch_count == BATCH_COUNT, "layout read by the client");
+        for(unsigned batch = 0; batch < BATCH_COUNT; batch++)
+        {
+            if(!ring->wait_until_readable())
+            {
+                check(false, "batch " + std::to_string(batch) + " readable");
+                break;
+            }
+            ImageNameBatch expected_names, names;
+            BoundingBoxBatch expected, meta_data;
+            make_batch(batch, expected_names, expected);
+            ring->read_meta_data(names, &meta_data);
+            check(names == expected_names, "names of batch " + std::to_string(batch));
+            for(unsigned i = 0; i < BATCH_SIZE && i < names.size(); i++)
+            {
+                auto &boxes = meta_data.get_bb_cords_batch()[i], &expected_boxes = expected.get_bb_cords_batch()[i];
+                bool same_boxes = boxes.size() == expected_boxes.size();
+                for(size_t box = 0; same_boxes && box < boxes.size(); box++)
+                    same_boxes = !memcmp(&boxes[box], &expected_boxes[box], sizeof(BoundingBoxCord));
+                check(same_boxes, "boxes of sample " + std::to_string(i) + " of batch " + std::to_string(batch));
+                check(meta_data.get_bb_labels_batch()[i] == expected.get_bb_labels_batch()[i], "box labels of sample " + std::to_string(i) + " of batch " + std::to_string(batch));
+                check(meta_data.get_img_sizes_batch()[i].w == expected.get_img_sizes_batch()[i].w &&
+                      meta_data.get_img_sizes_batch()[i].h == expected.get_img_sizes_batch()[i].h, "image size of sample " + std::to_string(i) + " of batch " + std::to_string(batch));
+            }
+            const unsigned char *images = ring->read_images();
+            bool same_images = true;
+            for(size_t byte = 0; byte < ring->layout().image_bytes; byte++)
+                same_images &= images[byte] == batch;
+            check(same_images, "images of batch " + std::to_string(batch));
+            ring->commit_read();
+        }
+        check(!ring->wait_until_readable(), "ring closed and drained after the last batch");
+    }
+    catch(const std::exception &e)
+    {
+        check(false, std::string("client: ") + e.what());
+    }
+    int status = -1;
+    waitpid(child, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "service process exit status");
+}
+
+static void test_meta_data_bytes(const std::string &segment)
+{
+    // The region holds a batch with the longest names and the most boxes it is sized for, one box more does not fit
+    auto ring = ShmBatchRing::create(segment, box_layout());
+    ImageNameBatch names(BATCH_SIZE, std::string(16, 'n'));
+    BoundingBoxBatch meta_data;
+    meta_data.resize(BATCH_SIZE);
+    for(unsigned i = 0; i < BATCH_SIZE; i++)
+    {
+        meta_data.get_bb_cords_batch()[i].assign(MAX_BOX_COUNT, BoundingBoxCord(0, 0, 1, 1));
+        meta_data.get_bb_labels_batch()[i].assign(MAX_BOX_COUNT, 1);
+        meta_data.get_img_sizes_batch()[i] = ImgSize{1, 1};
+    }
+    bool fits = true;
+    try { ring->write_meta_data(names, &meta_data); } catch(const std::exception &) { fits = false; }
+    check(fits, "a batch of the longest names and the most boxes fits in the region");
+    meta_data.get_bb_cords_batch()[BATCH_SIZE - 1].push_back(BoundingBoxCord(0, 0, 1, 1));
+    meta_data.get_bb_labels_batch()[BATCH_SIZE - 1].push_back(1);
+    fits = true;
+    try { ring->write_meta_data(names, &meta_data); } catch(const std::exception &) { fits = false; }
+    check(!fits, "one box more does not fit in the region");
+}
+
+static void test_service_exit(const std::string &segment)
+{
+    // A service that exits without closing its ring makes the waiting client throw instead of blocking forever
+    pid_t child = fork();
+    if(child == 0)
+    {
+        // Created and left behind, the process exits without running the destructor that would unlink the segment
+        auto ring = ShmBatchRing::create(segment, box_layout());
+        _exit(0);
+    }
+    bool thrown = false;
+    try
+    {
+        auto ring = ShmBatchRing::attach(segment, 5000);
+        // Reaped, a zombie would still be alive for kill()
+        waitpid(child, nullptr, 0);
+        const auto start = std::chrono::steady_clock::now();
+        try { ring->wait_until_readable(); } catch(const std::exception &) { thrown = true; }
+        auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        check(waited < 5000, "client gave up after " + std::to_string(waited) + " ms");
+    }
+    catch(const std::exception &e)
+    {
+        waitpid(child, nullptr, 0);
+        check(false, std::string("attaching: ") + e.what());
+    }
+    check(thrown, "client throws once the service has exited");
+    shm_unlink(segment.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    const std::string segment = ShmBatchRing::segment_name("ring_test_" + std::to_string(getpid()), 0);
+    test_round_trip(segment);
+    test_meta_data_bytes(segment);
+    test_service_exit(segment);
+    return rocal_test::report("rocal_shm_batch_ring_test");
+}
@@ -0,0 +1,262 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <vector>
+#include <string>
+
+#include "slot_ring.h"
+#include "circular_buffer.h"
+#include "ring_buffer.h"
+
+using namespace std::chrono;
+
+// Per slot meta data, stands in for the decoded_image_info / image names carried with every batch
+struct SlotInfo
+{
+    std::vector<std::string> names;
+};
+
+// Replica of the mutex + condition variable handoff used by the loaders before the SlotRing
+class LockedRing
+{
+public:
+    explicit LockedRing(size_t depth): _depth(depth) {}
+    size_t write_index() { return _write_ptr; }
+    size_t read_index() { return _read_ptr; }
+    void block_if_full()
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        while(_level >= _depth - 1)
+            _wait_for_unload.wait(lock);
+    }
+    void block_if_empty()
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        while(_level == 0)
+            _wait_for_load.wait(lock);
+    }
+    void push(const SlotInfo &info)
+    {
+        std::unique_lock<std::mutex> names_lock(_names_buff_lock);
+        _infos.push(info);
+        std::unique_lock<std::mutex> lock(_lock);
+        _write_ptr = (_write_ptr + 1) % _depth;
+        _level++;
+        lock.unlock();
+        _wait_for_load.notify_all();
+    }
+    SlotInfo &front()
+    {
+        block_if_empty();
+        std::unique_lock<std::mutex> names_lock(_names_buff_lock);
+        return _infos.front();
+    }
+    void pop()
+    {
+        std::unique_lock<std::mutex> names_lock(_names_buff_lock);
+        std::unique_lock<std::mutex> lock(_lock);
+        _read_ptr = (_read_ptr + 1) % _depth;
+        _level--;
+        lock.unlock();
+        _wait_for_unload.notify_all();
+        _infos.pop();
+    }
+private:
+    size_t _depth, _write_ptr = 0, _read_ptr = 0, _level = 0;
+    std::mutex _lock, _names_buff_lock;
+    std::condition_variable _wait_for_load, _wait_for_unload;
+    std::queue<SlotInfo> _infos;
+};
+
+static volatile size_t g_sink;// keeps the consumer side reads from being optimized out
+
+// Touches the first bytes of a slot so both sides see some real memory traffic per batch
+static inline void touch(std::vector<unsigned char> &slot, unsigned char value, size_t bytes)
+{
+    memset(slot.data(), value, bytes);
+}
+
+double run_locked(size_t iterations, size_t depth, size_t batch_size, size_t touch_bytes)
+{
+    LockedRing ring(depth);
+    std::vector<std::vector<unsigned char>> slots(depth, std::vector<unsigned char>(touch_bytes + 1));
+    SlotInfo info;
+    info.names.resize(batch_size, "image_000000.jpg");
+    size_t checksum = 0;
+    auto start = high_resolution_clock::now();
+    std::thread producer([&]()
+    {
+        for(size_t i = 0; i < iterations; i++)
+        {
+            ring.block_if_full();
+            touch(slots[ring.write_index()], (unsigned char)i, touch_bytes);
+            ring.push(info);
+        }
+    });
+    for(size_t i = 0; i < iterations; i++)
+    {
+        ring.block_if_empty();
+        checksum += slots[ring.read_index()][0] + ring.front().names.size();
+        ring.pop();
+    }
+    producer.join();
+    auto end = high_resolution_clock::now();
+    g_sink = checksum;
+    return duration_cast<nanoseconds>(end - start).count() / (double)iterations;
+}
+
+double run_slot_ring(size_t iterations, size_t depth, size_t batch_size, size_t touch_bytes)
+{
+    SlotRing ring(depth);
+    std::vector<std::vector<unsigned char>> slots(depth, std::vector<unsigned char>(touch_bytes + 1));
+    std::vector<SlotInfo> infos(depth);
+    SlotInfo info;
+    info.names.resize(batch_size, "image_000000.jpg");
+    size_t checksum = 0;
+    auto start = high_resolution_clock::now();
+    std::thread producer([&]()
+    {
+        for(size_t i = 0; i < iterations; i++)
+        {
+            ring.wait_until_writable();
+            touch(slots[ring.write_index()], (unsigned char)i, touch_bytes);
+            infos[ring.write_index()] = info;
+            ring.commit_write();
+        }
+    });
+    for(size_t i = 0; i < iterations; i++)
+    {
+        ring.wait_until_readable();
+        checksum += slots[ring.read_index()][0] + infos[ring.read_index()].names.size();
+        ring.commit_read();
+    }
+    producer.join();
+    auto end = high_resolution_clock::now();
+    g_sink = checksum;
+    return duration_cast<nanoseconds>(end - start).count() / (double)iterations;
+}
+
+// The buffers below are used with host memory only, the device resources are only needed by their constructors
+#if ENABLE_HIP
+using BenchmarkDeviceResources = DeviceResourcesHip;
+#elif ENABLE_OPENCL
+using BenchmarkDeviceResources = DeviceResources;
+#else
+struct BenchmarkDeviceResources {};
+#endif
+
+// Loader thread -> output thread handoff of the loader CircularBuffer: a slot and its decoded_image_info
+double run_circular_buffer(size_t iterations, size_t depth, size_t batch_size, size_t touch_bytes)
+{
+    BenchmarkDeviceResources dev_resources;
+    CircularBuffer buffer(&dev_resources);
+    buffer.init(RocalMemType::HOST, touch_bytes + 1, depth);
+    decoded_image_info info;
+    info._image_names.resize(batch_size, "image_000000.jpg");
+    info._roi_width.resize(batch_size, 640);
+    info._roi_height.resize(batch_size, 480);
+    info._original_width.resize(batch_size, 640);
+    info._original_height.resize(batch_size, 480);
+    size_t checksum = 0;
+    auto start = high_resolution_clock::now();
+    std::thread producer([&]()
+    {
+        for(size_t i = 0; i < iterations; i++)
+        {
+            memset(buffer.get_write_buffer(), (int)i, touch_bytes);
+            buffer.set_image_info(info);
+            buffer.push();
+        }
+    });
+    for(size_t i = 0; i < iterations; i++)
+    {
+        checksum += buffer.get_read_buffer_host()[0] + buffer.get_image_info()._image_names.size();
+        buffer.pop();
+    }
+    producer.join();
+    auto end = high_resolution_clock::now();
+    g_sink = checksum;
+    return duration_cast<nanoseconds>(end - start).count() / (double)iterations;
+}
+
+// Output thread -> user thread handoff of the output RingBuffer: the sub buffers and the meta data of a slot
+double run_ring_buffer(size_t iterations, size_t depth, size_t batch_size, size_t touch_bytes)
+{
+    BenchmarkDeviceResources dev_resources;
+    RingBuffer buffer(depth);
+    buffer.init(RocalMemType::HOST, &dev_resources, touch_bytes + 1, 1);
+    ImageNameBatch names(batch_size, "image_000000.jpg");
+    size_t checksum = 0;
+    auto start = high_resolution_clock::now();
+    std::thread producer([&]()
+    {
+        for(size_t i = 0; i < iterations; i++)
+        {
+            memset(buffer.get_write_buffers()[0], (int)i, touch_bytes);
+            buffer.set_meta_data(names, nullptr);
+            buffer.push();
+        }
+    });
+    for(size_t i = 0; i < iterations; i++)
+    {
+        checksum += static_cast<unsigned char *>(buffer.get_read_buffers()[0])[0] + buffer.get_meta_data().first.size();
+        buffer.pop();
+    }
+    producer.join();
+    auto end = high_resolution_clock::now();
+    g_sink = checksum;
+    return duration_cast<nanoseconds>(end - start).count() / (double)iterations;
+}
+
+int main(int argc, const char **argv)
+{
+    size_t iterations = (argc > 1) ? std::stoul(argv[1]) : 200000;
+    size_t depth = (argc > 2) ? std::stoul(argv[2]) : 3;
+    size_t batch_size = (argc > 3) ? std::stoul(argv[3]) : 8;
+    size_t touch_bytes = (argc > 4) ? std::stoul(argv[4]) : 64;
+    if(depth < 2)
+    {
+        std::cout << "Usage: rocal_slot_ring_benchmark <iterations> <buffer depth (>=2)> <names per batch> <bytes touched per batch>" << std::endl;
+        return -1;
+    }
+    std::cout << ">>> Producer/consumer handoff, iterations: " << iterations << " depth: " << depth
+              << " names per batch: " << batch_size << " bytes touched: " << touch_bytes << std::endl;
+
+    double locked_ns = run_locked(iterations, depth, batch_size, touch_bytes);
+    double slot_ring_ns = run_slot_ring(iterations, depth, batch_size, touch_bytes);
+    std::cout << "mutex/condition variable ring : " << locked_ns << " ns per push/pop" << std::endl;
+    std::cout << "lock-free slot ring           : " << slot_ring_ns << " ns per push/pop" << std::endl;
+    std::cout << "speedup                       : " << locked_ns / slot_ring_ns << "x" << std::endl;
+    std::cout << "loader CircularBuffer         : " << run_circular_buffer(iterations, depth, batch_size, touch_bytes) << " ns per push/pop" << std::endl;
+    std::cout << "output RingBuffer             : " << run_ring_buffer(iterations, depth, batch_size, touch_bytes) << " ns per push/pop" << std::endl;
+    return 0;
+}
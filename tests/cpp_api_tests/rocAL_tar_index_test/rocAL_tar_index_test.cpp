@@ -0,0 +1,271 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tar_shard_index.h"
+#include "rocal_test_check.h"
+
+using rocal_test::check;
+
+// Writes tar files member by member, ustar headers with the GNU long name and pax extended header extensions
+class TarWriter
+{
+public:
+    //! Returns the offset of the member's data in the file
+    size_t add(const std::string &name, const std::string &data, char type = '0')
+    {
+        if(name.size() > 100)
+        {
+            add_header("././@LongLink", name.size() + 1, 'L');
+            add_data(name + '\0');
+        }
+        add_header(name.substr(0, 100), data.size(), type);
+        size_t offset = _tar.size();
+        add_data(data);
+        return offset;
+    }
+    //! A member whose path and size are given by a pax extended header, the ustar fields hold other values
+    size_t add_pax(const std::string &path, const std::string &data)
+    {
+        std::string records = pax_record("path", path) + pax_record("size", std::to_string(data.size()));
+        add_header("PaxHeaders/member", records.size(), 'x');
+        add_data(records);
+        add_header("truncated_name", 0, '0');
+        size_t offset = _tar.size();
+        add_data(data);
+        return offset;
+    }
+    //! A member whose name is split between the ustar prefix and name fields
+    size_t add_prefixed(const std::string &prefix, const std::string &name, const std::string &data)
+    {
+        add_header(name, data.size(), '0', prefix);
+        size_t offset = _tar.size();
+        add_data(data);
+        return offset;
+    }
+    void end() { _tar.append(1024, '\0'); }
+    std::string &bytes() { return _tar; }
+    void write(const std::string &path) const
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(_tar.data(), _tar.size());
+    }
+private:
+    static std::string pax_record(const std::string &key, const std::string &value)
+    {
+        // The length of a record counts its own digits
+        std::string record = " " + key + "=" + value + "\n";
+        size_t length = record.size() + 1;
+        while(std::to_string(length).size() + record.size() != length)
+            length++;
+        return std::to_string(length) + record;
+    }
+    void add_header(const std::string &name, size_t size, char type, const std::string &prefix = "")
+    {
+        char header[512] = {};
+        memcpy(header, name.data(), std::min<size_t>(name.size(), 100));
+        snprintf(header + 100, 8, "%07o", 0644);
+        snprintf(header + 124, 12, "%011lo", (unsigned long)size);
+        header[156] = type;
+        memcpy(header + 257, "ustar", 6);
+        memcpy(header + 263, "00", 2);
+        memcpy(header + 345, prefix.data(), std::min<size_t>(prefix.size(), 155));
+        memset(header + 148, ' ', 8);
+        unsigned sum = 0;
+        for(unsigned char c : header)
+            sum += c;
+        snprintf(header + 148, 8, "%06o", sum);
+        _tar.append(header, sizeof(header));
+    }
+    void add_data(const std::string &data)
+    {
+        _tar += data;
+        _tar.append((512 - data.size() % 512) % 512, '\0');
+    }
+    std::string _tar;
+};
+
+static std::string g_folder;
+
+static std::string write_tar(TarWriter &writer, const std::string &name)
+{
+    std::string path = g_folder + "/" + name;
+    writer.write(path);
+    return path;
+}
+
+static bool throws(const std::string &path)
+{
+    try
+    {
+        load_tar_shard_index(path);
+    }
+    catch(const std::exception &e)
+    {
+        return true;
+    }
+    return false;
+}
+
+static const TarShardSample *find_sample(const TarShardFile &file, const std::string &key)
+{
+    for(auto &sample : file.samples)
+        if(sample.key == key)
+            return &sample;
+    return nullptr;
+}
+
+// Members of every size around the 512 byte blocks, the data of each has to be found at its offset, past the padding of the members before
+void test_padding()
+{
+    TarWriter writer;
+    const size_t sizes[] = {1, 511, 512, 513, 1024, 7};
+    std::vector<size_t> offsets;
+    for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        offsets.push_back(writer.add("sample" + std::to_string(i) + ".jpg", std::string(sizes[i], char('a' + i))));
+        writer.add("sample" + std::to_string(i) + ".cls", std::to_string(i));
+    }
+    writer.add("sample9.cls", "9");// no image, ignored
+    writer.add("images/", "", '5');// directory
+    writer.add("images/.hidden.jpg", "x");
+    writer.add("images/noextension", "x");
+    writer.end();
+    auto index = load_tar_shard_index(write_tar(writer, "padding.tar"));
+    check(index->files.size() == 1, "padding: " + std::to_string(index->files.size()) + " files instead of 1");
+    auto &file = index->files[0];
+    check(file.samples.size() == offsets.size(), "padding: " + std::to_string(file.samples.size()) + " samples instead of " + std::to_string(offsets.size()));
+    for(size_t i = 0; i < offsets.size() && i < file.samples.size(); i++)
+    {
+        auto &sample = file.samples[i];
+        const std::string name = "padding sample " + std::to_string(i);
+        check(sample.key == "sample" + std::to_string(i), name + ": key " + sample.key);
+        check(sample.image.offset == offsets[i] && sample.image.size == sizes[i], name + ": image at " + std::to_string(sample.image.offset) + " of " + std::to_string(sample.image.size) + " bytes");
+        check(sample.label.valid() && sample.label.offset == offsets[i] + ((sizes[i] + 511) / 512) * 512 + 512, name + ": label at " + std::to_string(sample.label.offset));
+        check(writer.bytes().substr(sample.image.offset, sample.image.size) == std::string(sizes[i], char('a' + i)), name + ": image data");
+    }
+}
+
+// Names longer than the 100 bytes of the ustar name field: GNU long names, pax paths (with a pax size) and the ustar prefix
+void test_long_names()
+{
+    TarWriter writer;
+    const std::string long_folder = "a_folder_with_a_name_long_enough_that_the_paths_of_its_members_do_not_fit_in_the_100_bytes_of_the_ustar_name";
+    size_t gnu_offset = writer.add(long_folder + "/gnu_sample.jpg", "gnu");
+    writer.add(long_folder + "/gnu_sample.json", "{}");
+    size_t pax_offset = writer.add_pax(long_folder + "/pax_sample.png", std::string(700, 'p'));
+    size_t prefix_offset = writer.add_prefixed("prefix_folder", "prefixed_sample.jpeg", "prefixed");
+    // The long name applies to the member right after it only
+    size_t short_offset = writer.add("short.jpg", "short");
+    writer.end();
+    auto index = load_tar_shard_index(write_tar(writer, "long_names.tar"));
+    auto &file = index->files[0];
+    check(file.samples.size() == 4, "long names: " + std::to_string(file.samples.size()) + " samples instead of 4");
+    auto gnu = find_sample(file, long_folder + "/gnu_sample");
+    check(gnu && gnu->image.offset == gnu_offset && gnu->image.size == 3 && gnu->boxes.valid(), "GNU long name");
+    auto pax = find_sample(file, long_folder + "/pax_sample");
+    check(pax && pax->image.offset == pax_offset && pax->image.size == 700, "pax path and size");
+    auto prefixed = find_sample(file, "prefix_folder/prefixed_sample");
+    check(prefixed && prefixed->image.offset == prefix_offset, "ustar prefix");
+    auto short_sample = find_sample(file, "short");
+    check(short_sample && short_sample->image.offset == short_offset, "name after the long names");
+}
+
+// A tar cut within a member's data or with a corrupted header is an error, members after the end of archive blocks are ignored
+void test_truncated_members()
+{
+    TarWriter complete;
+    complete.add("first.jpg", std::string(600, 'f'));
+    complete.add("second.jpg", std::string(2000, 's'));
+    complete.end();
+    TarWriter truncated = complete;
+    truncated.bytes().resize(512 + 1024 + 512 + 1000);
+    check(throws(write_tar(truncated, "truncated.tar")), "member cut in its data accepted");
+
+    TarWriter corrupted = complete;
+    corrupted.bytes()[512 + 1024 + 10] ^= 0x20;
+    check(throws(write_tar(corrupted, "corrupted.tar")), "header with an invalid checksum accepted");
+
+    TarWriter trailing = complete;
+    trailing.add("after_end.jpg", "ignored");
+    auto index = load_tar_shard_index(write_tar(trailing, "trailing.tar"));
+    check(index->files[0].samples.size() == 2, "members after the end of archive indexed");
+
+    TarWriter no_image;
+    no_image.add("only.cls", "1");
+    no_image.end();
+    check(throws(write_tar(no_image, "no_image.tar")), "tar without images accepted");
+}
+
+// The tar files of a folder are indexed in the order of their paths, the index is shared while it is in use
+void test_folder()
+{
+    const std::string folder = g_folder + "/shards";
+    if(mkdir(folder.c_str(), 0755) != 0)
+    {
+        check(false, "cannot create " + folder);
+        return;
+    }
+    for(auto name : {"shard-0002.tar", "shard-0000.tar", "shard-0001.tar"})
+    {
+        TarWriter writer;
+        writer.add("sample.jpg", name);
+        writer.end();
+        writer.write(folder + "/" + name);
+    }
+    std::ofstream(folder + "/notes.txt") << "not a tar file";
+    auto index = load_tar_shard_index(folder);
+    check(index->files.size() == 3 && index->sample_count() == 3, "folder: " + std::to_string(index->files.size()) + " files");
+    for(size_t i = 0; i < index->files.size(); i++)
+        check(index->files[i].path == folder + "/shard-000" + std::to_string(i) + ".tar", "folder file " + std::to_string(i) + ": " + index->files[i].path);
+    check(load_tar_shard_index(folder) == index, "index built again while in use");
+}
+
+int main(int argc, const char **argv)
+{
+    char folder[] = "/tmp/rocal_tar_index_test_XXXXXX";
+    if(!mkdtemp(folder))
+    {
+        std::cout << "Cannot create a temporary folder" << std::endl;
+        return -1;
+    }
+    g_folder = folder;
+    test_padding();
+    test_long_names();
+    test_truncated_members();
+    test_folder();
+    std::string remove = "rm -rf " + g_folder;
+    if(system(remove.c_str()) != 0)
+        std::cout << "Could not remove " << g_folder << std::endl;
+    return rocal_test::report("Tar shard index checks passed");
+}